@@ -0,0 +1,678 @@
+/******************************************************************************\
+ * Copyright (c) 2024
+ *
+ * Author(s):
+ *	EasyDRF developers
+ *
+ * Description:
+ *	Headless mode with a local control socket ("-d [socket]")
+ *
+ *	The program runs the same receiver and transmitter as with the window,
+ *	but without it, so a service wrapper or a script can start it. Clients
+ *	connect to a UNIX domain socket (Windows 10 1803 and up) and send one
+ *	command per line, each reply is one line of JSON:
+ *
+ *	status					receiver and transmitter state, SNR, CRC counters,
+ *							progress of the received and the sent file
+ *	stats [reset]			timing of the processing modules
+ *	rx on|off				start (with a new acquisition) or pause the receiver
+ *	queue [file]			add a file to the TX list, without a file the list
+ *	clear					empty the TX list
+ *	tx on|off				send the TX list, the receiver goes on afterwards
+ *	bsr request [3]			ask for the missing segments of the last file
+ *	bsr answer [3]			send the segments the other station asked for
+ *	quit					stop the program
+ *
+ *	Received files are saved to the RX path of settings.txt like with the
+ *	window and written to the reception log
+ *
+ ******************************************************************************
+ *
+ * This program is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation; either version 2 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ *
+\******************************************************************************/
+
+#include "Daemon.h"
+#include <afunix.h>
+#include "Dialog.h"
+#include "getfilenam.h"
+#include "Logging.h"
+#include "RS-defs.h"
+#include "common/ModulStats.h"
+#include "common/ThreadSetup.h"
+#include "common/settings.h"
+#include "common/libs/callsign.h"
+#include "sound/SoundLoopback.h"
+
+/* Globals of the program with the window, see Dialog.cpp */
+extern BOOL RX_Running;
+extern BOOL TX_Running;
+extern char rxfilepath[260];
+extern char bsrpath[260];
+
+BOOL __cdecl GetFileRX(char* FileName);
+int __cdecl GetLastTID();
+BOOL __cdecl GetPercentTX(int* piccnt, int* percent);
+
+
+/* Implementation *************************************************************/
+/* JSON string with quotes, file names contain backslashes */
+static string JsonStr(const string& strIn)
+{
+	string strOut = "\"";
+
+	for (size_t i = 0; i < strIn.size(); i++)
+	{
+		const unsigned char c = (unsigned char) strIn[i];
+
+		if ((c == '"') || (c == '\\'))
+		{
+			strOut += '\\';
+			strOut += (char) c;
+		}
+		else if (c < 0x20)
+		{
+			char chHex[8];
+			sprintf(chHex, "\\u%04x", c);
+			strOut += chHex;
+		}
+		else
+			strOut += (char) c;
+	}
+
+	return strOut + "\"";
+}
+
+static void JsonError(string& strReply, const char* pchError)
+{
+	strReply = string("{\"ok\":false,\"error\":") + JsonStr(pchError) + "}";
+}
+
+CDaemon::CDaemon() : bRxFailed(FALSE), bTxFailed(FALSE), iFACOk(0), iFACBad(0),
+	iMSCOk(0), iMSCBad(0), bSending(FALSE), bQuit(FALSE), bBSRRequest(FALSE),
+	iFilesRx(0), iFilesTx(0), iTxPicture(0), iTxPercent(0)
+{
+	for (int i = 0; i <= MS_MOT_OBJ_STAT; i++)
+		iState[i] = -1;
+}
+
+void CDaemon::OnMessage(const _MESSAGE_IDENT MessID, const int iMessageParam)
+{
+	/* Receive thread */
+	switch (MessID)
+	{
+	case MS_FAC_CRC:
+		if (iMessageParam == 0)
+			iFACOk++;
+		else
+			iFACBad++;
+		break;
+
+	case MS_MSC_CRC:
+		if (iMessageParam == 0)
+			iMSCOk++;
+		else
+			iMSCBad++;
+		break;
+
+	case MS_RESET_ALL:
+		for (int i = 0; i <= MS_MOT_OBJ_STAT; i++)
+			iState[i] = -1;
+		return;
+	}
+
+	if (MessID <= MS_MOT_OBJ_STAT)
+		iState[MessID] = iMessageParam;
+}
+
+void CDaemon::RxThread()
+{
+	CDSPThread DSPThread(DSP_THREAD_RX, L"EasyDRF RX");
+	pMessageSink = this;
+
+	try
+	{
+		DRMReceiver.Start();
+	}
+	catch (CGenErr)
+	{
+		bRxFailed = TRUE;
+	}
+}
+
+void CDaemon::TxThread()
+{
+	CDSPThread DSPThread(DSP_THREAD_TX, L"EasyDRF TX");
+
+	try
+	{
+		DRMTransmitter.Start();
+	}
+	catch (CGenErr)
+	{
+		bTxFailed = TRUE;
+	}
+}
+
+_BOOLEAN CDaemon::StartRadio()
+{
+	/* Like the start of the dialog, see WM_INITDIALOG in Dialog.cpp */
+	getvar();
+
+	if (SoundBackend == SOUND_BACKEND_LOOPBACK)
+	{
+		DRMReceiver.SetSoundBackend(GetSoundLoopback());
+		DRMTransmitter.SetSoundBackend(GetSoundLoopback());
+	}
+	DRMReceiver.GetSoundInterface()->SetLatency(SoundLatencyMs);
+	DRMReceiver.SetDisplayRate(DMN_DISPLAY_RATE);
+
+	comtx(gettxport());
+	EZHeaderID = "EasyDRFHeader/|000000";
+
+	try
+	{
+		DRMReceiver.GetParameters()->bOnlyPicture = FALSE;
+		DRMReceiver.Init();
+		DRMReceiver.GetSoundInterface()->SetInDev(getsoundin('r'));
+		DRMReceiver.GetSoundInterface()->SetOutDev(getsoundout('r'));
+
+		RX_Running = TRUE;
+		RxWorker = std::thread(&CDaemon::RxThread, this);
+	}
+	catch (CGenErr)
+	{
+		RX_Running = FALSE;
+		return FALSE;
+	}
+
+	try
+	{
+		DRMTransmitter.GetParameters()->bOnlyPicture = FALSE;
+		DRMTransmitter.Init();
+		DRMTransmitter.GetSoundInterface()->SetInDev(getsoundin('t'));
+		DRMTransmitter.GetSoundInterface()->SetOutDev(getsoundout('t'));
+		DRMTransmitter.GetParameters()->Service[0].strLabel = getcall();
+		DRMTransmitter.GetParameters()->Service[0].AudioParam.eAudioCoding = CParameter::AC_LPC;
+		DRMTransmitter.GetAudSrcEnc()->ClearTextMessage();
+		DRMTransmitter.GetAudSrcEnc()->ClearPicFileNames();
+		DRMTransmitter.GetAudSrcEnc()->SetTheStartDelay(DMN_START_DELAY);
+
+		TX_Running = TRUE;
+		TxWorker = std::thread(&CDaemon::TxThread, this);
+	}
+	catch (CGenErr)
+	{
+		/* Receive only */
+		TX_Running = FALSE;
+	}
+
+	ReceptionLog.Start(string(rxfilepath) + RXLOG_FILE_NAME);
+
+	return TRUE;
+}
+
+void CDaemon::StopRadio()
+{
+	if (bSending == TRUE)
+		StopSend();
+
+	DRMReceiver.Stop();
+	DRMTransmitter.Stop();
+
+	if (RxWorker.joinable())
+		RxWorker.join();
+	if (TxWorker.joinable())
+		TxWorker.join();
+
+	ReceptionLog.Stop();
+}
+
+void CDaemon::StartSend(const _BOOLEAN bSetFiles)
+{
+	/* Like the OK button of the TX file dialog */
+	if (bSetFiles == TRUE)
+		SetTXmode(TRUE);
+
+	if (RX_Running)
+		DRMReceiver.NotRec();
+
+	IsRX2 = FALSE;
+	PTTon();
+
+	DRMTransmitter.Init();
+	DRMTransmitter.Send();
+
+	bSending = TRUE;
+	iTxPicture = 0;
+	iTxPercent = 0;
+}
+
+void CDaemon::StopSend()
+{
+	DRMTransmitter.NotSend();
+
+	IsRX2 = TRUE;
+	PTToff();
+
+	if (RX_Running)
+		DRMReceiver.Rec();
+
+	bSending = FALSE;
+}
+
+void CDaemon::Poll()
+{
+	if (bSending == TRUE)
+	{
+		/* Back to receive some frames after the last file */
+		if (GetPercentTX(&iTxPicture, &iTxPercent) == TRUE)
+		{
+			iFilesTx += DRMTransmitter.GetAudSrcEnc()->GetNoOfPic();
+			StopSend();
+		}
+		return;
+	}
+
+	if (RX_Running == FALSE)
+		return;
+
+	/* Files with RS coding are saved by the decoder itself, see DABMOT.cpp */
+	if (RxRSlevel == 0)
+	{
+		char chFileName[300];
+
+		if (GetFileRX(chFileName) == TRUE)
+		{
+			iFilesRx++;
+			strLastFile = chFileName;
+
+			if (strLastFile == "bsr.bin")
+				bBSRRequest = TRUE;
+			else
+				ReceptionLog.AddFile(GetLastTID(), TRUE, chFileName);
+		}
+	}
+	else
+	{
+		CMOTObject RSObject;
+		DRMReceiver.GetDataDecoder()->GetSlideShowPicture(RSObject);
+	}
+}
+
+void CDaemon::Status(string& strReply)
+{
+	char chBuf[1024];
+
+	DRMReceiver.GetDisplay(Snap);
+
+	sprintf(chBuf, "{\"ok\":true,\"rx\":%s,\"tx\":%s,\"sending\":%s,"
+		"\"rx_failed\":%s,\"tx_failed\":%s,"
+		"\"snr\":%.1f,\"level\":%.3f,\"dc\":%.0f,"
+		"\"io\":%d,\"time_sync\":%d,\"frame_sync\":%d,\"fac\":%d,\"msc\":%d,\"mot\":%d,"
+		"\"fac_ok\":%d,\"fac_bad\":%d,\"msc_ok\":%d,\"msc_bad\":%d,"
+		"\"overruns\":%d,\"underruns\":%d,"
+		"\"rx_segs\":%u,\"rx_good\":%u,\"rx_pos\":%u,\"files_rx\":%d,"
+		"\"bsr_request\":%s,\"queued\":%d,\"tx_file\":%d,\"tx_percent\":%d,"
+		"\"files_tx\":%d,",
+		RX_Running ? "true" : "false", TX_Running ? "true" : "false",
+		bSending ? "true" : "false",
+		bRxFailed ? "true" : "false", bTxFailed ? "true" : "false",
+		(double) DRMReceiver.GetChanEst()->GetSNREstdB(), (double) Snap.rLevel,
+		(double) DRMReceiver.GetParameters()->GetDCFrequency(),
+		iState[MS_IOINTERFACE].load(), iState[MS_TIME_SYNC].load(),
+		iState[MS_FRAME_SYNC].load(), iState[MS_FAC_CRC].load(),
+		iState[MS_MSC_CRC].load(), iState[MS_MOT_OBJ_STAT].load(),
+		iFACOk.load(), iFACBad.load(), iMSCOk.load(), iMSCBad.load(),
+		DRMReceiver.GetSoundInterface()->GetNumOverruns(),
+		DRMReceiver.GetSoundInterface()->GetNumUnderruns(),
+		DRMReceiver.GetDataDecoder()->GetTotSize(),
+		DRMReceiver.GetDataDecoder()->GetActSize(),
+		DRMReceiver.GetDataDecoder()->GetActPos(), iFilesRx,
+		bBSRRequest ? "true" : "false", TXpicpospt, iTxPicture, iTxPercent,
+		iFilesTx);
+
+	strReply = chBuf;
+	strReply += "\"rx_file\":" + JsonStr(DMfilename) + ",";
+	strReply += "\"last_file\":" + JsonStr(strLastFile) + ",";
+	strReply += "\"callsign\":" +
+		JsonStr(DRMReceiver.GetParameters()->Service[0].strLabel) + "}";
+}
+
+void CDaemon::Stats(string& strReply)
+{
+	CVector<CModulStatSnap> vecSnap;
+	char chBuf[256];
+
+	const int iNum = ModulStats.GetSnapshot(vecSnap);
+
+	strReply = "{\"ok\":true,\"modules\":[";
+
+	for (int i = 0; i < iNum; i++)
+	{
+		sprintf(chBuf, "{\"name\":%s,\"calls\":%lld,\"total_ms\":%.3f,"
+			"\"max_us\":%.1f,\"in\":%lld,\"out\":%lld,\"fill\":%d,\"fill_max\":%d}",
+			JsonStr(vecSnap[i].strName).c_str(), vecSnap[i].llNumCalls,
+			(double) vecSnap[i].rTimeTotalMs, (double) vecSnap[i].rTimeMaxUs,
+			vecSnap[i].llSamplesIn, vecSnap[i].llSamplesOut,
+			vecSnap[i].iInputFill, vecSnap[i].iInputFillMax);
+
+		if (i > 0)
+			strReply += ",";
+		strReply += chBuf;
+	}
+
+	strReply += "]}";
+}
+
+void CDaemon::Queue(string& strReply)
+{
+	strReply = "{\"ok\":true,\"files\":[";
+
+	for (int i = 0; i < TXpicpospt; i++)
+	{
+		if (i > 0)
+			strReply += ",";
+		strReply += JsonStr(pictfile[i]);
+	}
+
+	strReply += "]}";
+}
+
+void CDaemon::Command(const string& strLine, string& strReply)
+{
+	/* Command word and the rest of the line */
+	string strCmd = strLine;
+	string strArg;
+
+	const size_t iSpace = strLine.find(' ');
+	if (iSpace != string::npos)
+	{
+		strCmd = strLine.substr(0, iSpace);
+		strArg = strLine.substr(iSpace + 1);
+	}
+
+	strReply = "{\"ok\":true}";
+
+	if (strCmd == "status")
+		Status(strReply);
+	else if (strCmd == "stats")
+	{
+		if (strArg == "reset")
+			ModulStats.Reset();
+		else
+			Stats(strReply);
+	}
+	else if (strCmd == "rx")
+	{
+		if (RX_Running == FALSE)
+			JsonError(strReply, "receiver not running");
+		else if (bSending == TRUE)
+			JsonError(strReply, "sending");
+		else if (strArg == "on")
+		{
+			DRMReceiver.SetInStartMode();
+			DRMReceiver.Rec();
+		}
+		else if (strArg == "off")
+			DRMReceiver.NotRec();
+		else
+			JsonError(strReply, "rx on|off");
+	}
+	else if (strCmd == "queue")
+	{
+		if (strArg.empty())
+			Queue(strReply);
+		else if (bSending == TRUE)
+			JsonError(strReply, "sending");
+		else if (TXpicpospt > 31)
+			JsonError(strReply, "list full");
+		else if (GetFileAttributesA(strArg.c_str()) == INVALID_FILE_ATTRIBUTES)
+			JsonError(strReply, "no such file");
+		else
+		{
+			/* The title is the name without the directory */
+			const size_t iSlash = strArg.find_last_of("\\/");
+			const string strTitle =
+				(iSlash == string::npos) ? strArg : strArg.substr(iSlash + 1);
+
+			strncpy(pictfile[TXpicpospt], strArg.c_str(), 259);
+			pictfile[TXpicpospt][259] = 0;
+			strncpy(filetitle[TXpicpospt], strTitle.c_str(), 259);
+			filetitle[TXpicpospt][259] = 0;
+			TXpicpospt++;
+
+			prepfiles(); /* segments are prepared in the background */
+		}
+	}
+	else if (strCmd == "clear")
+	{
+		if (bSending == TRUE)
+			JsonError(strReply, "sending");
+		else
+			TXpicpospt = 0;
+	}
+	else if (strCmd == "tx")
+	{
+		if (TX_Running == FALSE)
+			JsonError(strReply, "transmitter not running");
+		else if (strArg == "off")
+		{
+			if (bSending == TRUE)
+				StopSend();
+		}
+		else if (bSending == TRUE)
+			JsonError(strReply, "sending");
+		else if (TXpicpospt == 0)
+			JsonError(strReply, "no files");
+		else
+			StartSend(TRUE);
+	}
+	else if (strCmd == "bsr")
+	{
+		const int iInst = (strArg.find('3') != string::npos) ? 3 : 1;
+
+		if ((TX_Running == FALSE) || (bSending == TRUE))
+			JsonError(strReply, "transmitter not ready");
+		else if (strArg.compare(0, 7, "request") == 0)
+		{
+			int iNumSeg;
+			char chName[300];
+
+			/* Saves bsr.bin, the compressed request is sent 2 or 4 times */
+			if (GetBSR(&iNumSeg, chName) == FALSE)
+				JsonError(strReply, "no segments missing");
+			else
+			{
+				SendBSR((iInst == 3) ? 4 : 2, 1);
+				StartSend(FALSE);
+
+				char chBuf[400];
+				sprintf(chBuf, "{\"ok\":true,\"missing\":%d,\"file\":", iNumSeg);
+				strReply = string(chBuf) + JsonStr(chName) + "}";
+			}
+		}
+		else if (strArg.compare(0, 6, "answer") == 0)
+		{
+			int iNumSeg;
+			char chName[300];
+
+			if (bBSRRequest == FALSE)
+				JsonError(strReply, "no request");
+			else if (readthebsrfile(chName, &iNumSeg) == FALSE)
+			{
+				JsonError(strReply, "request is for another station");
+				bBSRRequest = FALSE;
+			}
+			else
+			{
+				/* The segments are written to the TX buffer directly */
+				writebsrselsegments(iInst);
+				StartSend(FALSE);
+				bBSRRequest = FALSE;
+
+				char chBuf[400];
+				sprintf(chBuf, "{\"ok\":true,\"segments\":%d,\"file\":", iNumSeg);
+				strReply = string(chBuf) + JsonStr(chName) + "}";
+			}
+		}
+		else
+			JsonError(strReply, "bsr request|answer [3]");
+	}
+	else if (strCmd == "quit")
+		bQuit = TRUE;
+	else
+		JsonError(strReply, "unknown command");
+}
+
+void CDaemon::CloseClient(const int iClient)
+{
+	closesocket(vecClients[iClient].Sock);
+	vecClients.erase(vecClients.begin() + iClient);
+}
+
+int CDaemon::Run(const char* pchSocketName)
+{
+	WSADATA WsaData;
+	if (WSAStartup(MAKEWORD(2, 2), &WsaData) != 0)
+		return 1;
+
+	SOCKET ListenSock = socket(AF_UNIX, SOCK_STREAM, 0);
+	if (ListenSock == INVALID_SOCKET)
+	{
+		WSACleanup();
+		return 1;
+	}
+
+	/* A socket file of an earlier run would make bind() fail */
+	SOCKADDR_UN Addr;
+	memset(&Addr, 0, sizeof(Addr));
+	Addr.sun_family = AF_UNIX;
+	strncpy(Addr.sun_path, pchSocketName, sizeof(Addr.sun_path) - 1);
+	DeleteFileA(Addr.sun_path);
+
+	if ((bind(ListenSock, (sockaddr*) &Addr, sizeof(Addr)) == SOCKET_ERROR) ||
+		(listen(ListenSock, DMN_MAX_CLIENTS) == SOCKET_ERROR) ||
+		(StartRadio() == FALSE))
+	{
+		closesocket(ListenSock);
+		WSACleanup();
+		return 1;
+	}
+
+	ULONGLONG llNextPoll = GetTickCount64() + DMN_POLL_MS;
+
+	while (bQuit == FALSE)
+	{
+		fd_set ReadSet;
+		FD_ZERO(&ReadSet);
+		FD_SET(ListenSock, &ReadSet);
+		for (size_t i = 0; i < vecClients.size(); i++)
+			FD_SET(vecClients[i].Sock, &ReadSet);
+
+		/* Wake up for the next tick at the latest */
+		const ULONGLONG llNow = GetTickCount64();
+		const long lWaitMs = (llNextPoll > llNow) ? (long) (llNextPoll - llNow) : 0;
+		timeval Timeout;
+		Timeout.tv_sec = 0;
+		Timeout.tv_usec = lWaitMs * 1000;
+
+		if (select(0, &ReadSet, NULL, NULL, &Timeout) == SOCKET_ERROR)
+			break;
+
+		if (GetTickCount64() >= llNextPoll)
+		{
+			Poll();
+			llNextPoll += DMN_POLL_MS;
+		}
+
+		if (FD_ISSET(ListenSock, &ReadSet))
+		{
+			SOCKET NewSock = accept(ListenSock, NULL, NULL);
+
+			if (NewSock != INVALID_SOCKET)
+			{
+				if (vecClients.size() >= DMN_MAX_CLIENTS)
+					closesocket(NewSock);
+				else
+				{
+					CDaemonClient NewClient;
+					NewClient.Sock = NewSock;
+					vecClients.push_back(NewClient);
+				}
+			}
+		}
+
+		/* Backwards, a client may be removed */
+		for (int i = (int) vecClients.size() - 1; i >= 0; i--)
+		{
+			if (!FD_ISSET(vecClients[i].Sock, &ReadSet))
+				continue;
+
+			char chBuf[512];
+			const int iLen = recv(vecClients[i].Sock, chBuf, sizeof(chBuf), 0);
+			if (iLen <= 0)
+			{
+				CloseClient(i);
+				continue;
+			}
+
+			string& strIn = vecClients[i].strIn;
+			strIn.append(chBuf, iLen);
+
+			size_t iEnd;
+			while ((iEnd = strIn.find('\n')) != string::npos)
+			{
+				string strLine = strIn.substr(0, iEnd);
+				strIn.erase(0, iEnd + 1);
+
+				if (!strLine.empty() && (strLine[strLine.size() - 1] == '\r'))
+					strLine.erase(strLine.size() - 1);
+
+				string strReply;
+				Command(strLine, strReply);
+				strReply += "\n";
+
+				send(vecClients[i].Sock, strReply.c_str(), (int) strReply.size(), 0);
+			}
+
+			if (strIn.size() > DMN_MAX_LINE)
+				strIn.clear();
+		}
+	}
+
+	for (int i = (int) vecClients.size() - 1; i >= 0; i--)
+		CloseClient(i);
+
+	closesocket(ListenSock);
+	DeleteFileA(Addr.sun_path);
+	WSACleanup();
+
+	StopRadio();
+
+	return 0;
+}
+
+int RunDaemon(const char* pchSocketName)
+{
+	/* Big members, not on the stack */
+	CDaemon* pDaemon = new CDaemon;
+
+	const int iResult = pDaemon->Run(pchSocketName);
+
+	delete pDaemon;
+
+	return iResult;
+}
@@ -0,0 +1,123 @@
+/******************************************************************************\
+ * Copyright (c) 2024
+ *
+ * Author(s):
+ *	EasyDRF developers
+ *
+ * Description:
+ *	See Daemon.cpp
+ *
+ ******************************************************************************
+ *
+ * This program is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation; either version 2 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ *
+\******************************************************************************/
+
+#if !defined(DAEMON_H__3B0UBVE98732KJVEW363DAEMONSK__INCLUDED_)
+#define DAEMON_H__3B0UBVE98732KJVEW363DAEMONSK__INCLUDED_
+
+#include <winsock2.h>
+#include <atomic>
+#include <thread>
+#include <vector>
+#include <string>
+#include "common/GlobalDefinitions.h"
+#include "common/DisplaySnapshot.h"
+
+
+/* Definitions ****************************************************************/
+/* Control socket in the working directory if no name is given */
+#define DMN_SOCKET_NAME				"easydrf.sock"
+
+#define DMN_MAX_CLIENTS				8
+#define DMN_MAX_LINE				1024	/* longer commands are dropped */
+
+/* Same tick as the timer of the dialog, GetPercentTX() counts in it */
+#define DMN_POLL_MS					100
+
+/* Long start delay of the dialog, the other decoder has more time to lock */
+#define DMN_START_DELAY				24
+
+/* Only the level is taken from the display snapshots */
+#define DMN_DISPLAY_RATE			1
+
+
+/* Classes ********************************************************************/
+class CDaemonClient
+{
+public:
+	SOCKET		Sock;
+	string		strIn; /* received, not yet complete line */
+};
+
+/* The receiver and transmitter of the program without the window. Runs in
+   the main thread until "quit" is received. The messages of the receive
+   thread are counted here instead of lighting the LEDs */
+class CDaemon : public CMessageSink
+{
+public:
+	CDaemon();
+	virtual ~CDaemon() {}
+
+	/* Returns the exit code of the program */
+	int				Run(const char* pchSocketName);
+
+	virtual void	OnMessage(const _MESSAGE_IDENT MessID, const int iMessageParam);
+
+protected:
+	_BOOLEAN		StartRadio();
+	void			StopRadio();
+	void			RxThread();
+	void			TxThread();
+
+	void			Poll();
+	void			StartSend(const _BOOLEAN bSetFiles);
+	void			StopSend();
+
+	void			Command(const string& strLine, string& strReply);
+	void			Status(string& strReply);
+	void			Stats(string& strReply);
+	void			Queue(string& strReply);
+
+	void			CloseClient(const int iClient);
+
+	std::thread				RxWorker;
+	std::thread				TxWorker;
+	std::atomic<_BOOLEAN>	bRxFailed;
+	std::atomic<_BOOLEAN>	bTxFailed;
+
+	/* Counters of the receive thread */
+	std::atomic<int>		iFACOk, iFACBad;
+	std::atomic<int>		iMSCOk, iMSCBad;
+	std::atomic<int>		iState[MS_MOT_OBJ_STAT + 1];
+
+	_BOOLEAN				bSending;
+	_BOOLEAN				bQuit;
+	_BOOLEAN				bBSRRequest; /* a request of the other station came in */
+	int						iFilesRx;
+	int						iFilesTx;
+	int						iTxPicture;
+	int						iTxPercent;
+	string					strLastFile;
+
+	CDisplaySnapshot		Snap;
+	std::vector<CDaemonClient>	vecClients;
+};
+
+/* Headless mode of the program ("-d [socket]") */
+int RunDaemon(const char* pchSocketName);
+
+
+#endif // !defined(DAEMON_H__3B0UBVE98732KJVEW363DAEMONSK__INCLUDED_)
@@ -35,6 +35,7 @@
 #include "resource.h"
 #include "common/DrmReceiver.h"
 #include "common/DrmTransmitter.h"
+#include "sound/SoundLoopback.h"
 #include "common/libs/ptt.h"
 #include "common/settings.h"
 #include "common/list.h"
@@ -47,6 +48,7 @@
 #include <shellapi.h>
 #include "common/callsign2.h"
 #include "RS-defs.h" //added DM
+#include "common/ThreadSetup.h"
 
 extern void WFtext(int select);
 
@@ -169,13 +171,6 @@ int DMRSpsize = 0; //previous segment size
 int DMmodehash = 0; //a hash of the transmit parameters, to make mode changes generate unique objects by adding it to the transport ID - DM
 float DMSNRaverage = 0;
 float DMSNRmax = 0;
-int DMobjectnum = 0;
-int DMrxokarray[50]{ 0 };
-float DMSNRavarray[50]{ 0 };
-float DMSNRmaxarray[50]{ 0 };
-int unsigned DMgoodsegsarray[50]{ 0 };
-int unsigned DMtotalsegsarray[50]{ 0 };
-int unsigned DMpossegssarray[50]{ 0 };
 //int DMspeechmodecount = 0;  //not used yet...
 
 //moved from further down DM
@@ -241,6 +236,8 @@ char namebsrfile[300]; //edit DM - increased from 130 to 300 char
 string filetosend;
 
 float specbufarr[300];
+int specline = 0; //next line of the input STFT for the spectrum displays
+CVector<_REAL> speclinevec;
 
 char filetitle[32][260]; // = { " " }; //32 was 8, 320 was 80 DM - 320 changed to 260 now (Windows max path length is 255 characters)
 char pictfile[32][260]; // = { " " }; //32 was 8, 1200 was 300 DM - 1200 changed to 260 now (Windows max path length is 255 characters)
@@ -332,6 +329,11 @@ void sendinfo(HWND hwnd) {
 	}
 }
 
+// Only the normal receiver runs here, its messages go to the window
+thread_local int iRxChannel = 0;
+thread_local CMessageSink* pMessageSink = NULL;
+thread_local int iHeapCountPause = 0;
+
 //NEW Colour "LEDs" for state information DM Oct 20, 2021
 void PostWinMessage(unsigned int MessID, int iMessageParam)
 {
@@ -339,6 +341,13 @@ void PostWinMessage(unsigned int MessID, int iMessageParam)
 	//use the parameter to set the colour for the particular LED
 	//then update the LEDs last
 
+	/* Benchmark receivers count the messages, they have no LEDs */
+	if (pMessageSink != NULL)
+	{
+		pMessageSink->OnMessage(MessID, iMessageParam);
+		return;
+	}
+
 	if (MessID == MS_RESET_ALL)
 	{
 		int i = 1;
@@ -445,7 +454,7 @@ static void PaintWaveData ( HWND hDlg , BOOL erase )
 
 void RxFunction(  void *dummy  )
 {
-	SetThreadPriority(GetCurrentThread(), THREAD_PRIORITY_ABOVE_NORMAL);
+	CDSPThread DSPThread(DSP_THREAD_RX, L"EasyDRF RX");
 	try
 	{
 		DRMReceiver.Start();
@@ -460,7 +469,7 @@ void RxFunction(  void *dummy  )
 
 void TxFunction(  void *dummy  )
 {
-	SetThreadPriority(GetCurrentThread(), THREAD_PRIORITY_ABOVE_NORMAL);
+	CDSPThread DSPThread(DSP_THREAD_TX, L"EasyDRF TX");
 	try
 	{
 		DRMTransmitter.Start();
@@ -622,6 +631,14 @@ BOOL CALLBACK DialogProc (HWND hwnd, UINT message, WPARAM wParam, LPARAM lParam)
 
 	getvar(); //read settings.txt and set variables from it
 
+	//Select the audio backend for the modem signal and the capture latency
+	if (SoundBackend == SOUND_BACKEND_LOOPBACK)
+	{
+		DRMReceiver.SetSoundBackend(GetSoundLoopback());
+		DRMTransmitter.SetSoundBackend(GetSoundLoopback());
+	}
+	DRMReceiver.GetSoundInterface()->SetLatency(SoundLatencyMs);
+
 	//Restore previous window position
 	RECT rect;
 	if (GetWindowRect(hwnd, &rect)) {
@@ -831,6 +848,10 @@ BOOL CALLBACK DialogProc (HWND hwnd, UINT message, WPARAM wParam, LPARAM lParam)
 		}
 		else
 			_chdir("..");
+
+		// append-only log of the reception, exported to JS from the menu
+		ReceptionLog.Start(string(rxfilepath) + RXLOG_FILE_NAME);
+
 //		if (_chdir("Corrupt"))
 		if (_chdir(rxcorruptpath))
 		{
@@ -883,6 +904,7 @@ BOOL CALLBACK DialogProc (HWND hwnd, UINT message, WPARAM wParam, LPARAM lParam)
  		DRMReceiver.Stop(); 
 		DRMTransmitter.Stop();
 		Sleep(1000);
+		ReceptionLog.Stop();
 		PostQuitMessage(0);
 		return TRUE;
     case WM_PAINT:
@@ -1198,6 +1220,11 @@ void OnCommand ( HWND hwnd, int ctrlid, int code)
 			CheckMenuItem(GetMenu(hwnd), ID_SETTINGS_FILETRANSFER_SHOWONLYONE, MF_BYCOMMAND | MF_CHECKED);	
 		ShowOnlyFirst = !ShowOnlyFirst;
 		break;
+	case ID_SETTINGS_FILETRANSFER_EXPORTLOG:
+		// writes reception.js and the JS files of the series into the Rx Files folder
+		if (ReceptionLog.Export(ReceptionLog.GetFileName(), rxfilepath) == FALSE)
+			MessageBox(hwnd, "No reception log found", "ERROR", 0);
+		break;
 	case ID_SETTINGS_FILETRANSFER_SENDFILE:
 		DialogBox(TheInstance, MAKEINTRESOURCE (DLG_PICTURE_TX), hwnd, TXPictureDlgProc);
 		break;
@@ -1460,8 +1487,7 @@ int setdisplay(int type) {
 
 CVector<_REAL>		scopeData1(19200, (_REAL)0.0); //initialize this here
 //CVector<_REAL>		scopeData2(19200, (_REAL)0.0); //initialize this here
-CVector<_REAL>		vecrData;
-CVector<_REAL>		vecrScale;
+CDisplaySnapshot	DisplaySnap; /* latest display products of the receiver */
 BOOL firstnorx = TRUE;
 int isspdisp = 0;
 int stoptx = -1;	
@@ -1495,7 +1521,11 @@ void CALLBACK TimerProc(HWND hwnd, UINT nMsg, UINT nIDEvent, DWORD dwTime)
 		if (IsRX2 && RX_Running)
 		{
 			newdata++;
-			level = (int)(170.0 * DRMReceiver.GetReceiver()->GetLevelMeter());
+
+			/* Only a copy, the receive thread is never held up by the display */
+			DRMReceiver.GetDisplay(DisplaySnap);
+
+			level = (int)(170.0 * DisplaySnap.rLevel);
 			//NEW spectral AGC routine Daz Man 2021
 			//apply a sensible threshold to the level input
 #define THRESHOLD 20
@@ -1518,8 +1548,9 @@ void CALLBACK TimerProc(HWND hwnd, UINT nMsg, UINT nIDEvent, DWORD dwTime)
 			if (Display == 0)	//spectrum
 			{
 				DCFreq = (int)DRMReceiver.GetParameters()->GetDCFrequency();
-				DRMReceiver.GetReceiver()->GetInputSpec(vecrData);
-				if (vecrData.Size() >= 500)
+				//mean of the lines since the last tick
+				const CVector<_REAL>& vecrData = speclinevec;
+				if (DRMReceiver.GetStft().GetCombined(specline, speclinevec, STFT_DISPLAY_BINS, FALSE) == TRUE)
 				{
 					for (i = 0; i < 250; i++)
 						specbufarr[i] = (3.0 * specbufarr[i] + vecrData[2 * i] + vecrData[2 * i + 1]) * 0.2;
@@ -1532,8 +1563,9 @@ void CALLBACK TimerProc(HWND hwnd, UINT nMsg, UINT nIDEvent, DWORD dwTime)
 			}
 			if (Display == 3)	//waterfall
 			{
-				DRMReceiver.GetReceiver()->GetInputSpec(vecrData);
-				if (vecrData.Size() >= 500)
+				//peak of the lines since the last tick, so short signals are not missed
+				const CVector<_REAL>& vecrData = speclinevec;
+				if (DRMReceiver.GetStft().GetCombined(specline, speclinevec, STFT_DISPLAY_BINS, TRUE) == TRUE)
 				{
 					for (i = 0; i < 250; i++)
 						specarr[i] = 25.0 * vecrData[i] * specagc; //
@@ -1543,8 +1575,8 @@ void CALLBACK TimerProc(HWND hwnd, UINT nMsg, UINT nIDEvent, DWORD dwTime)
 			if (Display == 8)	//Moving Waterfall
 			{
 				DCFreq = (int)DRMReceiver.GetParameters()->GetDCFrequency();
-				DRMReceiver.GetReceiver()->GetInputSpec(vecrData);
-				if (vecrData.Size() >= 500)
+				const CVector<_REAL>& vecrData = speclinevec;
+				if (DRMReceiver.GetStft().GetCombined(specline, speclinevec, STFT_DISPLAY_BINS, TRUE) == TRUE)
 				{
 					for (i = 0; i < 500; i++)
 						specarr[i] = 40.0 * vecrData[i] * specagc; //
@@ -1625,7 +1657,7 @@ void CALLBACK TimerProc(HWND hwnd, UINT nMsg, UINT nIDEvent, DWORD dwTime)
 			if (Display == 1)	//shifted PSD
 			{
 				int tmp = 0;
-				DRMReceiver.GetOFDMDemod()->GetPowDenSpec(vecrData);
+				const CVector<_REAL>& vecrData = DisplaySnap.vecrPSD;
 				if (vecrData.Size() >= 256)  // size = 512
 					for (i = 0; i < 250; i++)
 					{
@@ -1637,7 +1669,8 @@ void CALLBACK TimerProc(HWND hwnd, UINT nMsg, UINT nIDEvent, DWORD dwTime)
 			if (Display == 4)	//Transfer Funct.
 			{
 				int tmp = 0;
-				DRMReceiver.GetChanEst()->GetTransferFunction(vecrData, vecrScale);
+				const CVector<_REAL>& vecrData = DisplaySnap.vecrTransFct;
+				const CVector<_REAL>& vecrScale = DisplaySnap.vecrGroupDelay;
 				specarrlen = min((int)vecrData.Size(), 530);
 				for (i = 0; i < specarrlen; i++)
 				{
@@ -1650,10 +1683,7 @@ void CALLBACK TimerProc(HWND hwnd, UINT nMsg, UINT nIDEvent, DWORD dwTime)
 			if (Display == 5)	//Impulse Response
 			{
 				int tmp = 0;
-				_REAL				rLowerBound, rHigherBound;
-				_REAL				rStartGuard, rEndGuard;
-				_REAL				rPDSBegin, rPDSEnd;
-				DRMReceiver.GetChanEst()->GetAvPoDeSp(vecrData, vecrScale, rLowerBound, rHigherBound, rStartGuard, rEndGuard, rPDSBegin, rPDSEnd);
+				const CVector<_REAL>& vecrData = DisplaySnap.vecrImpResp;
 				specarrlen = vecrData.Size(); //this is quite short
 				for (i = 0; i < specarrlen; i++)
 				{
@@ -1664,8 +1694,7 @@ void CALLBACK TimerProc(HWND hwnd, UINT nMsg, UINT nIDEvent, DWORD dwTime)
 			if (Display == 6)	//FAC constellation
 			{
 				int tmp = 0;
-				CVector<_COMPLEX>	veccData;
-				DRMReceiver.GetFACMLC()->GetVectorSpace(veccData);
+				const CVector<_COMPLEX>& veccData = DisplaySnap.veccFACVectorSpace;
 				specarrlen = veccData.Size();
 				for (i = 0; i < specarrlen; i++)
 				{
@@ -1678,8 +1707,7 @@ void CALLBACK TimerProc(HWND hwnd, UINT nMsg, UINT nIDEvent, DWORD dwTime)
 			if (Display == 7)	//MSC constellation
 			{
 				int tmp = 0;
-				CVector<_COMPLEX>	veccData;
-				DRMReceiver.GetMSCMLC()->GetVectorSpace(veccData);
+				const CVector<_COMPLEX>& veccData = DisplaySnap.veccMSCVectorSpace;
 				specarrlen = veccData.Size();
 				if (specarrlen >= 530) specarrlen = 530;
 				for (i = 0; i < specarrlen; i++)
@@ -2108,7 +2136,7 @@ void CALLBACK TimerProc(HWND hwnd, UINT nMsg, UINT nIDEvent, DWORD dwTime)
 									//cut extension off filename
 									filename[strlen(filename) - 3] = 0; //terminate the string early to cut off the extra .gz extension DM
 
-									LogData(filename); //log the SNR stats DM
+									ReceptionLog.AddFile(NewPic.iTransportID, TRUE, filename); //log the SNR stats DM
 
 									char savename[260] = "";
 									wsprintf(savename, "Rx Files\\%s", filename);
@@ -2164,7 +2192,7 @@ void CALLBACK TimerProc(HWND hwnd, UINT nMsg, UINT nIDEvent, DWORD dwTime)
 										//cut extension off filename
 										filename[strlen(filename) - 3] = 0; //terminate the string early to cut off the extra .lz extension DM
 
-										LogData(filename, 1); //log the SNR stats DM
+										ReceptionLog.AddFile(NewPic.iTransportID, TRUE, filename); //log the SNR stats DM
 
 										char savename[260] = "";
 										wsprintf(savename, "Rx Files\\%s", filename);
@@ -2190,7 +2218,7 @@ void CALLBACK TimerProc(HWND hwnd, UINT nMsg, UINT nIDEvent, DWORD dwTime)
 									else {
 										//data is not compressed, save normally - no need for extra buffers
 										//Also - if incoming file is bigger than 512k (!) don't decompress it because it will overflow the buffers (can only happen if a *.lz file is sent (?), so save it normally)
-										LogData(filename, 1); //log the SNR stats DM
+										ReceptionLog.AddFile(NewPic.iTransportID, TRUE, filename); //log the SNR stats DM
 
 										char savename[260] = "";
 										wsprintf(savename, "Rx Files\\%s", filename);
@@ -3051,6 +3079,7 @@ BOOL CALLBACK TXPictureDlgProc
 		SendMessage(GetDlgItem(hwnd, IDC_RS4), BM_SETCHECK, (WPARAM)(ECCmode == 7), 0);
 		SendMessage(GetDlgItem(hwnd, IDC_LEADINLONG), BM_SETCHECK, (WPARAM)longleadin, 0);
 		SendMessage(GetDlgItem(hwnd, IDC_ADDALLFILES), BM_SETCHECK, (WPARAM)autoaddfiles, 0);
+		prepfiles(); //prepare the files in the list in the background
 		return TRUE;
 		break;
     case WM_COMMAND:
@@ -3177,6 +3206,7 @@ BOOL CALLBACK TXPictureDlgProc
 				putfiles(hwnd); //add filenames to window
 			}  //end Autoadd files
 
+			prepfiles(); //prepare the new files in the background while the dialog is open
 				return TRUE;
 		case ID_DELALLFILES:
 			TXpicpospt = 0;
@@ -3206,6 +3236,7 @@ BOOL CALLBACK TXPictureDlgProc
 			SendMessage(GetDlgItem(hwnd, IDC_RS2), BM_SETCHECK, (WPARAM)0, 0);
 			SendMessage(GetDlgItem(hwnd, IDC_RS3), BM_SETCHECK, (WPARAM)0, 0);
 			SendMessage(GetDlgItem(hwnd, IDC_RS4), BM_SETCHECK, (WPARAM)0, 0);
+			prepfiles(); //the objects depend on the ECC mode
 			return TRUE;
 		case IDC_SENDTWICE:
 			ECCmode = 2;
@@ -3216,6 +3247,7 @@ BOOL CALLBACK TXPictureDlgProc
 			SendMessage(GetDlgItem(hwnd, IDC_RS2), BM_SETCHECK, (WPARAM)0, 0);
 			SendMessage(GetDlgItem(hwnd, IDC_RS3), BM_SETCHECK, (WPARAM)0, 0);
 			SendMessage(GetDlgItem(hwnd, IDC_RS4), BM_SETCHECK, (WPARAM)0, 0);
+			prepfiles(); //the objects depend on the ECC mode
 			return TRUE;
 		case IDC_SENDTHREE:
 			ECCmode = 3;
@@ -3226,6 +3258,7 @@ BOOL CALLBACK TXPictureDlgProc
 			SendMessage(GetDlgItem(hwnd, IDC_RS2), BM_SETCHECK, (WPARAM)0, 0);
 			SendMessage(GetDlgItem(hwnd, IDC_RS3), BM_SETCHECK, (WPARAM)0, 0);
 			SendMessage(GetDlgItem(hwnd, IDC_RS4), BM_SETCHECK, (WPARAM)0, 0);
+			prepfiles(); //the objects depend on the ECC mode
 			return TRUE;
 		case IDC_RS1:
 			ECCmode = 4;
@@ -3236,6 +3269,7 @@ BOOL CALLBACK TXPictureDlgProc
 			SendMessage(GetDlgItem(hwnd, IDC_RS2), BM_SETCHECK, (WPARAM)0, 0);
 			SendMessage(GetDlgItem(hwnd, IDC_RS3), BM_SETCHECK, (WPARAM)0, 0);
 			SendMessage(GetDlgItem(hwnd, IDC_RS4), BM_SETCHECK, (WPARAM)0, 0);
+			prepfiles(); //the objects depend on the ECC mode
 			return TRUE;
 		case IDC_RS2:
 			ECCmode = 5;
@@ -3246,6 +3280,7 @@ BOOL CALLBACK TXPictureDlgProc
 			SendMessage(GetDlgItem(hwnd, IDC_RS2), BM_SETCHECK, (WPARAM)1, 0);
 			SendMessage(GetDlgItem(hwnd, IDC_RS3), BM_SETCHECK, (WPARAM)0, 0);
 			SendMessage(GetDlgItem(hwnd, IDC_RS4), BM_SETCHECK, (WPARAM)0, 0);
+			prepfiles(); //the objects depend on the ECC mode
 			return TRUE;
 		case IDC_RS3:
 			ECCmode = 6;
@@ -3256,6 +3291,7 @@ BOOL CALLBACK TXPictureDlgProc
 			SendMessage(GetDlgItem(hwnd, IDC_RS2), BM_SETCHECK, (WPARAM)0, 0);
 			SendMessage(GetDlgItem(hwnd, IDC_RS3), BM_SETCHECK, (WPARAM)1, 0);
 			SendMessage(GetDlgItem(hwnd, IDC_RS4), BM_SETCHECK, (WPARAM)0, 0);
+			prepfiles(); //the objects depend on the ECC mode
 			return TRUE;
 		case IDC_RS4:
 			ECCmode = 7;
@@ -3266,6 +3302,7 @@ BOOL CALLBACK TXPictureDlgProc
 			SendMessage(GetDlgItem(hwnd, IDC_RS2), BM_SETCHECK, (WPARAM)0, 0);
 			SendMessage(GetDlgItem(hwnd, IDC_RS3), BM_SETCHECK, (WPARAM)0, 0);
 			SendMessage(GetDlgItem(hwnd, IDC_RS4), BM_SETCHECK, (WPARAM)1, 0);
+			prepfiles(); //the objects depend on the ECC mode
 			return TRUE;
 		case IDC_LEADINLONG:
 			if (longleadin)
@@ -307,10 +307,6 @@ SOURCE=.\common\mlc\TrellisUpdateMMX.cpp
 # End Source File
 # Begin Source File
 
-SOURCE=.\common\mlc\TrellisUpdateSSE2.cpp
-# End Source File
-# Begin Source File
-
 SOURCE=.\common\mlc\ViterbiDecoder.cpp
 # End Source File
 # Begin Source File
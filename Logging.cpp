@@ -5,7 +5,15 @@
  *	Daz Man
  *
  * Description:
- *	Logging.cpp - Logging of stats to a Javascript file
+ *	Logging.cpp - Reception log
+ *
+ *	Every received data group, every saved file and every failed RS decoding
+ *	is appended as one line to a CSV file (SNR, CRC, segment counts, RS
+ *	errors, time, callsign, transport ID, file name). The decoder only puts
+ *	the record into a lock-free ring, a thread of its own writes the lines
+ *	once per second, so logging costs the same no matter how long the log
+ *	is. The JS files for the web page are made from the log on demand by
+ *	Export()
  *
  ******************************************************************************
  *
@@ -26,166 +34,392 @@
 \******************************************************************************/
 
 #include "logging.h"
-//#include <string.h>
 #include <Windows.h>
-#include <xutility>
 #include <cstdio>
+#include <string.h>
+#include <chrono>
+#include <map>
+#include <vector>
+#include "RS-defs.h"
+
+CReceptionLog ReceptionLog;
+
+/* The same slots as the old per-series JS files: SWRG-nnn-nn.ext uses the
+   number nn (up to 20), RNEIxx.ext and RCARxx.ext have one slot */
+#define RXLOG_SERIES_SLOTS	30
+
+class CRxObject
+{
+public:
+	CRxObject() : iTransportID(0), bOK(FALSE), rSNRav(0), rSNRmax(0), iTotSegs(0),
+		iGoodSegs(0), iActPos(0), iNumSeg(0), iNumCRCErr(0), iNumRSFailed(0),
+		llFirst(0), llLast(0) {}
+
+	int				iTransportID;
+	std::string		strName;
+	std::string		strCall;
+	_BOOLEAN		bOK;
+	float			rSNRav, rSNRmax;
+	unsigned int	iTotSegs, iGoodSegs, iActPos;
+	int				iNumSeg, iNumCRCErr, iNumRSFailed;
+	long long		llFirst, llLast;
+};
+
+class CSeriesSlot
+{
+public:
+	CSeriesSlot() : bOK(FALSE), rSNRav(0), rSNRmax(0), iTotSegs(0), iGoodSegs(0), iActPos(0) {}
+
+	_BOOLEAN		bOK;
+	float			rSNRav, rSNRmax;
+	unsigned int	iTotSegs, iGoodSegs, iActPos;
+};
+
+class CSeries
+{
+public:
+	CSeries() : iMaxSlot(0) {}
+
+	CSeriesSlot		Slot[RXLOG_SERIES_SLOTS];
+	int				iMaxSlot;
+};
 
-//make a function that builds an array of data for the incoming files
-//save the array data to a JS file
-//the JS file can be loaded into a web page for display
-
-char prevfilename[260] = "";
-
-void LogData(char* fn, bool saved) {
-	//fn: filename
-	//saved: TRUE = record that file was saved, FALSE = do nothing
-	//filenumber is derived from the filename
-	//update the stats as the data comes in
-	//save the data as each file saves
-	// 
-	//save the stats in an array first, then dump the array out to a file
-	//compute stats in browser - just save the raw data here
-	//use a Javascript object to hold the data
-	//add an object for each file number
-
-	//save avSNR once, smoothed over time by the decoder
-	//SNRav = SNRaverage
-	//SNRmax = SNRmaximum
-	//ts = totalsegments
-	//gs = goodsegments
-	//ps = active position
-
-	//format is SWRG-nnn-nn.ext or SWRGtest-nnn-nn.ext or RNEInn-sssss.ext or RNEInn.ext
-	int mode = 0; //mode 0 = none, 1 = SWRG, 2 = RNEI or RCAR
-#define SWRG 1
-#define RNEI 2
-	int n = 0;
+static void CopyName(char* pchOut, const int iSize, const char* pchIn)
+{
+	/* The fields of the CSV and the JS strings must not be broken up */
 	int i = 0;
-	int j = 0;
-	//check if it's SWRG
-	char filenumber[260]; //array for both filename and filenumber computations
-	strcpy(filenumber, fn);
-	if (strlen(filenumber) >= 4) {
-		filenumber[4] = 0; //cut short
-		//n = strcmp(filenumber, "SWRG"); //Match first four letters only
-		//n should = 0
-		//if (n == 0) {
-		//SWRG or RNEI detection
-		if (strcmp(filenumber, "SWRG") == 0) { mode = SWRG; } //SWRG mode
-		else if (strcmp(filenumber, "RNEI") == 0) { mode = RNEI; } //RNEI mode
-		else if (strcmp(filenumber, "RCAR") == 0) { mode = RNEI; } //RNEI mode
-
-		if (mode > 0) {
-			//filename must be SWRG*.* or RNEI*.*
-			//compute object number from filename - use consistent naming to make this easy
-			strcpy(filenumber, fn); //get entire filename again
-			//This also needs to work on the longer SWRGtest name, and any other name starting with SWRG or RNEI...
-
-			//in case the .lz is on the filename...
-			if (stricmp(&filenumber[strlen(filenumber) - 3], ".lz") == 0) {
-				filenumber[strlen(filenumber) - 3] = 0; //terminate the string early to cut off the extra .lz extension
-			}
+	if (pchIn != NULL)
+	{
+		for (; (i < iSize - 1) && (pchIn[i] != 0); i++)
+		{
+			const char c = pchIn[i];
+			pchOut[i] = ((c < ' ') || (c == ',') || (c == '"') || (c == '\\')) ? '_' : c;
+		}
+	}
 
-			i = strlen(filenumber); //point to last char
+	/* Empty fields would stop sscanf() */
+	if (i == 0)
+		pchOut[i++] = '-';
 
-			if (mode == SWRG) {
-				//find the first "-", backwards
-				while ((n != '-') && (i > 0)) {
-					n = filenumber[i]; //read a char
-					i--;
-				}
-				i++;
-			}
+	pchOut[i] = 0;
+}
 
-			else if (mode == RNEI) {
-				//find the first ".", backwards
-				while ((n != '.') && (i > 0)) {
-					n = filenumber[i]; //read a char
-					i--;
-				}
-				i++;
-			}
-			else n = 0; //failed to find the character
-
-			//now i points to the "-" (SWRG) or the "." (RNEI)
-			if (n > 0) {
-				//save filenumber
-				//SWRG-nnn-nn.ext
-				if (mode == SWRG) {
-					i++; //next char
-					n = min(max(filenumber[i] - 48, 0), 9) * 10; //compute tens
-					i++; //next char
-					n = n + min(max(filenumber[i] - 48, 0), 9); //compute units and add
-					DMobjectnum = n; //save
-				}
-				if (mode == RNEI) { DMobjectnum = 0; } //just one file for RNEI
-
-				//Range check - DMobjectnum must be between 0 and 29
-				if ((DMobjectnum >= 0) && (DMobjectnum < 30)) {
-
-					DMSNRavarray[DMobjectnum] = DMSNRaverage;
-					DMSNRmaxarray[DMobjectnum] = DMSNRmax;
-
-					if (saved == TRUE) {
-						DMrxokarray[DMobjectnum] = 1; //record that this file DID save OK
-					}
-
-					DMtotalsegsarray[DMobjectnum] = totsize;
-					DMpossegssarray[DMobjectnum] = actpos;
-
-					if (stricmp(filenumber, prevfilename) == 0){
-						//allow actsize to increase, but not decrease - because at the end of file it resets
-						DMgoodsegsarray[DMobjectnum] = max(actsize, DMgoodsegsarray[DMobjectnum]);
-					}
-					else {
-						DMgoodsegsarray[DMobjectnum] = actsize;  //if the base filename changed, just set it directly
-						strcpy(prevfilename, filenumber); //update
-					}
-					
-					if (mode == SWRG) { i -= 2; } //point to the '-' for SWRG
-					//RNEI points to the "." already
-
-					//update log file now
-					//write all objects to file and update each time
-					//save the data to a matching filename, but with a .js extension
-					filenumber[i] = '.'; //overwrite - with . 
-					i++; //next char
-					filenumber[i] = 'j'; //add js extension
-					i++; //next char
-					filenumber[i] = 's';
-					i++; //next char
-					filenumber[i] = 0; //terminate filename
-
-					//log file is opened here for writing
-					char logfile[260];
-					//add path
-					wsprintf(logfile, "Rx Files\\%s", filenumber);
-
-					FILE* set = nullptr;
-					if ((set = fopen(logfile, "wb")) == nullptr) {
-					// handle error here DM
-					}
-					else {
-						int err = 0;
-
-						//do this a set number of times so no data is lost if something repeats
-						int max = 0; //default to one file for RNEI
-						if (mode == SWRG) { max = 20; } //for SWRG save 20 entries to allow for many image files
-
-						for (i = 0; i <= max; i++) {
-							//reuse the filenumber array to hold data
-							err = sprintf_s(filenumber, "data%02d={ok:%d,SNRav:%2.1f,SNRmax:%2.1f,ts:%d,gs:%d,ps:%d};\r\n", i, DMrxokarray[i], DMSNRavarray[i], DMSNRmaxarray[i], DMtotalsegsarray[i], DMgoodsegsarray[i], DMpossegssarray[i]);
-							//write each char of filenumber array temp to file
-							for (j = 0; j < strlen(filenumber); j++) {
-								putc(filenumber[j], set);
-							}
-						}
-						fclose(set); //file is closed here - but only if it was opened
-					}
-				}
+static _BOOLEAN ParseSeries(const std::string& strName, std::string& strBase, int& iSlot, int& iMaxSlot)
+{
+	std::string strFile = strName;
+
+	/* In case the .lz is on the filename */
+	if ((strFile.size() >= 3) && (stricmp(&strFile.c_str()[strFile.size() - 3], ".lz") == 0))
+		strFile.erase(strFile.size() - 3);
+
+	if (strFile.size() < 4)
+		return FALSE;
+
+	const std::string strPrefix = strFile.substr(0, 4);
+	size_t iPos;
+
+	if (strPrefix == "SWRG")
+	{
+		/* SWRG-nnn-nn.ext */
+		iPos = strFile.rfind('-');
+		if ((iPos == std::string::npos) || (iPos + 2 >= strFile.size()))
+			return FALSE;
+
+		iSlot = min(max(strFile[iPos + 1] - '0', 0), 9) * 10 + min(max(strFile[iPos + 2] - '0', 0), 9);
+		iMaxSlot = 20;
+	}
+	else if ((strPrefix == "RNEI") || (strPrefix == "RCAR"))
+	{
+		iPos = strFile.rfind('.');
+		if (iPos == std::string::npos)
+			return FALSE;
+
+		iSlot = 0;
+		iMaxSlot = 0;
+	}
+	else
+		return FALSE;
+
+	if (iSlot >= RXLOG_SERIES_SLOTS)
+		return FALSE;
+
+	strBase = strFile.substr(0, iPos);
+	return TRUE;
+}
+
+void CReceptionLog::Start(const std::string& strNewFileName)
+{
+	Stop();
+
+	strFileName = strNewFileName;
+	bRun = TRUE;
+
+	WriteThread = std::thread(&CReceptionLog::Run, this);
+}
+
+void CReceptionLog::Stop()
+{
+	{
+		std::lock_guard<std::mutex> Lock(RunMutex);
+		bRun = FALSE;
+	}
+
+	RunCond.notify_all();
+
+	if (WriteThread.joinable())
+		WriteThread.join();
+}
+
+void CReceptionLog::AddSegment(const int iTransportID, const int iSegNum,
+	const _BOOLEAN bCRCOk, const char* pchName, const std::string& strCall)
+{
+	if (bRun.load(std::memory_order_relaxed) == FALSE)
+		return;
+
+	CLogRecord Record;
+	Record.cType = RXLOG_SEGMENT;
+	Record.iTransportID = iTransportID;
+	Record.iSegNum = iSegNum;
+	Record.bCRCOk = bCRCOk;
+	CopyName(Record.chCall, sizeof(Record.chCall), strCall.c_str());
+
+	Add(Record, pchName);
+}
+
+void CReceptionLog::AddFile(const int iTransportID, const _BOOLEAN bSaved, const char* pchName)
+{
+	if (bRun.load(std::memory_order_relaxed) == FALSE)
+		return;
+
+	/* The callsign is taken from the segments of the object by Export() */
+	CLogRecord Record;
+	Record.cType = (bSaved == TRUE) ? RXLOG_FILE_SAVED : RXLOG_RS_FAILED;
+	Record.iTransportID = iTransportID;
+	Record.iSegNum = -1;
+	Record.bCRCOk = bSaved;
+	CopyName(Record.chCall, sizeof(Record.chCall), NULL);
+
+	Add(Record, pchName);
+}
+
+void CReceptionLog::Add(CLogRecord& Record, const char* pchName)
+{
+	Record.llTime = std::chrono::duration_cast<std::chrono::milliseconds>(
+		std::chrono::system_clock::now().time_since_epoch()).count();
+	Record.iChannel = iRxChannel;
+
+	/* The statistics of the decoder are globals, a value which is changed at
+	   the same time only makes this line a bit old */
+	Record.rSNRav = DMSNRaverage;
+	Record.rSNRmax = DMSNRmax;
+	Record.iTotSegs = totsize;
+	Record.iGoodSegs = actsize;
+	Record.iActPos = actpos;
+	Record.iRSLevel = RxRSlevel;
+	Record.iRSErrors = lasterror;
+	Record.iRSAttempts = RScount;
+	CopyName(Record.chName, sizeof(Record.chName), pchName);
+
+	if (Ring.Push(Record) == FALSE)
+		iNumLost.fetch_add(1, std::memory_order_relaxed);
+}
+
+void CReceptionLog::Run()
+{
+	FILE* pFile = NULL;
+	std::unique_lock<std::mutex> Lock(RunMutex);
+
+	for (;;)
+	{
+		RunCond.wait_for(Lock, std::chrono::milliseconds(RXLOG_FLUSH_MS));
+
+		/* The file is opened again if it could not be opened before */
+		if (pFile == NULL)
+		{
+			pFile = fopen(strFileName.c_str(), "at");
+
+			if ((pFile != NULL) && (fseek(pFile, 0, SEEK_END) == 0) && (ftell(pFile) == 0))
+			{
+				fprintf(pFile, "time_ms,type,channel,transport_id,segment,crc,snr_av,snr_max,"
+					"tot_segs,good_segs,pos,rs_level,rs_errors,rs_attempts,callsign,name\n");
 			}
 		}
+
+		/* Also empties the ring if there is no file */
+		WriteAll(pFile);
+
+		if (pFile != NULL)
+			fflush(pFile);
+
+		if (bRun == FALSE)
+			break;
 	}
-};
-	
\ No newline at end of file
+
+	if (pFile != NULL)
+		fclose(pFile);
+}
+
+void CReceptionLog::WriteAll(FILE* pFile)
+{
+	CLogRecord Record;
+
+	while (Ring.Pop(Record) == TRUE)
+	{
+		if (pFile == NULL)
+			continue;
+
+		fprintf(pFile, "%lld,%c,%d,%d,%d,%d,%.1f,%.1f,%u,%u,%u,%d,%d,%u,%s,%s\n",
+			Record.llTime, Record.cType, Record.iChannel, Record.iTransportID,
+			Record.iSegNum, Record.bCRCOk, Record.rSNRav, Record.rSNRmax,
+			Record.iTotSegs, Record.iGoodSegs, Record.iActPos, Record.iRSLevel,
+			Record.iRSErrors, Record.iRSAttempts, Record.chCall, Record.chName);
+	}
+}
+
+_BOOLEAN CReceptionLog::Export(const std::string& strLogFile, const std::string& strOutDir)
+{
+	FILE* pFile = fopen(strLogFile.c_str(), "rt");
+	if (pFile == NULL)
+		return FALSE;
+
+	/* One entry per transport ID in the order of the first reception */
+	std::vector<CRxObject> vecObject;
+	std::map<int, size_t> ObjectIndex;
+
+	char chLine[512];
+	CLogRecord Record;
+	int iCRCOk;
+
+	while (fgets(chLine, sizeof(chLine), pFile) != NULL)
+	{
+		/* The header and a line which is just being written do not match */
+		if (sscanf(chLine, "%lld,%c,%d,%d,%d,%d,%f,%f,%u,%u,%u,%d,%d,%u,%15[^,],%63[^\r\n]",
+			&Record.llTime, &Record.cType, &Record.iChannel, &Record.iTransportID,
+			&Record.iSegNum, &iCRCOk, &Record.rSNRav, &Record.rSNRmax,
+			&Record.iTotSegs, &Record.iGoodSegs, &Record.iActPos, &Record.iRSLevel,
+			&Record.iRSErrors, &Record.iRSAttempts, Record.chCall, Record.chName) != 16)
+		{
+			continue;
+		}
+
+		std::map<int, size_t>::iterator it = ObjectIndex.find(Record.iTransportID);
+		if (it == ObjectIndex.end())
+		{
+			it = ObjectIndex.insert(std::make_pair(Record.iTransportID, vecObject.size())).first;
+			vecObject.push_back(CRxObject());
+			vecObject.back().iTransportID = Record.iTransportID;
+			vecObject.back().llFirst = Record.llTime;
+		}
+
+		CRxObject& Object = vecObject[it->second];
+		const std::string strName = Record.chName;
+		const _BOOLEAN bNamed = (strName != "-") && (strName != "unknown");
+
+		Object.llLast = Record.llTime;
+
+		if (Record.cType == RXLOG_SEGMENT)
+		{
+			Object.iNumSeg++;
+			if (iCRCOk == 0)
+				Object.iNumCRCErr++;
+
+			if (strcmp(Record.chCall, "-") != 0)
+				Object.strCall = Record.chCall;
+
+			/* The name of the saved file is the better one */
+			if (bNamed && ((Object.bOK == FALSE) || Object.strName.empty()))
+				Object.strName = strName;
+
+			Object.rSNRav = Record.rSNRav;
+			Object.rSNRmax = max(Object.rSNRmax, Record.rSNRmax);
+			if (Record.iTotSegs > 0)
+				Object.iTotSegs = Record.iTotSegs;
+
+			/* The count is reset at the end of the file, it must not go back */
+			Object.iGoodSegs = max(Object.iGoodSegs, Record.iGoodSegs);
+			Object.iActPos = Record.iActPos;
+		}
+		else if (Record.cType == RXLOG_FILE_SAVED)
+		{
+			Object.bOK = TRUE;
+			if (bNamed)
+				Object.strName = strName;
+		}
+		else if (Record.cType == RXLOG_RS_FAILED)
+		{
+			Object.iNumRSFailed++;
+			if (bNamed && Object.strName.empty())
+				Object.strName = strName;
+		}
+	}
+
+	fclose(pFile);
+
+	/* All objects ---------------------------------------------------------- */
+	const std::string strJSFile = strOutDir + RXLOG_JS_NAME;
+	pFile = fopen(strJSFile.c_str(), "wt");
+	if (pFile == NULL)
+		return FALSE;
+
+	fprintf(pFile, "// Reception log, made from %s\nrxlog=[\n", RXLOG_FILE_NAME);
+
+	for (size_t i = 0; i < vecObject.size(); i++)
+	{
+		const CRxObject& Object = vecObject[i];
+
+		fprintf(pFile, "{tid:%d,name:\"%s\",call:\"%s\",ok:%d,SNRav:%2.1f,SNRmax:%2.1f,"
+			"ts:%u,gs:%u,ps:%u,segs:%d,crcerr:%d,rsfail:%d,first:%lld,last:%lld},\n",
+			Object.iTransportID, Object.strName.c_str(), Object.strCall.c_str(),
+			Object.bOK, Object.rSNRav, Object.rSNRmax, Object.iTotSegs,
+			Object.iGoodSegs, Object.iActPos, Object.iNumSeg, Object.iNumCRCErr,
+			Object.iNumRSFailed, Object.llFirst, Object.llLast);
+	}
+
+	fprintf(pFile, "];\n");
+	fclose(pFile);
+
+	/* Files of the old format, one per series ------------------------------ */
+	std::map<std::string, CSeries> SeriesMap;
+
+	for (size_t i = 0; i < vecObject.size(); i++)
+	{
+		const CRxObject& Object = vecObject[i];
+		std::string strBase;
+		int iSlot, iMaxSlot;
+
+		if (ParseSeries(Object.strName, strBase, iSlot, iMaxSlot) == FALSE)
+			continue;
+
+		CSeries& Series = SeriesMap[strBase];
+		CSeriesSlot& Slot = Series.Slot[iSlot];
+
+		Series.iMaxSlot = iMaxSlot;
+		if (Object.bOK == TRUE)
+			Slot.bOK = TRUE;
+		Slot.rSNRav = Object.rSNRav;
+		Slot.rSNRmax = Object.rSNRmax;
+		Slot.iTotSegs = Object.iTotSegs;
+		Slot.iGoodSegs = Object.iGoodSegs;
+		Slot.iActPos = Object.iActPos;
+	}
+
+	for (std::map<std::string, CSeries>::iterator it = SeriesMap.begin(); it != SeriesMap.end(); it++)
+	{
+		const std::string strSeriesFile = strOutDir + it->first + ".js";
+		pFile = fopen(strSeriesFile.c_str(), "wb");
+		if (pFile == NULL)
+			continue;
+
+		for (int i = 0; i <= it->second.iMaxSlot; i++)
+		{
+			const CSeriesSlot& Slot = it->second.Slot[i];
+
+			fprintf(pFile, "data%02d={ok:%d,SNRav:%2.1f,SNRmax:%2.1f,ts:%d,gs:%d,ps:%d};\r\n",
+				i, Slot.bOK, Slot.rSNRav, Slot.rSNRmax, Slot.iTotSegs, Slot.iGoodSegs, Slot.iActPos);
+		}
+
+		fclose(pFile);
+	}
+
+	return TRUE;
+}
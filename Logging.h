@@ -1,15 +1,80 @@
 #pragma once
-void LogData(char*,bool);
+#include <string>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include "common/GlobalDefinitions.h"
+#include "common/LockFreeRing.h"
+
+/* Reception log, see Logging.cpp */
+#define RXLOG_FILE_NAME		"reception.csv"
+#define RXLOG_JS_NAME		"reception.js"
+#define RXLOG_RING_SIZE		2048	/* records (power of 2) */
+#define RXLOG_FLUSH_MS		1000	/* the writer thread wakes up this often */
+
+#define RXLOG_SEGMENT		'S'		/* a data group was received */
+#define RXLOG_FILE_SAVED	'F'		/* a file was saved */
+#define RXLOG_RS_FAILED		'E'		/* RS decoding of a file failed */
+
+class CLogRecord
+{
+public:
+	long long		llTime; /* ms since 1970 */
+	char			cType;
+	int				iChannel;
+	int				iTransportID;
+	int				iSegNum;
+	_BOOLEAN		bCRCOk;
+	float			rSNRav, rSNRmax;
+	unsigned int	iTotSegs, iGoodSegs, iActPos;
+	int				iRSLevel;
+	int				iRSErrors; /* bits of lasterror, 0: ok */
+	unsigned int	iRSAttempts;
+	char			chCall[16];
+	char			chName[64];
+};
+
+/* Producers never wait, the records are written by a thread of its own */
+class CReceptionLog
+{
+public:
+	CReceptionLog() : iNumLost(0), bRun(FALSE) {}
+	virtual ~CReceptionLog() {Stop();}
+
+	void		Start(const std::string& strNewFileName);
+	void		Stop();
+
+	void		AddSegment(const int iTransportID, const int iSegNum,
+					const _BOOLEAN bCRCOk, const char* pchName, const std::string& strCall);
+	void		AddFile(const int iTransportID, const _BOOLEAN bSaved, const char* pchName);
+
+	/* Reads the whole log and writes the JS files for the web page, the
+	   decoder is not involved */
+	static _BOOLEAN Export(const std::string& strLogFile, const std::string& strOutDir);
+
+	const std::string& GetFileName() {return strFileName;}
+	int			GetNumLost() {return iNumLost.load(std::memory_order_relaxed);}
+
+protected:
+	void		Add(CLogRecord& Record, const char* pchName);
+	void		Run();
+	void		WriteAll(FILE* pFile);
+
+	CLockFreeRing<CLogRecord, RXLOG_RING_SIZE>	Ring;
+	std::atomic<int>		iNumLost;
+
+	std::string				strFileName;
+	std::thread				WriteThread;
+	std::mutex				RunMutex;
+	std::condition_variable	RunCond;
+	std::atomic<_BOOLEAN>	bRun;
+};
+
+extern CReceptionLog ReceptionLog;
+
 extern char DMfilename[260];
 extern float DMSNRaverage;
 extern float DMSNRmax;
-extern int DMobjectnum;
-extern int DMrxokarray[50];
-extern float DMSNRavarray[50];
-extern float DMSNRmaxarray[50];
-extern unsigned int DMgoodsegsarray[50];
-extern unsigned int DMtotalsegsarray[50];
-extern unsigned int DMpossegssarray[50];
 extern unsigned int actsize; //Decoder active segment count global
 extern unsigned int totsize; //Decoder total segment count global
 extern unsigned int actpos; //Decoder actual position global
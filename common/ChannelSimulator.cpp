@@ -0,0 +1,338 @@
+/******************************************************************************\
+ * Copyright (c) 2024
+ *
+ * Author(s):
+ *	EasyDRF developers
+ *
+ * Description:
+ *	Channel simulator for the loopback benchmark
+ *
+ *	The real audio signal is made analytic with a Hilbert filter, so that
+ *	the complex path gains of the Watterson model and the frequency offset
+ *	act on the signal like on the HF channel. The real part is resampled for
+ *	the sample clock offset and white Gaussian noise is added. The noise
+ *	power is set from the average input power, so the SNR is the same for
+ *	all transmit levels
+ *
+ ******************************************************************************
+ *
+ * This program is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation; either version 2 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ *
+\******************************************************************************/
+
+#include "ChannelSimulator.h"
+
+
+/* Implementation *************************************************************/
+const char* CChannelSimulator::GetProfileName(const EChanProfile eProfile)
+{
+	switch (eProfile)
+	{
+	case CP_CCIR_GOOD:
+		return "CCIR good";
+
+	case CP_CCIR_MODERATE:
+		return "CCIR moderate";
+
+	case CP_CCIR_POOR:
+		return "CCIR poor";
+
+	case CP_FLUTTER:
+		return "Flutter";
+
+	default:
+		return "AWGN";
+	}
+}
+
+void CChannelSimulator::Init(const EChanProfile eNewProfile, const _REAL rNewSNRdB,
+							 const _REAL rBandwidth, const _REAL rFreqOffset,
+							 const _REAL rSampleOffsetPPM, const unsigned int iSeed)
+{
+	int i;
+
+	Random.seed(iSeed);
+	Normal.reset();
+
+	/* Hilbert filter, Blackman window */
+	const int iHalfLen = (CHSIM_HILBERT_LEN - 1) / 2;
+
+	vecrHilbert.Init(CHSIM_HILBERT_LEN, (_REAL) 0.0);
+	for (i = 0; i < CHSIM_HILBERT_LEN; i++)
+	{
+		const int k = i - iHalfLen;
+
+		if ((k & 1) != 0)
+		{
+			const _REAL rWin = (_REAL) 0.42 -
+				(_REAL) 0.5 * cos((_REAL) 2.0 * crPi * i / (CHSIM_HILBERT_LEN - 1)) +
+				(_REAL) 0.08 * cos((_REAL) 4.0 * crPi * i / (CHSIM_HILBERT_LEN - 1));
+
+			vecrHilbert[i] = (_REAL) 2.0 / (crPi * k) * rWin;
+		}
+	}
+
+	vecrHilbHist.Init(2 * CHSIM_HILBERT_LEN, (_REAL) 0.0);
+	iHilbPos = 0;
+
+	/* Paths */
+	switch (eNewProfile)
+	{
+	case CP_CCIR_GOOD:
+		iNumPaths = 2;
+		InitPath(Path[0], (_REAL) 0.0, (_REAL) 0.1);
+		InitPath(Path[1], (_REAL) 0.5, (_REAL) 0.1);
+		break;
+
+	case CP_CCIR_MODERATE:
+		iNumPaths = 2;
+		InitPath(Path[0], (_REAL) 0.0, (_REAL) 0.5);
+		InitPath(Path[1], (_REAL) 1.0, (_REAL) 0.5);
+		break;
+
+	case CP_CCIR_POOR:
+		iNumPaths = 2;
+		InitPath(Path[0], (_REAL) 0.0, (_REAL) 1.0);
+		InitPath(Path[1], (_REAL) 2.0, (_REAL) 1.0);
+		break;
+
+	case CP_FLUTTER:
+		iNumPaths = 2;
+		InitPath(Path[0], (_REAL) 0.0, (_REAL) 10.0);
+		InitPath(Path[1], (_REAL) 0.5, (_REAL) 10.0);
+		break;
+
+	default:
+		iNumPaths = 1;
+		InitPath(Path[0], (_REAL) 0.0, (_REAL) 0.0);
+		break;
+	}
+
+	/* Equal power, the sum is one */
+	for (i = 0; i < iNumPaths; i++)
+		Path[i].rAmp = sqrt((_REAL) 1.0 / iNumPaths);
+
+	veccDelayLine.Init(CHSIM_MAX_DELAY, _COMPLEX((_REAL) 0.0, (_REAL) 0.0));
+	iDelayPos = 0;
+	iFadingPeriod = SOUNDCRD_SAMPLE_RATE / CHSIM_FADING_RATE;
+	iFadingCnt = 0;
+
+	/* Frequency offset */
+	const _REAL rPhaseStep = (_REAL) 2.0 * crPi * rFreqOffset / SOUNDCRD_SAMPLE_RATE;
+	cRotate = _COMPLEX((_REAL) 1.0, (_REAL) 0.0);
+	cRotStep = _COMPLEX(cos(rPhaseStep), sin(rPhaseStep));
+
+	/* A faster sound card clock gives more samples per second of signal */
+	bResample = (rSampleOffsetPPM != (_REAL) 0.0);
+	rResStep = (_REAL) 1.0 / ((_REAL) 1.0 + rSampleOffsetPPM * (_REAL) 1e-6);
+	rResPos = (_REAL) 0.0;
+	for (i = 0; i < 4; i++)
+		rResHist[i] = (_REAL) 0.0;
+
+	/* Real white noise spreads over half the sampling rate, only the part in
+	   the signal bandwidth counts */
+	const _REAL rSNR = pow((_REAL) 10.0, rNewSNRdB / 10);
+	rNoiseFactor = sqrt((_REAL) SOUNDCRD_SAMPLE_RATE / 2 / rBandwidth / rSNR);
+	rSumPower = (_REAL) 0.0;
+	rNoiseSigma = (_REAL) 0.0;
+	dNumSamples = 0.0;
+}
+
+void CChannelSimulator::InitPath(CPath& NewPath, const _REAL rDelayMs, const _REAL rDopplerSpread)
+{
+	NewPath.iDelay = (int) (rDelayMs * SOUNDCRD_SAMPLE_RATE / 1000 + (_REAL) 0.5);
+	if (NewPath.iDelay > CHSIM_MAX_DELAY - 1)
+		NewPath.iDelay = CHSIM_MAX_DELAY - 1;
+	NewPath.bFading = (rDopplerSpread > (_REAL) 0.0);
+
+	if (NewPath.bFading == FALSE)
+	{
+		NewPath.cGainOld = NewPath.cGainNew = _COMPLEX((_REAL) 1.0, (_REAL) 0.0);
+		return;
+	}
+
+	/* The Doppler spread is two times the standard deviation of the power
+	   spectrum. A Gaussian impulse response with the standard deviation
+	   "rSigmaT" has a power spectrum with 1 / (2 pi sqrt(2) rSigmaT) */
+	const _REAL rSigmaT = (_REAL) CHSIM_FADING_RATE /
+		((_REAL) 2.0 * crPi * sqrt((_REAL) 2.0) * rDopplerSpread / 2);
+	const int iHalfLen = (int) ceil(3 * rSigmaT);
+	const int iLen = 2 * iHalfLen + 1;
+
+	/* Unit power of the output for unit power noise */
+	_REAL rSum = (_REAL) 0.0;
+	NewPath.vecrDoppler.Init(iLen);
+	for (int i = 0; i < iLen; i++)
+	{
+		const _REAL t = (_REAL) (i - iHalfLen) / rSigmaT;
+		NewPath.vecrDoppler[i] = exp(-t * t / 2);
+		rSum += NewPath.vecrDoppler[i] * NewPath.vecrDoppler[i];
+	}
+	for (int i = 0; i < iLen; i++)
+		NewPath.vecrDoppler[i] /= sqrt(rSum);
+
+	/* Each noise sample is stored twice, so that the filter reads contiguous
+	   memory */
+	NewPath.veccNoise.Init(2 * iLen);
+	for (int i = 0; i < iLen; i++)
+		NewPath.veccNoise[i] = NewPath.veccNoise[i + iLen] = Gauss();
+	NewPath.iNoisePos = 0;
+
+	NewPath.cGainOld = NextGain(NewPath);
+	NewPath.cGainNew = NextGain(NewPath);
+}
+
+_COMPLEX CChannelSimulator::Gauss()
+{
+	const _REAL rRe = Normal(Random);
+	const _REAL rIm = Normal(Random);
+
+	return _COMPLEX(rRe, rIm) / sqrt((_REAL) 2.0);
+}
+
+_COMPLEX CChannelSimulator::NextGain(CPath& CurPath)
+{
+	const int iLen = CurPath.vecrDoppler.Size();
+
+	CurPath.veccNoise[CurPath.iNoisePos] =
+		CurPath.veccNoise[CurPath.iNoisePos + iLen] = Gauss();
+
+	CurPath.iNoisePos++;
+	if (CurPath.iNoisePos == iLen)
+		CurPath.iNoisePos = 0;
+
+	_COMPLEX cSum((_REAL) 0.0, (_REAL) 0.0);
+	const _COMPLEX* pcNoise = &CurPath.veccNoise[CurPath.iNoisePos];
+
+	for (int i = 0; i < iLen; i++)
+		cSum += CurPath.vecrDoppler[i] * pcNoise[i];
+
+	return cSum;
+}
+
+void CChannelSimulator::Process(const _SAMPLE* psIn, const int iStride, const int iLen,
+								std::vector<_SAMPLE>& vecsOut)
+{
+	int i, j;
+	const int iHalfLen = (CHSIM_HILBERT_LEN - 1) / 2;
+
+	/* Average power of the input up to now */
+	for (i = 0; i < iLen; i++)
+		rSumPower += (_REAL) psIn[i * iStride] * psIn[i * iStride];
+
+	dNumSamples += iLen;
+	if (dNumSamples > 0)
+		rNoiseSigma = sqrt(rSumPower / dNumSamples) * rNoiseFactor;
+
+	for (i = 0; i < iLen; i++)
+	{
+		const _REAL rIn = (_REAL) psIn[i * iStride];
+
+		/* Analytic signal, the real part is delayed by the filter */
+		vecrHilbHist[iHilbPos] = vecrHilbHist[iHilbPos + CHSIM_HILBERT_LEN] = rIn;
+		iHilbPos++;
+		if (iHilbPos == CHSIM_HILBERT_LEN)
+			iHilbPos = 0;
+
+		const _REAL* prHist = &vecrHilbHist[iHilbPos]; /* oldest sample first */
+		_REAL rImag = (_REAL) 0.0;
+
+		for (j = 0; j < CHSIM_HILBERT_LEN; j += 2)
+			rImag += vecrHilbert[CHSIM_HILBERT_LEN - 1 - j] * prHist[j];
+
+		veccDelayLine[iDelayPos] = _COMPLEX(prHist[iHalfLen], rImag);
+
+		/* Multipath, the gains are interpolated linearly */
+		const _REAL rWeight = (_REAL) iFadingCnt / iFadingPeriod;
+		_COMPLEX cSig((_REAL) 0.0, (_REAL) 0.0);
+
+		for (j = 0; j < iNumPaths; j++)
+		{
+			const _COMPLEX cGain = Path[j].cGainOld +
+				(Path[j].cGainNew - Path[j].cGainOld) * rWeight;
+
+			cSig += Path[j].rAmp * cGain *
+				veccDelayLine[(iDelayPos - Path[j].iDelay) & (CHSIM_MAX_DELAY - 1)];
+		}
+
+		iDelayPos = (iDelayPos + 1) & (CHSIM_MAX_DELAY - 1);
+
+		iFadingCnt++;
+		if (iFadingCnt == iFadingPeriod)
+		{
+			iFadingCnt = 0;
+
+			for (j = 0; j < iNumPaths; j++)
+			{
+				if (Path[j].bFading == TRUE)
+				{
+					Path[j].cGainOld = Path[j].cGainNew;
+					Path[j].cGainNew = NextGain(Path[j]);
+				}
+			}
+		}
+
+		/* Frequency offset */
+		cSig *= cRotate;
+		cRotate *= cRotStep;
+
+		if (bResample == TRUE)
+			Resample(cSig.real(), vecsOut);
+		else
+			Output(cSig.real(), vecsOut);
+	}
+
+	/* Keep the amplitude of the oscillator at one */
+	cRotate /= abs(cRotate);
+}
+
+void CChannelSimulator::Resample(const _REAL rIn, std::vector<_SAMPLE>& vecsOut)
+{
+	rResHist[0] = rResHist[1];
+	rResHist[1] = rResHist[2];
+	rResHist[2] = rResHist[3];
+	rResHist[3] = rIn;
+
+	/* "rResPos" is the position between the second and the third sample of
+	   the history */
+	rResPos -= (_REAL) 1.0;
+
+	while (rResPos < (_REAL) 1.0)
+	{
+		const _REAL x = rResPos;
+
+		const _REAL rOut =
+			-x * (x - 1) * (x - 2) / 6 * rResHist[0] +
+			(x + 1) * (x - 1) * (x - 2) / 2 * rResHist[1] -
+			(x + 1) * x * (x - 2) / 2 * rResHist[2] +
+			(x + 1) * x * (x - 1) / 6 * rResHist[3];
+
+		Output(rOut, vecsOut);
+
+		rResPos += rResStep;
+	}
+}
+
+void CChannelSimulator::Output(const _REAL rVal, std::vector<_SAMPLE>& vecsOut)
+{
+	_REAL rOut = rVal + Normal(Random) * rNoiseSigma;
+
+	if (rOut > (_REAL) _MAXSHORT)
+		rOut = (_REAL) _MAXSHORT;
+	else if (rOut < (_REAL) -_MAXSHORT)
+		rOut = (_REAL) -_MAXSHORT;
+
+	vecsOut.push_back((_SAMPLE) floor(rOut + (_REAL) 0.5));
+}
@@ -0,0 +1,133 @@
+/******************************************************************************\
+ * Copyright (c) 2024
+ *
+ * Author(s):
+ *	EasyDRF developers
+ *
+ * Description:
+ *	See ChannelSimulator.cpp
+ *
+ ******************************************************************************
+ *
+ * This program is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation; either version 2 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ *
+\******************************************************************************/
+
+#if !defined(CHANNELSIMULATOR_H__3B0UBVE98732KJVEW363CHANS1MUL__INCLUDED_)
+#define CHANNELSIMULATOR_H__3B0UBVE98732KJVEW363CHANS1MUL__INCLUDED_
+
+#include <vector>
+#include <random>
+#include "GlobalDefinitions.h"
+#include "Vector.h"
+
+
+/* Definitions ****************************************************************/
+/* Hilbert filter for the analytic signal (odd length) */
+#define CHSIM_HILBERT_LEN			127
+
+/* Maximum number of paths and maximum path delay (samples, power of 2) */
+#define CHSIM_MAX_PATHS				2
+#define CHSIM_MAX_DELAY				512
+
+/* The path gains are computed with this rate and interpolated in between */
+#define CHSIM_FADING_RATE			200
+
+/* Watterson profiles (ITU-R F.520 / F.1487): two paths of equal power with
+   Gaussian Doppler spectrum, delay and Doppler spread (two sigma) */
+enum EChanProfile {CP_AWGN, CP_CCIR_GOOD, CP_CCIR_MODERATE, CP_CCIR_POOR, CP_FLUTTER};
+
+
+/* Classes ********************************************************************/
+/* HF channel between the audio output of the transmitter and the audio input
+   of the receiver: multipath with Rayleigh fading, frequency offset (like a
+   mistuned SSB receiver), sample clock offset of the receiving sound card and
+   white noise. The SNR refers to the noise power in the signal bandwidth */
+class CChannelSimulator
+{
+public:
+	CChannelSimulator() : iNumPaths(0) {}
+	virtual ~CChannelSimulator() {}
+
+	void		Init(const EChanProfile eNewProfile, const _REAL rNewSNRdB,
+					 const _REAL rBandwidth, const _REAL rFreqOffset,
+					 const _REAL rSampleOffsetPPM, const unsigned int iSeed);
+
+	/* "iStride" is the distance of the input samples (2 for stereo). The
+	   output is appended, its length differs from the input length if there
+	   is a sample clock offset */
+	void		Process(const _SAMPLE* psIn, const int iStride, const int iLen,
+						std::vector<_SAMPLE>& vecsOut);
+
+	static const char*	GetProfileName(const EChanProfile eProfile);
+
+protected:
+	class CPath
+	{
+	public:
+		int					iDelay;
+		_REAL				rAmp;
+		_BOOLEAN			bFading;
+
+		/* Gaussian Doppler filter on complex white noise */
+		CVector<_REAL>		vecrDoppler;
+		CVector<_COMPLEX>	veccNoise;
+		int					iNoisePos;
+
+		_COMPLEX			cGainOld;
+		_COMPLEX			cGainNew;
+	};
+
+	void		InitPath(CPath& Path, const _REAL rDelayMs, const _REAL rDopplerSpread);
+	_COMPLEX	NextGain(CPath& Path);
+	_COMPLEX	Gauss();
+	void		Resample(const _REAL rIn, std::vector<_SAMPLE>& vecsOut);
+	void		Output(const _REAL rVal, std::vector<_SAMPLE>& vecsOut);
+
+	std::mt19937					Random;
+	std::normal_distribution<_REAL>	Normal;
+
+	/* Analytic signal */
+	CVector<_REAL>		vecrHilbert;
+	CVector<_REAL>		vecrHilbHist; /* twice the filter length */
+	int					iHilbPos;
+
+	/* Multipath */
+	CPath				Path[CHSIM_MAX_PATHS];
+	int					iNumPaths;
+	CVector<_COMPLEX>	veccDelayLine;
+	int					iDelayPos;
+	int					iFadingPeriod;
+	int					iFadingCnt;
+
+	/* Frequency offset */
+	_COMPLEX			cRotate;
+	_COMPLEX			cRotStep;
+
+	/* Sample clock offset, 4-point Lagrange interpolation */
+	_BOOLEAN			bResample;
+	_REAL				rResStep;
+	_REAL				rResPos; /* relative to the newest input sample */
+	_REAL				rResHist[4];
+
+	/* Noise */
+	_REAL				rNoiseFactor;
+	_REAL				rNoiseSigma;
+	_REAL				rSumPower;
+	double				dNumSamples;
+};
+
+
+#endif // !defined(CHANNELSIMULATOR_H__3B0UBVE98732KJVEW363CHANS1MUL__INCLUDED_)
@@ -0,0 +1,316 @@
+/******************************************************************************\
+ * Copyright (c) 2024
+ *
+ * Author(s):
+ *	EasyDRF developers
+ *
+ * Description:
+ *	Channeliser front end for the wideband receiver
+ *
+ *	Several HamDRM signals can share one SSB passband (or the much wider
+ *	input of an SDR). The signal detector finds them in the averaged PSD of
+ *	the input, one channel filter per signal cuts it out and moves it to the
+ *	position where the receiver expects it. The chain after it does not
+ *	know that the input was wider
+ *
+ ******************************************************************************
+ *
+ * This program is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation; either version 2 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ *
+\******************************************************************************/
+
+#include "Channelizer.h"
+#include "tables/TableCarrier.h"
+
+
+/* Implementation *************************************************************/
+/******************************************************************************\
+* Channel filter                                                               *
+\******************************************************************************/
+void CChannelizer::Init(const _REAL rNewInFreq, const _REAL rNewOutFreq, const int iNewMaxBlock)
+{
+	int i, j;
+
+	rInFreq = rNewInFreq;
+
+	/* Prototype low-pass filter (windowed sinc) with unity gain at DC */
+	CRealVector vecrWin(CHAN_NUM_TAPS);
+	vecrWin = Hamming(CHAN_NUM_TAPS);
+	const _REAL rNormCutOff = (_REAL) 2.0 * CHAN_CUT_OFF_FREQ / SOUNDCRD_SAMPLE_RATE;
+	_REAL rSum = (_REAL) 0.0;
+
+	vecrTaps.Init(CHAN_NUM_TAPS);
+	for (i = 0; i < CHAN_NUM_TAPS; i++)
+	{
+		const _REAL rT = (_REAL) i - (_REAL) (CHAN_NUM_TAPS - 1) / 2;
+		vecrTaps[i] = rNormCutOff * Sinc(rNormCutOff * rT) * vecrWin[i];
+		rSum += vecrTaps[i];
+	}
+	for (i = 0; i < CHAN_NUM_TAPS; i++)
+		vecrTaps[i] /= rSum;
+
+	/* Branch "p" of the interpolator uses the taps p, p + D, p + 2D, ... The
+	   factor D compensates the zeros which are inserted by the upsampling */
+	vecrBranch.Init(CHAN_NUM_TAPS);
+	for (i = 0; i < CHAN_DEC_FACT; i++)
+	{
+		for (j = 0; j < CHAN_TAPS_PER_BRANCH; j++)
+		{
+			vecrBranch[i * CHAN_TAPS_PER_BRANCH + j] =
+				CHAN_DEC_FACT * vecrTaps[i + j * CHAN_DEC_FACT];
+		}
+	}
+
+	veccDecBuf.Init(iHistSize + iNewMaxBlock, (_REAL) 0.0);
+	veccIntBuf.Init(CHAN_TAPS_PER_BRANCH - 1 + iNewMaxBlock / CHAN_DEC_FACT, (_REAL) 0.0);
+
+	/* Mixers */
+	cRotIn = (_REAL) 1.0;
+	cRotOut = (_REAL) 1.0;
+	cStepIn = exp(_COMPLEX((_REAL) 0.0, (_REAL) -2.0 * crPi * rNewInFreq / SOUNDCRD_SAMPLE_RATE));
+	cStepOut = exp(_COMPLEX((_REAL) 0.0, (_REAL) 2.0 * crPi * rNewOutFreq / SOUNDCRD_SAMPLE_RATE));
+}
+
+void CChannelizer::Process(const CVector<_REAL>& vecrIn, const int iLen, _SAMPLE* psOut)
+{
+	int i, j, m;
+	const int iNumDec = iLen / CHAN_DEC_FACT;
+	const int iIntHist = CHAN_TAPS_PER_BRANCH - 1;
+
+	/* Mix the centre of the signal down to 0 Hz. The end of the last block is
+	   kept in front of the new samples */
+	for (i = 0; i < iLen; i++)
+	{
+		veccDecBuf[iHistSize + i] = vecrIn[i] * cRotIn;
+		cRotIn *= cStepIn;
+	}
+	cRotIn /= abs(cRotIn);
+
+	/* Decimation, only the outputs which are kept are calculated */
+	for (m = 0; m < iNumDec; m++)
+	{
+		const _COMPLEX* pcIn = &veccDecBuf[iHistSize + m * CHAN_DEC_FACT + CHAN_DEC_FACT - 1];
+		_REAL rRe = (_REAL) 0.0;
+		_REAL rIm = (_REAL) 0.0;
+
+		for (j = 0; j < CHAN_NUM_TAPS; j++)
+		{
+			rRe += vecrTaps[j] * pcIn[-j].real();
+			rIm += vecrTaps[j] * pcIn[-j].imag();
+		}
+
+		veccIntBuf[iIntHist + m] = _COMPLEX(rRe, rIm);
+	}
+
+	/* Interpolation, each decimated sample gives one output per branch. Mix
+	   up to the new position, the real part has half of the power */
+	for (m = 0; m < iNumDec; m++)
+	{
+		const _COMPLEX* pcDec = &veccIntBuf[iIntHist + m];
+
+		for (i = 0; i < CHAN_DEC_FACT; i++)
+		{
+			const _REAL* prBranch = &vecrBranch[i * CHAN_TAPS_PER_BRANCH];
+			_REAL rRe = (_REAL) 0.0;
+			_REAL rIm = (_REAL) 0.0;
+
+			for (j = 0; j < CHAN_TAPS_PER_BRANCH; j++)
+			{
+				rRe += prBranch[j] * pcDec[-j].real();
+				rIm += prBranch[j] * pcDec[-j].imag();
+			}
+
+			psOut[m * CHAN_DEC_FACT + i] = Real2Sample((_REAL) 2.0 *
+				(rRe * cRotOut.real() - rIm * cRotOut.imag()));
+			cRotOut *= cStepOut;
+		}
+	}
+	cRotOut /= abs(cRotOut);
+
+	/* Keep the histories for the next block */
+	for (i = 0; i < iHistSize; i++)
+		veccDecBuf[i] = veccDecBuf[iLen + i];
+	for (i = 0; i < iIntHist; i++)
+		veccIntBuf[i] = veccIntBuf[iNumDec + i];
+}
+
+
+/******************************************************************************\
+* Signal detector                                                              *
+\******************************************************************************/
+void CSignalDetector::Init(const _REAL rLowFreq, const _REAL rHighFreq,
+						   const int iHop)
+{
+	const _REAL rBinHz = (_REAL) SOUNDCRD_SAMPLE_RATE / CHAN_DET_FFT_SIZE;
+
+	/* Frequency pilots of robustness mode B, like in the frequency
+	   acquisition */
+	veciFreqPilots.Init(3);
+	for (int i = 0; i < 3; i++)
+		veciFreqPilots[i] = iTableFreqPilRobModB[i][0] * CHAN_DET_NUM_BLOCKS;
+
+	/* Magnitudes of all bins below half the sample rate */
+	Stft.Setup(1, 2, CHAN_DET_FFT_SIZE, iHop);
+	iNextLine = 0;
+
+	iHalfBuffer = Stft.GetNumBins();
+	iSearchWinSize = iHalfBuffer - veciFreqPilots[2];
+
+	/* Search range, the neighbours of each index are needed for the peak
+	   detection */
+	iStartSearch = (int) Floor(rLowFreq / rBinHz);
+	iEndSearch = (int) Ceil(rHighFreq / rBinHz);
+
+	if (iStartSearch < 1)
+		iStartSearch = 1;
+	if ((iEndSearch > iSearchWinSize - 1) || (iEndSearch <= iStartSearch))
+		iEndSearch = iSearchWinSize - 1;
+
+	vecrPSD.Init(iHalfBuffer);
+	vecrPSD = Zeros(iHalfBuffer);
+	vecrPSDPilCor.Init(iSearchWinSize);
+	vecrFiltResLR.Init(iSearchWinSize);
+	vecrFiltResRL.Init(iSearchWinSize);
+	veciPeakIndex.Init(iSearchWinSize);
+
+	iNumPSD = 0;
+}
+
+void CSignalDetector::AddBlock(CVector<_REAL>& vecrIn, const int iLen)
+{
+	Stft.AddBlock(vecrIn, iLen);
+
+	/* Averaged power spectrum over all new lines */
+	const int iNumLines = Stft.GetLines(iNextLine, STFT_NUM_LINES, vecfLines);
+
+	for (int j = 0; j < iNumLines; j++)
+	{
+		const float* pfLine = &vecfLines[j * iHalfBuffer];
+
+		for (int i = 1; i < iHalfBuffer; i++)
+		{
+			vecrPSD[i] = CHAN_DET_PSD_LAMBDA * vecrPSD[i] +
+				((_REAL) 1.0 - CHAN_DET_PSD_LAMBDA) * pfLine[i] * pfLine[i];
+		}
+
+		iNumPSD++;
+	}
+}
+
+int CSignalDetector::Detect(CVector<_REAL>& vecrDCFreq)
+{
+	int i, j;
+	const _REAL rBinHz = (_REAL) SOUNDCRD_SAMPLE_RATE / CHAN_DET_FFT_SIZE;
+	const int iMinSpacing = (int) (CHAN_MIN_SIGNAL_SPACING / rBinHz);
+
+	/* The history must be filled and the PSD averaged first */
+	if (iNumPSD < 2 * CHAN_DET_NUM_BLOCKS)
+		return 0;
+
+	/* Correlate the known frequency pilot structure with the power spectrum */
+	for (i = 0; i < iSearchWinSize; i++)
+	{
+		vecrPSDPilCor[i] = vecrPSD[i + veciFreqPilots[0]] +
+			vecrPSD[i + veciFreqPilots[1]] + vecrPSD[i + veciFreqPilots[2]];
+	}
+
+	/* Low pass filtering over the frequency axis from both sides, the peaks
+	   are measured against the sum of both */
+	const _REAL rLambdaF = (_REAL) 0.9;
+	vecrFiltResLR[0] = vecrPSDPilCor[0];
+	for (i = 1; i < iSearchWinSize; i++)
+	{
+		vecrFiltResLR[i] = rLambdaF * (vecrFiltResLR[i - 1] -
+			vecrPSDPilCor[i]) + vecrPSDPilCor[i];
+	}
+	vecrFiltResRL[iSearchWinSize - 1] = vecrPSDPilCor[iSearchWinSize - 1];
+	for (i = iSearchWinSize - 2; i >= 0; i--)
+	{
+		vecrFiltResRL[i] = rLambdaF * (vecrFiltResRL[i + 1] -
+			vecrPSDPilCor[i]) + vecrPSDPilCor[i];
+	}
+
+	/* Local maxima above the filtered curve, which have at least two pilots of
+	   similar power (excludes sinusoid interferers) */
+	int iNumPeaks = 0;
+	for (i = iStartSearch; i < iEndSearch; i++)
+	{
+		if ((vecrPSDPilCor[i] <= vecrPSDPilCor[i - 1]) ||
+			(vecrPSDPilCor[i] < vecrPSDPilCor[i + 1]))
+		{
+			continue;
+		}
+
+		if (vecrPSDPilCor[i] <= CHAN_DET_PEAK_BOUND *
+			(vecrFiltResLR[i] + vecrFiltResRL[i]))
+		{
+			continue;
+		}
+
+		_REAL rHighest = (_REAL) 0.0;
+		_REAL rSecond = (_REAL) 0.0;
+		for (j = 0; j < 3; j++)
+		{
+			const _REAL rPil = vecrPSD[i + veciFreqPilots[j]];
+
+			if (rPil > rHighest)
+			{
+				rSecond = rHighest;
+				rHighest = rPil;
+			}
+			else if (rPil > rSecond)
+				rSecond = rPil;
+		}
+
+		if (rHighest > CHAN_DET_MAX_RAT_PILOTS * rSecond)
+			continue;
+
+		veciPeakIndex[iNumPeaks] = i;
+		iNumPeaks++;
+	}
+
+	/* Take the strongest peak first, peaks too close to an already taken one
+	   belong to the same signal (or overlap with it) */
+	vecrDCFreq.Init(iNumPeaks);
+	int iNumSignals = 0;
+
+	while (iNumPeaks > 0)
+	{
+		int iMax = 0;
+		for (i = 1; i < iNumPeaks; i++)
+		{
+			if (vecrPSDPilCor[veciPeakIndex[i]] > vecrPSDPilCor[veciPeakIndex[iMax]])
+				iMax = i;
+		}
+
+		const int iIndex = veciPeakIndex[iMax];
+		vecrDCFreq[iNumSignals] = iIndex * rBinHz;
+		iNumSignals++;
+
+		/* Remove all peaks near the taken one */
+		j = 0;
+		for (i = 0; i < iNumPeaks; i++)
+		{
+			if (abs(veciPeakIndex[i] - iIndex) >= iMinSpacing)
+			{
+				veciPeakIndex[j] = veciPeakIndex[i];
+				j++;
+			}
+		}
+		iNumPeaks = j;
+	}
+
+	return iNumSignals;
+}
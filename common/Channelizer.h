@@ -0,0 +1,141 @@
+/******************************************************************************\
+ * Copyright (c) 2024
+ *
+ * Author(s):
+ *	EasyDRF developers
+ *
+ * Description:
+ *	See Channelizer.cpp
+ *
+ ******************************************************************************
+ *
+ * This program is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation; either version 2 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ *
+\******************************************************************************/
+
+#if !defined(CHANNELIZER_H__3B0UBVE98732KJVEW363CHANNEL1Z__INCLUDED_)
+#define CHANNELIZER_H__3B0UBVE98732KJVEW363CHANNEL1Z__INCLUDED_
+
+#include "GlobalDefinitions.h"
+#include "Vector.h"
+#include "matlib/Matlib.h"
+#include "Stft.h"
+
+
+/* Definitions ****************************************************************/
+/* Decimation factor of the channel filter. One signal (2.5 kHz) is moved to
+   baseband and decimated to 4 kHz complex, then interpolated back */
+#define CHAN_DEC_FACT				12
+#define CHAN_TAPS_PER_BRANCH		48
+#define CHAN_NUM_TAPS				(CHAN_DEC_FACT * CHAN_TAPS_PER_BRANCH)
+
+/* Cut-off frequency of the channel filter (two sided bandwidth is twice this
+   value). The widest spectrum occupancy ends 1.2 kHz from the centre */
+#define CHAN_CUT_OFF_FREQ			((_REAL) 1360.0)
+
+/* Distance of the centre of the signal from the DC carrier (robustness mode B,
+   widest spectrum occupancy: carriers 1 to 51) */
+#define CHAN_DC_TO_CENTRE			((_REAL) SOUNDCRD_SAMPLE_RATE / RMB_FFT_SIZE_N * 26)
+
+/* Signal detection. The PSD is averaged over the same number of symbols as in
+   the frequency acquisition of the receiver */
+#define CHAN_DET_NUM_BLOCKS			6
+#define CHAN_DET_FFT_SIZE			(RMB_FFT_SIZE_N * CHAN_DET_NUM_BLOCKS)
+#define CHAN_DET_PSD_LAMBDA			((_REAL) 0.9)
+#define CHAN_DET_PEAK_BOUND			((_REAL) 1.5)
+#define CHAN_DET_MAX_RAT_PILOTS		((_REAL) 3.0)
+
+/* Two signals must be at least this far apart (in Hz) */
+#define CHAN_MIN_SIGNAL_SPACING		((_REAL) 2400.0)
+
+
+/* Classes ********************************************************************/
+/* Polyphase channel filter for one signal. The real input is mixed down so that
+   the centre of the signal is at 0 Hz, low-pass filtered and decimated by
+   "CHAN_DEC_FACT" (only every "CHAN_DEC_FACT"th output is calculated), then
+   interpolated with the polyphase branches of the same prototype filter and
+   mixed up to the new position. The output has the sample rate of the input */
+class CChannelizer
+{
+public:
+	CChannelizer() : iHistSize(CHAN_NUM_TAPS - 1) {}
+	virtual ~CChannelizer() {}
+
+	/* "rNewInFreq" is moved to "rNewOutFreq", both in Hz */
+	void Init(const _REAL rNewInFreq, const _REAL rNewOutFreq, const int iNewMaxBlock);
+
+	/* "iLen" must be a multiple of "CHAN_DEC_FACT" */
+	void Process(const CVector<_REAL>& vecrIn, const int iLen, _SAMPLE* psOut);
+
+	_REAL GetInFreq() const {return rInFreq;}
+
+protected:
+	_REAL				rInFreq;
+
+	CVector<_REAL>		vecrTaps;		/* Decimation, prototype filter */
+	CVector<_REAL>		vecrBranch;		/* Interpolation, polyphase branches */
+
+	const int			iHistSize;
+	CVector<_COMPLEX>	veccDecBuf;		/* History plus mixed input block */
+	CVector<_COMPLEX>	veccIntBuf;		/* History plus decimated block */
+
+	_COMPLEX			cRotIn;
+	_COMPLEX			cStepIn;
+	_COMPLEX			cRotOut;
+	_COMPLEX			cStepOut;
+};
+
+/* Finds HamDRM signals in a wide input spectrum. Like the frequency acquisition
+   of the receiver, the averaged PSD is correlated with the positions of the
+   three frequency pilots. Instead of taking the maximum, all peaks which are
+   far enough apart are reported. The spectra come from a STFT over the full
+   band with one line per hop */
+class CSignalDetector
+{
+public:
+	CSignalDetector() : iNumPSD(0) {}
+	virtual ~CSignalDetector() {}
+
+	/* Search range of the DC carrier in Hz, one spectrum every "iHop"
+	   samples */
+	void Init(const _REAL rLowFreq, const _REAL rHighFreq, const int iHop);
+	void AddBlock(CVector<_REAL>& vecrIn, const int iLen);
+
+	/* Frequencies of the DC carriers in Hz, strongest signal first. Returns
+	   the number of detected signals */
+	int Detect(CVector<_REAL>& vecrDCFreq);
+
+protected:
+	CVector<int>			veciFreqPilots;
+
+	CStft					Stft;
+	CVector<float>			vecfLines;
+	int						iNextLine;
+
+	int						iHalfBuffer;
+	int						iSearchWinSize;
+	int						iStartSearch;
+	int						iEndSearch;
+	int						iNumPSD;
+
+	CRealVector				vecrPSD;
+	CRealVector				vecrPSDPilCor;
+	CRealVector				vecrFiltResLR;
+	CRealVector				vecrFiltResRL;
+	CVector<int>			veciPeakIndex;
+};
+
+
+#endif // !defined(CHANNELIZER_H__3B0UBVE98732KJVEW363CHANNEL1Z__INCLUDED_)
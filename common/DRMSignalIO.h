@@ -33,7 +33,8 @@
 #include "Modul.h"
 #include <math.h>
 #include "matlib/Matlib.h"
-#include "TransmitterFilter.h"
+#include "TransmitShaper.h"
+#include "Stft.h"
 
 #include "../sound/sound.h"
 
@@ -48,11 +49,6 @@ extern HWND mainwindow;
 /* Definitions ****************************************************************/
 #define	METER_FLY_BACK				15
 
-/* Length of vector for input spectrum. We use approx. 0.2 sec
-   of sampled data for spectrum calculation, this is 2^13 = 8192 to 
-   make the FFT work more efficient */
-#define NUM_SMPLS_4_INPUT_SPECTRUM	8192
-
 /* Use raw 16 bit data or in text form for file format for DRM data. Defining
    the following macro will enable the raw data option */
 #define FILE_DRM_USING_RAW_DATA
@@ -76,8 +72,8 @@ public:
 
 	void Init(_REAL rStartVal) {rCurLevel = Abs(rStartVal);}
 	void Update(_REAL rVal);
-	void Update(CVector<_REAL> vecrVal);
-	void Update(CVector<_SAMPLE> vecsVal);
+	void Update(const CVector<_REAL>& vecrVal);
+	void Update(const CVector<_SAMPLE>& vecsVal);
 	_REAL Level();
 
 protected:
@@ -90,8 +86,12 @@ class CTransmitData : public CTransmitterModul<_COMPLEX, _COMPLEX>
 public:
 	enum EOutFormat {OF_REAL_VAL /* real valued */, OF_IQ /* I / Q */, OF_EP /* envelope / phase */};
 
-	CTransmitData(CSound* pNS) : pSound(pNS), eOutputFormat(OF_REAL_VAL), rDefCarOffset((_REAL) VIRTUAL_INTERMED_FREQ) {}
+	CTransmitData(CSoundInterface* pNS) : pSound(pNS), eOutputFormat(OF_REAL_VAL), rDefCarOffset((_REAL) VIRTUAL_INTERMED_FREQ) {}
 	void SetIQOutput(const EOutFormat eFormat) {eOutputFormat = eFormat;}
+
+	/* Audio backend for the modem signal, used from the next "Init()" on */
+	void SetSoundInterface(CSoundInterface* pNS) {pSound = pNS;}
+	CSoundInterface* GetSoundInterface() {return pSound;}
 	EOutFormat GetIQOutput() {return eOutputFormat;}
 	virtual ~CTransmitData();
 
@@ -99,69 +99,36 @@ public:
 		{rDefCarOffset = rNewCarOffset;}
 
 protected:
-	CSound*			pSound;
+	CSoundInterface*	pSound;
 	CVector<short>	vecsDataOut;
 	int				iBlockCnt;
 	int				iNumBlocks;
 	EOutFormat		eOutputFormat;
 
 	CReal			rDefCarOffset;
-	CRealVector		rvecA; 
-	CRealVector		rvec1; //OFDM bandpass filter coeffs DM
-//	CRealVector		rvec2; //Unused
-	CRealVector		rvec3; //Post clipper filter coeffs DM
-	CRealVector		rvec4; //OFDM and Overshoot Comp filter coeffs DM
-	CRealVector		rvec5; //24k interpolation filter coeffs DM
-	CRealVector		rvec6; //48k interpolation filter coeffs DM
-	CRealVector		rvecZI1; //48kHz state memory
-	CRealVector		rvecZQ1; //48kHz state memory
-	CRealVector		rvecDataDecI; //12kHz decimation buffer
-	CRealVector		rvecDataDecQ; //12kHz decimation buffer
-	CRealVector		rvecDataI;  //48kHz buffer
-	CRealVector		rvecDataQ;  //48kHz buffer
-	CRealVector		rvecData2I; //24kHz buffer
-	CRealVector		rvecData2Q; //24kHz buffer
-	CRealVector		rvecZDecI2; //12kHz state memory
-	CRealVector		rvecZDecQ2; //12kHz state memory
-	CRealVector		rvecZDecI3; //12kHz state memory
-	CRealVector		rvecZDecQ3; //12kHz state memory
-	CRealVector		rvecZDecI4; //12kHz state memory
-	CRealVector		rvecZDecQ4; //12kHz state memory
-	CRealVector		rvecZDecI5; //12kHz state memory
-	CRealVector		rvecZDecQ5; //12kHz state memory
-	CRealVector		rvecZI6; //48kHz state memory
-	CRealVector		rvecZQ6; //48kHz state memory
 
-	CReal			rNormFactor;
+	/* Decimation, PAPR clipping, filters and interpolation */
+	CTransmitShaper	Shaper;
 
-	CComplex WURotate;
-	CComplex WUSinStep;
+	CReal			rNormFactor;
 
 	virtual void InitInternal(CParameter& TransmParam);
 	virtual void ProcessDataInternal(CParameter& Parameter);
 };
 
-class CHanningWindow
-{
-public:
-	CHanningWindow() : bIsInit(FALSE) {}
-	virtual ~CHanningWindow() {}
-
-	void Init(void);
-
-	CRealVector				vecrHannWind;
-	_BOOLEAN				bIsInit;
-};
-
 class CReceiveData : public CReceiverModul<_REAL, _REAL>
 {
 public:
-	CReceiveData(CSound* pNS) : bFippedSpectrum(FALSE), pFileReceiver(NULL), bUseSoundcard(TRUE), bNewUseSoundcard(TRUE), pSound(pNS), vecrInpData(NUM_SMPLS_4_INPUT_SPECTRUM, (_REAL)0.0) {} //added DM
+	CReceiveData(CSoundInterface* pNS) : bFippedSpectrum(FALSE), pFileReceiver(NULL), bUseSoundcard(TRUE), bNewUseSoundcard(TRUE), pSound(pNS),
+		iRecChannel(RECORDING_CHANNEL), iSoundChannels(2), Inp(0), Outp(0), bFlagInv(FALSE) {} //added DM
 //	CReceiveData(CSound* pNS) : pFileReceiver(NULL), pSound(pNS), vecrInpData(NUM_SMPLS_4_INPUT_SPECTRUM, (_REAL) 0.0) {}
 	virtual ~CReceiveData();
 
 	_REAL GetLevelMeter() {return SignalLevelMeter.Level();}
 	void GetInputSpec(CVector<_REAL>& vecrData);
+
+	/* Spectral lines of the input, callable from every thread */
+	CStft& GetStft() {return Stft;}
 	
 	//added DM
 	void SetFlippedSpectrum(const _BOOLEAN bNewF) { bFippedSpectrum = bNewF; }
@@ -174,21 +141,35 @@ public:
 	}
 	//added DM end
 
+	/* Audio backend for the modem signal */
+	void SetSoundInterface(CSoundInterface* pNS) {pSound = pNS; SetInitFlag();}
+	CSoundInterface* GetSoundInterface() {return pSound;}
+
+	/* 0: Left, 1: Right. Not used if the backend delivers only one channel */
+	void SetRecordingChannel(const int iNewChan) {iRecChannel = iNewChan;}
+	int GetRecordingChannel() {return iRecChannel;}
+
 protected:
 	CSignalLevelMeter		SignalLevelMeter;
-	CHanningWindow			HanningWindow;
 	
 	FILE*					pFileReceiver;
 
-	CSound*					pSound;
-	CVector<_SAMPLE>		vecsSoundBuffer;
+	CSoundInterface*		pSound;
 
-	CShiftRegister<_REAL>	vecrInpData;
+	CStft					Stft;
 
 	_BOOLEAN				bFippedSpectrum; //added DM
 	_BOOLEAN				bUseSoundcard; //added DM
 	_BOOLEAN				bNewUseSoundcard; //added DM
 
+	int						iRecChannel;
+	int						iSoundChannels;
+
+	/* DC blocker and spectrum flipping state */
+	int						Inp; //previous input
+	int						Outp; //previous output
+	_BOOLEAN				bFlagInv;
+
 	virtual void InitInternal(CParameter& ReceiverParam);
 	virtual void ProcessDataInternal(CParameter& ReceiverParam);
 };
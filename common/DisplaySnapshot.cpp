@@ -0,0 +1,82 @@
+/******************************************************************************\
+ * Copyright (c) 2024
+ *
+ * Author(s):
+ *	EasyDRF developers
+ *
+ * Description:
+ *	Display products of the receiver
+ *
+ *	The receive thread computes the input spectrum, the PSD, the transfer
+ *	function, the impulse response, the constellations and the level a few
+ *	times per second and publishes them in a triple buffer. The dialog and
+ *	the DLL functions only copy the latest snapshot, they never touch the
+ *	data of the processing modules and never hold up the receive thread
+ *
+ ******************************************************************************
+ *
+ * This program is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation; either version 2 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ *
+\******************************************************************************/
+
+#include "DisplaySnapshot.h"
+#include <chrono>
+
+
+/* Implementation *************************************************************/
+CDisplaySnapshot& CDisplaySnapshot::operator=(const CDisplaySnapshot& Snap)
+{
+	CopyVector(vecrInputSpec, Snap.vecrInputSpec);
+	CopyVector(vecrPSD, Snap.vecrPSD);
+	CopyVector(vecrTransFct, Snap.vecrTransFct);
+	CopyVector(vecrGroupDelay, Snap.vecrGroupDelay);
+	CopyVector(vecrImpResp, Snap.vecrImpResp);
+	CopyVector(vecrImpRespScale, Snap.vecrImpRespScale);
+	CopyVector(veccFACVectorSpace, Snap.veccFACVectorSpace);
+	CopyVector(veccMSCVectorSpace, Snap.veccMSCVectorSpace);
+
+	rLowerBound = Snap.rLowerBound;
+	rHigherBound = Snap.rHigherBound;
+	rStartGuard = Snap.rStartGuard;
+	rEndGuard = Snap.rEndGuard;
+	rPDSBegin = Snap.rPDSBegin;
+	rPDSEnd = Snap.rPDSEnd;
+	rLevel = Snap.rLevel;
+	iNumber = Snap.iNumber;
+	llTime = Snap.llTime;
+
+	return *this;
+}
+
+_REAL CDisplaySnapshot::GetAgeMs() const
+{
+	if (iNumber == 0)
+		return (_REAL) -1.0;
+
+	return (_REAL) (std::chrono::duration_cast<std::chrono::nanoseconds>(
+		std::chrono::steady_clock::now().time_since_epoch()).count() - llTime) / 1000000;
+}
+
+template<class T> void CDisplaySnapshot::CopyVector(CVector<T>& vecOut, const CVector<T>& vecIn)
+{
+	/* Init() keeps the memory of the vector if the size does not change */
+	const int iSize = vecIn.Size();
+
+	if (vecOut.Size() != iSize)
+		vecOut.Init(iSize);
+
+	for (int i = 0; i < iSize; i++)
+		vecOut[i] = vecIn[i];
+}
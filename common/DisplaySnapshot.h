@@ -0,0 +1,140 @@
+/******************************************************************************\
+ * Copyright (c) 2024
+ *
+ * Author(s):
+ *	EasyDRF developers
+ *
+ * Description:
+ *	See DisplaySnapshot.cpp
+ *
+ ******************************************************************************
+ *
+ * This program is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation; either version 2 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ *
+\******************************************************************************/
+
+#if !defined(DISPLAYSNAPSHOT_H__3B0UBVE98732KJVEW363D1SPSNAP__INCLUDED_)
+#define DISPLAYSNAPSHOT_H__3B0UBVE98732KJVEW363D1SPSNAP__INCLUDED_
+
+#include <atomic>
+#include <mutex>
+#include "GlobalDefinitions.h"
+#include "Vector.h"
+
+
+/* Definitions ****************************************************************/
+/* Default number of snapshots per second, 0 switches the publishing off */
+#define DISPLAY_SNAPSHOT_RATE		10
+
+/* Index of the middle slot of the triple buffer and the flag that the writer
+   has put a new snapshot there */
+#define TRIPLE_BUF_INDEX			3
+#define TRIPLE_BUF_FRESH			4
+
+
+/* Classes ********************************************************************/
+/* Display products of one receiver, made by the receive thread */
+class CDisplaySnapshot
+{
+public:
+	CDisplaySnapshot() : rLowerBound((_REAL) 0.0), rHigherBound((_REAL) 0.0),
+		rStartGuard((_REAL) 0.0), rEndGuard((_REAL) 0.0), rPDSBegin((_REAL) 0.0),
+		rPDSEnd((_REAL) 0.0), rLevel((_REAL) 0.0), iNumber(0), llTime(0) {}
+	CDisplaySnapshot(const CDisplaySnapshot& Snap) : iNumber(0), llTime(0)
+		{*this = Snap;}
+	virtual ~CDisplaySnapshot() {}
+
+	/* Keeps the memory of the vectors if the sizes do not change */
+	CDisplaySnapshot& operator=(const CDisplaySnapshot& Snap);
+
+	/* Age of the snapshot in ms, -1 if there is none yet */
+	_REAL						GetAgeMs() const;
+
+	CVector<_REAL>				vecrInputSpec;
+	CVector<_REAL>				vecrPSD; /* shifted PSD of the OFDM demodulator */
+
+	CVector<_REAL>				vecrTransFct;
+	CVector<_REAL>				vecrGroupDelay;
+
+	CVector<_REAL>				vecrImpResp;
+	CVector<_REAL>				vecrImpRespScale;
+	_REAL						rLowerBound, rHigherBound;
+	_REAL						rStartGuard, rEndGuard;
+	_REAL						rPDSBegin, rPDSEnd;
+
+	CVector<_COMPLEX>			veccFACVectorSpace;
+	CVector<_COMPLEX>			veccMSCVectorSpace;
+
+	_REAL						rLevel;
+
+	/* Counts the snapshots of the receiver, 0: nothing published yet */
+	int							iNumber;
+	long long					llTime; /* steady clock, ns */
+
+protected:
+	template<class T> static void CopyVector(CVector<T>& vecOut, const CVector<T>& vecIn);
+};
+
+/* One writer and any number of readers, the writer never waits. It fills the
+   back slot and swaps it with the middle slot, a reader takes the middle slot
+   for its front slot if it is newer. The readers only wait for each other */
+template<class T> class CTripleBuffer
+{
+public:
+	CTripleBuffer() : iBack(0), iMiddle(1), iFront(2), llNumWaits(0) {}
+	virtual ~CTripleBuffer() {}
+
+	/* Writer */
+	T&			GetWriteSlot() {return Slot[iBack];}
+	void		Publish()
+	{
+		iBack = iMiddle.exchange(iBack | TRIPLE_BUF_FRESH,
+			std::memory_order_acq_rel) & TRIPLE_BUF_INDEX;
+	}
+
+	/* Reader, copies the latest slot. A reader which finds another one
+	   copying is counted */
+	void		Read(T& Copy)
+	{
+		std::unique_lock<std::mutex> Lock(ReadMutex, std::try_to_lock);
+
+		if (!Lock.owns_lock())
+		{
+			llNumWaits.fetch_add(1, std::memory_order_relaxed);
+			Lock.lock();
+		}
+
+		if ((iMiddle.load(std::memory_order_relaxed) & TRIPLE_BUF_FRESH) != 0)
+		{
+			iFront = iMiddle.exchange(iFront,
+				std::memory_order_acq_rel) & TRIPLE_BUF_INDEX;
+		}
+
+		Copy = Slot[iFront];
+	}
+
+	long long	GetNumWaits() {return llNumWaits.load(std::memory_order_relaxed);}
+
+protected:
+	T					Slot[3];
+	int					iBack; /* writer only */
+	std::atomic<int>	iMiddle;
+	int					iFront; /* readers only */
+	std::mutex			ReadMutex;
+	std::atomic<long long>	llNumWaits;
+};
+
+
+#endif // !defined(DISPLAYSNAPSHOT_H__3B0UBVE98732KJVEW363D1SPSNAP__INCLUDED_)
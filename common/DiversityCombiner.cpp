@@ -0,0 +1,194 @@
+/******************************************************************************\
+ * Copyright (c) 2024
+ *
+ * Author(s):
+ *	EasyDRF developers
+ *
+ * Description:
+ *	Diversity reception with two antennas and two receivers
+ *
+ *	Each receiver equalises its own input, "rChan" of a cell is the channel
+ *	power |H|^2. Divided by the noise power of that input, it is the SNR of
+ *	the cell, which is the weight for maximum-ratio combining. The combined
+ *	cell gets the sum of both SNRs (in the units of the main receiver), so
+ *	the soft decisions of the MLC decoder see the better quality
+ *
+ ******************************************************************************
+ *
+ * This program is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation; either version 2 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ *
+\******************************************************************************/
+
+#include "DiversityCombiner.h"
+
+
+/* Implementation *************************************************************/
+void CDiversityCombiner::Reset()
+{
+	std::lock_guard<std::mutex> Lock(Mutex);
+
+	for (int i = 0; i < DIV_MAX_SYMBOLS; i++)
+	{
+		Slot[i].bValid = FALSE;
+		Slot[i].LastPass = Slot[i].PrevPass = std::chrono::steady_clock::time_point();
+	}
+
+	bSynced[DIV_MAIN] = bSynced[DIV_AUX] = FALSE;
+	rSNR[DIV_MAIN] = rSNR[DIV_AUX] = (_REAL) 1.0;
+
+	iNumSymbols = 0;
+	iNumCombined = 0;
+}
+
+void CDiversityCombiner::SetState(const int iRole, const _BOOLEAN bNewSynced, const _REAL rNewSNR)
+{
+	std::lock_guard<std::mutex> Lock(Mutex);
+
+	bSynced[iRole] = bNewSynced;
+	rSNR[iRole] = rNewSNR;
+}
+
+void CDiversityCombiner::GetStatistics(int& iSymbols, int& iCombined)
+{
+	std::lock_guard<std::mutex> Lock(Mutex);
+
+	iSymbols = iNumSymbols;
+	iCombined = iNumCombined;
+}
+
+void CDiversityCombiner::Publish(const int iSymbolAbs, CVectorEx<CEquSig>& vecIn, const int iNumCar)
+{
+	if ((iSymbolAbs < 0) || (iSymbolAbs >= DIV_MAX_SYMBOLS))
+		return;
+
+	std::lock_guard<std::mutex> Lock(Mutex);
+
+	/* Cells of a receiver without signal would only add noise */
+	if (bSynced[DIV_AUX] == FALSE)
+		return;
+
+	CSlot& CurSlot = Slot[iSymbolAbs];
+
+	if (CurSlot.vecCells.Size() < iNumCar)
+		CurSlot.vecCells.Init(iNumCar);
+
+	for (int i = 0; i < iNumCar; i++)
+		CurSlot.vecCells[i] = vecIn[i];
+
+	CurSlot.iNumCar = iNumCar;
+	CurSlot.Time = std::chrono::steady_clock::now();
+	CurSlot.bValid = TRUE;
+}
+
+_BOOLEAN CDiversityCombiner::IsReady(const int iSymbolAbs, const int iNumCar,
+	const std::chrono::steady_clock::time_point Now)
+{
+	const CSlot& CurSlot = Slot[iSymbolAbs];
+
+	if ((CurSlot.bValid == FALSE) || (CurSlot.iNumCar != iNumCar) ||
+		(Now - CurSlot.Time >= std::chrono::milliseconds(DIV_MAX_AGE_MS)))
+	{
+		return FALSE;
+	}
+
+	/* Cells which came shortly after the last pass of the main receiver
+	   were too late for it, they belong to the last super frame. Faster
+	   than real time (loopback simulation) they would still be young
+	   enough */
+	if (CurSlot.PrevPass != std::chrono::steady_clock::time_point())
+	{
+		return (CurSlot.Time - CurSlot.LastPass >
+			(CurSlot.LastPass - CurSlot.PrevPass) / 2);
+	}
+
+	return (CurSlot.Time > CurSlot.LastPass);
+}
+
+_REAL CDiversityCombiner::GetNoise(const CEquSig* pCells, const int iNumCar, const _REAL rSNR)
+{
+	/* Average signal power of this symbol divided by the SNR */
+	_REAL rSignal = (_REAL) 0.0;
+
+	for (int i = 0; i < iNumCar; i++)
+		rSignal += pCells[i].rChan;
+
+	rSignal /= iNumCar;
+
+	if ((rSignal <= (_REAL) 0.0) || (rSNR <= (_REAL) 0.0))
+		return (_REAL) 0.0;
+
+	return rSignal / rSNR;
+}
+
+_BOOLEAN CDiversityCombiner::Combine(const int iSymbolAbs, CVectorEx<CEquSig>& vecInOut, const int iNumCar)
+{
+	if ((iSymbolAbs < 0) || (iSymbolAbs >= DIV_MAX_SYMBOLS))
+		return FALSE;
+
+	std::lock_guard<std::mutex> Lock(Mutex);
+
+	iNumSymbols++;
+
+	const std::chrono::steady_clock::time_point Now = std::chrono::steady_clock::now();
+	const _BOOLEAN bReady = IsReady(iSymbolAbs, iNumCar, Now);
+
+	Slot[iSymbolAbs].PrevPass = Slot[iSymbolAbs].LastPass;
+	Slot[iSymbolAbs].LastPass = Now;
+
+	if ((bSynced[DIV_MAIN] == FALSE) || (bSynced[DIV_AUX] == FALSE))
+	{
+		/* The slot is not taken a super frame later. Faster than real time
+		   (loopback simulation) it would still be young enough */
+		Slot[iSymbolAbs].bValid = FALSE;
+
+		return FALSE;
+	}
+
+	/* Only the cells which are already there are taken, the demodulation
+	   of this receiver must not depend on the timing of the other one */
+	if (bReady == FALSE)
+	{
+		Slot[iSymbolAbs].bValid = FALSE;
+
+		return FALSE;
+	}
+
+	CSlot& CurSlot = Slot[iSymbolAbs];
+	CurSlot.bValid = FALSE;
+
+	const _REAL rNoiseMain = GetNoise(&vecInOut[0], iNumCar, rSNR[DIV_MAIN]);
+	const _REAL rNoiseAux = GetNoise(&CurSlot.vecCells[0], iNumCar, rSNR[DIV_AUX]);
+
+	if ((rNoiseMain <= (_REAL) 0.0) || (rNoiseAux <= (_REAL) 0.0))
+		return FALSE;
+
+	for (int i = 0; i < iNumCar; i++)
+	{
+		const _REAL rWeightMain = vecInOut[i].rChan / rNoiseMain;
+		const _REAL rWeightAux = CurSlot.vecCells[i].rChan / rNoiseAux;
+		const _REAL rWeightSum = rWeightMain + rWeightAux;
+
+		if (rWeightSum > (_REAL) 0.0)
+		{
+			vecInOut[i].cSig = (rWeightMain * vecInOut[i].cSig +
+				rWeightAux * CurSlot.vecCells[i].cSig) / rWeightSum;
+			vecInOut[i].rChan = rWeightSum * rNoiseMain;
+		}
+	}
+
+	iNumCombined++;
+
+	return TRUE;
+}
@@ -0,0 +1,112 @@
+/******************************************************************************\
+ * Copyright (c) 2024
+ *
+ * Author(s):
+ *	EasyDRF developers
+ *
+ * Description:
+ *	See DiversityCombiner.cpp
+ *
+ ******************************************************************************
+ *
+ * This program is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation; either version 2 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ *
+\******************************************************************************/
+
+#if !defined(DIVERSITYCOMBINER_H__3B0UBVE98732KJVEW363D1VERS1TY__INCLUDED_)
+#define DIVERSITYCOMBINER_H__3B0UBVE98732KJVEW363D1VERS1TY__INCLUDED_
+
+#include <mutex>
+#include <chrono>
+#include "GlobalDefinitions.h"
+#include "Vector.h"
+
+
+/* Definitions ****************************************************************/
+/* Number of OFDM symbols in the longest super frame (robustness mode E) */
+#define DIV_MAX_SYMBOLS				(NUM_FRAMES_IN_SUPERFRAME * RME_NUM_SYM_PER_FRAME)
+
+/* A symbol of the second receiver is only combined if it is not older than
+   this (well below the duration of a super frame, so that the same symbol of
+   the last super frame is never taken) */
+#define DIV_MAX_AGE_MS				300
+
+/* Receiver roles */
+#define DIV_MAIN					0
+#define DIV_AUX						1
+
+
+/* Classes ********************************************************************/
+/* Maximum-ratio combining of the equalised cells of two receivers which get
+   the same signal from different antennas. The second receiver hands over
+   each symbol after the channel estimation, the main receiver combines it
+   with its own one before the cells are demapped, so that FAC and MSC are
+   decoded from the combined cells. The main receiver never waits, a symbol
+   which the second receiver has not delivered yet is decoded alone */
+class CDiversityCombiner
+{
+public:
+	CDiversityCombiner() {Reset();}
+	virtual ~CDiversityCombiner() {}
+
+	void		Reset();
+
+	/* Called by each receiver after the FAC, only synchronised receivers are
+	   combined. "rNewSNR" is linear */
+	void		SetState(const int iRole, const _BOOLEAN bNewSynced, const _REAL rNewSNR);
+
+	/* "iSymbolAbs" is the position of the symbol in the super frame.
+	   "Combine()" returns FALSE if the cells of the second receiver are not
+	   there (yet) */
+	void		Publish(const int iSymbolAbs, CVectorEx<CEquSig>& vecIn, const int iNumCar);
+	_BOOLEAN	Combine(const int iSymbolAbs, CVectorEx<CEquSig>& vecInOut, const int iNumCar);
+
+	/* Number of symbols of the main receiver and how many of them were
+	   combined */
+	void		GetStatistics(int& iSymbols, int& iCombined);
+
+protected:
+	class CSlot
+	{
+	public:
+		CSlot() : iNumCar(0), bValid(FALSE) {}
+
+		CVector<CEquSig>						vecCells;
+		int										iNumCar;
+		std::chrono::steady_clock::time_point	Time;
+		_BOOLEAN								bValid;
+
+		/* The last two times the main receiver came to this symbol, the
+		   difference is the duration of a super frame */
+		std::chrono::steady_clock::time_point	LastPass;
+		std::chrono::steady_clock::time_point	PrevPass;
+	};
+
+	_BOOLEAN	IsReady(const int iSymbolAbs, const int iNumCar,
+					const std::chrono::steady_clock::time_point Now);
+	_REAL		GetNoise(const CEquSig* pCells, const int iNumCar, const _REAL rSNR);
+
+	CSlot					Slot[DIV_MAX_SYMBOLS];
+	_BOOLEAN				bSynced[2];
+	_REAL					rSNR[2];
+
+	int						iNumSymbols;
+	int						iNumCombined;
+
+	std::mutex				Mutex;
+};
+
+
+#endif // !defined(DIVERSITYCOMBINER_H__3B0UBVE98732KJVEW363D1VERS1TY__INCLUDED_)
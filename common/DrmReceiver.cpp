@@ -31,9 +31,9 @@
 \******************************************************************************/
 
 #include "DrmReceiver.h"
+#include "EventQueue.h"
 
 BOOL DoNotRec = TRUE;
-BOOL isfirstrx = FALSE;
 
 /* Implementation *************************************************************/
 void CDRMReceiver::Run()
@@ -47,19 +47,21 @@ void CDRMReceiver::Run()
 	{
 		if (DoNotRec)
 		{
-			isfirstrx = TRUE;
+			bIsFirstRx = TRUE;
 			Sleep(500);
 		}
 		else
 		{
+			/* The temporaries of this pass come from the frame arena */
+			CFrameScope FrameScope(FrameArena);
 
 			/* Check for parameter changes from GUI thread ---------------------- */
 			/* The parameter changes are done through flags, the actual
 			   initialization is done in this (the working) thread to avoid
 			   problems with shared data */
-			if (isfirstrx)
+			if (bIsFirstRx)
 				InitReceiverMode();
-			isfirstrx = FALSE;
+			bIsFirstRx = FALSE;
 
 			if (eNewReceiverMode != RM_NONE)
 				InitReceiverMode();
@@ -68,6 +70,9 @@ void CDRMReceiver::Run()
 			/* Receive data ----------------------------------------------------- */
 			ReceiveData.ReadData(ReceiverParam, RecDataBuf);
 
+			/* Display products for the GUI ----------------------------- */
+			PublishDisplay();
+
 			bEnoughData = TRUE;
 
 			while (bEnoughData && ReceiverParam.bRunThread)
@@ -157,6 +162,14 @@ void CDRMReceiver::Run()
 
 						/* Use information of FAC CRC for detecting the acquisition requirement */
 						DetectAcquiFAC();
+
+						/* Only receivers which have the signal are combined */
+						if (pDiversity != NULL)
+						{
+							pDiversity->SetState(iDiversityRole,
+								eAcquiState == AS_WITH_SIGNAL,
+								pow((_REAL) 10.0, ChannelEstimation.GetSNREstdB() / 10));
+						}
 					}
 
 					/* MSC ------------------------------------------------------ */
@@ -179,9 +192,12 @@ void CDRMReceiver::Run()
 						bEnoughData = TRUE;
 					}
 
-					/* Data decoding */
+					/* Data decoding. The MOT objects are allocated as they
+					   come, the benchmark does not count them */
+					iHeapCountPause++;
 					if (DataDecoder.WriteData(ReceiverParam, MSCDeMUXBufData))
 						bEnoughData = TRUE;
+					iHeapCountPause--;
 
 					/* Source decoding (audio) */
 					if (AudioSourceDecoder.ProcessData(ReceiverParam, MSCDeMUXBufAud, AudSoDecBuf))
@@ -198,6 +214,52 @@ void CDRMReceiver::Run()
 	} while (ReceiverParam.bRunThread && (!bDoInitRun));
 }
 
+void CDRMReceiver::PublishDisplay()
+{
+	if ((iDisplayRate <= 0) || bDoInitRun)
+		return;
+
+	/* The rate refers to the received samples, one symbol per call */
+	iDisplaySamples += ReceiverParam.iSymbolBlockSize;
+	if (iDisplaySamples < SOUNDCRD_SAMPLE_RATE / iDisplayRate)
+		return;
+
+	iDisplaySamples = 0;
+
+#if USE_MODUL_STATS
+	/* Shown in the module statistics like a processing module */
+	if (pDisplayStat == NULL)
+		pDisplayStat = ModulStats.Register("CDisplaySnapshot");
+
+	const std::chrono::steady_clock::time_point Start = std::chrono::steady_clock::now();
+#endif
+
+	/* All modules are between two calls, the data is consistent */
+	CDisplaySnapshot& Snap = DisplayBuf.GetWriteSlot();
+
+	ReceiveData.GetInputSpec(Snap.vecrInputSpec);
+	OFDMDemodulation.GetPowDenSpec(Snap.vecrPSD);
+	ChannelEstimation.GetTransferFunction(Snap.vecrTransFct, Snap.vecrGroupDelay);
+	ChannelEstimation.GetAvPoDeSp(Snap.vecrImpResp, Snap.vecrImpRespScale,
+		Snap.rLowerBound, Snap.rHigherBound, Snap.rStartGuard, Snap.rEndGuard,
+		Snap.rPDSBegin, Snap.rPDSEnd);
+	FACMLCDecoder.GetVectorSpace(Snap.veccFACVectorSpace);
+	MSCMLCDecoder.GetVectorSpace(Snap.veccMSCVectorSpace);
+	Snap.rLevel = ReceiveData.GetLevelMeter();
+
+	Snap.iNumber = ++iDisplayNum;
+	Snap.llTime = std::chrono::duration_cast<std::chrono::nanoseconds>(
+		std::chrono::steady_clock::now().time_since_epoch()).count();
+
+	DisplayBuf.Publish();
+
+#if USE_MODUL_STATS
+	pDisplayStat->Add(std::chrono::duration_cast<std::chrono::nanoseconds>(
+		std::chrono::steady_clock::now() - Start).count(),
+		0, 0, -1);
+#endif
+}
+
 void CDRMReceiver::DetectAcquiSymbol()
 {
 
@@ -243,6 +305,9 @@ void CDRMReceiver::DetectAcquiFAC()
 		   successive FAC blocks "ok" if no good signal is received */
 		if (iGoodSignCnt > 0)
 		{
+			if (eAcquiState != AS_WITH_SIGNAL)
+				EventQueue.Post(EV_ACQ_STATE, 1);
+
 			eAcquiState = AS_WITH_SIGNAL;
 
 			/* Take care of delayed tracking mode switch */
@@ -322,6 +387,9 @@ void CDRMReceiver::Stop()
 	try
 	{
 		SoundInterface.Close();
+
+		if (ReceiveData.GetSoundInterface() != &SoundInterface)
+			ReceiveData.GetSoundInterface()->Close();
 	}
 	catch (CGenErr GenErr)
 	{
@@ -333,6 +401,10 @@ void CDRMReceiver::SetInStartMode()
 	/* Load start parameters for all modules */
 	StartParameters(ReceiverParam);
 
+	/* The cells are not usable for diversity until the FAC is good again */
+	if (pDiversity != NULL)
+		pDiversity->SetState(iDiversityRole, FALSE, (_REAL) 1.0);
+
 	/* Activate acquisition */
 	FreqSyncAcq.StartAcquisition();
 	TimeSync.StartAcquisition();
@@ -344,6 +416,15 @@ void CDRMReceiver::SetInStartMode()
 	SyncUsingPil.StopTrackPil();
 
 	/* Set flag that no signal is currently received */
+	if (eAcquiState == AS_WITH_SIGNAL)
+	{
+		EventQueue.Post(EV_ACQ_STATE, 0);
+
+		/* The object which was received last stays incomplete */
+		if (DataDecoder.HasSlideShowPartPicture() == TRUE)
+			EventQueue.Post(EV_FILE_CORRUPT);
+	}
+
 	eAcquiState = AS_NO_SIGNAL;
 
 	/* Set flag for receiver state */
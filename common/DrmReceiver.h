@@ -47,6 +47,8 @@
 #include "sync/FreqSyncAcq.h"
 #include "sync/TimeSync.h"
 #include "sync/SyncUsingPil.h"
+#include "DisplaySnapshot.h"
+#include "FrameArena.h"
 #include "../sound/sound.h"
 
 
@@ -84,7 +86,10 @@ public:
 		iGoodSignCnt(0), bWasFreqAcqu(TRUE), bDoInitRun(FALSE),
 		eReceiverMode(RM_DRM), 	eNewReceiverMode(RM_NONE),
 		ReceiveData(&SoundInterface), WriteData(&SoundInterface),
-		rInitResampleOffset((_REAL) 0.0) {}
+		rInitResampleOffset((_REAL) 0.0), bIsFirstRx(FALSE),
+		pDiversity(NULL), iDiversityRole(DIV_MAIN),
+		iDisplayRate(DISPLAY_SNAPSHOT_RATE), iDisplaySamples(0), iDisplayNum(0),
+		pDisplayStat(NULL) {ReceiverParam.SetReceiver(this);}
 	virtual ~CDRMReceiver() {}
 
 	/* For GUI */
@@ -125,6 +130,31 @@ public:
 							{FreqSyncAcq.SetSearchWindow(rNewCenterFreq,rNewWinSize); }
 	void					SetFastReset(_BOOLEAN bisfast) { bDoFastReset = bisfast; }
 
+	/* Diversity reception with a second receiver, NULL switches it off */
+	void					SetDiversity(CDiversityCombiner* pNewDiv, const int iNewRole)
+							{pDiversity = pNewDiv; iDiversityRole = iNewRole;
+							 OFDMCellDemapping.SetDiversity(pNewDiv, iNewRole);}
+
+	/* Audio backend for the modem input, NULL selects the sound card. The
+	   decoded audio always goes to the sound card */
+	void					SetSoundBackend(CSoundInterface* pNewBackend)
+							{ReceiveData.SetSoundInterface(pNewBackend != NULL ? pNewBackend : &SoundInterface);}
+
+	/* Display products, see DisplaySnapshot.cpp. The rate is in snapshots
+	   per second, 0 switches them off */
+	void					SetDisplayRate(const int iNewRate)
+								{iDisplayRate = iNewRate;}
+	int						GetDisplayRate() {return iDisplayRate;}
+	void					GetDisplay(CDisplaySnapshot& Snap)
+								{DisplayBuf.Read(Snap);}
+	long long				GetDisplayWaits() {return DisplayBuf.GetNumWaits();}
+
+	/* Spectral lines of the input, see Stft.h. Callable from every thread */
+	CStft&					GetStft() {return ReceiveData.GetStft();}
+
+	/* Only for statistics of the receive thread */
+	CFrameArena*			GetFrameArena() {return &FrameArena;}
+
 	void					InitsForAllModules();
 
 	void					InitsForWaveMode();
@@ -146,6 +176,11 @@ protected:
 	void					DetectAcquiFAC();
 	void					DetectAcquiSymbol();
 	void					InitReceiverMode();
+	void					PublishDisplay();
+
+	/* Temporaries of the receive thread. Before the modules, it must be
+	   destroyed after them */
+	CFrameArena				FrameArena;
 
 	/* Modules */
 	CReceiveData			ReceiveData;
@@ -198,9 +233,20 @@ protected:
 
 	_BOOLEAN				bWasFreqAcqu;
 	_BOOLEAN				bDoInitRun;
+	_BOOLEAN				bIsFirstRx;
 	_BOOLEAN				bDoFastReset;
 
 	_REAL					rInitResampleOffset;
+
+	CDiversityCombiner*		pDiversity;
+	int						iDiversityRole;
+
+	/* Display products */
+	CTripleBuffer<CDisplaySnapshot>	DisplayBuf;
+	int						iDisplayRate;
+	int						iDisplaySamples;
+	int						iDisplayNum;
+	CModulStat*				pDisplayStat;
 };
 
 
@@ -0,0 +1,1128 @@
+/******************************************************************************\
+ * Copyright (c) 2024
+ *
+ * Author(s):
+ *	EasyDRF developers
+ *
+ * Description:
+ *	Loopback simulation of transmitter, HF channel and receiver
+ *
+ *	The transmitter and the receiver run in one thread without sound card.
+ *	The receiver asks the link for samples, the link lets the transmitter
+ *	generate frames and sends them through the channel simulator. Each point
+ *	of the benchmark sends a few files of random data and counts the FAC and
+ *	MSC CRC results and the files which arrive unchanged. The time for
+ *	generating the signal is measured separately, so the report shows how
+ *	much CPU the receiver needs for one second of signal. The diversity
+ *	points add a second receiver in its own thread, which gets the signal
+ *	through a second channel with independent fading
+ *
+ ******************************************************************************
+ *
+ * This program is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation; either version 2 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ *
+\******************************************************************************/
+
+#include "DrmSimulation.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <new>
+#include <random>
+#include <windows.h>
+#include <psapi.h>
+#include "callsign2.h"
+#include "ModulStats.h"
+#include "../RS-defs.h"
+
+
+/* Implementation *************************************************************/
+#if SIM_COUNT_HEAP
+/* Allocations of each thread, the benchmark reports those of the receive
+   thread in the steady state. The signal is generated in the same thread,
+   its allocations are counted on their own */
+static thread_local long long llSimHeapAllocs = 0;
+static thread_local long long llSimHeapAllocsTx = 0;
+static thread_local _BOOLEAN bSimHeapTx = FALSE;
+
+void* operator new(size_t iSize)
+{
+	if (iHeapCountPause == 0)
+	{
+		if (bSimHeapTx == TRUE)
+			llSimHeapAllocsTx++;
+		else
+			llSimHeapAllocs++;
+	}
+
+	void* pMem = malloc((iSize == 0) ? 1 : iSize);
+	if (pMem == NULL)
+		throw std::bad_alloc();
+
+	return pMem;
+}
+
+void operator delete(void* pMem) noexcept
+{
+	free(pMem);
+}
+
+static long long GetNumHeapAllocs() {return llSimHeapAllocs;}
+static long long GetNumHeapAllocsTx() {return llSimHeapAllocsTx;}
+static void SetHeapCountTx(const _BOOLEAN bTx) {bSimHeapTx = bTx;}
+#else
+static long long GetNumHeapAllocs() {return 0;}
+static long long GetNumHeapAllocsTx() {return 0;}
+static void SetHeapCountTx(const _BOOLEAN) {}
+#endif
+
+
+/******************************************************************************\
+* Link                                                                         *
+\******************************************************************************/
+void CSimLink::Reset(CDRMSimulation* pNewSimulation, CSimAuxLink* pNewAuxLink)
+{
+	pSimulation = pNewSimulation;
+	pAuxLink = pNewAuxLink;
+
+	vecsFifo.clear();
+	iReadPos = 0;
+	iNumSamples = 0;
+	iNumGenerated = 0;
+	bFromFifo = FALSE;
+}
+
+void CSimLink::InitRecording(int iNewBufferSize, _BOOLEAN)
+{
+	iBlockSize = iNewBufferSize;
+	vecsZero.Init(iBlockSize, 0);
+}
+
+_BOOLEAN CSimLink::ReadBlock(const _SAMPLE*& psData)
+{
+	/* Let the transmitter work until there are enough samples */
+	while ((int) vecsFifo.size() - iReadPos < iBlockSize)
+	{
+		if (pSimulation->Generate() == FALSE)
+		{
+			/* End of the point, the receiver leaves its loop after this
+			   block */
+			psData = &vecsZero[0];
+			bFromFifo = FALSE;
+
+			return FALSE;
+		}
+	}
+
+	psData = &vecsFifo[iReadPos];
+	bFromFifo = TRUE;
+
+	return FALSE;
+}
+
+void CSimLink::ReleaseBlock()
+{
+	if (bFromFifo == FALSE)
+		return;
+
+	iReadPos += iBlockSize;
+	iNumSamples += iBlockSize;
+	bFromFifo = FALSE;
+
+	if (iReadPos >= SIM_FIFO_COMPACT)
+	{
+		vecsFifo.erase(vecsFifo.begin(), vecsFifo.begin() + iReadPos);
+		iReadPos = 0;
+	}
+}
+
+_BOOLEAN CSimLink::Write(CVector<short>& psData)
+{
+	/* Both channels of the transmitter carry the same signal, the right one
+	   goes to the second antenna. The channels and the FIFOs of the links
+	   are not part of the transmitter, their growth is not counted */
+	iHeapCountPause++;
+
+	Channel.Process(&psData[0], 2, psData.Size() / 2, vecsFifo);
+	iNumGenerated += psData.Size() / 2;
+
+	if (pAuxLink != NULL)
+		pAuxLink->Put(&psData[1], 2, psData.Size() / 2);
+
+	iHeapCountPause--;
+
+	return FALSE;
+}
+
+
+/******************************************************************************\
+* Link of the second antenna                                                   *
+\******************************************************************************/
+void CSimAuxLink::Reset(CDRMReceiver* pNewReceiver)
+{
+	std::lock_guard<std::mutex> Lock(Mutex);
+
+	pReceiver = pNewReceiver;
+	vecsFifo.clear();
+	iReadPos = 0;
+	bEnd = FALSE;
+}
+
+void CSimAuxLink::Put(const short* psData, const int iStride, const int iLen)
+{
+	/* The channel is only used in this thread */
+	vecsChanOut.clear();
+	Channel.Process(psData, iStride, iLen, vecsChanOut);
+
+	std::lock_guard<std::mutex> Lock(Mutex);
+
+	vecsFifo.insert(vecsFifo.end(), vecsChanOut.begin(), vecsChanOut.end());
+	Cond.notify_all();
+}
+
+void CSimAuxLink::Finish()
+{
+	std::lock_guard<std::mutex> Lock(Mutex);
+
+	bEnd = TRUE;
+	Cond.notify_all();
+}
+
+void CSimAuxLink::InitRecording(int iNewBufferSize, _BOOLEAN)
+{
+	std::lock_guard<std::mutex> Lock(Mutex);
+
+	iBlockSize = iNewBufferSize;
+	vecsBlock.Init(iBlockSize, 0);
+}
+
+_BOOLEAN CSimAuxLink::ReadBlock(const _SAMPLE*& psData)
+{
+	std::unique_lock<std::mutex> Lock(Mutex);
+
+	while (((int) vecsFifo.size() - iReadPos < iBlockSize) && (bEnd == FALSE))
+		Cond.wait(Lock);
+
+	psData = &vecsBlock[0];
+
+	if ((int) vecsFifo.size() - iReadPos < iBlockSize)
+	{
+		/* End of the point. The flag is cleared in the thread of the
+		   receiver, "Start()" sets it there */
+		for (int i = 0; i < iBlockSize; i++)
+			vecsBlock[i] = 0;
+
+		if (pReceiver != NULL)
+			pReceiver->GetParameters()->bRunThread = FALSE;
+
+		return FALSE;
+	}
+
+	for (int i = 0; i < iBlockSize; i++)
+		vecsBlock[i] = vecsFifo[iReadPos + i];
+
+	iReadPos += iBlockSize;
+
+	if (iReadPos >= SIM_FIFO_COMPACT)
+	{
+		vecsFifo.erase(vecsFifo.begin(), vecsFifo.begin() + iReadPos);
+		iReadPos = 0;
+	}
+
+	return FALSE;
+}
+
+
+/******************************************************************************\
+* Benchmark                                                                    *
+\******************************************************************************/
+void CDRMSimulation::MakeDefaultPlan(std::vector<CSimPoint>& vecPlan)
+{
+	const ERobMode eModes[] = {RM_ROBUSTNESS_MODE_A, RM_ROBUSTNESS_MODE_B, RM_ROBUSTNESS_MODE_E};
+	const CParameter::ECodScheme eQAMs[] = {CParameter::CS_1_SM, CParameter::CS_2_SM, CParameter::CS_3_SM};
+	const int iRSLevels[] = {0, 2, 4};
+	const EChanProfile eProfiles[] = {CP_AWGN, CP_CCIR_MODERATE};
+
+	vecPlan.clear();
+
+	for (int iMode = 0; iMode < 3; iMode++)
+	{
+		for (int iQAM = 0; iQAM < 3; iQAM++)
+		{
+			for (int iRS = 0; iRS < 3; iRS++)
+			{
+				for (int iProf = 0; iProf < 2; iProf++)
+				{
+					for (int iSNR = 0; iSNR <= 24; iSNR += 4)
+					{
+						CSimPoint Point;
+
+						Point.eRobMode = eModes[iMode];
+						Point.eCodScheme = eQAMs[iQAM];
+						Point.iRSLevel = iRSLevels[iRS];
+						Point.eProfile = eProfiles[iProf];
+						Point.rSNRdB = (_REAL) iSNR;
+
+						/* A real link is never tuned exactly and the sound
+						   cards have different clocks */
+						if (Point.eProfile != CP_AWGN)
+						{
+							Point.rFreqOffset = (_REAL) 5.0;
+							Point.rSampleOffsetPPM = (_REAL) 50.0;
+						}
+
+						vecPlan.push_back(Point);
+					}
+				}
+			}
+		}
+	}
+
+	AddDiversityPoints(vecPlan, 8, 20);
+}
+
+void CDRMSimulation::MakeQuickPlan(std::vector<CSimPoint>& vecPlan)
+{
+	const EChanProfile eProfiles[] = {CP_AWGN, CP_CCIR_MODERATE};
+
+	vecPlan.clear();
+
+	for (int iProf = 0; iProf < 2; iProf++)
+	{
+		for (int iSNR = 6; iSNR <= 24; iSNR += 6)
+		{
+			CSimPoint Point;
+
+			Point.eProfile = eProfiles[iProf];
+			Point.rSNRdB = (_REAL) iSNR;
+
+			if (Point.eProfile != CP_AWGN)
+			{
+				Point.rFreqOffset = (_REAL) 5.0;
+				Point.rSampleOffsetPPM = (_REAL) 50.0;
+			}
+
+			vecPlan.push_back(Point);
+		}
+	}
+
+	AddDiversityPoints(vecPlan, 12, 20);
+}
+
+void CDRMSimulation::AddDiversityPoints(std::vector<CSimPoint>& vecPlan, const int iMinSNR,
+	const int iMaxSNR)
+{
+	for (int iSNR = iMinSNR; iSNR <= iMaxSNR; iSNR += 4)
+	{
+		for (int iAnt = 1; iAnt <= 2; iAnt++)
+		{
+			CSimPoint Point;
+
+			Point.eProfile = CP_CCIR_MODERATE;
+			Point.rSNRdB = (_REAL) iSNR;
+			Point.rFreqOffset = (_REAL) 5.0;
+			Point.rSampleOffsetPPM = (_REAL) 50.0;
+			Point.iNumAntennas = iAnt;
+			Point.iSeed = SIM_DIV_SEED + iSNR;
+
+			vecPlan.push_back(Point);
+		}
+	}
+}
+
+_BOOLEAN CDRMSimulation::Run(const std::vector<CSimPoint>& vecPlan, const string& strReportFile)
+{
+	FILE* pFile = fopen(strReportFile.c_str(), "w");
+	if (pFile == NULL)
+		return FALSE;
+
+	/* File names must differ from earlier runs, the receiver keeps
+	   incomplete objects by their name */
+	iSession = GetTickCount();
+
+	/* The RS decoder saves the files there */
+	CreateDirectory("Rx Files", NULL);
+
+	fprintf(pFile, "Mode\tQAM\tRS\tChannel\tAntennas\tSNR [dB]\tOffset [Hz]\tSCO [ppm]\t"
+		"Signal [s]\tDecode [s]\tRx [ms/s]\tFAC ok\tFrames\tMSC ok\tMSC total\t"
+		"Files ok\tFiles sent\tHeap/frame\tTx heap/frame\tArena misses\tCombined\n");
+	fflush(pFile);
+
+	/* MSC blocks per frame of the diversity points, with one and with two
+	   antennas */
+	_REAL rDivMSC[2] = {(_REAL) 0.0, (_REAL) 0.0};
+	int iNumDivPairs = 0;
+	CSimResult LastRes;
+
+	int iNumHeapFails = 0;
+	int iNumTxHeapFails = 0;
+	int iNumArenaFails = 0;
+
+	for (size_t i = 0; i < vecPlan.size(); i++)
+	{
+		const CSimPoint& Point = vecPlan[i];
+		const CSimResult Res = RunPoint(Point);
+
+		const char* pchModes[] = {"A", "B", "E"};
+		const int iQAMs[] = {4, 16, 64};
+
+		_REAL rMsPerSec = (_REAL) 0.0;
+		if (Res.rSignalTime > (_REAL) 0.0)
+			rMsPerSec = Res.rDecodeTime * 1000 / Res.rSignalTime;
+
+		fprintf(pFile, "%s\t%d\t%d\t%s\t%d\t%.1f\t%.1f\t%.1f\t%.1f\t%.2f\t%.1f\t%d\t%d\t%d\t%d\t%d\t%d\t%.2f\t%.2f\t%lld\t%d\n",
+			pchModes[Point.eRobMode], iQAMs[Point.eCodScheme], Point.iRSLevel,
+			CChannelSimulator::GetProfileName(Point.eProfile), Point.iNumAntennas,
+			Point.rSNRdB, Point.rFreqOffset, Point.rSampleOffsetPPM,
+			Res.rSignalTime, Res.rDecodeTime, rMsPerSec,
+			Res.iFACOk, Res.iNumFrames, Res.iMSCOk, Res.iMSCOk + Res.iMSCBad,
+			Res.iFilesOk, Res.iFilesSent, Res.rHeapPerFrame, Res.rTxHeapPerFrame,
+			Res.llArenaMisses, Res.iDivCombined);
+
+		/* A long run can be watched */
+		fflush(pFile);
+
+		if ((Res.bSteady == TRUE) && (Res.rHeapPerFrame > (_REAL) 0.0))
+			iNumHeapFails++;
+
+		/* The transmitter does not depend on the reception */
+		if (Res.rTxHeapPerFrame > (_REAL) 0.0)
+			iNumTxHeapFails++;
+
+		if (Res.llArenaMisses > 0)
+			iNumArenaFails++;
+
+		/* Two antennas are compared with the point before, which has the
+		   same fading on the first one. The transmissions can end after a
+		   different number of frames */
+		if ((Point.iNumAntennas == 2) && (i > 0) &&
+			(vecPlan[i - 1].iNumAntennas == 1) && (vecPlan[i - 1].iSeed == Point.iSeed) &&
+			(LastRes.iNumFrames > 0) && (Res.iNumFrames > 0))
+		{
+			rDivMSC[0] += (_REAL) LastRes.iMSCOk / LastRes.iNumFrames;
+			rDivMSC[1] += (_REAL) Res.iMSCOk / Res.iNumFrames;
+			iNumDivPairs++;
+		}
+
+		LastRes = Res;
+	}
+
+	/* Signal processing without heap allocations once the receiver is in
+	   sync, all temporaries fit in the frame arenas */
+	_BOOLEAN bHeapOk = TRUE;
+
+	if (SIM_COUNT_HEAP)
+	{
+		bHeapOk = (iNumHeapFails == 0) && (iNumTxHeapFails == 0) &&
+			(iNumArenaFails == 0);
+
+		fprintf(pFile, "\nHeap: %d points allocate in the steady state on receive, "
+			"%d on transmit, %d miss the frame arenas: %s\n", iNumHeapFails,
+			iNumTxHeapFails, iNumArenaFails, (bHeapOk == TRUE) ? "ok" : "FAILED");
+	}
+
+	/* Maximum-ratio combining must gain over one antenna */
+	_BOOLEAN bDivOk = TRUE;
+
+	if (iNumDivPairs > 0)
+	{
+		bDivOk = (rDivMSC[1] > rDivMSC[0]);
+
+		fprintf(pFile, "\nDiversity: %.2f MSC ok per frame with one antenna, "
+			"%.2f with two (mean of %d SNR points): %s\n",
+			rDivMSC[0] / iNumDivPairs, rDivMSC[1] / iNumDivPairs, iNumDivPairs,
+			(bDivOk == TRUE) ? "gain" : "NO GAIN");
+	}
+
+	/* Transmitter without sound card */
+	RunRender(pFile);
+
+	/* Display snapshots for the GUI */
+	RunDisplay(pFile);
+
+	/* Peak memory of the whole run (all points) */
+	PROCESS_MEMORY_COUNTERS MemCounters;
+
+	if (GetProcessMemoryInfo(GetCurrentProcess(), &MemCounters, sizeof(MemCounters)) != 0)
+	{
+		fprintf(pFile, "\nMemory: peak working set %.1f MB, peak private bytes %.1f MB\n",
+			MemCounters.PeakWorkingSetSize / 1048576.0,
+			MemCounters.PeakPagefileUsage / 1048576.0);
+	}
+
+	fclose(pFile);
+
+	return (bHeapOk == TRUE) && (bDivOk == TRUE);
+}
+
+#if USE_FIXED_POINT
+_BOOLEAN CDRMSimulation::RunFixedPoint(const string& strReportFile)
+{
+	const ERobMode eModes[] = {RM_ROBUSTNESS_MODE_A, RM_ROBUSTNESS_MODE_B, RM_ROBUSTNESS_MODE_E};
+	const CParameter::ECodScheme eQAMs[] = {CParameter::CS_1_SM, CParameter::CS_2_SM, CParameter::CS_3_SM};
+	const EChanProfile eProfiles[] = {CP_AWGN, CP_CCIR_MODERATE};
+
+	FILE* pFile = fopen(strReportFile.c_str(), "w");
+	if (pFile == NULL)
+		return FALSE;
+
+	iSession = GetTickCount();
+	CreateDirectory("Rx Files", NULL);
+
+	fprintf(pFile, "Mode\tQAM\tChannel\tFloat [dB]\tFixed [dB]\tLoss [dB]\t"
+		"Float [ms/s]\tFixed [ms/s]\n");
+	fflush(pFile);
+
+	for (int iMode = 0; iMode < 3; iMode++)
+	{
+		for (int iQAM = 0; iQAM < 3; iQAM++)
+		{
+			for (int iProf = 0; iProf < 2; iProf++)
+			{
+				CSimPoint Point;
+
+				Point.eRobMode = eModes[iMode];
+				Point.eCodScheme = eQAMs[iQAM];
+				Point.eProfile = eProfiles[iProf];
+				Point.iSeed = SIM_SENS_SEED;
+
+				if (Point.eProfile != CP_AWGN)
+				{
+					Point.rFreqOffset = (_REAL) 5.0;
+					Point.rSampleOffsetPPM = (_REAL) 50.0;
+				}
+
+				/* Floating-point first, the modules read the switch in
+				   their Init() */
+				_REAL rSNRdB[2], rMsPerSec[2];
+				_BOOLEAN bFound[2];
+
+				for (int iFixed = 0; iFixed < 2; iFixed++)
+				{
+					FixedPointRx = iFixed;
+					bFound[iFixed] = FindSensitivity(Point, rSNRdB[iFixed],
+						rMsPerSec[iFixed]);
+				}
+
+				FixedPointRx = TRUE;
+
+				const char* pchModes[] = {"A", "B", "E"};
+				const int iQAMs[] = {4, 16, 64};
+
+				fprintf(pFile, "%s\t%d\t%s\t", pchModes[Point.eRobMode],
+					iQAMs[Point.eCodScheme],
+					CChannelSimulator::GetProfileName(Point.eProfile));
+
+				for (int i = 0; i < 2; i++)
+				{
+					if (bFound[i] == TRUE)
+						fprintf(pFile, "%.1f\t", rSNRdB[i]);
+					else
+						fprintf(pFile, "-\t");
+				}
+
+				if ((bFound[0] == TRUE) && (bFound[1] == TRUE))
+					fprintf(pFile, "%.1f\t", rSNRdB[1] - rSNRdB[0]);
+				else
+					fprintf(pFile, "-\t");
+
+				fprintf(pFile, "%.1f\t%.1f\n", rMsPerSec[0], rMsPerSec[1]);
+				fflush(pFile);
+			}
+		}
+	}
+
+	fclose(pFile);
+
+	return TRUE;
+}
+
+_BOOLEAN CDRMSimulation::FindSensitivity(CSimPoint Point, _REAL& rSNRdB, _REAL& rMsPerSec)
+{
+	rSNRdB = (_REAL) SIM_SENS_MAX_SNR;
+	rMsPerSec = (_REAL) 0.0;
+
+	for (int iSNR = SIM_SENS_MIN_SNR; iSNR <= SIM_SENS_MAX_SNR; iSNR++)
+	{
+		if (SensitivityOk(Point, (_REAL) iSNR, rMsPerSec) == TRUE)
+		{
+			/* The threshold is between the last failed step and this one,
+			   bisected in steps of the resolution. The lowest SNR of the
+			   sweep has no failed step below */
+			const int iStepsPerDB = (int) (1 / SIM_SENS_RESOLUTION + (_REAL) 0.5);
+			int iLow = (iSNR - 1) * iStepsPerDB;
+			int iHigh = iSNR * iStepsPerDB;
+
+			if (iSNR > SIM_SENS_MIN_SNR)
+			{
+				while (iHigh - iLow > 1)
+				{
+					const int iMid = (iLow + iHigh) / 2;
+					_REAL rMidMsPerSec;
+
+					if (SensitivityOk(Point, (_REAL) iMid / iStepsPerDB,
+						rMidMsPerSec) == TRUE)
+					{
+						iHigh = iMid;
+					}
+					else
+						iLow = iMid;
+				}
+			}
+
+			rSNRdB = (_REAL) iHigh / iStepsPerDB;
+			return TRUE;
+		}
+	}
+
+	return FALSE;
+}
+
+_BOOLEAN CDRMSimulation::SensitivityOk(CSimPoint Point, const _REAL rSNRdB, _REAL& rMsPerSec)
+{
+	Point.rSNRdB = rSNRdB;
+
+	const CSimResult Res = RunPoint(Point);
+
+	if (Res.rSignalTime > (_REAL) 0.0)
+		rMsPerSec = Res.rDecodeTime * 1000 / Res.rSignalTime;
+
+	const int iMSCTotal = Res.iMSCSensOk + Res.iMSCSensBad;
+
+	return (iMSCTotal > 0) && (Res.iMSCSensOk >= SIM_SENS_MSC_OK * iMSCTotal);
+}
+#endif
+
+CSimResult CDRMSimulation::RunPoint(const CSimPoint& Point)
+{
+	LARGE_INTEGER liFreq, liStart, liStop;
+
+	Result = CSimResult();
+	liGenTime.QuadPart = 0;
+	iEndFrame = -1;
+	llHeapStart = -1;
+	llTxHeapStart = 0;
+	iHeapStartFrame = 0;
+	iHeapStartFACBad = 0;
+	llArenaStart = 0;
+	iHeapCountPause = 0;
+
+	pTransmitter = new CDRMTransmitter;
+	pReceiver = new CDRMReceiver;
+
+	if (Point.iNumAntennas > 1)
+		pAuxReceiver = new CDRMReceiver;
+
+	const unsigned int iChanSeed = (Point.iSeed != 0) ? Point.iSeed : iSession + iFileCnt;
+
+	Link.Reset(this, (pAuxReceiver != NULL) ? &AuxLink : NULL);
+	Link.GetChannel()->Init(Point.eProfile, Point.rSNRdB, SIM_BANDWIDTH,
+		Point.rFreqOffset, Point.rSampleOffsetPPM, iChanSeed);
+
+	/* Same sound card for both antennas, only fading and noise differ */
+	AuxLink.Reset(pAuxReceiver);
+	AuxLink.GetChannel()->Init(Point.eProfile, Point.rSNRdB, SIM_BANDWIDTH,
+		Point.rFreqOffset, Point.rSampleOffsetPPM, iChanSeed + SIM_DIV_SEED_ANT2);
+
+	Combiner.Reset();
+
+	try
+	{
+		/* Points with the same channel (diversity pairs) also send the same
+		   data, so that they only differ in the second antenna */
+		MakeFiles((Point.iSeed != 0) ? Point.iSeed : iSession + iFileCnt);
+		SetupTransmitter(Point);
+
+		/* Same receiver setup as a wideband instance */
+		pReceiver->GetParameters()->bOnlyPicture = TRUE;
+		pReceiver->SetSoundBackend(&Link);
+
+		/* Nobody looks at the display, its time would count as decoding.
+		   Display points keep the default rate */
+		if (Point.iDisplayReaders == 0)
+			pReceiver->SetDisplayRate(0);
+
+		if (pAuxReceiver != NULL)
+		{
+			/* Like "StartThreadRXDiversity()", the second receiver works in
+			   its own thread and hands its cells to the main one */
+			pAuxReceiver->GetParameters()->bOnlyPicture = TRUE;
+			pAuxReceiver->SetSoundBackend(&AuxLink);
+			pAuxReceiver->SetDisplayRate(0);
+
+			pReceiver->SetDiversity(&Combiner, DIV_MAIN);
+			pAuxReceiver->SetDiversity(&Combiner, DIV_AUX);
+
+			pAuxReceiver->Init();
+			AuxThread = std::thread(&CDRMSimulation::RunAuxReceiver, this);
+		}
+
+		pReceiver->Init();
+
+		/* GUI threads */
+		bDisplayRun = TRUE;
+		for (int i = 0; i < Point.iDisplayReaders; i++)
+			vecDisplayThreads.push_back(std::thread(&CDRMSimulation::RunDisplayReader, this));
+
+		/* The receiver runs in this thread until the link ends the point */
+		pMessageSink = this;
+
+		QueryPerformanceFrequency(&liFreq);
+		QueryPerformanceCounter(&liStart);
+
+		pReceiver->Start();
+
+		QueryPerformanceCounter(&liStop);
+
+		pMessageSink = NULL;
+
+		if (pAuxReceiver != NULL)
+			Combiner.GetStatistics(Result.iDivSymbols, Result.iDivCombined);
+
+		/* Steady state: the frames after the warm-up. A lost FAC can make
+		   the receiver acquire the signal again, which sets up its buffers */
+		if (llHeapStart >= 0)
+		{
+			Result.rHeapPerFrame = (_REAL) (GetNumHeapAllocs() - llHeapStart) /
+				(Result.iNumFrames - iHeapStartFrame + 1);
+			Result.rTxHeapPerFrame = (_REAL) (GetNumHeapAllocsTx() - llTxHeapStart) /
+				(Result.iNumFrames - iHeapStartFrame + 1);
+			Result.llArenaMisses = pReceiver->GetFrameArena()->GetNumHeapAllocs() +
+				pTransmitter->GetFrameArena()->GetNumHeapAllocs() - llArenaStart;
+			Result.bSteady = (Result.iFACBad == iHeapStartFACBad);
+		}
+
+		/* Files which only the RS decoder could restore */
+		CheckSavedFiles();
+
+		Result.rSignalTime = (_REAL) Link.GetNumSamples() / SOUNDCRD_SAMPLE_RATE;
+		Result.rDecodeTime = (_REAL) (liStop.QuadPart - liStart.QuadPart -
+			liGenTime.QuadPart) / liFreq.QuadPart;
+	}
+	catch (CGenErr)
+	{
+		/* The point is reported with what was counted so far */
+		pMessageSink = NULL;
+	}
+
+	if (pAuxReceiver != NULL)
+	{
+		AuxLink.Finish();
+
+		if (AuxThread.joinable())
+			AuxThread.join();
+	}
+
+	bDisplayRun = FALSE;
+	for (size_t i = 0; i < vecDisplayThreads.size(); i++)
+		vecDisplayThreads[i].join();
+	vecDisplayThreads.clear();
+
+	if (Result.iDisplayReads > 0)
+	{
+		Result.rDisplayReadUs /= Result.iDisplayReads;
+		Result.llDisplayWaits = pReceiver->GetDisplayWaits();
+	}
+
+	for (size_t i = 0; i < vecFiles.size(); i++)
+	{
+		if (vecFiles[i].bReceived == TRUE)
+			Result.iFilesOk++;
+	}
+	Result.iFilesSent = (int) vecFiles.size();
+
+	DeleteFiles();
+
+	delete pAuxReceiver;
+	delete pReceiver;
+	delete pTransmitter;
+	pAuxReceiver = NULL;
+	pReceiver = NULL;
+	pTransmitter = NULL;
+
+	return Result;
+}
+
+void CDRMSimulation::RunAuxReceiver()
+{
+	/* Second receiver, like in the dual-channel mode */
+	iRxChannel = 1;
+	pMessageSink = &AuxMessages;
+
+	try
+	{
+		pAuxReceiver->Start();
+	}
+	catch (CGenErr)
+	{
+		/* The main receiver decodes on its own */
+	}
+
+	pMessageSink = NULL;
+}
+
+void CDRMSimulation::RunRender(FILE* pFile)
+{
+	const CSimPoint Point;
+	const string strWaveFile = "sim_render.wav";
+	_REAL rRealTimeFactor = (_REAL) 0.0;
+	_REAL rDuration = (_REAL) 0.0;
+
+	pTransmitter = new CDRMTransmitter;
+
+	try
+	{
+		MakeFiles(iSession + iFileCnt);
+		SetupTransmitter(Point);
+
+		rDuration = pTransmitter->Render(strWaveFile, rRealTimeFactor);
+	}
+	catch (CGenErr)
+	{
+		/* Reported as nothing rendered */
+	}
+
+	DeleteFiles();
+	DeleteFile(strWaveFile.c_str());
+
+	delete pTransmitter;
+	pTransmitter = NULL;
+
+	fprintf(pFile, "\nRender: mode B, 16-QAM, %d files of %d bytes, %.1f s of signal, "
+		"%.1f x real time\n", SIM_NUM_FILES, SIM_FILE_SIZE, rDuration, rRealTimeFactor);
+}
+
+void CDRMSimulation::RunDisplay(FILE* pFile)
+{
+	CSimPoint Point;
+	Point.iSeed = SIM_DIV_SEED;
+
+	const CSimResult ResOff = RunPoint(Point);
+
+	/* The publishing is counted like a processing module */
+	ModulStats.Reset();
+
+	Point.iDisplayReaders = SIM_DISPLAY_READERS;
+	const CSimResult ResOn = RunPoint(Point);
+
+	CVector<CModulStatSnap> vecStats;
+	const int iNumStats = ModulStats.GetSnapshot(vecStats);
+	long long llNumPublished = 0;
+	_REAL rPublishUs = (_REAL) 0.0;
+	_REAL rPublishMaxUs = (_REAL) 0.0;
+
+	for (int i = 0; i < iNumStats; i++)
+	{
+		if ((vecStats[i].strName == "CDisplaySnapshot") && (vecStats[i].llNumCalls > 0))
+		{
+			llNumPublished = vecStats[i].llNumCalls;
+			rPublishUs = vecStats[i].rTimeTotalMs * 1000 / llNumPublished;
+			rPublishMaxUs = vecStats[i].rTimeMaxUs;
+		}
+	}
+
+	_REAL rMsPerSec[2] = {(_REAL) 0.0, (_REAL) 0.0};
+	if (ResOff.rSignalTime > (_REAL) 0.0)
+		rMsPerSec[0] = ResOff.rDecodeTime * 1000 / ResOff.rSignalTime;
+	if (ResOn.rSignalTime > (_REAL) 0.0)
+		rMsPerSec[1] = ResOn.rDecodeTime * 1000 / ResOn.rSignalTime;
+
+	fprintf(pFile, "\nDisplay: Rx %.1f ms/s without and %.1f ms/s with %d snapshots per "
+		"second of signal\n", rMsPerSec[0], rMsPerSec[1], DISPLAY_SNAPSHOT_RATE);
+	fprintf(pFile, "Display: receive thread published %lld snapshots, %.1f us mean, "
+		"%.1f us max, it never waits for a reader\n", llNumPublished, rPublishUs, rPublishMaxUs);
+	fprintf(pFile, "Display: %d GUI threads made %d copies, %.1f us mean, %.1f us max, "
+		"%lld of them waited for another reader\n", SIM_DISPLAY_READERS,
+		ResOn.iDisplayReads, ResOn.rDisplayReadUs, ResOn.rDisplayReadMaxUs,
+		ResOn.llDisplayWaits);
+}
+
+void CDRMSimulation::RunDisplayReader()
+{
+	/* Like the dialog timer or a DLL client, each thread has its own copy */
+	CDisplaySnapshot Snap;
+	LARGE_INTEGER liFreq, liStart, liStop;
+	int iReads = 0;
+	_REAL rTimeUs = (_REAL) 0.0;
+	_REAL rMaxUs = (_REAL) 0.0;
+
+	QueryPerformanceFrequency(&liFreq);
+
+	while (bDisplayRun == TRUE)
+	{
+		QueryPerformanceCounter(&liStart);
+		pReceiver->GetDisplay(Snap);
+		QueryPerformanceCounter(&liStop);
+
+		const _REAL rUs = (_REAL) (liStop.QuadPart - liStart.QuadPart) * 1000000 / liFreq.QuadPart;
+		rTimeUs += rUs;
+		rMaxUs = max(rMaxUs, rUs);
+		iReads++;
+
+		std::this_thread::sleep_for(std::chrono::milliseconds(SIM_DISPLAY_READ_MS));
+	}
+
+	std::lock_guard<std::mutex> Lock(DisplayMutex);
+
+	Result.iDisplayReads += iReads;
+	Result.rDisplayReadUs += rTimeUs;
+	Result.rDisplayReadMaxUs = max(Result.rDisplayReadMaxUs, rMaxUs);
+}
+
+void CDRMSimulation::SetupTransmitter(const CSimPoint& Point)
+{
+	CParameter* pParam = pTransmitter->GetParameters();
+
+	/* Same as "SetParams()" of the DLL */
+	pParam->SetSpectrumOccup(SO_1);
+	pParam->InitCellMapTable(Point.eRobMode, SO_1);
+	pParam->SetMSCProtLev(0);
+	pParam->eMSCCodingScheme = Point.eCodScheme;
+	pParam->SetInterleaverDepth(CParameter::SI_SHORT);
+
+	/* Slide show service, see "SetTXmode()" */
+	pParam->iNumAudioService = 0;
+	pParam->iNumDataService = 1;
+	pParam->Service[0].eAudDataFlag = CParameter::SF_DATA;
+	pParam->Service[0].DataParam.iStreamID = 0;
+	pParam->Service[0].DataParam.eDataUnitInd = CParameter::DU_DATA_UNITS;
+	pParam->Service[0].DataParam.eAppDomain = CParameter::AD_DAB_SPEC_APP;
+	pParam->Service[0].iServiceDescr = 0;
+	pParam->Service[0].strLabel = "SIM";
+	pParam->bOnlyPicture = TRUE;
+
+	pTransmitter->SetSoundBackend(&Link);
+	pTransmitter->Init();
+	pParam->Service[0].DataParam.iPacketLen = calcpacklen(pParam->iNumDecodedBitsMSC);
+
+	/* The packet length follows from the number of MSC bits of the first
+	   init, the data encoder only takes it in the next one */
+	pTransmitter->Init();
+
+	/* The frames are counted in samples like in "Render()", the transmitter
+	   writes its signal in blocks which do not follow the frames */
+	iFrameLen = pParam->iNumSymPerFrame * pParam->iSymbolBlockSize;
+
+	iTailFrames = SIM_EXTRA_TAIL_FRAMES +
+		((pParam->GetInterleaverDepth() == CParameter::SI_LONG) ?
+		RENDER_TAIL_FRAMES_LONG : RENDER_TAIL_FRAMES_SHORT);
+
+	/* The files are prepared with the ECC setting at the time they are
+	   queued */
+	ECCmode = (Point.iRSLevel > 0) ? 3 + Point.iRSLevel : 1;
+
+	CVector<short> vecsDummy;
+	vecsDummy.Init(0);
+
+	pTransmitter->GetAudSrcEnc()->SetTheStartDelay(SIM_START_DELAY);
+
+	for (size_t i = 0; i < vecFiles.size(); i++)
+	{
+		pTransmitter->GetAudSrcEnc()->SetPicFileName(vecFiles[i].strPath,
+			vecFiles[i].strName, vecsDummy);
+	}
+}
+
+void CDRMSimulation::MakeFiles(const unsigned int iSeed)
+{
+	char chTempDir[MAX_PATH];
+	char chName[64];
+
+	if (GetTempPath(MAX_PATH, chTempDir) == 0)
+		strcpy(chTempDir, ".\\");
+
+	std::mt19937 Random(iSeed);
+
+	vecFiles.clear();
+
+	for (int i = 0; i < SIM_NUM_FILES; i++)
+	{
+		CSentFile NewFile;
+
+		/* The transport ID is made from the name, each file of the run gets
+		   its own one */
+		sprintf(chName, "sim%u_%d.bin", iSession, iFileCnt++);
+
+		NewFile.strName = chName;
+		NewFile.strPath = string(chTempDir) + chName;
+		NewFile.bReceived = FALSE;
+
+		NewFile.vecbyData.Init(SIM_FILE_SIZE);
+		for (int j = 0; j < SIM_FILE_SIZE; j++)
+			NewFile.vecbyData[j] = (_BYTE) (Random() & 0xFF);
+
+		FILE* pFile = fopen(NewFile.strPath.c_str(), "wb");
+		if (pFile == NULL)
+			throw CGenErr("Could not write " + NewFile.strPath);
+
+		fwrite(&NewFile.vecbyData[0], 1, SIM_FILE_SIZE, pFile);
+		fclose(pFile);
+
+		vecFiles.push_back(NewFile);
+	}
+}
+
+void CDRMSimulation::DeleteFiles()
+{
+	for (size_t i = 0; i < vecFiles.size(); i++)
+	{
+		DeleteFile(vecFiles[i].strPath.c_str());
+		DeleteFile(("Rx Files\\" + vecFiles[i].strName).c_str());
+	}
+
+	vecFiles.clear();
+}
+
+_BOOLEAN CDRMSimulation::Generate()
+{
+	LARGE_INTEGER liStart, liStop;
+
+	/* End of the transmission. If nothing is decoded at all, the transmitter
+	   would never finish */
+	if (((iEndFrame >= 0) && (Result.iNumFrames >= iEndFrame)) ||
+		(Result.iNumFrames >= RENDER_MAX_FRAMES))
+	{
+		/* The receiver leaves its loop after the current block */
+		pReceiver->GetParameters()->bRunThread = FALSE;
+
+		return FALSE;
+	}
+
+	/* The signal is generated in the receive thread, its allocations are
+	   counted for the transmitter */
+	SetHeapCountTx(TRUE);
+	QueryPerformanceCounter(&liStart);
+
+	pTransmitter->ProcessChain();
+
+	QueryPerformanceCounter(&liStop);
+	SetHeapCountTx(FALSE);
+	liGenTime.QuadPart += liStop.QuadPart - liStart.QuadPart;
+
+	/* The bookkeeping of the benchmark is not counted */
+	iHeapCountPause++;
+
+	Result.iNumFrames = Link.GetNumGenerated() / iFrameLen;
+
+	/* Counted from the first frame after the warm-up at which the receiver
+	   has decoded a FAC */
+	if ((llHeapStart < 0) && (Result.iNumFrames >= SIM_WARMUP_FRAMES) &&
+		(Result.iFACOk > 0))
+	{
+		llHeapStart = GetNumHeapAllocs();
+		llTxHeapStart = GetNumHeapAllocsTx();
+		iHeapStartFrame = Result.iNumFrames;
+		iHeapStartFACBad = Result.iFACBad;
+		llArenaStart = pReceiver->GetFrameArena()->GetNumHeapAllocs() +
+			pTransmitter->GetFrameArena()->GetNumHeapAllocs();
+	}
+
+	/* "Render()" stops like the dialog once the last object has started,
+	   which only cuts a copy of the same file. Here each file is different,
+	   so all objects must be sent (the count includes the null object of the
+	   encoder) */
+	CAudioSourceEncoder* pEnc = pTransmitter->GetAudSrcEnc();
+
+	if ((iEndFrame < 0) && (pEnc->GetPicCnt() > pEnc->GetNoOfPic()))
+		iEndFrame = Result.iNumFrames + iTailFrames;
+
+	/* Once per frame is often enough for the objects of the receiver */
+	CheckReceived();
+
+	iHeapCountPause--;
+
+	return TRUE;
+}
+
+void CDRMSimulation::CheckReceived()
+{
+	CMOTObject NewPic;
+
+	while (pReceiver->GetDataDecoder()->GetSlideShowPicture(NewPic) == TRUE)
+	{
+		if (NewPic.vecbRawData.Size() == 0)
+			continue;
+
+		for (size_t i = 0; i < vecFiles.size(); i++)
+		{
+			if ((vecFiles[i].bReceived == FALSE) && (NewPic.strName == vecFiles[i].strName) &&
+				(IsEqual(vecFiles[i], &NewPic.vecbRawData[0], NewPic.vecbRawData.Size()) == TRUE))
+			{
+				vecFiles[i].bReceived = TRUE;
+			}
+		}
+	}
+}
+
+void CDRMSimulation::CheckSavedFiles()
+{
+	/* Wait until the RS decoder thread is done with the last object */
+	for (int i = 0; (i < SIM_RS_WAIT_MS / 10) && (RSbusy != 0); i++)
+		Sleep(10);
+
+	for (size_t i = 0; i < vecFiles.size(); i++)
+	{
+		if (vecFiles[i].bReceived == TRUE)
+			continue;
+
+		FILE* pFile = fopen(("Rx Files\\" + vecFiles[i].strName).c_str(), "rb");
+		if (pFile == NULL)
+			continue;
+
+		CVector<_BYTE> vecbyData;
+		vecbyData.Init(SIM_FILE_SIZE + 1);
+
+		const int iSize = (int) fread(&vecbyData[0], 1, SIM_FILE_SIZE + 1, pFile);
+		fclose(pFile);
+
+		if (IsEqual(vecFiles[i], &vecbyData[0], iSize) == TRUE)
+			vecFiles[i].bReceived = TRUE;
+	}
+}
+
+_BOOLEAN CDRMSimulation::IsEqual(const CSentFile& File, const _BYTE* pbyData, const int iSize)
+{
+	if (iSize != File.vecbyData.Size())
+		return FALSE;
+
+	return memcmp(pbyData, File.vecbyData.data(), iSize) == 0;
+}
+
+void CDRMSimulation::OnMessage(const _MESSAGE_IDENT MessID, const int iMessageParam)
+{
+	switch (MessID)
+	{
+	case MS_FAC_CRC:
+		if (iMessageParam == 0)
+			Result.iFACOk++;
+		else
+			Result.iFACBad++;
+		break;
+
+	case MS_MSC_CRC:
+		if (Result.iMSCOk + Result.iMSCBad >= SIM_SENS_SKIP_MSC)
+		{
+			if (iMessageParam == 0)
+				Result.iMSCSensOk++;
+			else
+				Result.iMSCSensBad++;
+		}
+
+		if (iMessageParam == 0)
+			Result.iMSCOk++;
+		else
+			Result.iMSCBad++;
+		break;
+	}
+}
@@ -0,0 +1,401 @@
+/******************************************************************************\
+ * Copyright (c) 2024
+ *
+ * Author(s):
+ *	EasyDRF developers
+ *
+ * Description:
+ *	See DrmSimulation.cpp
+ *
+ ******************************************************************************
+ *
+ * This program is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation; either version 2 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ *
+\******************************************************************************/
+
+#if !defined(DRMSIMULATION_H__3B0UBVE98732KJVEW363DRMS1MUL__INCLUDED_)
+#define DRMSIMULATION_H__3B0UBVE98732KJVEW363DRMS1MUL__INCLUDED_
+
+#include <vector>
+#include <thread>
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include "GlobalDefinitions.h"
+#include "Vector.h"
+#include "Parameter.h"
+#include "DrmTransmitter.h"
+#include "DrmReceiver.h"
+#include "ChannelSimulator.h"
+#include "DiversityCombiner.h"
+#include "FixedPoint.h"
+#include "../sound/SoundInterface.h"
+
+
+/* Definitions ****************************************************************/
+/* Random files which are sent in each point of the benchmark */
+#define SIM_NUM_FILES				2
+#define SIM_FILE_SIZE				2000
+
+/* Lead-in of the slide show, like a normal transmission from the dialog */
+#define SIM_START_DELAY				14
+
+/* The receiver is a few frames behind the transmitter */
+#define SIM_EXTRA_TAIL_FRAMES		4
+
+/* The RS decoder runs in its own thread, the receiver waits for it at most
+   this long at the end of a point */
+#define SIM_RS_WAIT_MS				5000
+
+/* The heap allocations of the receive thread are counted after the first
+   frames, when all buffers have their size. Only the signal processing
+   counts, not the MOT decoder. The generated signal is counted on its own
+   (transmitter). This replaces
+   the global operator new, so only the "Benchmark" configuration of the
+   project sets it */
+#ifndef SIM_COUNT_HEAP
+# define SIM_COUNT_HEAP				FALSE
+#endif
+#define SIM_WARMUP_FRAMES			10
+
+/* Bandwidth of the signal for the SNR (spectrum occupancy SO_1) */
+#define SIM_BANDWIDTH				((_REAL) 2500.0)
+
+/* Consumed samples are removed from the channel output once there are this
+   many */
+#define SIM_FIFO_COMPACT			(1 << 16)
+
+/* Sensitivity for the fixed-point comparison: lowest SNR at which this
+   share of the MSC blocks is decoded. The first blocks are not counted, the
+   receiver is still settling there at any SNR. The sweep goes in 1 dB
+   steps, then the last step is bisected down to the resolution. Both
+   arithmetics see the same channel and data */
+#define SIM_SENS_MIN_SNR			0
+#define SIM_SENS_MAX_SNR			30
+#define SIM_SENS_MSC_OK				((_REAL) 0.99)
+#define SIM_SENS_RESOLUTION			((_REAL) 0.1)
+#define SIM_SENS_SKIP_MSC			20
+#define SIM_SENS_SEED				2000
+
+/* Diversity points: the second antenna gets the same channel with its own
+   fading and noise, one antenna and two antennas see the same fading of the
+   first one (same seed) */
+#define SIM_DIV_SEED				1000
+#define SIM_DIV_SEED_ANT2			7919
+
+/* Display point: GUI threads which read the display snapshots like the
+   dialog timer and the DLL display functions, each one every few ms (the
+   simulation runs much faster than real time) */
+#define SIM_DISPLAY_READERS			2
+#define SIM_DISPLAY_READ_MS			1
+
+
+/* Classes ********************************************************************/
+class CDRMSimulation;
+
+class CSimAuxLink;
+
+/* Audio backend which connects the transmitter and the receiver through the
+   channel simulator. The receiver pulls the samples, each time it needs more
+   the transmitter generates the next frame in the same thread. There is no
+   sound card and no waiting, the chain runs as fast as the CPU allows */
+class CSimLink : public CSoundInterface
+{
+public:
+	CSimLink() : pSimulation(NULL), iBlockSize(0), iReadPos(0), iNumSamples(0),
+		iNumGenerated(0), bFromFifo(FALSE) {}
+	virtual ~CSimLink() {}
+
+	/* "pNewAuxLink" gets the signal of the second antenna, NULL for one
+	   antenna */
+	void		Reset(CDRMSimulation* pNewSimulation, CSimAuxLink* pNewAuxLink);
+	CChannelSimulator*	GetChannel() {return &Channel;}
+
+	/* Number of samples which were handed to the receiver */
+	int			GetNumSamples() {return iNumSamples;}
+
+	/* Number of samples which the transmitter has written */
+	int			GetNumGenerated() {return iNumGenerated;}
+
+	void		InitRecording(int iNewBufferSize, _BOOLEAN bNewBlocking = TRUE);
+	void		InitPlayback(int, _BOOLEAN = FALSE) {}
+	_BOOLEAN	ReadBlock(const _SAMPLE*& psData);
+	void		ReleaseBlock();
+	_BOOLEAN	Write(CVector<short>& psData);
+	_BOOLEAN	IsEmpty(void) {return TRUE;}
+	void		Close() {}
+
+	int			GetNumDevIn() {return 1;}
+	string		GetDeviceNameIn(int) {return "Simulation";}
+	int			GetNumDevOut() {return 1;}
+	string		GetDeviceNameOut(int) {return "Simulation";}
+	void		SetInDev(int) {}
+	void		SetOutDev(int) {}
+	unsigned int	GetOutDev() {return 0;}
+
+	/* The channel simulator works on one channel */
+	int			GetNumChannels() {return 1;}
+
+protected:
+	CDRMSimulation*			pSimulation;
+	CSimAuxLink*			pAuxLink;
+	CChannelSimulator		Channel;
+
+	std::vector<_SAMPLE>	vecsFifo;
+	int						iBlockSize;
+	int						iReadPos;
+	int						iNumSamples;
+	int						iNumGenerated;
+	_BOOLEAN				bFromFifo;
+	CVector<_SAMPLE>		vecsZero;
+};
+
+/* Input of the second receiver of a diversity point, which runs in its own
+   thread like in the dual-channel mode. The main link writes the signal of
+   the second antenna, the receiver waits for it. The blocks are copied, the
+   FIFO is appended to while the receiver reads */
+class CSimAuxLink : public CSoundInterface
+{
+public:
+	CSimAuxLink() : pReceiver(NULL), iBlockSize(0), iReadPos(0), bEnd(FALSE) {}
+	virtual ~CSimAuxLink() {}
+
+	void		Reset(CDRMReceiver* pNewReceiver);
+	CChannelSimulator*	GetChannel() {return &Channel;}
+
+	/* Called by the main link in the thread of the transmitter */
+	void		Put(const short* psData, const int iStride, const int iLen);
+
+	/* No more signal, the receiver gets silence and leaves its loop */
+	void		Finish();
+
+	void		InitRecording(int iNewBufferSize, _BOOLEAN bNewBlocking = TRUE);
+	void		InitPlayback(int, _BOOLEAN = FALSE) {}
+	_BOOLEAN	ReadBlock(const _SAMPLE*& psData);
+	void		ReleaseBlock() {}
+	_BOOLEAN	Write(CVector<short>&) {return FALSE;}
+	_BOOLEAN	IsEmpty(void) {return TRUE;}
+	void		Close() {}
+
+	int			GetNumDevIn() {return 1;}
+	string		GetDeviceNameIn(int) {return "Simulation";}
+	int			GetNumDevOut() {return 1;}
+	string		GetDeviceNameOut(int) {return "Simulation";}
+	void		SetInDev(int) {}
+	void		SetOutDev(int) {}
+	unsigned int	GetOutDev() {return 0;}
+
+	int			GetNumChannels() {return 1;}
+
+protected:
+	CDRMReceiver*			pReceiver;
+	CChannelSimulator		Channel;
+	std::vector<_SAMPLE>	vecsChanOut;
+
+	std::mutex				Mutex;
+	std::condition_variable	Cond;
+	std::vector<_SAMPLE>	vecsFifo;
+	int						iBlockSize;
+	int						iReadPos;
+	_BOOLEAN				bEnd;
+	CVector<_SAMPLE>		vecsBlock;
+};
+
+/* Settings of one point of the benchmark */
+class CSimPoint
+{
+public:
+	CSimPoint() : eRobMode(RM_ROBUSTNESS_MODE_B), eCodScheme(CParameter::CS_2_SM),
+		iRSLevel(0), eProfile(CP_AWGN), rSNRdB((_REAL) 20.0),
+		rFreqOffset((_REAL) 0.0), rSampleOffsetPPM((_REAL) 0.0),
+		iNumAntennas(1), iSeed(0), iDisplayReaders(0) {}
+
+	ERobMode				eRobMode;
+	CParameter::ECodScheme	eCodScheme;
+	int						iRSLevel; /* 0: no RS code, 1 to 4: RS1 to RS4 */
+	EChanProfile			eProfile;
+	_REAL					rSNRdB;
+	_REAL					rFreqOffset; /* Hz */
+	_REAL					rSampleOffsetPPM;
+	int						iNumAntennas; /* 2: diversity reception */
+	unsigned int			iSeed; /* channel, 0: a new one for each point */
+	int						iDisplayReaders; /* 0: display snapshots off */
+};
+
+class CSimResult
+{
+public:
+	CSimResult() : rSignalTime((_REAL) 0.0), rDecodeTime((_REAL) 0.0),
+		iNumFrames(0), iFACOk(0), iFACBad(0), iMSCOk(0), iMSCBad(0),
+		iFilesSent(0), iFilesOk(0), rHeapPerFrame((_REAL) 0.0),
+		rTxHeapPerFrame((_REAL) 0.0), llArenaMisses(0),
+		bSteady(FALSE), iMSCSensOk(0), iMSCSensBad(0), iDivSymbols(0),
+		iDivCombined(0), iDisplayReads(0),
+		rDisplayReadUs((_REAL) 0.0), rDisplayReadMaxUs((_REAL) 0.0),
+		llDisplayWaits(0) {}
+
+	_REAL		rSignalTime; /* seconds of signal */
+	_REAL		rDecodeTime; /* seconds, without generating the signal */
+
+	int			iNumFrames;
+	int			iFACOk;
+	int			iFACBad;
+	int			iMSCOk;
+	int			iMSCBad;
+	int			iFilesSent;
+	int			iFilesOk;
+
+	/* After the warm-up: heap allocations per frame of the receiver and of
+	   the transmitter and temporaries which did not fit in the frame arenas.
+	   Steady means that the receiver was synchronised and kept every FAC */
+	_REAL		rHeapPerFrame;
+	_REAL		rTxHeapPerFrame;
+	long long	llArenaMisses;
+	_BOOLEAN	bSteady;
+
+	/* MSC blocks for the sensitivity, without the first ones */
+	int			iMSCSensOk;
+	int			iMSCSensBad;
+
+	/* Symbols of the main receiver and how many of them were combined with
+	   the second antenna */
+	int			iDivSymbols;
+	int			iDivCombined;
+
+	/* Copies of the display snapshots by the GUI threads, time per copy and
+	   how many copies had to wait for another reader */
+	int			iDisplayReads;
+	_REAL		rDisplayReadUs; /* mean */
+	_REAL		rDisplayReadMaxUs;
+	long long	llDisplayWaits;
+};
+
+/* Loopback benchmark: each point transmits a few random files through the
+   simulated channel and counts what the receiver decodes. The messages of
+   the receiver (CRC results) are counted instead of shown */
+class CDRMSimulation : public CMessageSink
+{
+public:
+	CDRMSimulation() : pTransmitter(NULL), pReceiver(NULL), pAuxReceiver(NULL),
+		bDisplayRun(FALSE), iSession(0), iFileCnt(0) {}
+	virtual ~CDRMSimulation() {}
+
+	/* Complete sweep over modes, QAM, RS levels, channels and SNR or a short
+	   one for a quick check */
+	void		MakeDefaultPlan(std::vector<CSimPoint>& vecPlan);
+	void		MakeQuickPlan(std::vector<CSimPoint>& vecPlan);
+
+	CSimResult	RunPoint(const CSimPoint& Point);
+
+	/* Runs all points and writes one tab separated line per point. Returns
+	   FALSE if the report can not be written, if the signal processing of
+	   the receiver or the transmitter allocates heap memory in the steady
+	   state or a temporary misses the frame arenas (SIM_COUNT_HEAP) or if two
+	   antennas do not decode more MSC blocks than one antenna on the same
+	   fading */
+	_BOOLEAN	Run(const std::vector<CSimPoint>& vecPlan, const string& strReportFile);
+
+#if USE_FIXED_POINT
+	/* Sensitivity of the floating-point and the fixed-point receive path
+	   for each mode, QAM and channel, one line each with the loss in dB */
+	_BOOLEAN	RunFixedPoint(const string& strReportFile);
+#endif
+
+	/* Called by the link */
+	_BOOLEAN	Generate();
+
+	void		OnMessage(const _MESSAGE_IDENT MessID, const int iMessageParam);
+
+protected:
+	class CSentFile
+	{
+	public:
+		string			strName;
+		string			strPath;
+		CVector<_BYTE>	vecbyData;
+		_BOOLEAN		bReceived;
+	};
+
+	void		SetupTransmitter(const CSimPoint& Point);
+	/* "iSeed" of the content, the names always differ */
+	void		MakeFiles(const unsigned int iSeed);
+	void		DeleteFiles();
+	void		CheckReceived();
+	void		CheckSavedFiles();
+	_BOOLEAN	IsEqual(const CSentFile& File, const _BYTE* pbyData, const int iSize);
+
+	/* One point with one and with two antennas for each SNR */
+	void		AddDiversityPoints(std::vector<CSimPoint>& vecPlan, const int iMinSNR,
+					const int iMaxSNR);
+
+	/* Thread of the second receiver */
+	void		RunAuxReceiver();
+
+	/* Renders the files of one point to a wave file like "Save as WAV" and
+	   writes the speed to the report */
+	void		RunRender(FILE* pFile);
+
+	/* One point without and one with display snapshots and GUI threads
+	   which read them, the costs on both sides are written to the report */
+	void		RunDisplay(FILE* pFile);
+	void		RunDisplayReader();
+
+	/* The CRC results of the second receiver are not counted */
+	class CIgnoreMessages : public CMessageSink
+	{
+	public:
+		void OnMessage(const _MESSAGE_IDENT, const int) {}
+	};
+
+#if USE_FIXED_POINT
+	/* FALSE if the sweep does not reach SIM_SENS_MSC_OK */
+	_BOOLEAN	FindSensitivity(CSimPoint Point, _REAL& rSNRdB, _REAL& rMsPerSec);
+	_BOOLEAN	SensitivityOk(CSimPoint Point, const _REAL rSNRdB, _REAL& rMsPerSec);
+#endif
+
+	CDRMTransmitter*		pTransmitter;
+	CDRMReceiver*			pReceiver;
+	CSimLink				Link;
+
+	/* Diversity points */
+	CDRMReceiver*			pAuxReceiver;
+	CSimAuxLink				AuxLink;
+	CDiversityCombiner		Combiner;
+	std::thread				AuxThread;
+	CIgnoreMessages			AuxMessages;
+
+	/* Display points */
+	std::vector<std::thread>	vecDisplayThreads;
+	std::atomic<_BOOLEAN>	bDisplayRun;
+	std::mutex				DisplayMutex;
+
+	std::vector<CSentFile>	vecFiles;
+	unsigned int			iSession;
+	int						iFileCnt;
+
+	int						iFrameLen;
+	int						iTailFrames;
+	int						iEndFrame;
+	long long				llHeapStart;
+	long long				llTxHeapStart;
+	int						iHeapStartFrame;
+	int						iHeapStartFACBad;
+	long long				llArenaStart;
+	LARGE_INTEGER			liGenTime;
+	CSimResult				Result;
+};
+
+
+#endif // !defined(DRMSIMULATION_H__3B0UBVE98732KJVEW363DRMS1MUL__INCLUDED_)
@@ -81,37 +81,106 @@ void CDRMTransmitter::Run()
 			Sleep(200);
 		}
 		else
-		{
-			/* MSC ****************************************************************/
-			/* Read the source signal (Audio Input from Mike) */
-			ReadData.ReadData(TransmParam, DataBuf);
+			ProcessChain();
+	}
+	try
+	{
+		SoundInterface.Close();
 
-			/* Audio source encoder */
-			AudioSourceEncoder.ProcessData(TransmParam, DataBuf, AudSrcBuf); //Added DM - This naming convention is confusing here. DataBuf is the audio input, and AudSrcBuf is the data output!
-//			AudioSourceEncoder.ProcessData(TransmParam, AudSrcBuf); //no audio input for DLL version DM
+		if (TransmitData.GetSoundInterface() != &SoundInterface)
+			TransmitData.GetSoundInterface()->Close();
+	}
+	catch (CGenErr) { throw; }
+}
 
-			/* MLC-encoder */
-			MSCMLCEncoder.ProcessData(TransmParam, AudSrcBuf, MLCEncBuf);
-	
-			/* Convolutional interleaver */
-			SymbInterleaver.ProcessData(TransmParam, MLCEncBuf, IntlBuf);
+void CDRMTransmitter::ProcessChain()
+{
+	/* The temporaries of this frame come from the frame arena */
+	CFrameScope FrameScope(FrameArena);
 
-			/* FAC ****************************************************************/
-			GenerateFACData.ReadData(TransmParam, GenFACDataBuf);
-			FACMLCEncoder.ProcessData(TransmParam, GenFACDataBuf, FACMapBuf);
+	/* MSC ********************************************************************/
+	/* Read the source signal (Audio Input from Mike) */
+	ReadData.ReadData(TransmParam, DataBuf);
 
-			/* Mapping of the MSC, FAC and pilots on the carriers ************/
-			OFDMCellMapping.ProcessData(TransmParam, IntlBuf, FACMapBuf, CarMapBuf);
+	/* Audio source encoder */
+	AudioSourceEncoder.ProcessData(TransmParam, DataBuf, AudSrcBuf); //Added DM - This naming convention is confusing here. DataBuf is the audio input, and AudSrcBuf is the data output!
+//	AudioSourceEncoder.ProcessData(TransmParam, AudSrcBuf); //no audio input for DLL version DM
 
-			/* OFDM-modulation ****************************************************/
-			OFDMModulation.ProcessData(TransmParam, CarMapBuf, OFDMModBuf);
-	
-			/* Transmit the signal ************************************************/
-			TransmitData.WriteData(TransmParam, OFDMModBuf);
+	/* MLC-encoder */
+	MSCMLCEncoder.ProcessData(TransmParam, AudSrcBuf, MLCEncBuf);
+
+	/* Convolutional interleaver */
+	SymbInterleaver.ProcessData(TransmParam, MLCEncBuf, IntlBuf);
+
+	/* FAC ********************************************************************/
+	GenerateFACData.ReadData(TransmParam, GenFACDataBuf);
+	FACMLCEncoder.ProcessData(TransmParam, GenFACDataBuf, FACMapBuf);
+
+	/* Mapping of the MSC, FAC and pilots on the carriers *********************/
+	OFDMCellMapping.ProcessData(TransmParam, IntlBuf, FACMapBuf, CarMapBuf);
+
+	/* OFDM-modulation ********************************************************/
+	OFDMModulation.ProcessData(TransmParam, CarMapBuf, OFDMModBuf);
+
+	/* Transmit the signal ****************************************************/
+	TransmitData.WriteData(TransmParam, OFDMModBuf);
+}
+
+_REAL CDRMTransmitter::Render(const string& strFileName, _REAL& rRealTimeFactor)
+{
+	CSoundWaveFile	WaveFile;
+	LARGE_INTEGER	liFreq, liStart, liStop;
+
+	rRealTimeFactor = (_REAL) 0.0;
+
+	if (WaveFile.Open(strFileName) == FALSE)
+		return (_REAL) 0.0;
+
+	/* No microphone, the signal only depends on the queued files */
+	CSoundInterface* pOldBackend = TransmitData.GetSoundInterface();
+	const _BOOLEAN bOldOnlyPicture = TransmParam.bOnlyPicture;
+
+	TransmParam.bOnlyPicture = TRUE;
+	TransmitData.SetSoundInterface(&WaveFile);
+	Init();
+
+	const int iFrameLen = TransmParam.iNumSymPerFrame * TransmParam.iSymbolBlockSize;
+	const int iTailFrames =
+		(TransmParam.GetInterleaverDepth() == CParameter::SI_LONG) ?
+		RENDER_TAIL_FRAMES_LONG : RENDER_TAIL_FRAMES_SHORT;
+	int iEndSample = -1;
+
+	QueryPerformanceFrequency(&liFreq);
+	QueryPerformanceCounter(&liStart);
+
+	while (WaveFile.GetNumSamples() < RENDER_MAX_FRAMES * iFrameLen)
+	{
+		ProcessChain();
+
+		/* Same end of transmission as in "GetPercentTX()" */
+		if (iEndSample < 0)
+		{
+			if (AudioSourceEncoder.GetPicCnt() + 1 > AudioSourceEncoder.GetNoOfPic())
+				iEndSample = WaveFile.GetNumSamples() + iTailFrames * iFrameLen;
 		}
+		else if (WaveFile.GetNumSamples() >= iEndSample)
+			break;
 	}
-	try{ SoundInterface.Close(); }
-	catch (CGenErr) { throw; }
+
+	QueryPerformanceCounter(&liStop);
+
+	WaveFile.Close();
+
+	TransmitData.SetSoundInterface(pOldBackend);
+	TransmParam.bOnlyPicture = bOldOnlyPicture;
+	Init();
+
+	const _REAL rDuration = WaveFile.GetDuration();
+	const _REAL rTime = (_REAL) (liStop.QuadPart - liStart.QuadPart) / liFreq.QuadPart;
+	if (rTime > (_REAL) 0.0)
+		rRealTimeFactor = rDuration / rTime;
+
+	return rDuration;
 }
 
 void CDRMTransmitter::Init()
@@ -38,11 +38,23 @@
 #include "ofdmcellmapping/OFDMCellMapping.h"
 #include "OFDM.h"
 #include "DRMSignalIO.h"
+#include "FrameArena.h"
 #include "sourcedecoders/AudioSourceDecoder.h"
 
 #ifndef WRITE_TRNSM_TO_FILE
 #include "../sound/sound.h"
 #endif
+#include "../sound/SoundWaveFile.h"
+
+
+/* Definitions ****************************************************************/
+/* Frames which are rendered after the last file, so that the interleavers are
+   flushed (same as the end of a transmission in the dialog) */
+#define RENDER_TAIL_FRAMES_SHORT	4
+#define RENDER_TAIL_FRAMES_LONG		12
+
+/* Upper limit of a rendered file (one hour) */
+#define RENDER_MAX_FRAMES			9000
 
 
 /* Classes ********************************************************************/
@@ -65,6 +77,12 @@ public:
 	void Send();
 	void NotSend();
 
+	/* Renders the queued files to a wave file without sound card, as fast as
+	   the CPU allows. Must not be called while the transmitter is sending.
+	   Returns the duration of the signal in seconds, "rRealTimeFactor" is
+	   this duration divided by the processing time */
+	_REAL Render(const string& strFileName, _REAL& rRealTimeFactor);
+
 	/* Get pointer to internal modules */
 	CAudioSourceEncoder*	GetAudSrcEnc() {return &AudioSourceEncoder;}
 	CTransmitData*			GetTransData() {return &TransmitData;}
@@ -74,6 +92,11 @@ public:
 	CParameter*				GetParameters() {return &TransmParam;}
 
 
+	/* Audio backend for the modem output, NULL selects the sound card. Takes
+	   effect with the next "Init()" */
+	void SetSoundBackend(CSoundInterface* pNewBackend)
+		{TransmitData.SetSoundInterface(pNewBackend != NULL ? pNewBackend : &SoundInterface);}
+
 	void SetCarOffset(const _REAL rNewCarOffset)
 	{
 		/* Has to be set in OFDM modulation and transmitter filter module */
@@ -83,10 +106,20 @@ public:
 	}
 	_REAL GetCarOffset() {return rDefCarOffset;}
 
+	/* Generates one frame without sound card (the output goes to the sound
+	   backend). Used by "Render()" and the loopback simulation */
+	void ProcessChain();
+
+	/* Only for statistics of the calling thread */
+	CFrameArena* GetFrameArena() {return &FrameArena;}
+
 protected:
 	void StartParameters(CParameter& Param);
 	void Run();
 
+	/* Temporaries of the transmit chain, destroyed after the modules */
+	CFrameArena				FrameArena;
+
 	/* Parameters */
 	CParameter				TransmParam;
 	
@@ -0,0 +1,126 @@
+/******************************************************************************\
+ * Copyright (c) 2024
+ *
+ * Author(s):
+ *	EasyDRF developers
+ *
+ * Description:
+ *	Events of the receivers and the transmitter for the DLL
+ *
+ *	The processing threads post what happened (file received, CRC results,
+ *	acquisition state, transmit progress) into a lock-free ring. A dispatcher
+ *	thread of its own waits on an event object and calls the callback of the
+ *	application for each entry, so a slow callback never holds up the signal
+ *	processing. If nobody registered a callback, posting costs one atomic
+ *	load
+ *
+ ******************************************************************************
+ *
+ * This program is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation; either version 2 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ *
+\******************************************************************************/
+
+#include "EventQueue.h"
+
+
+/* Implementation *************************************************************/
+CEventQueue EventQueue;
+
+CEventQueue::CEventQueue() : bActive(FALSE), iNumLost(0), iNumLostReported(0),
+	bRun(FALSE), pCallback(NULL), pUser(NULL)
+{
+	hDataEvent = CreateEvent(nullptr, FALSE, FALSE, nullptr);
+}
+
+CEventQueue::~CEventQueue()
+{
+	Stop();
+	CloseHandle(hDataEvent);
+}
+
+void CEventQueue::Post(const int iType, const int iParam1, const int iParam2)
+{
+	if (bActive.load(std::memory_order_relaxed) == FALSE)
+		return;
+
+	CEvent NewEvent;
+	NewEvent.iType = iType;
+	NewEvent.iChannel = iRxChannel;
+	NewEvent.iParam1 = iParam1;
+	NewEvent.iParam2 = iParam2;
+
+	if (Ring.Push(NewEvent) == FALSE)
+	{
+		/* Ring full */
+		iNumLost.fetch_add(1, std::memory_order_relaxed);
+		return;
+	}
+
+	SetEvent(hDataEvent);
+}
+
+void CEventQueue::Start(_EVENT_CALLBACK pNewCallback, void* pNewUser)
+{
+	Stop();
+
+	if (pNewCallback == NULL)
+		return;
+
+	pCallback = pNewCallback;
+	pUser = pNewUser;
+	bRun = TRUE;
+
+	Dispatcher = std::thread(&CEventQueue::Run, this);
+
+	bActive = TRUE;
+}
+
+void CEventQueue::Stop()
+{
+	/* Events which are posted from now on are ignored, the dispatcher
+	   delivers what is in the ring and ends */
+	bActive = FALSE;
+	bRun = FALSE;
+	SetEvent(hDataEvent);
+
+	if (Dispatcher.joinable())
+		Dispatcher.join();
+
+	pCallback = NULL;
+}
+
+void CEventQueue::Run()
+{
+	CEvent Event;
+
+	for (;;)
+	{
+		while (Ring.Pop(Event) == TRUE)
+			pCallback(Event.iType, Event.iChannel, Event.iParam1, Event.iParam2, pUser);
+
+		/* Tell the application once that it has missed events */
+		const int iLost = iNumLost.load(std::memory_order_relaxed);
+		if (iLost != iNumLostReported)
+		{
+			iNumLostReported = iLost;
+			pCallback(EV_LOST, 0, iLost, 0, pUser);
+		}
+
+		if (bRun == FALSE)
+			break;
+
+		WaitForSingleObject(hDataEvent, INFINITE);
+	}
+}
@@ -0,0 +1,105 @@
+/******************************************************************************\
+ * Copyright (c) 2024
+ *
+ * Author(s):
+ *	EasyDRF developers
+ *
+ * Description:
+ *	See EventQueue.cpp
+ *
+ ******************************************************************************
+ *
+ * This program is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation; either version 2 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ *
+\******************************************************************************/
+
+#if !defined(EVENTQUEUE_H__3B0UBVE98732KJVEW363EVENTQUE__INCLUDED_)
+#define EVENTQUEUE_H__3B0UBVE98732KJVEW363EVENTQUE__INCLUDED_
+
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#include <atomic>
+#include <thread>
+#include "GlobalDefinitions.h"
+#include "LockFreeRing.h"
+
+
+/* Definitions ****************************************************************/
+/* Number of events the ring can hold (power of 2). If the callback is slower
+   than the events come in, the newest ones are dropped and counted */
+#define EVQ_RING_SIZE				1024
+
+/* Events, the same numbers are in hamdrm.h */
+#define EV_FILE_RX					1	/* param1: transport ID */
+#define EV_BSR_RX					2	/* param1: transport ID */
+#define EV_FILE_CORRUPT				3	/* signal lost during an object */
+#define EV_FAC_CRC					4	/* param1: 0 ok, 2 wrong */
+#define EV_MSC_CRC					5	/* param1: 0 ok, 1 was ok, 2 wrong */
+#define EV_ACQ_STATE				6	/* param1: 1 signal, 0 no signal */
+#define EV_TX_PROGRESS				7	/* param1: file, param2: percent */
+#define EV_LOST						8	/* param1: events dropped so far */
+
+typedef void (__cdecl *_EVENT_CALLBACK)(int iEvent, int iChannel,
+	int iParam1, int iParam2, void* pUser);
+
+
+/* Classes ********************************************************************/
+class CEvent
+{
+public:
+	int			iType;
+	int			iChannel; /* receiver instance of the posting thread */
+	int			iParam1;
+	int			iParam2;
+};
+
+/* The consumer of the ring is the dispatcher thread which calls the
+   callback */
+class CEventQueue
+{
+public:
+	CEventQueue();
+	virtual ~CEventQueue();
+
+	/* Callable from every thread. Without a callback the event is ignored */
+	void		Post(const int iType, const int iParam1 = 0, const int iParam2 = 0);
+
+	/* Starts the dispatcher thread, NULL stops it. Must be stopped before the
+	   program ends if it runs in a DLL. The callback must not call Start() */
+	void		Start(_EVENT_CALLBACK pNewCallback, void* pNewUser);
+	void		Stop();
+
+	int			GetNumLost() {return iNumLost.load(std::memory_order_relaxed);}
+
+protected:
+	void		Run();
+
+	CLockFreeRing<CEvent, EVQ_RING_SIZE>	Ring;
+
+	std::atomic<_BOOLEAN>	bActive;
+	std::atomic<int>		iNumLost;
+	int						iNumLostReported;
+
+	std::thread				Dispatcher;
+	HANDLE					hDataEvent;
+	std::atomic<_BOOLEAN>	bRun;
+	_EVENT_CALLBACK			pCallback;
+	void*					pUser;
+};
+
+extern CEventQueue EventQueue;
+
+
+#endif // !defined(EVENTQUEUE_H__3B0UBVE98732KJVEW363EVENTQUE__INCLUDED_)
@@ -36,8 +36,6 @@
 
 /* Implementation *************************************************************/
 
-int packlen =  40;
-int streamlen =  0;
 
 /******************************************************************************\
 * CFACTransmit																   *
@@ -280,9 +278,6 @@ void CFACTransmit::Init(CParameter& Parameter)
 * CFACReceive																   *
 \******************************************************************************/
 
-string strlabel[3];
-int ilabelstate = 0;
-
 _BOOLEAN CFACReceive::FACParam(CVector<_BINARY>* pbiFACData,
 	CParameter& Parameter)
 {
@@ -57,7 +57,7 @@ protected:
 class CFACReceive
 {
 public:
-	CFACReceive() {}
+	CFACReceive() : packlen(40), streamlen(0), ilabelstate(0) {}
 	virtual ~CFACReceive() {}
 
 	/* "pbiFACData" contains 72 bits */
@@ -65,6 +65,12 @@ public:
 
 protected:
 	CCRC CRCObject;
+
+	/* Kept from block to block, one set per receiver */
+	int packlen;
+	int streamlen;
+	string strlabel[3];
+	int ilabelstate;
 };
 
 
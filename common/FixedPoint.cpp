@@ -0,0 +1,303 @@
+/******************************************************************************\
+ * Copyright (c) 2024
+ *
+ * Author(s):
+ *	EasyDRF developers
+ *
+ * Description:
+ *	Fixed-point arithmetic for the receive path
+ *
+ *	Small ARM boards run the receiver unattended, there the double precision
+ *	complex math of the modules is what limits the number of receivers. With
+ *	USE_FIXED_POINT the hot loops of the receiver work on Q15 values with
+ *	32 bit accumulators: the polyphase filter of the input resampler, the FFT
+ *	of the OFDM demodulation, the frequency interpolation and equalization of
+ *	the channel estimation and the QAM metrics for the Viterbi decoder.
+ *	Blocks of complex values get one common exponent (block floating point),
+ *	so the quantization follows the level of the signal.
+ *
+ *	The buffers between the modules still hold _REAL values. The benchmark
+ *	("-bf", see DrmSimulation.cpp) runs both paths over the simulated channel
+ *	and reports the difference of the sensitivity in dB
+ *
+ ******************************************************************************
+ *
+ * This program is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation; either version 2 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ *
+\******************************************************************************/
+
+#include "FixedPoint.h"
+#include <string.h>
+
+
+/* Implementation *************************************************************/
+int FixedPointRx = TRUE;
+
+int GetBlockExp(const _REAL rMaxAbs)
+{
+	if (rMaxAbs <= (_REAL) 0.0)
+		return 0;
+
+	/* rMaxAbs = m * 2^exp with 0.5 <= m < 1 */
+	int iExp;
+	frexp(rMaxAbs, &iExp);
+
+	return iExp + 1;
+}
+
+static CComplexQ15 ExpQ15(const _REAL rPhase, const _REAL rAmp)
+{
+	CComplexQ15 c;
+	c.re = SatQ15(RoundReal(cos(rPhase) * rAmp * FIXP_Q15_ONE));
+	c.im = SatQ15(RoundReal(sin(rPhase) * rAmp * FIXP_Q15_ONE));
+	return c;
+}
+
+void CFftQ15::Init(const int iNewSize)
+{
+	int i, j, k;
+
+	if (iNewSize == iSize)
+		return;
+
+	/* Radix 4 first, it needs no multiplications in the butterfly */
+	std::vector<int> veciRadix;
+	int iRest = iNewSize;
+
+	while (iRest % 4 == 0)
+	{
+		veciRadix.push_back(4);
+		iRest /= 4;
+	}
+	while (iRest % 2 == 0)
+	{
+		veciRadix.push_back(2);
+		iRest /= 2;
+	}
+	while (iRest % 3 == 0)
+	{
+		veciRadix.push_back(3);
+		iRest /= 3;
+	}
+	while (iRest % 5 == 0)
+	{
+		veciRadix.push_back(5);
+		iRest /= 5;
+	}
+
+	if ((iRest != 1) || (iNewSize < 2))
+		throw CGenErr("Fixed-point FFT: size not supported");
+
+	iSize = iNewSize;
+
+	/* Stockham stages: the first one works on the whole length, the twiddle
+	   factors are exp(-j 2 pi j q / n) of the current length n */
+	vecStages.clear();
+	vecTwiddles.clear();
+
+	int iN = iSize;
+	int iStride = 1;
+
+	for (i = 0; i < (int) veciRadix.size(); i++)
+	{
+		CStage Stage;
+		Stage.iRadix = veciRadix[i];
+		Stage.iM = iN / Stage.iRadix;
+		Stage.iStride = iStride;
+		Stage.iTwiddle = (int) vecTwiddles.size();
+
+		for (k = 0; k < Stage.iM; k++)
+		{
+			for (j = 1; j < Stage.iRadix; j++)
+			{
+				vecTwiddles.push_back(
+					ExpQ15((_REAL) -2.0 * crPi * j * k / iN, (_REAL) 1.0));
+			}
+		}
+
+		vecStages.push_back(Stage);
+
+		iN = Stage.iM;
+		iStride *= Stage.iRadix;
+	}
+
+	/* Butterflies of the odd radices, scaled with 1 / p */
+	for (j = 0; j < 3; j++)
+	{
+		for (k = 0; k < 3; k++)
+		{
+			cDFT3[j][k] = ExpQ15((_REAL) -2.0 * crPi * j * k / 3,
+				(_REAL) 1.0 / 3);
+		}
+	}
+
+	for (j = 0; j < 5; j++)
+	{
+		for (k = 0; k < 5; k++)
+		{
+			cDFT5[j][k] = ExpQ15((_REAL) -2.0 * crPi * j * k / 5,
+				(_REAL) 1.0 / 5);
+		}
+	}
+
+	vecWork.resize(iSize);
+}
+
+void CFftQ15::Forward(CComplexQ15* pData)
+{
+	CComplexQ15* pIn = pData;
+	CComplexQ15* pOut = &vecWork[0];
+
+	for (size_t i = 0; i < vecStages.size(); i++)
+	{
+		switch (vecStages[i].iRadix)
+		{
+		case 2:
+			Radix2(vecStages[i], pIn, pOut);
+			break;
+
+		case 4:
+			Radix4(vecStages[i], pIn, pOut);
+			break;
+
+		default:
+			RadixOdd(vecStages[i], pIn, pOut);
+			break;
+		}
+
+		CComplexQ15* pTmp = pIn;
+		pIn = pOut;
+		pOut = pTmp;
+	}
+
+	/* Result of the last stage is in the work buffer */
+	if (pIn != pData)
+		memcpy(pData, pIn, iSize * sizeof(CComplexQ15));
+}
+
+void CFftQ15::Radix2(const CStage& Stage, const CComplexQ15* pIn, CComplexQ15* pOut)
+{
+	const int iM = Stage.iM;
+	const int iS = Stage.iStride;
+	const CComplexQ15* pTw = &vecTwiddles[Stage.iTwiddle];
+
+	for (int q = 0; q < iM; q++)
+	{
+		const CComplexQ15 w = pTw[q];
+
+		for (int s = 0; s < iS; s++)
+		{
+			const CComplexQ15 a0 = pIn[s + iS * q];
+			const CComplexQ15 a1 = pIn[s + iS * (q + iM)];
+
+			CComplexQ15 b;
+			pOut[s + iS * 2 * q].re = (_FIXP16) RoundShift(a0.re + a1.re, 1);
+			pOut[s + iS * 2 * q].im = (_FIXP16) RoundShift(a0.im + a1.im, 1);
+			b.re = (_FIXP16) RoundShift(a0.re - a1.re, 1);
+			b.im = (_FIXP16) RoundShift(a0.im - a1.im, 1);
+			pOut[s + iS * (2 * q + 1)] = MulQ15(b, w);
+		}
+	}
+}
+
+void CFftQ15::Radix4(const CStage& Stage, const CComplexQ15* pIn, CComplexQ15* pOut)
+{
+	const int iM = Stage.iM;
+	const int iS = Stage.iStride;
+	const CComplexQ15* pTw = &vecTwiddles[Stage.iTwiddle];
+
+	for (int q = 0; q < iM; q++)
+	{
+		const CComplexQ15* w = &pTw[3 * q];
+
+		for (int s = 0; s < iS; s++)
+		{
+			const CComplexQ15 a0 = pIn[s + iS * q];
+			const CComplexQ15 a1 = pIn[s + iS * (q + iM)];
+			const CComplexQ15 a2 = pIn[s + iS * (q + 2 * iM)];
+			const CComplexQ15 a3 = pIn[s + iS * (q + 3 * iM)];
+
+			/* t3 = -j (a1 - a3) */
+			const int t0re = a0.re + a2.re, t0im = a0.im + a2.im;
+			const int t1re = a0.re - a2.re, t1im = a0.im - a2.im;
+			const int t2re = a1.re + a3.re, t2im = a1.im + a3.im;
+			const int t3re = a1.im - a3.im, t3im = a3.re - a1.re;
+
+			CComplexQ15 b1, b2, b3;
+			CComplexQ15* pY = &pOut[s + iS * 4 * q];
+
+			pY[0].re = (_FIXP16) RoundShift(t0re + t2re, 2);
+			pY[0].im = (_FIXP16) RoundShift(t0im + t2im, 2);
+			b1.re = (_FIXP16) RoundShift(t1re + t3re, 2);
+			b1.im = (_FIXP16) RoundShift(t1im + t3im, 2);
+			b2.re = (_FIXP16) RoundShift(t0re - t2re, 2);
+			b2.im = (_FIXP16) RoundShift(t0im - t2im, 2);
+			b3.re = (_FIXP16) RoundShift(t1re - t3re, 2);
+			b3.im = (_FIXP16) RoundShift(t1im - t3im, 2);
+
+			pY[iS] = MulQ15(b1, w[0]);
+			pY[2 * iS] = MulQ15(b2, w[1]);
+			pY[3 * iS] = MulQ15(b3, w[2]);
+		}
+	}
+}
+
+void CFftQ15::RadixOdd(const CStage& Stage, const CComplexQ15* pIn, CComplexQ15* pOut)
+{
+	const int iP = Stage.iRadix;
+	const int iM = Stage.iM;
+	const int iS = Stage.iStride;
+	const CComplexQ15* pTw = &vecTwiddles[Stage.iTwiddle];
+	const CComplexQ15* pDFT = (iP == 3) ? &cDFT3[0][0] : &cDFT5[0][0];
+
+	CComplexQ15 a[5];
+
+	for (int q = 0; q < iM; q++)
+	{
+		const CComplexQ15* w = &pTw[(iP - 1) * q];
+
+		for (int s = 0; s < iS; s++)
+		{
+			int j, k;
+
+			for (k = 0; k < iP; k++)
+				a[k] = pIn[s + iS * (q + k * iM)];
+
+			CComplexQ15* pY = &pOut[s + iS * iP * q];
+
+			for (j = 0; j < iP; j++)
+			{
+				/* Q30, the 1 / p of the butterfly keeps it in range */
+				int iRe = 0, iIm = 0;
+				const CComplexQ15* d = &pDFT[j * iP];
+
+				for (k = 0; k < iP; k++)
+				{
+					iRe += (int) a[k].re * d[k].re - (int) a[k].im * d[k].im;
+					iIm += (int) a[k].re * d[k].im + (int) a[k].im * d[k].re;
+				}
+
+				CComplexQ15 b;
+				b.re = SatQ15(RoundShift(iRe, 15));
+				b.im = SatQ15(RoundShift(iIm, 15));
+
+				if (j == 0)
+					pY[0] = b;
+				else
+					pY[j * iS] = MulQ15(b, w[j - 1]);
+			}
+		}
+	}
+}
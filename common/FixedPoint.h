@@ -0,0 +1,185 @@
+/******************************************************************************\
+ * Copyright (c) 2024
+ *
+ * Author(s):
+ *	EasyDRF developers
+ *
+ * Description:
+ *	See FixedPoint.cpp
+ *
+ ******************************************************************************
+ *
+ * This program is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation; either version 2 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ *
+\******************************************************************************/
+
+#if !defined(FIXEDPOINT_H__3B0UBVE98732KJVEW363FIXPOINT__INCLUDED_)
+#define FIXEDPOINT_H__3B0UBVE98732KJVEW363FIXPOINT__INCLUDED_
+
+#include <math.h>
+#include <vector>
+#include "GlobalDefinitions.h"
+
+
+/* Definitions ****************************************************************/
+/* Set to TRUE to build the fixed-point receive path (resampler, OFDM FFT,
+   frequency interpolation and equalization, QAM metrics).
+   Known limitation: the buffers between the modules still hold _REAL values,
+   each of these modules converts its input to Q15 and its output back. The
+   path therefore still needs a floating-point unit and pays for the
+   conversions, it shows the precision of a Q15 receiver, not its speed */
+#define USE_FIXED_POINT				FALSE
+
+/* Q15: 1 sign bit, 15 bits after the point. Q31 for accumulators */
+typedef short						_FIXP16;
+typedef int							_FIXP32;
+
+#define FIXP_Q15_ONE				32768
+
+/* Equalized cells and the QAM tables: Q13, the 64-QAM points are up to 1.08,
+   noisy cells go a bit further */
+#define FIXP_SIG_FRAC_BITS			13
+
+/* Set by the benchmark to compare both receive paths in one build (only
+   read when USE_FIXED_POINT is TRUE, modules read it in Init()) */
+extern int FixedPointRx;
+
+
+/* Classes ********************************************************************/
+class CComplexQ15
+{
+public:
+	_FIXP16		re;
+	_FIXP16		im;
+};
+
+inline _FIXP16 SatQ15(const int iVal)
+{
+	if (iVal > 32767)
+		return 32767;
+	if (iVal < -32768)
+		return -32768;
+
+	return (_FIXP16) iVal;
+}
+
+/* Shift right with rounding */
+inline int RoundShift(const int iVal, const int iShift)
+{
+	return (iVal + (1 << (iShift - 1))) >> iShift;
+}
+
+inline int RoundReal(const _REAL rVal)
+{
+	return (int) floor(rVal + (_REAL) 0.5);
+}
+
+/* (a * b) in Q15, both factors Q15 */
+inline CComplexQ15 MulQ15(const CComplexQ15 a, const CComplexQ15 b)
+{
+	CComplexQ15 c;
+	c.re = SatQ15(RoundShift((int) a.re * b.re - (int) a.im * b.im, 15));
+	c.im = SatQ15(RoundShift((int) a.re * b.im + (int) a.im * b.re, 15));
+	return c;
+}
+
+/* Exponent of a block with the largest magnitude "rMaxAbs": the values times
+   2^-exp are below 0.5, so sums of two values still fit in Q15 */
+int GetBlockExp(const _REAL rMaxAbs);
+
+/* One complex value with "iFracBits" bits after the point, e.g. filter taps */
+inline CComplexQ15 ComplexToFix(const _COMPLEX cVal, const int iFracBits)
+{
+	CComplexQ15 c;
+	c.re = SatQ15(RoundReal(ldexp(cVal.real(), iFracBits)));
+	c.im = SatQ15(RoundReal(ldexp(cVal.imag(), iFracBits)));
+	return c;
+}
+
+/* Block floating point: the complex values are converted to Q15 with one
+   exponent for all of them, which is returned */
+template<class TVec> int ComplexToQ15(const TVec& vecIn, const int iLen,
+									  CComplexQ15* pOut)
+{
+	int i;
+	_REAL rMaxAbs = (_REAL) 0.0;
+
+	for (i = 0; i < iLen; i++)
+	{
+		const _REAL rRe = fabs(vecIn[i].real());
+		const _REAL rIm = fabs(vecIn[i].imag());
+
+		if (rRe > rMaxAbs)
+			rMaxAbs = rRe;
+		if (rIm > rMaxAbs)
+			rMaxAbs = rIm;
+	}
+
+	const int iExp = GetBlockExp(rMaxAbs);
+	const _REAL rScale = ldexp((_REAL) FIXP_Q15_ONE, -iExp);
+
+	for (i = 0; i < iLen; i++)
+	{
+		pOut[i].re = SatQ15(RoundReal(vecIn[i].real() * rScale));
+		pOut[i].im = SatQ15(RoundReal(vecIn[i].imag() * rScale));
+	}
+
+	return iExp;
+}
+
+/* FFT of Q15 values for the OFDM symbols (sizes 1152, 1024 and 640, so the
+   radices 4, 2, 3 and 5 are needed). Each stage divides by its radix, the
+   result is X[k] / N like the normalization in the OFDM demodulation and
+   can not overflow */
+class CFftQ15
+{
+public:
+	CFftQ15() : iSize(0) {}
+	virtual ~CFftQ15() {}
+
+	/* Throws CGenErr if the size has other prime factors */
+	void Init(const int iNewSize);
+
+	/* In place */
+	void Forward(CComplexQ15* pData);
+
+	int GetSize() const {return iSize;}
+
+protected:
+	class CStage
+	{
+	public:
+		int		iRadix;
+		int		iM; /* butterflies per group */
+		int		iStride;
+		int		iTwiddle; /* first twiddle factor of the stage */
+	};
+
+	void Radix2(const CStage& Stage, const CComplexQ15* pIn, CComplexQ15* pOut);
+	void Radix4(const CStage& Stage, const CComplexQ15* pIn, CComplexQ15* pOut);
+	void RadixOdd(const CStage& Stage, const CComplexQ15* pIn, CComplexQ15* pOut);
+
+	int							iSize;
+	std::vector<CStage>			vecStages;
+	std::vector<CComplexQ15>	vecTwiddles;
+	std::vector<CComplexQ15>	vecWork;
+
+	/* exp(-j 2 pi j k / p) / p for the radices 3 and 5 */
+	CComplexQ15					cDFT3[3][3];
+	CComplexQ15					cDFT5[5][5];
+};
+
+
+#endif // !defined(FIXEDPOINT_H__3B0UBVE98732KJVEW363FIXPOINT__INCLUDED_)
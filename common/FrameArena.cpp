@@ -0,0 +1,76 @@
+/******************************************************************************\
+ * Copyright (c) 2024
+ *
+ * Author(s):
+ *	EasyDRF developers
+ *
+ * Description:
+ *	Memory for the temporaries of one frame
+ *
+ *	The receiver and the transmitter own an arena each. Their processing
+ *	loop opens a CFrameScope per pass, during which the temporary Matlib
+ *	vectors of the thread (results of the operators, FFTs and filters) are
+ *	taken from the arena instead of the heap. The block is only enlarged
+ *	between two frames and only if nothing is left in it, so a temporary
+ *	which is kept longer (e.g. stolen by a member vector) never loses its
+ *	memory; the arena then simply stays full and the heap is used
+ *
+ ******************************************************************************
+ *
+ * This program is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation; either version 2 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ *
+\******************************************************************************/
+
+#include "FrameArena.h"
+
+
+/* Implementation *************************************************************/
+thread_local CFrameArena* pFrameArena = NULL;
+
+static char* AlignBlock(char* pchMem)
+{
+	return (char*) (((size_t) pchMem + FRAME_ARENA_ALIGN - 1) &
+		~((size_t) FRAME_ARENA_ALIGN - 1));
+}
+
+CFrameArena::CFrameArena() : iSize(FRAME_ARENA_INIT_SIZE), iUsed(0), iWanted(0),
+	iHighWater(0), iNumLive(0), llNumFrames(0), llNumHeapAllocs(0)
+{
+	pchMem = new char[iSize + FRAME_ARENA_ALIGN];
+	pchBlock = AlignBlock(pchMem);
+}
+
+CFrameArena::~CFrameArena()
+{
+	delete[] pchMem;
+}
+
+void CFrameArena::EndFrame()
+{
+	llNumFrames++;
+
+	/* A temporary is still in the block, it must stay where it is */
+	if ((iWanted <= iSize) || (iNumLive != 0))
+		return;
+
+	/* Some room for frames which need a bit more, e.g. after a mode change */
+	iSize = iWanted + iWanted / 2;
+	iWanted = 0;
+
+	delete[] pchMem;
+	pchMem = new char[iSize + FRAME_ARENA_ALIGN];
+	pchBlock = AlignBlock(pchMem);
+	iUsed = 0;
+}
@@ -0,0 +1,145 @@
+/******************************************************************************\
+ * Copyright (c) 2024
+ *
+ * Author(s):
+ *	EasyDRF developers
+ *
+ * Description:
+ *	See FrameArena.cpp
+ *
+ ******************************************************************************
+ *
+ * This program is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation; either version 2 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ *
+\******************************************************************************/
+
+#if !defined(FRAMEARENA_H__3B0UBVE98732KJVEW363FRMARENA__INCLUDED_)
+#define FRAMEARENA_H__3B0UBVE98732KJVEW363FRMARENA__INCLUDED_
+
+#include <stddef.h>
+#include "GlobalDefinitions.h"
+
+
+/* Definitions ****************************************************************/
+/* Set to FALSE to take all temporaries from the heap again */
+#define USE_FRAME_ARENA				TRUE
+
+/* First size of the block, it grows to what the frames really need */
+#define FRAME_ARENA_INIT_SIZE		(256 * 1024)
+
+/* Alignment of each temporary (SSE/AVX loads) */
+#define FRAME_ARENA_ALIGN			32
+
+
+/* Classes ********************************************************************/
+/* Temporaries of one processing thread, e.g. the results of the Matlib
+   operators. The memory is taken from one block from the front. When the
+   last temporary is given back, the block is empty again, so the same
+   addresses are used in every frame. A temporary which does not fit comes
+   from the heap; after the frame the block is enlarged, so this only
+   happens in the first frames */
+class CFrameArena
+{
+public:
+	CFrameArena();
+	virtual ~CFrameArena();
+
+	/* NULL if the block is full, the caller uses the heap then */
+	inline void*	Alloc(const size_t iBytes)
+	{
+		const size_t iNewUsed = iUsed + ((iBytes + FRAME_ARENA_ALIGN - 1) &
+			~((size_t) FRAME_ARENA_ALIGN - 1));
+
+		if (iNewUsed > iSize)
+		{
+			/* The block must hold this much after the frame */
+			if (iNewUsed > iWanted)
+				iWanted = iNewUsed;
+
+			llNumHeapAllocs++;
+			return NULL;
+		}
+
+		void* pMem = pchBlock + iUsed;
+		iUsed = iNewUsed;
+		iNumLive++;
+
+		if (iUsed > iHighWater)
+			iHighWater = iUsed;
+
+		return pMem;
+	}
+
+	inline void		Free(void*)
+	{
+		/* The temporaries are given back in any order, the block is reused
+		   as soon as none is alive */
+		iNumLive--;
+		if (iNumLive == 0)
+			iUsed = 0;
+	}
+
+	/* Called by CFrameScope after each frame */
+	void			EndFrame();
+
+	long long		GetNumFrames() {return llNumFrames;}
+	long long		GetNumHeapAllocs() {return llNumHeapAllocs;}
+	size_t			GetHighWater() {return iHighWater;}
+	size_t			GetSize() {return iSize;}
+
+protected:
+	char*			pchMem;
+	char*			pchBlock; /* aligned start in pchMem */
+	size_t			iSize;
+	size_t			iUsed;
+	size_t			iWanted;
+	size_t			iHighWater;
+	int				iNumLive;
+
+	long long		llNumFrames;
+	long long		llNumHeapAllocs;
+};
+
+/* Arena of the calling thread, NULL if it has none */
+extern thread_local CFrameArena* pFrameArena;
+
+/* One frame of a processing thread. The arena is active for the thread until
+   the scope ends, scopes can be nested (the benchmark runs the transmitter
+   in the receive thread) */
+class CFrameScope
+{
+public:
+	CFrameScope(CFrameArena& NewArena) : Arena(NewArena), pOldArena(pFrameArena)
+	{
+#if USE_FRAME_ARENA
+		pFrameArena = &Arena;
+#endif
+	}
+
+	~CFrameScope()
+	{
+#if USE_FRAME_ARENA
+		pFrameArena = pOldArena;
+		Arena.EndFrame();
+#endif
+	}
+
+protected:
+	CFrameArena&	Arena;
+	CFrameArena*	pOldArena;
+};
+
+
+#endif // !defined(FRAMEARENA_H__3B0UBVE98732KJVEW363FRMARENA__INCLUDED_)
@@ -228,6 +228,24 @@ public:
 /* Posting a window message */
 void PostWinMessage(const _MESSAGE_IDENT MessID, const int iMessageParam = 0);
 
+/* Receiver instance of the calling thread, messages are kept per instance */
+extern thread_local int iRxChannel;
+
+/* If set, the messages of the calling thread go to this sink instead of the
+   GUI (used by the loopback simulation to count CRC results) */
+class CMessageSink
+{
+public:
+	virtual ~CMessageSink() {}
+	virtual void OnMessage(const _MESSAGE_IDENT MessID, const int iMessageParam) = 0;
+};
+
+extern thread_local CMessageSink* pMessageSink;
+
+/* While this is above zero, the heap allocations of the calling thread are
+   not counted by the loopback benchmark (MOT objects, simulated channel) */
+extern thread_local int iHeapCountPause;
+
 /* Debug error handling */
 void DebugError(const char* pchErDescr, const char* pchPar1Descr, const double dPar1, const char* pchPar2Descr,	const double dPar2);
 
@@ -0,0 +1,116 @@
+/******************************************************************************\
+ * Copyright (c) 2024
+ *
+ * Author(s):
+ *	EasyDRF developers
+ *
+ * Description:
+ *	Bounded ring for any number of producers and one consumer
+ *
+ ******************************************************************************
+ *
+ * This program is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation; either version 2 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ *
+\******************************************************************************/
+
+#if !defined(LOCKFREERING_H__3B0UBVE98732KJVEW363L0CKFREE__INCLUDED_)
+#define LOCKFREERING_H__3B0UBVE98732KJVEW363L0CKFREE__INCLUDED_
+
+#include <atomic>
+#include "GlobalDefinitions.h"
+
+
+/* Classes ********************************************************************/
+/* Each slot has a sequence number which tells whether it is free or filled,
+   so a producer only needs one compare-exchange on the write position and
+   never waits. The size must be a power of 2 */
+template<class T, unsigned int N> class CLockFreeRing
+{
+public:
+	CLockFreeRing() : iWritePos(0), iReadPos(0)
+	{
+		for (unsigned int i = 0; i < N; i++)
+			Slot[i].iSeq.store(i, std::memory_order_relaxed);
+	}
+	virtual ~CLockFreeRing() {}
+
+	/* Callable from every thread, FALSE if the ring is full */
+	_BOOLEAN	Push(const T& Item)
+	{
+		/* Reserve a slot. The sequence number equals the position if the slot
+		   is free, it is behind if the consumer has not emptied it yet */
+		unsigned int iPos = iWritePos.load(std::memory_order_relaxed);
+		CSlot* pSlot;
+
+		for (;;)
+		{
+			pSlot = &Slot[iPos & (N - 1)];
+
+			const int iDiff = (int) (pSlot->iSeq.load(std::memory_order_acquire) - iPos);
+
+			if (iDiff == 0)
+			{
+				if (iWritePos.compare_exchange_weak(iPos, iPos + 1,
+					std::memory_order_relaxed) == TRUE)
+				{
+					break;
+				}
+			}
+			else if (iDiff < 0)
+				return FALSE;
+			else
+				iPos = iWritePos.load(std::memory_order_relaxed);
+		}
+
+		pSlot->Item = Item;
+
+		/* Now the consumer may read the slot */
+		pSlot->iSeq.store(iPos + 1, std::memory_order_release);
+
+		return TRUE;
+	}
+
+	/* Consumer only */
+	_BOOLEAN	Pop(T& Item)
+	{
+		CSlot& CurSlot = Slot[iReadPos & (N - 1)];
+
+		if (CurSlot.iSeq.load(std::memory_order_acquire) != iReadPos + 1)
+			return FALSE;
+
+		Item = CurSlot.Item;
+
+		/* Free for the producers of the next round */
+		CurSlot.iSeq.store(iReadPos + N, std::memory_order_release);
+		iReadPos++;
+
+		return TRUE;
+	}
+
+protected:
+	class CSlot
+	{
+	public:
+		std::atomic<unsigned int>	iSeq;
+		T							Item;
+	};
+
+	CSlot						Slot[N];
+	std::atomic<unsigned int>	iWritePos;
+	unsigned int				iReadPos;
+};
+
+
+#endif // !defined(LOCKFREERING_H__3B0UBVE98732KJVEW363L0CKFREE__INCLUDED_)
@@ -30,9 +30,11 @@
 #if !defined(AFX_MODUL_H__41E39CD3_2AEC_400E_907B_148C0EC17A43__INCLUDED_)
 #define AFX_MODUL_H__41E39CD3_2AEC_400E_907B_148C0EC17A43__INCLUDED_
 
+#include <typeinfo>
 #include "Buffer.h"
 #include "Vector.h"
 #include "Parameter.h"
+#include "ModulStats.h"
 
 
 /* Classes ********************************************************************/
@@ -62,11 +64,17 @@ protected:
 
 	void				InitThreadSave(CParameter& Parameter);
 	virtual void		InitInternal(CParameter& Parameter) = 0;
-	void				ProcessDataThreadSave(CParameter& Parameter);
+	/* "iInputFill" is what is left in the input buffer after the block for
+	   this call was taken, -1 for modules without input buffer */
+	void				ProcessDataThreadSave(CParameter& Parameter, const int iInputFill = -1);
+	void				ProcessDataTimed(CParameter& Parameter, const int iInputFill = -1);
 	virtual void		ProcessDataInternal(CParameter& Parameter) = 0;
 
 private:
 	CMutex				Mutex;
+
+	/* Entry in the module statistics, see ModulStats.cpp */
+	CModulStat*			pStat;
 };
 
 
@@ -153,21 +161,43 @@ CModul<TInput, TOutput>::CModul()
 	iOutputBlockSize = 0;
 	pvecInputData = NULL;
 	pvecOutputData = NULL;
+	pStat = NULL;
 }
 
 template<class TInput, class TOutput> 
-void CModul<TInput, TOutput>::ProcessDataThreadSave(CParameter& Parameter)
+void CModul<TInput, TOutput>::ProcessDataThreadSave(CParameter& Parameter, const int iInputFill)
 {
 	/* Get a lock for the resources */
 	Lock();
 
 	/* Call processing routine of derived modul */
-	ProcessDataInternal(Parameter);
+	ProcessDataTimed(Parameter, iInputFill);
 
 	/* Unlock resources */
 	Unlock();
 }
 
+template<class TInput, class TOutput> 
+void CModul<TInput, TOutput>::ProcessDataTimed(CParameter& Parameter, const int iInputFill)
+{
+#if USE_MODUL_STATS
+	/* The type of the derived modul is not known in the constructor */
+	if (pStat == NULL)
+		pStat = ModulStats.Register(typeid(*this).name());
+
+	const int iIn = iInputBlockSize;
+	const std::chrono::steady_clock::time_point Start = std::chrono::steady_clock::now();
+
+	ProcessDataInternal(Parameter);
+
+	pStat->Add(std::chrono::duration_cast<std::chrono::nanoseconds>(
+		std::chrono::steady_clock::now() - Start).count(),
+		iIn, iOutputBlockSize, iInputFill);
+#else
+	ProcessDataInternal(Parameter);
+#endif
+}
+
 template<class TInput, class TOutput> 
 void CModul<TInput, TOutput>::InitThreadSave(CParameter& Parameter)
 {
@@ -270,7 +300,7 @@ void CTransmitterModul<TInput, TOutput>::
 		pvecOutputData = OutputBuffer.QueryWriteBuffer();
 
 		/* Call the underlying processing-routine */
-		ProcessDataInternal(Parameter);
+		ProcessDataTimed(Parameter);
 	
 		/* Write processed data from internal memory in transfer-buffer */
 		OutputBuffer.Put(iOutputBlockSize);
@@ -307,7 +337,7 @@ _BOOLEAN CTransmitterModul<TInput, TOutput>::
 		(*pvecOutputData).SetExData((*pvecInputData).GetExData());
 
 		/* Call the underlying processing-routine */
-		ProcessDataInternal(Parameter);
+		ProcessDataTimed(Parameter, InputBuffer.GetFillLevel());
 	
 		/* Write processed data from internal memory in transfer-buffer */
 		OutputBuffer.Put(iOutputBlockSize);
@@ -351,7 +381,7 @@ void CTransmitterModul<TInput, TOutput>::
 		pvecOutputData = OutputBuffer.QueryWriteBuffer();
 
 		/* Call the underlying processing-routine */
-		ProcessDataInternal(Parameter);
+		ProcessDataTimed(Parameter, InputBuffer.GetFillLevel());
 	
 		/* Write processed data from internal memory in transfer-buffer */
 		OutputBuffer.Put(iOutputBlockSize);
@@ -374,7 +404,7 @@ void CTransmitterModul<TInput, TOutput>::
 		pvecOutputData = OutputBuffer.QueryWriteBuffer();
 
 		/* Call the underlying processing-routine */
-		ProcessDataInternal(Parameter);
+		ProcessDataTimed(Parameter);
 		
 		/* Write processed data from internal memory in transfer-buffer */
 		OutputBuffer.Put(iOutputBlockSize);
@@ -402,7 +432,7 @@ _BOOLEAN CTransmitterModul<TInput, TOutput>::
 	pvecInputData = InputBuffer.Get(iInputBlockSize);
 
 	/* Call the underlying processing-routine */
-	ProcessDataInternal(Parameter);
+	ProcessDataTimed(Parameter, InputBuffer.GetFillLevel());
 
 	return TRUE;
 }
@@ -538,7 +568,7 @@ _BOOLEAN CReceiverModul<TInput, TOutput>::
 		(*pvecOutputData).SetExData((*pvecInputData).GetExData());
 
 		/* Call the underlying processing-routine */
-		ProcessDataThreadSave(Parameter);
+		ProcessDataThreadSave(Parameter, InputBuffer.GetFillLevel());
 	
 		/* Write processed data from internal memory in transfer-buffer */
 		OutputBuffer.Put(iOutputBlockSize);
@@ -591,7 +621,7 @@ _BOOLEAN CReceiverModul<TInput, TOutput>::
 		pvecOutputData2 = OutputBuffer2.QueryWriteBuffer();
 		
 		/* Call the underlying processing-routine */
-		ProcessDataThreadSave(Parameter);
+		ProcessDataThreadSave(Parameter, InputBuffer.GetFillLevel());
 	
 		/* Write processed data from internal memory in transfer-buffers */
 		OutputBuffer.Put(iOutputBlockSize);
@@ -652,7 +682,7 @@ _BOOLEAN CReceiverModul<TInput, TOutput>::
 		pvecOutputData3 = OutputBuffer3.QueryWriteBuffer();
 		
 		/* Call the underlying processing-routine */
-		ProcessDataThreadSave(Parameter);
+		ProcessDataThreadSave(Parameter, InputBuffer.GetFillLevel());
 	
 		/* Write processed data from internal memory in transfer-buffers */
 		OutputBuffer.Put(iOutputBlockSize);
@@ -760,7 +790,7 @@ _BOOLEAN CReceiverModul<TInput, TOutput>::
 		pvecInputData = InputBuffer.Get(iInputBlockSize);
 	
 		/* Call the underlying processing-routine */
-		ProcessDataThreadSave(Parameter);
+		ProcessDataThreadSave(Parameter, InputBuffer.GetFillLevel());
 	}
 
 	return bEnoughData;
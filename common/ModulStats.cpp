@@ -0,0 +1,188 @@
+/******************************************************************************\
+ * Copyright (c) 2024
+ *
+ * Author(s):
+ *	EasyDRF developers
+ *
+ * Description:
+ *	Timing and counters of the processing modules
+ *
+ *	Every module runs its processing routine through CModul (see Modul.h),
+ *	which measures the wall time of each call and counts the samples. The
+ *	counters are atomics, so the processing threads never wait for each
+ *	other or for the reader. Instances of the same class share one entry,
+ *	e.g. "CTimeSync" is the sum of all receivers. A snapshot can be taken at
+ *	any time, the table can also be appended to a file periodically
+ *
+ ******************************************************************************
+ *
+ * This program is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation; either version 2 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ *
+\******************************************************************************/
+
+#include "ModulStats.h"
+#include <string.h>
+
+
+/* Implementation *************************************************************/
+CModulStats ModulStats;
+
+CModulStat* CModulStats::Register(const char* pchName)
+{
+	/* MSVC names the type "class CTimeSync" */
+	if (strncmp(pchName, "class ", 6) == 0)
+		pchName += 6;
+
+	std::lock_guard<std::mutex> Lock(RegMutex);
+
+	const int iNum = iNumModules.load();
+
+	for (int i = 0; i < iNum; i++)
+	{
+		if (strcmp(Stat[i].chName, pchName) == 0)
+			return &Stat[i];
+	}
+
+	/* The last entry collects all modules which do not fit */
+	if (iNum == MODSTATS_MAX_MODULES)
+		return &Stat[MODSTATS_MAX_MODULES - 1];
+
+	CModulStat& NewStat = Stat[iNum];
+
+	if (iNum == MODSTATS_MAX_MODULES - 1)
+		strcpy(NewStat.chName, "(others)");
+	else
+	{
+		strncpy(NewStat.chName, pchName, MODSTATS_NAME_LEN - 1);
+		NewStat.chName[MODSTATS_NAME_LEN - 1] = 0;
+	}
+
+	NewStat.Reset();
+
+	/* The entry is complete before the readers see it */
+	iNumModules.store(iNum + 1);
+
+	return &NewStat;
+}
+
+int CModulStats::GetSnapshot(CVector<CModulStatSnap>& vecSnap)
+{
+	const int iNum = iNumModules.load();
+
+	vecSnap.Init(iNum);
+
+	for (int i = 0; i < iNum; i++)
+	{
+		const CModulStat& CurStat = Stat[i];
+		CModulStatSnap& Snap = vecSnap[i];
+
+		Snap.strName = CurStat.chName;
+		Snap.llNumCalls = CurStat.llNumCalls.load(std::memory_order_relaxed);
+		Snap.rTimeTotalMs = (_REAL) CurStat.llTimeTotal.load(std::memory_order_relaxed) / 1000000;
+		Snap.rTimeMaxUs = (_REAL) CurStat.llTimeMax.load(std::memory_order_relaxed) / 1000;
+		Snap.llSamplesIn = CurStat.llSamplesIn.load(std::memory_order_relaxed);
+		Snap.llSamplesOut = CurStat.llSamplesOut.load(std::memory_order_relaxed);
+		Snap.iInputFill = CurStat.iInputFill.load(std::memory_order_relaxed);
+		Snap.iInputFillMax = CurStat.iInputFillMax.load(std::memory_order_relaxed);
+	}
+
+	return iNum;
+}
+
+void CModulStats::Reset()
+{
+	/* A module which is running at the same time may add one call to the old
+	   values, that does not matter for a profile */
+	const int iNum = iNumModules.load();
+
+	for (int i = 0; i < iNum; i++)
+		Stat[i].Reset();
+
+	StartTime = std::chrono::steady_clock::now();
+}
+
+_BOOLEAN CModulStats::Dump(const string& strFileName)
+{
+	CVector<CModulStatSnap> vecSnap;
+	const int iNum = GetSnapshot(vecSnap);
+
+	FILE* pFile = fopen(strFileName.c_str(), "a+t");
+	if (pFile == NULL)
+		return FALSE;
+
+	fprintf(pFile, "Modules after %.1f s\n", (_REAL) std::chrono::duration_cast<
+		std::chrono::milliseconds>(std::chrono::steady_clock::now() - StartTime).count() / 1000);
+	fprintf(pFile, "%-31s %10s %11s %9s %9s %12s %12s %7s %7s\n", "Module", "Calls",
+		"Total [ms]", "Avg [us]", "Max [us]", "Samples in", "Samples out", "Fill", "Max fill");
+
+	for (int i = 0; i < iNum; i++)
+	{
+		const CModulStatSnap& Snap = vecSnap[i];
+		_REAL rAvgUs = (_REAL) 0.0;
+
+		if (Snap.llNumCalls > 0)
+			rAvgUs = Snap.rTimeTotalMs * 1000 / Snap.llNumCalls;
+
+		fprintf(pFile, "%-31s %10lld %11.1f %9.1f %9.1f %12lld %12lld %7d %7d\n",
+			Snap.strName.c_str(), Snap.llNumCalls, Snap.rTimeTotalMs, rAvgUs,
+			Snap.rTimeMaxUs, Snap.llSamplesIn, Snap.llSamplesOut,
+			Snap.iInputFill, Snap.iInputFillMax);
+	}
+
+	fprintf(pFile, "\n");
+	fclose(pFile);
+
+	return TRUE;
+}
+
+void CModulStats::StartDump(const string& strFileName, const int iSeconds)
+{
+	StopDump();
+
+	if (iSeconds <= 0)
+		return;
+
+	strDumpFile = strFileName;
+	iDumpSec = iSeconds;
+	bDumpRun = TRUE;
+
+	DumpThread = std::thread(&CModulStats::RunDump, this);
+}
+
+void CModulStats::StopDump()
+{
+	{
+		std::lock_guard<std::mutex> Lock(DumpMutex);
+		bDumpRun = FALSE;
+	}
+
+	DumpCond.notify_all();
+
+	if (DumpThread.joinable())
+		DumpThread.join();
+}
+
+void CModulStats::RunDump()
+{
+	std::unique_lock<std::mutex> Lock(DumpMutex);
+
+	while (bDumpRun == TRUE)
+	{
+		DumpCond.wait_for(Lock, std::chrono::seconds(iDumpSec));
+
+		if (bDumpRun == TRUE)
+			Dump(strDumpFile);
+	}
+}
@@ -0,0 +1,158 @@
+/******************************************************************************\
+ * Copyright (c) 2024
+ *
+ * Author(s):
+ *	EasyDRF developers
+ *
+ * Description:
+ *	See ModulStats.cpp
+ *
+ ******************************************************************************
+ *
+ * This program is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation; either version 2 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ *
+\******************************************************************************/
+
+#if !defined(MODULSTATS_H__3B0UBVE98732KJVEW363M0DSTATS__INCLUDED_)
+#define MODULSTATS_H__3B0UBVE98732KJVEW363M0DSTATS__INCLUDED_
+
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <condition_variable>
+#include <chrono>
+#include "GlobalDefinitions.h"
+#include "Vector.h"
+
+
+/* Definitions ****************************************************************/
+/* Set to FALSE to remove the timing from the processing modules */
+#define USE_MODUL_STATS				TRUE
+
+/* Number of module types which are counted. All instances of one type (e.g.
+   the receivers of the wideband mode) share one entry */
+#define MODSTATS_MAX_MODULES		64
+#define MODSTATS_NAME_LEN			32
+
+
+/* Classes ********************************************************************/
+/* Counters of one module type. They are written by the processing threads
+   without lock */
+class CModulStat
+{
+public:
+	CModulStat() {Reset();}
+
+	void Reset()
+	{
+		llNumCalls = 0;
+		llTimeTotal = 0;
+		llTimeMax = 0;
+		llSamplesIn = 0;
+		llSamplesOut = 0;
+		iInputFill = 0;
+		iInputFillMax = 0;
+	}
+
+	inline void Add(const long long llTime, const int iIn, const int iOut, const int iFill)
+	{
+		llNumCalls.fetch_add(1, std::memory_order_relaxed);
+		llTimeTotal.fetch_add(llTime, std::memory_order_relaxed);
+		llSamplesIn.fetch_add(iIn, std::memory_order_relaxed);
+		llSamplesOut.fetch_add(iOut, std::memory_order_relaxed);
+		SetMax(llTimeMax, llTime);
+
+		if (iFill >= 0)
+		{
+			iInputFill.store(iFill, std::memory_order_relaxed);
+			SetMax(iInputFillMax, iFill);
+		}
+	}
+
+	char					chName[MODSTATS_NAME_LEN];
+
+	std::atomic<long long>	llNumCalls;
+	std::atomic<long long>	llTimeTotal; /* ns */
+	std::atomic<long long>	llTimeMax; /* ns */
+	std::atomic<long long>	llSamplesIn;
+	std::atomic<long long>	llSamplesOut;
+	std::atomic<int>		iInputFill; /* input buffer at the last call */
+	std::atomic<int>		iInputFillMax;
+
+protected:
+	template<class T> static inline void SetMax(std::atomic<T>& Max, const T Val)
+	{
+		T Old = Max.load(std::memory_order_relaxed);
+		while ((Val > Old) && (Max.compare_exchange_weak(Old, Val, std::memory_order_relaxed) == FALSE)) {}
+	}
+};
+
+/* Copy of the counters of one module type */
+class CModulStatSnap
+{
+public:
+	string		strName;
+	long long	llNumCalls;
+	_REAL		rTimeTotalMs;
+	_REAL		rTimeMaxUs;
+	long long	llSamplesIn;
+	long long	llSamplesOut;
+	int			iInputFill;
+	int			iInputFillMax;
+};
+
+class CModulStats
+{
+public:
+	CModulStats() : iNumModules(0), iDumpSec(0), bDumpRun(FALSE),
+		StartTime(std::chrono::steady_clock::now()) {}
+	virtual ~CModulStats() {StopDump();}
+
+	/* Entry of a module type, made on the first call of a module */
+	CModulStat*	Register(const char* pchName);
+
+	/* Returns the number of modules in "vecSnap" */
+	int			GetSnapshot(CVector<CModulStatSnap>& vecSnap);
+	void		Reset();
+
+	/* Appends a table of all modules to the file */
+	_BOOLEAN	Dump(const string& strFileName);
+
+	/* Writes the table every "iSeconds" in a thread of its own. Must be
+	   stopped before the program ends if it runs in a DLL */
+	void		StartDump(const string& strFileName, const int iSeconds);
+	void		StopDump();
+
+protected:
+	void		RunDump();
+
+	CModulStat				Stat[MODSTATS_MAX_MODULES];
+	std::atomic<int>		iNumModules;
+	std::mutex				RegMutex;
+
+	/* Periodic dump */
+	std::thread				DumpThread;
+	std::mutex				DumpMutex;
+	std::condition_variable	DumpCond;
+	string					strDumpFile;
+	int						iDumpSec;
+	_BOOLEAN				bDumpRun;
+	std::chrono::steady_clock::time_point	StartTime;
+};
+
+extern CModulStats ModulStats;
+
+
+#endif // !defined(MODULSTATS_H__3B0UBVE98732KJVEW363M0DSTATS__INCLUDED_)
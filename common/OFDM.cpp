@@ -39,28 +39,35 @@ void COFDMModulation::ProcessDataInternal(CParameter& TransmParam)
 {
 	int	i = 0; //init DM
 
-	/* Copy input vector in matlib vector and place bins at the correct
-	   position */
 	if (paintmode == 0) {
 		//Normal data operation
+		/* Only the data cells are transformed, the pilots are zero in the
+		   input vector and their time signal is taken from the table */
+		CVector<_COMPLEX>& veccPilot =
+			matcPilotSym[(*pvecInputData).GetExData().iSymbolID];
+
+		/* Place bins at the correct position */
 		for (i = iShiftedKmin; i < iEndIndex; i++)
-		veccFFTInput[i] = (*pvecInputData)[i - iShiftedKmin];
+			SetBin(i, (*pvecInputData)[i - iShiftedKmin]);
+
+		/* Calculate inverse fast Fourier transformation. The bins outside
+		   the useful carriers stay zero, the input is not modified by an
+		   out-of-place transform */
+		fftw_one(FftPlan.FFTPlBackw, FftPlan.pFftwComplexIn, FftPlan.pFftwComplexOut);
+
+		/* Copy FFT output in output buffer and add the pilots */
+		for (i = 0; i < iDFTSize; i++)
+			(*pvecOutputData)[i + iGuardSize] = GetSample(i) + veccPilot[i];
 	}
 	else if (paintmode == 2) {
-		//Tuning tones mode
-		float lev = 4;
-		veccFFTInput[iShiftedKmin + 7] = CComplex(lev, 0.0); //Tone bins in IFFT for Mode B
-		veccFFTInput[iShiftedKmin + 23] = CComplex(lev, 0.0); //
-		veccFFTInput[iShiftedKmin + 31] = CComplex(lev, 0.0); //
+		//Tuning tones mode, every symbol is the same
+		for (i = 0; i < iDFTSize; i++)
+			(*pvecOutputData)[i + iGuardSize] = veccToneSym[i];
+	}
+	else {
+		//The waterfall text does not use the OFDM signal (see DRMSignalIO.cpp)
+		return;
 	}
-
-	/* Calculate inverse fast Fourier transformation */
-	veccFFTOutput = Ifft(veccFFTInput, FftPlan);
-
-	/* Copy complex FFT output in output buffer and scale */
-	for (i = 0; i < iDFTSize; i++)
-		(*pvecOutputData)[i + iGuardSize] = veccFFTOutput[i] * (CReal)iDFTSize;
-
 
 	/* Copy data from the end to the guard-interval (Add guard-interval) */
 	for (i = 0; i < iGuardSize; i++)
@@ -84,6 +91,12 @@ void COFDMModulation::ProcessDataInternal(CParameter& TransmParam)
 	}
 }
 
+void COFDMModulation::ClearBins()
+{
+	for (int i = 0; i < iDFTSize; i++)
+		FftPlan.pFftwComplexIn[i].re = FftPlan.pFftwComplexIn[i].im = 0;
+}
+
 void COFDMModulation::InitInternal(CParameter& TransmParam)
 {
 	/* Get global parameters */
@@ -114,10 +127,42 @@ void COFDMModulation::InitInternal(CParameter& TransmParam)
 	/* Init plans for FFT (faster processing of Fft and Ifft commands) */
 	FftPlan.Init(iDFTSize);
 
-	/* Allocate memory for intermediate result of fft. Zero out input vector
-	   (because only a few bins are used, the rest has to be zero) */
-	veccFFTInput.Init(iDFTSize, (CReal) 0.0);
-	veccFFTOutput.Init(iDFTSize);
+	/* Time signal of the pilots of each symbol of the super frame. The
+	   pattern only depends on the robustness mode and spectrum occupancy */
+	const int iNumSym = TransmParam.iNumSymbolsPerSuperframe;
+	const int iNumCar = TransmParam.iNumCarrier;
+
+	matcPilotSym.Init(iNumSym, iDFTSize);
+	for (int j = 0; j < iNumSym; j++)
+	{
+		ClearBins();
+		for (int i = 0; i < iNumCar; i++)
+		{
+			if (_IsPilot(TransmParam.matiMapTab[j][i]))
+				SetBin(iShiftedKmin + i, TransmParam.matcPilotCells[j][i]);
+		}
+
+		fftw_one(FftPlan.FFTPlBackw, FftPlan.pFftwComplexIn, FftPlan.pFftwComplexOut);
+
+		for (int i = 0; i < iDFTSize; i++)
+			matcPilotSym[j][i] = GetSample(i);
+	}
+
+	/* Tuning tones */
+	const _COMPLEX cToneLev((_REAL) 4.0, (_REAL) 0.0);
+	ClearBins();
+	SetBin(iShiftedKmin + 7, cToneLev); //Tone bins in IFFT for Mode B
+	SetBin(iShiftedKmin + 23, cToneLev);
+	SetBin(iShiftedKmin + 31, cToneLev);
+
+	fftw_one(FftPlan.FFTPlBackw, FftPlan.pFftwComplexIn, FftPlan.pFftwComplexOut);
+
+	veccToneSym.Init(iDFTSize);
+	for (int i = 0; i < iDFTSize; i++)
+		veccToneSym[i] = GetSample(i);
+
+	/* Only a few bins are used, the rest has to be zero */
+	ClearBins();
 
 	/* Define block-sizes for input and output */
 	iInputBlockSize = TransmParam.iNumCarrier;
@@ -129,7 +174,6 @@ void COFDMModulation::InitInternal(CParameter& TransmParam)
 * OFDM-demodulation                                                            *
 \******************************************************************************/
 
-CComplexVector			vecInput;
 double hilbdata[1500] = {0.0};
 
 void COFDMDemodulation::ProcessDataInternal(CParameter& ReceiverParam)
@@ -162,7 +206,7 @@ void COFDMDemodulation::ProcessDataInternal(CParameter& ReceiverParam)
 			vecInput[i] = (*pvecInputData)[i] * Conj(cCurExp);
 			cCurExp *= cExpStep;
 		}
-		DoFir(&vecInput[0],&veccFFTInput[0]);
+		DoFir(&vecInput[0],&veccFFTInput[0],iDFTSize);
 
 	}
 	else
@@ -182,7 +226,26 @@ void COFDMDemodulation::ProcessDataInternal(CParameter& ReceiverParam)
 	}
 
 	/* Calculate Fourier transformation (actual OFDM demodulation) */
-	veccFFTOutput = Fft(veccFFTInput, FftPlan);
+#if USE_FIXED_POINT
+	if (bFixedPoint == TRUE)
+	{
+		/* One exponent for the whole symbol. The fixed-point FFT already
+		   divides by N, the normalization below and the spectrum expect the
+		   plain transform */
+		const int iExp = ComplexToQ15(veccFFTInput, iDFTSize, &veccFFTQ15[0]);
+
+		FftQ15.Forward(&veccFFTQ15[0]);
+
+		const _REAL rScale = ldexp((_REAL) iDFTSize, iExp - 15);
+		for (i = 0; i < iDFTSize; i++)
+		{
+			veccFFTOutput[i] = CComplex(veccFFTQ15[i].re * rScale,
+				veccFFTQ15[i].im * rScale);
+		}
+	}
+	else
+#endif
+		veccFFTOutput = Fft(veccFFTInput, FftPlan);
 
 	/* Use only useful carriers and normalize with the block-size ("N") */
 	for (i = iShiftedKmin; i < iShiftedKmax + 1; i++)
@@ -211,6 +274,12 @@ void COFDMDemodulation::InitInternal(CParameter& ReceiverParam)
 	/* Init plans for FFT (faster processing of Fft and Ifft commands) */
 	FftPlan.Init(iDFTSize);
 
+#if USE_FIXED_POINT
+	bFixedPoint = FixedPointRx;
+	FftQ15.Init(iDFTSize);
+	veccFFTQ15.Init(iDFTSize);
+#endif
+
 
 	/* Vector for power density spectrum of input signal */
 	iLenPowSpec = iDFTSize / 2;
@@ -225,8 +294,6 @@ void COFDMDemodulation::InitInternal(CParameter& ReceiverParam)
 	iOutputBlockSize = ReceiverParam.iNumCarrier;
 
 	vecInput.Init(iInputBlockSize);
-	
-	FirInit(iDFTSize,ReceiverParam.GetSpectrumOccup()); 
 
 }
 
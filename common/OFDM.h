@@ -31,6 +31,7 @@
 
 #include "Parameter.h"
 #include "Modul.h"
+#include "FixedPoint.h"
 
 #ifdef HAVE_DFFTW_H
 # include <dfftw.h>
@@ -61,8 +62,12 @@ public:
 protected:
 	CFftPlans				FftPlan;
 
-	CComplexVector			veccFFTInput;
-	CComplexVector			veccFFTOutput;
+	/* The OFDM modulation is linear: the fixed cells of a symbol are
+	   transformed once per robustness mode and spectrum occupancy and added
+	   to the transformed data cells. Both are not scaled (the scaling of the
+	   IFFT and the scaling by the DFT size cancel out) */
+	CMatrix<_COMPLEX>		matcPilotSym; /* one row per symbol of the super frame */
+	CVector<_COMPLEX>		veccToneSym; /* tuning tones */
 
 	int						iShiftedKmin;
 	int						iEndIndex;
@@ -73,6 +78,12 @@ protected:
 	_COMPLEX				cExpStep;
 	_REAL					rDefCarOffset;
 
+	void ClearBins();
+	void SetBin(const int iBin, const _COMPLEX cVal)
+		{FftPlan.pFftwComplexIn[iBin].re = cVal.real(); FftPlan.pFftwComplexIn[iBin].im = cVal.imag();}
+	_COMPLEX GetSample(const int iIdx)
+		{return _COMPLEX(FftPlan.pFftwComplexOut[iIdx].re, FftPlan.pFftwComplexOut[iIdx].im);}
+
 	virtual void InitInternal(CParameter& TransmParam);
 	virtual void ProcessDataInternal(CParameter& TransmParam);
 };
@@ -89,9 +100,16 @@ protected:
 	CVector<_REAL>			vecrPDSResult;
 
 	CFftPlans				FftPlan;
+	CComplexVector			vecInput;
 	CComplexVector			veccFFTInput;
 	CComplexVector			veccFFTOutput;
 
+#if USE_FIXED_POINT
+	_BOOLEAN				bFixedPoint;
+	CFftQ15					FftQ15;
+	CVector<CComplexQ15>	veccFFTQ15;
+#endif
+
 	CVector<_REAL>			vecrPowSpec;
 	int						iLenPowSpec;
 
@@ -35,6 +35,11 @@ extern CDRMReceiver	DRMReceiver;
 
 
 /* Implementation *************************************************************/
+CDRMReceiver* CParameter::GetReceiver()
+{
+	return (pDRMRec != NULL) ? pDRMRec : &DRMReceiver;
+}
+
 void CParameter::ResetServicesStreams()
 {
 	int i;
@@ -222,7 +227,7 @@ _BOOLEAN CParameter::SetWaveMode(const ERobMode eNewWaveMode)
 		MakeTable(eRobustnessMode, eSpectOccup);
 
 		/* Set init flags */
-		DRMReceiver.InitsForWaveMode();
+		GetReceiver()->InitsForWaveMode();
 
 		/* Signal that parameter has changed */
 		return TRUE;
@@ -243,7 +248,7 @@ void CParameter::SetSpectrumOccup(ESpecOcc eNewSpecOcc)
 		MakeTable(eRobustnessMode, eSpectOccup);
 
 		/* Set init flags */
-		DRMReceiver.InitsForSpectrumOccup();
+		GetReceiver()->InitsForSpectrumOccup();
 	}
 }
 
@@ -256,7 +261,7 @@ void CParameter::SetStreamLen(const int iStreamID, const int iNewLenPartB)
 		Stream[iStreamID].iLenPartB = iNewLenPartB;
 
 		/* Set init flags */
-		DRMReceiver.InitsForMSC();
+		GetReceiver()->InitsForMSC();
 	}
 }
 
@@ -268,7 +273,7 @@ void CParameter::SetNumDecodedBitsMSC(const int iNewNumDecodedBitsMSC)
 		iNumDecodedBitsMSC = iNewNumDecodedBitsMSC;
 
 		/* Set init flags */
-		DRMReceiver.InitsForMSCDemux();
+		GetReceiver()->InitsForMSCDemux();
 	}
 }
 
@@ -280,7 +285,7 @@ void CParameter::SetNumBitsHieraFrTot(const int iNewNumBitsHieraFrTot)
 		iNumBitsHierarchFrameTotal = iNewNumBitsHieraFrTot;
 
 		/* Set init flags */
-		DRMReceiver.InitsForMSCDemux();
+		GetReceiver()->InitsForMSCDemux();
 	}
 }
 
@@ -292,7 +297,7 @@ void CParameter::SetNumAudioDecoderBits(const int iNewNumAudioDecoderBits)
 		iNumAudioDecoderBits = iNewNumAudioDecoderBits;
 
 		/* Set init flags */
-		DRMReceiver.InitsForAudParam();
+		GetReceiver()->InitsForAudParam();
 	}
 }
 
@@ -304,7 +309,7 @@ void CParameter::SetNumDataDecoderBits(const int iNewNumDataDecoderBits)
 		iNumDataDecoderBits = iNewNumDataDecoderBits;
 
 		/* Set init flags */
-		DRMReceiver.InitsForDataParam();
+		GetReceiver()->InitsForDataParam();
 	}
 }
 
@@ -321,7 +326,7 @@ void CParameter::SetMSCProtLev(const int NewMSCPrLe)
 
 	/* In case parameters have changed, set init flags */
 	if (bParamersHaveChanged == TRUE)
-		DRMReceiver.InitsForMSC();
+		GetReceiver()->InitsForMSC();
 }
 
 void CParameter::SetAudioParam(const int iShortID,
@@ -333,7 +338,7 @@ void CParameter::SetAudioParam(const int iShortID,
 		Service[iShortID].AudioParam = NewAudParam;
 
 		/* Set init flags */
-		DRMReceiver.InitsForAudParam();
+		GetReceiver()->InitsForAudParam();
 	}
 }
 
@@ -345,7 +350,7 @@ void CParameter::SetDataParam(const int iShortID, const CDataParam NewDataParam)
 		Service[iShortID].DataParam = NewDataParam;
 
 		/* Set init flags */
-		DRMReceiver.InitsForDataParam();
+		GetReceiver()->InitsForDataParam();
 	}
 }
 
@@ -356,7 +361,7 @@ void CParameter::SetInterleaverDepth(const ESymIntMod eNewDepth)
 		eSymbolInterlMode = eNewDepth;
 
 		/* Set init flags */
-		DRMReceiver.InitsForInterlDepth();
+		GetReceiver()->InitsForInterlDepth();
 	}
 
 }
@@ -368,7 +373,7 @@ void CParameter::SetMSCCodingScheme(const ECodScheme eNewScheme)
 		eMSCCodingScheme = eNewScheme;
 
 		/* Set init flags */
-		DRMReceiver.InitsForMSCCodSche();
+		GetReceiver()->InitsForMSCCodSche();
 	}
 }
 
@@ -379,7 +384,7 @@ void CParameter::SetCurSelAudioService(const int iNewService)
 		iCurSelAudioService = iNewService;
 
 		/* Set init flags */
-		DRMReceiver.InitsForMSCDemux();
+		GetReceiver()->InitsForMSCDemux();
 	}
 }
 
@@ -390,7 +395,7 @@ void CParameter::SetCurSelDataService(const int iNewService)
 		iCurSelDataService = iNewService;
 
 		/* Set init flags */
-		DRMReceiver.InitsForMSCDemux();
+		GetReceiver()->InitsForMSCDemux();
 	}
 }
 
@@ -401,7 +406,7 @@ void CParameter::EnableMultimedia(const _BOOLEAN bFlag)
 		bUsingMultimedia = bFlag;
 
 		/* Set init flags */
-		DRMReceiver.InitsForMSCDemux();
+		GetReceiver()->InitsForMSCDemux();
 	}
 }
 
@@ -415,7 +420,7 @@ void CParameter::SetNumOfServices(const int iNNumAuSe, const int iNNumDaSe)
 	{
 		/* Reset services and streams and set flag for init modules */
 		ResetServicesStreams();
-		DRMReceiver.InitsForMSCDemux();
+		GetReceiver()->InitsForMSCDemux();
 	}
 
 	if ((iNumAudioService != iNNumAuSe) || (iNumDataService != iNNumDaSe))
@@ -424,7 +429,7 @@ void CParameter::SetNumOfServices(const int iNNumAuSe, const int iNNumDaSe)
 		iNumDataService = iNNumDaSe;
 
 		/* Set init flags */
-		DRMReceiver.InitsForMSCDemux();
+		GetReceiver()->InitsForMSCDemux();
 	}
 }
 
@@ -435,7 +440,7 @@ void CParameter::SetAudDataFlag(const int iServID, const ETyOServ iNewADaFl)
 		Service[iServID].eAudDataFlag = iNewADaFl;
 
 		/* Set init flags */
-		DRMReceiver.InitsForMSC();
+		GetReceiver()->InitsForMSC();
 	}
 }
 
@@ -446,7 +451,7 @@ void CParameter::SetServID(const int iServID, const _UINT32BIT iNewServID)
 		Service[iServID].iServiceID = iNewServID;
 
 		/* Set init flags */
-		DRMReceiver.InitsForMSC();
+		GetReceiver()->InitsForMSC();
 	}
 }
 
@@ -39,11 +39,13 @@
 #define USEPAPR 1 //Use PAPR processing code. This changes the output to a 0Hz IF, adds the PAPR code and converts the 0Hz IF back to audio
 
 /* Classes ********************************************************************/
+class CDRMReceiver;
+
 class CParameter : public CCellMappingTable
 {
 public:
 	CParameter() : bRunThread(FALSE), Stream(MAX_NUM_STREAMS), iChanEstDelay(0),
-		bUsingMultimedia(TRUE) {}
+		bUsingMultimedia(TRUE), pDRMRec(NULL) {}
 	virtual ~CParameter() {}
 
 	/* Enumerations --------------------------------------------------------- */
@@ -292,7 +294,14 @@ public:
 	_BOOLEAN			bRunThread;
 	_BOOLEAN			bUsingMultimedia;
 
+	/* Receiver which is initialized on parameter changes. If it is not set,
+	   the global receiver is used */
+	void				SetReceiver(CDRMReceiver* pNewDRMRec) {pDRMRec = pNewDRMRec;}
+
 protected:
+	CDRMReceiver*		GetReceiver();
+	CDRMReceiver*		pDRMRec;
+
 	/* Current selected audio service for processing */
 	int					iCurSelAudioService;
 	int					iCurSelDataService;
@@ -32,6 +32,7 @@
 #include "schifra_reed_solomon_decoder.hpp"
 #include "schifra_reed_solomon_block.hpp"
 #include "schifra_error_processes.hpp"
+#include "../SimdKernels.h"
 //#include "../../RS-defs.h"
 
 #define RScodeLength 255;
@@ -344,6 +345,14 @@ int rs1decodeE(unsigned char* inbuf, unsigned char* inbuf2, unsigned  char* outb
     schifra::reed_solomon::erasure_locations_t erasure_location_list;
     erasure_location_list.clear();
 
+    //roots of the generator polynomial, for the syndromes of the SIMD kernel
+    unsigned char roots[SIMD_RS_MAX_ROOTS];
+    unsigned char syndromes[SIMD_RS_MAX_ROOTS];
+    for (std::size_t r = 0; r < fec_length; r++) {
+        roots[r] = (unsigned char)field.alpha(generator_polynomial_index + r);
+    }
+    const CSimdKernels& kernels = SimdKernels();
+
     if (code_length == 0) { return 5; } //div by 0 prevention
 
     //loop through buffer and read data in blocks of 255 bytes to feed it, until done to length DM
@@ -375,7 +384,11 @@ int rs1decodeE(unsigned char* inbuf, unsigned char* inbuf2, unsigned  char* outb
             i++;
         }
 
-        if (!decoder.decode(block, erasure_location_list)){
+        //a code word without errors needs no decoding, the decoder would return it unchanged
+        const bool clean = (erasure_location_list.size() <= fec_length) &&
+            !kernels.RSSyndromes(&inbuf[i - code_length], code_length, roots, fec_length, syndromes);
+
+        if (!clean && !decoder.decode(block, erasure_location_list)){
           errors++;
           lastRSbcERR = bc; //save last RS error block number
             //replace data by zeroes
@@ -434,6 +447,14 @@ int rs2decodeE(unsigned char* inbuf, unsigned char* inbuf2, unsigned  char* outb
     schifra::reed_solomon::erasure_locations_t erasure_location_list;
     erasure_location_list.clear();
 
+    //roots of the generator polynomial, for the syndromes of the SIMD kernel
+    unsigned char roots[SIMD_RS_MAX_ROOTS];
+    unsigned char syndromes[SIMD_RS_MAX_ROOTS];
+    for (std::size_t r = 0; r < fec_length; r++) {
+        roots[r] = (unsigned char)field.alpha(generator_polynomial_index + r);
+    }
+    const CSimdKernels& kernels = SimdKernels();
+
     if (code_length == 0) { return 5; } //div by 0 prevention
 
     //loop through buffer and read data in blocks of 255 bytes to feed it, until done to length DM
@@ -465,7 +486,11 @@ int rs2decodeE(unsigned char* inbuf, unsigned char* inbuf2, unsigned  char* outb
             i++;
         }
 
-        if (!decoder.decode(block, erasure_location_list)){
+        //a code word without errors needs no decoding, the decoder would return it unchanged
+        const bool clean = (erasure_location_list.size() <= fec_length) &&
+            !kernels.RSSyndromes(&inbuf[i - code_length], code_length, roots, fec_length, syndromes);
+
+        if (!clean && !decoder.decode(block, erasure_location_list)){
           errors++;
           lastRSbcERR = bc; //save last RS error block number
             //replace data by zeroes
@@ -524,6 +549,14 @@ int rs3decodeE(unsigned char* inbuf, unsigned char* inbuf2, unsigned  char* outb
     schifra::reed_solomon::erasure_locations_t erasure_location_list;
     erasure_location_list.clear();
 
+    //roots of the generator polynomial, for the syndromes of the SIMD kernel
+    unsigned char roots[SIMD_RS_MAX_ROOTS];
+    unsigned char syndromes[SIMD_RS_MAX_ROOTS];
+    for (std::size_t r = 0; r < fec_length; r++) {
+        roots[r] = (unsigned char)field.alpha(generator_polynomial_index + r);
+    }
+    const CSimdKernels& kernels = SimdKernels();
+
     if (code_length == 0) { return 5; } //div by 0 prevention
 
     //loop through buffer and read data in blocks of 255 bytes to feed it, until done to length DM
@@ -555,7 +588,11 @@ int rs3decodeE(unsigned char* inbuf, unsigned char* inbuf2, unsigned  char* outb
             i++;
         }
 
-        if (!decoder.decode(block, erasure_location_list)){
+        //a code word without errors needs no decoding, the decoder would return it unchanged
+        const bool clean = (erasure_location_list.size() <= fec_length) &&
+            !kernels.RSSyndromes(&inbuf[i - code_length], code_length, roots, fec_length, syndromes);
+
+        if (!clean && !decoder.decode(block, erasure_location_list)){
           errors++;
           lastRSbcERR = bc; //save last RS error block number
             //replace data by zeroes
@@ -614,6 +651,14 @@ int rs4decodeE(unsigned char* inbuf, unsigned char* inbuf2, unsigned  char* outb
     schifra::reed_solomon::erasure_locations_t erasure_location_list;
     erasure_location_list.clear();
 
+    //roots of the generator polynomial, for the syndromes of the SIMD kernel
+    unsigned char roots[SIMD_RS_MAX_ROOTS];
+    unsigned char syndromes[SIMD_RS_MAX_ROOTS];
+    for (std::size_t r = 0; r < fec_length; r++) {
+        roots[r] = (unsigned char)field.alpha(generator_polynomial_index + r);
+    }
+    const CSimdKernels& kernels = SimdKernels();
+
     if (code_length == 0) { return 5; } //div by 0 prevention
 
     //loop through buffer and read data in blocks of 255 bytes to feed it, until done to length DM
@@ -645,7 +690,11 @@ int rs4decodeE(unsigned char* inbuf, unsigned char* inbuf2, unsigned  char* outb
             i++;
         }
 
-        if (!decoder.decode(block, erasure_location_list)){
+        //a code word without errors needs no decoding, the decoder would return it unchanged
+        const bool clean = (erasure_location_list.size() <= fec_length) &&
+            !kernels.RSSyndromes(&inbuf[i - code_length], code_length, roots, fec_length, syndromes);
+
+        if (!clean && !decoder.decode(block, erasure_location_list)){
           errors++;
           lastRSbcERR = bc; //save last RS error block number
             //replace data by zeroes
@@ -0,0 +1,1288 @@
+/******************************************************************************\
+ * Copyright (c) 2024
+ *
+ * Author(s):
+ *	EasyDRF developers
+ *
+ * Description:
+ *	SIMD kernels of the receiver with dispatch at run time
+ *
+ *	The inner loops which dominate the profile on small boards are kept here
+ *	in three versions: generic C, SSE2 (x86 and x64) and NEON (ARM64 and
+ *	ARMv7 with NEON). These are the Viterbi trellis update, the QAM metrics
+ *	(fixed and floating point), the complex FIR filter of the timing
+ *	acquisition, the syndromes of the RS decoder and the spectrogram. Which
+ *	version is used is decided once at run time from the instruction sets of
+ *	the processor.
+ *
+ *	All versions do exactly the same operations in the same order (integer
+ *	math is saturated the same way, the FIR sums each output in tap order),
+ *	so the decoded data does not depend on the machine. SimdSelfCheck()
+ *	("-bs") compares each version with the generic one on random data and
+ *	the outputs with hashes taken on the reference machine
+ *
+ ******************************************************************************
+ *
+ * This program is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation; either version 2 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ *
+\******************************************************************************/
+
+#include "SimdKernels.h"
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+
+#ifdef _WIN32
+# include <windows.h>
+#endif
+
+#if SIMD_HAVE_SSE2
+# include <emmintrin.h>
+#endif
+
+#if SIMD_HAVE_NEON
+# if defined(_M_ARM64) && defined(_MSC_VER)
+#  include <arm64_neon.h>
+# else
+#  include <arm_neon.h>
+# endif
+#endif
+
+/* GCC and Clang only generate SSE2 for 32 bit x86 if asked for */
+#if SIMD_HAVE_SSE2 && defined(__GNUC__)
+# define SIMD_TARGET_SSE2			__attribute__((target("sse2")))
+#else
+# define SIMD_TARGET_SSE2
+#endif
+
+/* Each product of the FIR sums is rounded on its own like in the SIMD code,
+   a fused multiply-add would give other results on machines which have it */
+#if defined(__clang__)
+# pragma clang fp contract(off)
+#elif defined(__GNUC__)
+# pragma GCC optimize("fp-contract=off")
+#elif defined(_MSC_VER)
+# pragma fp_contract(off)
+#endif
+
+/* The FIR kernel needs double precision vectors */
+#if defined(_M_ARM64) || defined(__aarch64__)
+# define SIMD_HAVE_NEON_F64			TRUE
+#else
+# define SIMD_HAVE_NEON_F64			FALSE
+#endif
+
+/* Normalization threshold of the trellis (same as the MMX code) */
+#define TRELLIS_NORM_LIMIT			150
+
+
+/* Implementation *************************************************************/
+/******************************************************************************\
+* Generic C                                                                    *
+\******************************************************************************/
+static inline unsigned char AddSatU8(const int iA, const int iB)
+{
+	const int iSum = iA + iB;
+	return (unsigned char) ((iSum > 255) ? 255 : iSum);
+}
+
+static void TrellisNormalizeC(unsigned char* pNewMetric)
+{
+	int i;
+
+	if (pNewMetric[0] <= TRELLIS_NORM_LIMIT)
+		return;
+
+	unsigned char ucMin = pNewMetric[0];
+	for (i = 1; i < SIMD_TRELLIS_STATES; i++)
+	{
+		if (pNewMetric[i] < ucMin)
+			ucMin = pNewMetric[i];
+	}
+
+	for (i = 0; i < SIMD_TRELLIS_STATES; i++)
+		pNewMetric[i] -= ucMin;
+}
+
+static void TrellisUpdateC(unsigned char* pDec, unsigned char* pNewMetric,
+						   const unsigned char* pOldMetric,
+						   const unsigned char* pMet1,
+						   const unsigned char* pMet2)
+{
+	for (int p = 0; p < SIMD_TRELLIS_STATES / 2; p++)
+	{
+		const int iOld0 = pOldMetric[p];
+		const int iOld1 = pOldMetric[p + SIMD_TRELLIS_STATES / 2];
+
+		/* First state: bit "0" from state p, bit "1" from state p + 32 */
+		const unsigned char ucA = AddSatU8(iOld0, pMet1[p]);
+		const unsigned char ucB = AddSatU8(iOld1, pMet2[p]);
+
+		/* Second state with swapped metrics */
+		const unsigned char ucC = AddSatU8(iOld0, pMet2[p]);
+		const unsigned char ucD = AddSatU8(iOld1, pMet1[p]);
+
+		/* On equal metrics the path of state p + 32 is taken */
+		pDec[2 * p] = (ucB <= ucA) ? 0xFF : 0;
+		pNewMetric[2 * p] = (ucB <= ucA) ? ucB : ucA;
+
+		pDec[2 * p + 1] = (ucD <= ucC) ? 0xFF : 0;
+		pNewMetric[2 * p + 1] = (ucD <= ucC) ? ucD : ucC;
+	}
+
+	TrellisNormalizeC(pNewMetric);
+}
+
+static inline int MetricQ13C(const short sSig, const short sWeight,
+							 const short* psPoints, const int iNumPoints)
+{
+	int iMin = abs((int) sSig - psPoints[0]);
+
+	for (int j = 1; j < iNumPoints; j++)
+	{
+		const int iDist = abs((int) sSig - psPoints[j]);
+
+		if (iDist < iMin)
+			iMin = iDist;
+	}
+
+	/* Below 2^16 * 2^15, fits in an int */
+	return (iMin * sWeight) >> 15;
+}
+
+static void QAMMetricQ13C(const short* psSig, const short* psWeight,
+						  const short* psPoints, const int iNumPoints,
+						  int* piMetric, const int iLen)
+{
+	for (int i = 0; i < iLen; i++)
+		piMetric[i] = MetricQ13C(psSig[i], psWeight[i], psPoints, iNumPoints);
+}
+
+static inline _REAL MetricRealC(const _REAL rSig, const _REAL rWeight,
+								const _REAL* prPoints, const int iNumPoints)
+{
+	_REAL rMin = fabs(rSig - prPoints[0]);
+
+	for (int j = 1; j < iNumPoints; j++)
+	{
+		const _REAL rDist = fabs(rSig - prPoints[j]);
+
+		if (rDist < rMin)
+			rMin = rDist;
+	}
+
+	return rMin * rWeight;
+}
+
+static void QAMMetricRealC(const _REAL* prSig, const _REAL* prWeight,
+						   const _REAL* prPoints, const int iNumPoints,
+						   _REAL* prMetric, const int iLen)
+{
+	for (int i = 0; i < iLen; i++)
+		prMetric[i] = MetricRealC(prSig[i], prWeight[i], prPoints, iNumPoints);
+}
+
+static inline void FirCplxTapsOneC(const _REAL* prTaps, const int iNumTaps,
+								   const _REAL* prXCur, _REAL* prY)
+{
+	_REAL rRe = (_REAL) 0.0;
+	_REAL rIm = (_REAL) 0.0;
+
+	for (int n = 0; n < iNumTaps; n++)
+	{
+		rRe += prTaps[2 * n] * prXCur[-n];
+		rIm += prTaps[2 * n + 1] * prXCur[-n];
+	}
+
+	prY[0] = rRe;
+	prY[1] = rIm;
+}
+
+static void FirCplxTapsDecC(const _REAL* prTaps, const int iNumTaps,
+							const _REAL* prX, const int iFirstPos,
+							const int iDecFact, _REAL* prY, const int iNumOut)
+{
+	for (int m = 0; m < iNumOut; m++)
+	{
+		FirCplxTapsOneC(prTaps, iNumTaps, &prX[iFirstPos + m * iDecFact],
+			&prY[2 * m]);
+	}
+}
+
+static inline unsigned char GFMulC(unsigned char ucA, unsigned char ucB)
+{
+	unsigned char ucProd = 0;
+
+	while (ucB != 0)
+	{
+		if (ucB & 1)
+			ucProd ^= ucA;
+
+		/* ucA * x */
+		ucA = (unsigned char) ((ucA << 1) ^ ((ucA & 0x80) ? SIMD_RS_FIELD_POLY : 0));
+		ucB >>= 1;
+	}
+
+	return ucProd;
+}
+
+static _BOOLEAN RSSyndromesC(const unsigned char* pBlock, const int iCodeLen,
+							 const unsigned char* pRoots, const int iNumRoots,
+							 unsigned char* pSyndromes)
+{
+	unsigned char ucAny = 0;
+
+	for (int j = 0; j < iNumRoots; j++)
+	{
+		/* Horner, the first symbol has the highest power */
+		unsigned char ucS = 0;
+		for (int i = 0; i < iCodeLen; i++)
+			ucS = GFMulC(ucS, pRoots[j]) ^ pBlock[i];
+
+		pSyndromes[j] = ucS;
+		ucAny |= ucS;
+	}
+
+	return (ucAny != 0) ? TRUE : FALSE;
+}
+
+static void WindowToDoubleC(const float* pfIn, const float* pfWin,
+							double* pdOut, const int iLen)
+{
+	for (int i = 0; i < iLen; i++)
+		pdOut[i] = pfIn[i] * pfWin[i];
+}
+
+static inline float HalfComplexMagOneC(const double* pdSpec, const int iSize,
+									   const float fNorm, const int k)
+{
+	const float fRe = (float) pdSpec[k];
+	const float fIm = (k == 0) ? 0.0f : (float) pdSpec[iSize - k];
+
+	return sqrtf((fRe * fRe + fIm * fIm) * fNorm);
+}
+
+static void HalfComplexMagC(const double* pdSpec, const int iSize,
+							const float fNorm, float* pfMag, const int iNumBins)
+{
+	for (int k = 0; k < iNumBins; k++)
+		pfMag[k] = HalfComplexMagOneC(pdSpec, iSize, fNorm, k);
+}
+
+
+/******************************************************************************\
+* SSE2                                                                         *
+\******************************************************************************/
+#if SIMD_HAVE_SSE2
+SIMD_TARGET_SSE2
+static void TrellisUpdateSSE2(unsigned char* pDec, unsigned char* pNewMetric,
+							  const unsigned char* pOldMetric,
+							  const unsigned char* pMet1,
+							  const unsigned char* pMet2)
+{
+	/* 16 butterflies per pass */
+	for (int g = 0; g < SIMD_TRELLIS_STATES / 2; g += 16)
+	{
+		const __m128i xOld0 = _mm_loadu_si128((const __m128i*) &pOldMetric[g]);
+		const __m128i xOld1 = _mm_loadu_si128(
+			(const __m128i*) &pOldMetric[g + SIMD_TRELLIS_STATES / 2]);
+		const __m128i xMet1 = _mm_loadu_si128((const __m128i*) &pMet1[g]);
+		const __m128i xMet2 = _mm_loadu_si128((const __m128i*) &pMet2[g]);
+
+		const __m128i xA = _mm_adds_epu8(xOld0, xMet1);
+		const __m128i xB = _mm_adds_epu8(xOld1, xMet2);
+		const __m128i xC = _mm_adds_epu8(xOld0, xMet2);
+		const __m128i xD = _mm_adds_epu8(xOld1, xMet1);
+
+		/* b <= a if (b - a) saturates to zero */
+		const __m128i xZero = _mm_setzero_si128();
+		const __m128i xDec1 = _mm_cmpeq_epi8(_mm_subs_epu8(xB, xA), xZero);
+		const __m128i xDec2 = _mm_cmpeq_epi8(_mm_subs_epu8(xD, xC), xZero);
+
+		const __m128i xSurv1 = _mm_min_epu8(xA, xB);
+		const __m128i xSurv2 = _mm_min_epu8(xC, xD);
+
+		_mm_storeu_si128((__m128i*) &pDec[2 * g], _mm_unpacklo_epi8(xDec1, xDec2));
+		_mm_storeu_si128((__m128i*) &pDec[2 * g + 16], _mm_unpackhi_epi8(xDec1, xDec2));
+		_mm_storeu_si128((__m128i*) &pNewMetric[2 * g], _mm_unpacklo_epi8(xSurv1, xSurv2));
+		_mm_storeu_si128((__m128i*) &pNewMetric[2 * g + 16], _mm_unpackhi_epi8(xSurv1, xSurv2));
+	}
+
+	if (pNewMetric[0] <= TRELLIS_NORM_LIMIT)
+		return;
+
+	/* Smallest metric of all states in each byte */
+	__m128i xMin = _mm_loadu_si128((const __m128i*) &pNewMetric[0]);
+	xMin = _mm_min_epu8(xMin, _mm_loadu_si128((const __m128i*) &pNewMetric[16]));
+	xMin = _mm_min_epu8(xMin, _mm_loadu_si128((const __m128i*) &pNewMetric[32]));
+	xMin = _mm_min_epu8(xMin, _mm_loadu_si128((const __m128i*) &pNewMetric[48]));
+	xMin = _mm_min_epu8(xMin, _mm_srli_si128(xMin, 8));
+	xMin = _mm_min_epu8(xMin, _mm_srli_si128(xMin, 4));
+	xMin = _mm_min_epu8(xMin, _mm_srli_si128(xMin, 2));
+	xMin = _mm_min_epu8(xMin, _mm_srli_si128(xMin, 1));
+	xMin = _mm_set1_epi8((char) _mm_cvtsi128_si32(xMin));
+
+	for (int i = 0; i < SIMD_TRELLIS_STATES; i += 16)
+	{
+		__m128i* pxMetric = (__m128i*) &pNewMetric[i];
+		_mm_storeu_si128(pxMetric, _mm_subs_epu8(_mm_loadu_si128(pxMetric), xMin));
+	}
+}
+
+SIMD_TARGET_SSE2
+static void QAMMetricQ13SSE2(const short* psSig, const short* psWeight,
+							 const short* psPoints, const int iNumPoints,
+							 int* piMetric, const int iLen)
+{
+	int i;
+
+	/* There is no unsigned 16 bit minimum in SSE2, the distances are
+	   compared with the sign bit flipped */
+	const __m128i xBias = _mm_set1_epi16((short) 0x8000);
+	const __m128i xZero = _mm_setzero_si128();
+
+	for (i = 0; i + 8 <= iLen; i += 8)
+	{
+		const __m128i xSig = _mm_loadu_si128((const __m128i*) &psSig[i]);
+		__m128i xMin = _mm_set1_epi16(0x7FFF);
+
+		for (int j = 0; j < iNumPoints; j++)
+		{
+			const __m128i xPoint = _mm_set1_epi16(psPoints[j]);
+
+			/* |a - p| is below 2^16, exact as unsigned 16 bit */
+			const __m128i xDist = _mm_sub_epi16(_mm_max_epi16(xSig, xPoint),
+				_mm_min_epi16(xSig, xPoint));
+
+			xMin = _mm_min_epi16(xMin, _mm_xor_si128(xDist, xBias));
+		}
+
+		xMin = _mm_xor_si128(xMin, xBias);
+
+		/* (dist * weight) >> 15 from the 32 bit product */
+		const __m128i xWeight = _mm_loadu_si128((const __m128i*) &psWeight[i]);
+		const __m128i xLo = _mm_mullo_epi16(xMin, xWeight);
+		const __m128i xHi = _mm_mulhi_epu16(xMin, xWeight);
+		const __m128i xRes = _mm_or_si128(_mm_slli_epi16(xHi, 1),
+			_mm_srli_epi16(xLo, 15));
+
+		_mm_storeu_si128((__m128i*) &piMetric[i], _mm_unpacklo_epi16(xRes, xZero));
+		_mm_storeu_si128((__m128i*) &piMetric[i + 4], _mm_unpackhi_epi16(xRes, xZero));
+	}
+
+	for (; i < iLen; i++)
+		piMetric[i] = MetricQ13C(psSig[i], psWeight[i], psPoints, iNumPoints);
+}
+
+SIMD_TARGET_SSE2
+static void QAMMetricRealSSE2(const _REAL* prSig, const _REAL* prWeight,
+							  const _REAL* prPoints, const int iNumPoints,
+							  _REAL* prMetric, const int iLen)
+{
+	int i;
+
+	/* Clearing the sign bit is fabs() */
+	const __m128d xAbsMask = _mm_castsi128_pd(_mm_set_epi32(0x7FFFFFFF, -1,
+		0x7FFFFFFF, -1));
+
+	for (i = 0; i + 2 <= iLen; i += 2)
+	{
+		const __m128d xSig = _mm_loadu_pd(&prSig[i]);
+		__m128d xMin = _mm_and_pd(_mm_sub_pd(xSig, _mm_set1_pd(prPoints[0])),
+			xAbsMask);
+
+		for (int j = 1; j < iNumPoints; j++)
+		{
+			xMin = _mm_min_pd(xMin, _mm_and_pd(
+				_mm_sub_pd(xSig, _mm_set1_pd(prPoints[j])), xAbsMask));
+		}
+
+		_mm_storeu_pd(&prMetric[i], _mm_mul_pd(xMin, _mm_loadu_pd(&prWeight[i])));
+	}
+
+	for (; i < iLen; i++)
+		prMetric[i] = MetricRealC(prSig[i], prWeight[i], prPoints, iNumPoints);
+}
+
+SIMD_TARGET_SSE2
+static void FirCplxTapsDecSSE2(const _REAL* prTaps, const int iNumTaps,
+							   const _REAL* prX, const int iFirstPos,
+							   const int iDecFact, _REAL* prY,
+							   const int iNumOut)
+{
+	int m;
+
+	/* Real and imaginary part in one register, two outputs at a time */
+	for (m = 0; m + 2 <= iNumOut; m += 2)
+	{
+		const _REAL* prX0 = &prX[iFirstPos + m * iDecFact];
+		const _REAL* prX1 = prX0 + iDecFact;
+		__m128d xAcc0 = _mm_setzero_pd();
+		__m128d xAcc1 = _mm_setzero_pd();
+
+		for (int n = 0; n < iNumTaps; n++)
+		{
+			const __m128d xTap = _mm_loadu_pd(&prTaps[2 * n]);
+
+			xAcc0 = _mm_add_pd(xAcc0, _mm_mul_pd(xTap, _mm_set1_pd(prX0[-n])));
+			xAcc1 = _mm_add_pd(xAcc1, _mm_mul_pd(xTap, _mm_set1_pd(prX1[-n])));
+		}
+
+		_mm_storeu_pd(&prY[2 * m], xAcc0);
+		_mm_storeu_pd(&prY[2 * m + 2], xAcc1);
+	}
+
+	for (; m < iNumOut; m++)
+	{
+		FirCplxTapsOneC(prTaps, iNumTaps, &prX[iFirstPos + m * iDecFact],
+			&prY[2 * m]);
+	}
+}
+
+SIMD_TARGET_SSE2
+static inline __m128i GFMulXSSE2(const __m128i xA, const __m128i xPoly)
+{
+	/* Bytes with the highest bit set are reduced after the shift */
+	const __m128i xHigh = _mm_cmplt_epi8(xA, _mm_setzero_si128());
+	return _mm_xor_si128(_mm_add_epi8(xA, xA), _mm_and_si128(xHigh, xPoly));
+}
+
+SIMD_TARGET_SSE2
+static _BOOLEAN RSSyndromesSSE2(const unsigned char* pBlock, const int iCodeLen,
+								const unsigned char* pRoots,
+								const int iNumRoots, unsigned char* pSyndromes)
+{
+	int i, k;
+	unsigned char ucAny = 0;
+	const __m128i xPoly = _mm_set1_epi8((char) SIMD_RS_FIELD_POLY);
+
+	/* 16 syndromes at a time, each byte has its own root */
+	for (int j = 0; j < iNumRoots; j += 16)
+	{
+		const int iNumLanes = (iNumRoots - j < 16) ? iNumRoots - j : 16;
+
+		unsigned char ucRoots[16];
+		memset(ucRoots, 0, sizeof(ucRoots));
+		memcpy(ucRoots, &pRoots[j], iNumLanes);
+
+		/* The multiplication with the roots is split in their bits */
+		const __m128i xRoots = _mm_loadu_si128((const __m128i*) ucRoots);
+		__m128i xBitMask[8];
+		for (k = 0; k < 8; k++)
+		{
+			const __m128i xBit = _mm_set1_epi8((char) (1 << k));
+			xBitMask[k] = _mm_cmpeq_epi8(_mm_and_si128(xRoots, xBit), xBit);
+		}
+
+		__m128i xS = _mm_setzero_si128();
+		for (i = 0; i < iCodeLen; i++)
+		{
+			__m128i xProd = _mm_and_si128(xS, xBitMask[0]);
+			__m128i xPow = xS;
+
+			for (k = 1; k < 8; k++)
+			{
+				xPow = GFMulXSSE2(xPow, xPoly);
+				xProd = _mm_xor_si128(xProd, _mm_and_si128(xPow, xBitMask[k]));
+			}
+
+			xS = _mm_xor_si128(xProd, _mm_set1_epi8((char) pBlock[i]));
+		}
+
+		unsigned char ucS[16];
+		_mm_storeu_si128((__m128i*) ucS, xS);
+
+		for (k = 0; k < iNumLanes; k++)
+		{
+			pSyndromes[j + k] = ucS[k];
+			ucAny |= ucS[k];
+		}
+	}
+
+	return (ucAny != 0) ? TRUE : FALSE;
+}
+
+SIMD_TARGET_SSE2
+static void WindowToDoubleSSE2(const float* pfIn, const float* pfWin,
+							   double* pdOut, const int iLen)
+{
+	int i;
+
+	for (i = 0; i + 4 <= iLen; i += 4)
+	{
+		const __m128 x = _mm_mul_ps(_mm_loadu_ps(pfIn + i), _mm_loadu_ps(pfWin + i));
+
+		_mm_storeu_pd(pdOut + i, _mm_cvtps_pd(x));
+		_mm_storeu_pd(pdOut + i + 2, _mm_cvtps_pd(_mm_movehl_ps(x, x)));
+	}
+
+	for (; i < iLen; i++)
+		pdOut[i] = pfIn[i] * pfWin[i];
+}
+
+SIMD_TARGET_SSE2
+static void HalfComplexMagSSE2(const double* pdSpec, const int iSize,
+							   const float fNorm, float* pfMag, const int iNumBins)
+{
+	int k;
+	const __m128 xNorm = _mm_set1_ps(fNorm);
+
+	/* Bin 0 has no imaginary part */
+	if (iNumBins < 1)
+		return;
+	pfMag[0] = HalfComplexMagOneC(pdSpec, iSize, fNorm, 0);
+
+	for (k = 1; k + 4 <= iNumBins; k += 4)
+	{
+		const __m128 xRe = _mm_movelh_ps(_mm_cvtpd_ps(_mm_loadu_pd(pdSpec + k)),
+			_mm_cvtpd_ps(_mm_loadu_pd(pdSpec + k + 2)));
+
+		/* iSize - k - 3 ... iSize - k, reversed */
+		const double* pdIm = pdSpec + iSize - k - 3;
+		__m128 xIm = _mm_movelh_ps(_mm_cvtpd_ps(_mm_loadu_pd(pdIm)),
+			_mm_cvtpd_ps(_mm_loadu_pd(pdIm + 2)));
+		xIm = _mm_shuffle_ps(xIm, xIm, _MM_SHUFFLE(0, 1, 2, 3));
+
+		const __m128 xSqMag = _mm_add_ps(_mm_mul_ps(xRe, xRe), _mm_mul_ps(xIm, xIm));
+		_mm_storeu_ps(pfMag + k, _mm_sqrt_ps(_mm_mul_ps(xSqMag, xNorm)));
+	}
+
+	for (; k < iNumBins; k++)
+		pfMag[k] = HalfComplexMagOneC(pdSpec, iSize, fNorm, k);
+}
+#endif
+
+
+/******************************************************************************\
+* NEON                                                                         *
+\******************************************************************************/
+#if SIMD_HAVE_NEON
+static void TrellisUpdateNEON(unsigned char* pDec, unsigned char* pNewMetric,
+							  const unsigned char* pOldMetric,
+							  const unsigned char* pMet1,
+							  const unsigned char* pMet2)
+{
+	/* 16 butterflies per pass */
+	for (int g = 0; g < SIMD_TRELLIS_STATES / 2; g += 16)
+	{
+		const uint8x16_t vOld0 = vld1q_u8(&pOldMetric[g]);
+		const uint8x16_t vOld1 = vld1q_u8(&pOldMetric[g + SIMD_TRELLIS_STATES / 2]);
+		const uint8x16_t vMet1 = vld1q_u8(&pMet1[g]);
+		const uint8x16_t vMet2 = vld1q_u8(&pMet2[g]);
+
+		const uint8x16_t vA = vqaddq_u8(vOld0, vMet1);
+		const uint8x16_t vB = vqaddq_u8(vOld1, vMet2);
+		const uint8x16_t vC = vqaddq_u8(vOld0, vMet2);
+		const uint8x16_t vD = vqaddq_u8(vOld1, vMet1);
+
+		/* The interleaving store puts the two states of a butterfly next to
+		   each other */
+		uint8x16x2_t vDec, vSurv;
+		vDec.val[0] = vcleq_u8(vB, vA);
+		vDec.val[1] = vcleq_u8(vD, vC);
+		vSurv.val[0] = vminq_u8(vA, vB);
+		vSurv.val[1] = vminq_u8(vC, vD);
+
+		vst2q_u8(&pDec[2 * g], vDec);
+		vst2q_u8(&pNewMetric[2 * g], vSurv);
+	}
+
+	if (pNewMetric[0] <= TRELLIS_NORM_LIMIT)
+		return;
+
+	uint8x16_t vMin = vld1q_u8(&pNewMetric[0]);
+	vMin = vminq_u8(vMin, vld1q_u8(&pNewMetric[16]));
+	vMin = vminq_u8(vMin, vld1q_u8(&pNewMetric[32]));
+	vMin = vminq_u8(vMin, vld1q_u8(&pNewMetric[48]));
+
+#if defined(_M_ARM64) || defined(__aarch64__)
+	const uint8x16_t vSub = vdupq_n_u8(vminvq_u8(vMin));
+#else
+	uint8x8_t vMin8 = vmin_u8(vget_low_u8(vMin), vget_high_u8(vMin));
+	vMin8 = vpmin_u8(vMin8, vMin8);
+	vMin8 = vpmin_u8(vMin8, vMin8);
+	vMin8 = vpmin_u8(vMin8, vMin8);
+	const uint8x16_t vSub = vdupq_lane_u8(vMin8, 0);
+#endif
+
+	for (int i = 0; i < SIMD_TRELLIS_STATES; i += 16)
+		vst1q_u8(&pNewMetric[i], vqsubq_u8(vld1q_u8(&pNewMetric[i]), vSub));
+}
+
+static void QAMMetricQ13NEON(const short* psSig, const short* psWeight,
+							 const short* psPoints, const int iNumPoints,
+							 int* piMetric, const int iLen)
+{
+	int i;
+
+	for (i = 0; i + 8 <= iLen; i += 8)
+	{
+		const int16x8_t vSig = vld1q_s16(&psSig[i]);
+
+		/* The absolute difference wraps, as unsigned 16 bit it is exact */
+		uint16x8_t vMin = vreinterpretq_u16_s16(
+			vabdq_s16(vSig, vdupq_n_s16(psPoints[0])));
+
+		for (int j = 1; j < iNumPoints; j++)
+		{
+			vMin = vminq_u16(vMin, vreinterpretq_u16_s16(
+				vabdq_s16(vSig, vdupq_n_s16(psPoints[j]))));
+		}
+
+		const uint16x8_t vWeight = vreinterpretq_u16_s16(vld1q_s16(&psWeight[i]));
+		const uint32x4_t vLo = vshrq_n_u32(
+			vmull_u16(vget_low_u16(vMin), vget_low_u16(vWeight)), 15);
+		const uint32x4_t vHi = vshrq_n_u32(
+			vmull_u16(vget_high_u16(vMin), vget_high_u16(vWeight)), 15);
+
+		vst1q_s32((int32_t*) &piMetric[i], vreinterpretq_s32_u32(vLo));
+		vst1q_s32((int32_t*) &piMetric[i + 4], vreinterpretq_s32_u32(vHi));
+	}
+
+	for (; i < iLen; i++)
+		piMetric[i] = MetricQ13C(psSig[i], psWeight[i], psPoints, iNumPoints);
+}
+
+#if SIMD_HAVE_NEON_F64
+static void QAMMetricRealNEON(const _REAL* prSig, const _REAL* prWeight,
+							  const _REAL* prPoints, const int iNumPoints,
+							  _REAL* prMetric, const int iLen)
+{
+	int i;
+
+	for (i = 0; i + 2 <= iLen; i += 2)
+	{
+		const float64x2_t vSig = vld1q_f64(&prSig[i]);
+		float64x2_t vMin = vabdq_f64(vSig, vdupq_n_f64(prPoints[0]));
+
+		for (int j = 1; j < iNumPoints; j++)
+			vMin = vminq_f64(vMin, vabdq_f64(vSig, vdupq_n_f64(prPoints[j])));
+
+		vst1q_f64(&prMetric[i], vmulq_f64(vMin, vld1q_f64(&prWeight[i])));
+	}
+
+	for (; i < iLen; i++)
+		prMetric[i] = MetricRealC(prSig[i], prWeight[i], prPoints, iNumPoints);
+}
+
+static void FirCplxTapsDecNEON(const _REAL* prTaps, const int iNumTaps,
+							   const _REAL* prX, const int iFirstPos,
+							   const int iDecFact, _REAL* prY,
+							   const int iNumOut)
+{
+	int m;
+
+	/* Multiply and add are separate instructions on purpose, a fused
+	   multiply-add rounds differently than the generic code */
+	for (m = 0; m + 2 <= iNumOut; m += 2)
+	{
+		const _REAL* prX0 = &prX[iFirstPos + m * iDecFact];
+		const _REAL* prX1 = prX0 + iDecFact;
+		float64x2_t vAcc0 = vdupq_n_f64(0.0);
+		float64x2_t vAcc1 = vdupq_n_f64(0.0);
+
+		for (int n = 0; n < iNumTaps; n++)
+		{
+			const float64x2_t vTap = vld1q_f64(&prTaps[2 * n]);
+
+			vAcc0 = vaddq_f64(vAcc0, vmulq_n_f64(vTap, prX0[-n]));
+			vAcc1 = vaddq_f64(vAcc1, vmulq_n_f64(vTap, prX1[-n]));
+		}
+
+		vst1q_f64(&prY[2 * m], vAcc0);
+		vst1q_f64(&prY[2 * m + 2], vAcc1);
+	}
+
+	for (; m < iNumOut; m++)
+	{
+		FirCplxTapsOneC(prTaps, iNumTaps, &prX[iFirstPos + m * iDecFact],
+			&prY[2 * m]);
+	}
+}
+#endif
+
+static inline uint8x16_t GFMulXNEON(const uint8x16_t vA, const uint8x16_t vPoly)
+{
+	/* Bytes with the highest bit set are reduced after the shift */
+	const uint8x16_t vHigh =
+		vreinterpretq_u8_s8(vshrq_n_s8(vreinterpretq_s8_u8(vA), 7));
+	return veorq_u8(vshlq_n_u8(vA, 1), vandq_u8(vHigh, vPoly));
+}
+
+static _BOOLEAN RSSyndromesNEON(const unsigned char* pBlock, const int iCodeLen,
+								const unsigned char* pRoots,
+								const int iNumRoots, unsigned char* pSyndromes)
+{
+	int i, k;
+	unsigned char ucAny = 0;
+	const uint8x16_t vPoly = vdupq_n_u8(SIMD_RS_FIELD_POLY);
+
+	/* 16 syndromes at a time, each byte has its own root */
+	for (int j = 0; j < iNumRoots; j += 16)
+	{
+		const int iNumLanes = (iNumRoots - j < 16) ? iNumRoots - j : 16;
+
+		unsigned char ucRoots[16];
+		memset(ucRoots, 0, sizeof(ucRoots));
+		memcpy(ucRoots, &pRoots[j], iNumLanes);
+
+		/* The multiplication with the roots is split in their bits */
+		const uint8x16_t vRoots = vld1q_u8(ucRoots);
+		uint8x16_t vBitMask[8];
+		for (k = 0; k < 8; k++)
+			vBitMask[k] = vtstq_u8(vRoots, vdupq_n_u8((unsigned char) (1 << k)));
+
+		uint8x16_t vS = vdupq_n_u8(0);
+		for (i = 0; i < iCodeLen; i++)
+		{
+			uint8x16_t vProd = vandq_u8(vS, vBitMask[0]);
+			uint8x16_t vPow = vS;
+
+			for (k = 1; k < 8; k++)
+			{
+				vPow = GFMulXNEON(vPow, vPoly);
+				vProd = veorq_u8(vProd, vandq_u8(vPow, vBitMask[k]));
+			}
+
+			vS = veorq_u8(vProd, vdupq_n_u8(pBlock[i]));
+		}
+
+		unsigned char ucS[16];
+		vst1q_u8(ucS, vS);
+
+		for (k = 0; k < iNumLanes; k++)
+		{
+			pSyndromes[j + k] = ucS[k];
+			ucAny |= ucS[k];
+		}
+	}
+
+	return (ucAny != 0) ? TRUE : FALSE;
+}
+
+#if SIMD_HAVE_NEON_F64
+static void WindowToDoubleNEON(const float* pfIn, const float* pfWin,
+							   double* pdOut, const int iLen)
+{
+	int i;
+
+	for (i = 0; i + 4 <= iLen; i += 4)
+	{
+		const float32x4_t v = vmulq_f32(vld1q_f32(pfIn + i), vld1q_f32(pfWin + i));
+
+		vst1q_f64(pdOut + i, vcvt_f64_f32(vget_low_f32(v)));
+		vst1q_f64(pdOut + i + 2, vcvt_high_f64_f32(v));
+	}
+
+	for (; i < iLen; i++)
+		pdOut[i] = pfIn[i] * pfWin[i];
+}
+
+static void HalfComplexMagNEON(const double* pdSpec, const int iSize,
+							   const float fNorm, float* pfMag, const int iNumBins)
+{
+	int k;
+
+	/* Bin 0 has no imaginary part */
+	if (iNumBins < 1)
+		return;
+	pfMag[0] = HalfComplexMagOneC(pdSpec, iSize, fNorm, 0);
+
+	for (k = 1; k + 4 <= iNumBins; k += 4)
+	{
+		const float32x4_t vRe = vcvt_high_f32_f64(
+			vcvt_f32_f64(vld1q_f64(pdSpec + k)), vld1q_f64(pdSpec + k + 2));
+
+		/* iSize - k - 3 ... iSize - k, reversed */
+		const double* pdIm = pdSpec + iSize - k - 3;
+		float32x4_t vIm = vcvt_high_f32_f64(
+			vcvt_f32_f64(vld1q_f64(pdIm)), vld1q_f64(pdIm + 2));
+		vIm = vrev64q_f32(vcombine_f32(vget_high_f32(vIm), vget_low_f32(vIm)));
+
+		const float32x4_t vSqMag = vaddq_f32(vmulq_f32(vRe, vRe), vmulq_f32(vIm, vIm));
+		vst1q_f32(pfMag + k, vsqrtq_f32(vmulq_n_f32(vSqMag, fNorm)));
+	}
+
+	for (; k < iNumBins; k++)
+		pfMag[k] = HalfComplexMagOneC(pdSpec, iSize, fNorm, k);
+}
+#endif
+#endif
+
+
+/******************************************************************************\
+* Dispatch                                                                     *
+\******************************************************************************/
+static const CSimdKernels GenericKernels =
+{
+	SL_GENERIC, "generic",
+	TrellisUpdateC, QAMMetricQ13C, QAMMetricRealC, FirCplxTapsDecC,
+	RSSyndromesC, WindowToDoubleC, HalfComplexMagC
+};
+
+#if SIMD_HAVE_SSE2
+static const CSimdKernels SSE2Kernels =
+{
+	SL_SSE2, "SSE2",
+	TrellisUpdateSSE2, QAMMetricQ13SSE2, QAMMetricRealSSE2, FirCplxTapsDecSSE2,
+	RSSyndromesSSE2, WindowToDoubleSSE2, HalfComplexMagSSE2
+};
+#endif
+
+#if SIMD_HAVE_NEON
+static const CSimdKernels NEONKernels =
+{
+	SL_NEON, "NEON",
+	TrellisUpdateNEON, QAMMetricQ13NEON,
+#if SIMD_HAVE_NEON_F64
+	QAMMetricRealNEON, FirCplxTapsDecNEON,
+#else
+	QAMMetricRealC, FirCplxTapsDecC, /* ARMv7 NEON has no double precision */
+#endif
+	RSSyndromesNEON,
+#if SIMD_HAVE_NEON_F64
+	WindowToDoubleNEON, HalfComplexMagNEON
+#else
+	WindowToDoubleC, HalfComplexMagC
+#endif
+};
+#endif
+
+#if SIMD_HAVE_SSE2
+static _BOOLEAN HaveSSE2()
+{
+# if defined(_M_X64) || defined(__x86_64__)
+	/* Part of x64 */
+	return TRUE;
+# elif defined(_WIN32)
+	return IsProcessorFeaturePresent(PF_XMMI64_INSTRUCTIONS_AVAILABLE) ?
+		TRUE : FALSE;
+# else
+	return __builtin_cpu_supports("sse2") ? TRUE : FALSE;
+# endif
+}
+#endif
+
+const CSimdKernels* GetSimdKernels(const ESimdLevel eLevel)
+{
+	switch (eLevel)
+	{
+	case SL_GENERIC:
+		return &GenericKernels;
+
+#if SIMD_HAVE_SSE2
+	case SL_SSE2:
+		return (HaveSSE2() == TRUE) ? &SSE2Kernels : NULL;
+#endif
+
+#if SIMD_HAVE_NEON
+	case SL_NEON:
+		/* ARM64 always has it. A 32 bit build with NEON enabled is already
+		   tied to processors which have it (also all Windows ARM devices) */
+		return &NEONKernels;
+#endif
+
+	default:
+		return NULL;
+	}
+}
+
+static const CSimdKernels* DetectSimdKernels()
+{
+	for (int i = SL_NUM_LEVELS - 1; i > SL_GENERIC; i--)
+	{
+		const CSimdKernels* pKernels = GetSimdKernels((ESimdLevel) i);
+
+		if (pKernels != NULL)
+			return pKernels;
+	}
+
+	return &GenericKernels;
+}
+
+const CSimdKernels& SimdKernels()
+{
+	/* Initialized once, also if the first calls come from several threads */
+	static const CSimdKernels* pKernels = DetectSimdKernels();
+
+	return *pKernels;
+}
+
+
+/******************************************************************************\
+* Self check                                                                   *
+\******************************************************************************/
+/* Same numbers on every machine */
+class CCheckRandom
+{
+public:
+	CCheckRandom() : iState(0x12345678) {}
+
+	unsigned int Next()
+	{
+		iState = iState * 1664525 + 1013904223;
+		return iState >> 8;
+	}
+
+	int Range(const int iMin, const int iMax)
+	{
+		return iMin + (int) (Next() % (unsigned int) (iMax - iMin + 1));
+	}
+
+protected:
+	unsigned int iState;
+};
+
+/* FNV-1a over the bytes of the kernel outputs */
+class CCheckHash
+{
+public:
+	CCheckHash() : iHash(2166136261u) {}
+
+	void Add(const void* pData, const int iNumBytes)
+	{
+		const unsigned char* pucData = (const unsigned char*) pData;
+
+		for (int i = 0; i < iNumBytes; i++)
+			iHash = (iHash ^ pucData[i]) * 16777619u;
+	}
+
+	unsigned int Get() const {return iHash;}
+
+protected:
+	unsigned int iHash;
+};
+
+static int CheckTrellis(const CSimdKernels& Kernels, CCheckRandom& Random,
+						CCheckHash& Hash, int& iNumTests)
+{
+	unsigned char ucOld[SIMD_TRELLIS_STATES];
+	unsigned char ucMet1[SIMD_TRELLIS_STATES / 2], ucMet2[SIMD_TRELLIS_STATES / 2];
+	unsigned char ucNewRef[SIMD_TRELLIS_STATES], ucDecRef[SIMD_TRELLIS_STATES];
+	unsigned char ucNew[SIMD_TRELLIS_STATES], ucDec[SIMD_TRELLIS_STATES];
+	int i, iNumDiff = 0;
+
+	for (i = 0; i < SIMD_TRELLIS_STATES; i++)
+		ucOld[i] = (unsigned char) Random.Range(0, 255);
+
+	/* Runs like the decoder, small metrics with some large ones so that the
+	   normalization and the saturation are used */
+	for (iNumTests = 0; iNumTests < 20000; iNumTests++)
+	{
+		for (i = 0; i < SIMD_TRELLIS_STATES / 2; i++)
+		{
+			ucMet1[i] = (unsigned char) ((Random.Range(0, 15) == 0) ?
+				Random.Range(0, 255) : Random.Range(0, 40));
+			ucMet2[i] = (unsigned char) ((Random.Range(0, 15) == 0) ?
+				Random.Range(0, 255) : Random.Range(0, 40));
+		}
+
+		TrellisUpdateC(ucDecRef, ucNewRef, ucOld, ucMet1, ucMet2);
+		Kernels.TrellisUpdate(ucDec, ucNew, ucOld, ucMet1, ucMet2);
+
+		Hash.Add(ucDec, sizeof(ucDec));
+		Hash.Add(ucNew, sizeof(ucNew));
+
+		if ((memcmp(ucDec, ucDecRef, sizeof(ucDec)) != 0) ||
+			(memcmp(ucNew, ucNewRef, sizeof(ucNew)) != 0))
+		{
+			iNumDiff++;
+		}
+
+		memcpy(ucOld, ucNewRef, sizeof(ucOld));
+	}
+
+	return iNumDiff;
+}
+
+static int CheckQAMMetric(const CSimdKernels& Kernels, CCheckRandom& Random,
+						  CCheckHash& Hash, int& iNumTests)
+{
+	const int iMaxLen = 100;
+	short sSig[iMaxLen], sWeight[iMaxLen], sPoints[4];
+	int iMetricRef[iMaxLen], iMetric[iMaxLen];
+	int i, iNumDiff = 0;
+
+	for (iNumTests = 0; iNumTests < 20000; iNumTests++)
+	{
+		const int iLen = Random.Range(1, iMaxLen);
+		const int iNumPoints = 1 << Random.Range(0, 2);
+
+		/* Full range of the signal, the weights are not negative */
+		for (i = 0; i < iLen; i++)
+		{
+			sSig[i] = (short) Random.Range(-32768, 32767);
+			sWeight[i] = (short) Random.Range(0, 32767);
+		}
+
+		for (i = 0; i < iNumPoints; i++)
+			sPoints[i] = (short) Random.Range(-32768, 32767);
+
+		QAMMetricQ13C(sSig, sWeight, sPoints, iNumPoints, iMetricRef, iLen);
+		Kernels.QAMMetricQ13(sSig, sWeight, sPoints, iNumPoints, iMetric, iLen);
+
+		Hash.Add(iMetric, iLen * sizeof(int));
+
+		if (memcmp(iMetric, iMetricRef, iLen * sizeof(int)) != 0)
+			iNumDiff++;
+	}
+
+	return iNumDiff;
+}
+
+static int CheckQAMMetricReal(const CSimdKernels& Kernels, CCheckRandom& Random,
+							  CCheckHash& Hash, int& iNumTests)
+{
+	const int iMaxLen = 100;
+	_REAL rSig[iMaxLen], rWeight[iMaxLen], rPoints[4];
+	_REAL rMetricRef[iMaxLen], rMetric[iMaxLen];
+	int i, iNumDiff = 0;
+
+	for (iNumTests = 0; iNumTests < 20000; iNumTests++)
+	{
+		const int iLen = Random.Range(1, iMaxLen);
+		const int iNumPoints = 1 << Random.Range(0, 2);
+
+		/* Equalized cells around the 64-QAM points, weights like sqrt of
+		   the channel power */
+		for (i = 0; i < iLen; i++)
+		{
+			rSig[i] = (_REAL) Random.Range(-2000000, 2000000) / 999983;
+			rWeight[i] = sqrt((_REAL) Random.Range(0, 1000000) / 65521);
+		}
+
+		for (i = 0; i < iNumPoints; i++)
+			rPoints[i] = (_REAL) Random.Range(-1100000, 1100000) / 999983;
+
+		QAMMetricRealC(rSig, rWeight, rPoints, iNumPoints, rMetricRef, iLen);
+		Kernels.QAMMetricReal(rSig, rWeight, rPoints, iNumPoints, rMetric, iLen);
+
+		Hash.Add(rMetric, iLen * sizeof(_REAL));
+
+		if (memcmp(rMetric, rMetricRef, iLen * sizeof(_REAL)) != 0)
+			iNumDiff++;
+	}
+
+	return iNumDiff;
+}
+
+static int CheckFir(const CSimdKernels& Kernels, CCheckRandom& Random,
+					CCheckHash& Hash, int& iNumTests)
+{
+	const int iMaxTaps = 80;
+	const int iMaxOut = 64;
+	const int iMaxDec = 4;
+	const int iLenX = iMaxTaps + iMaxOut * iMaxDec;
+	std::vector<_REAL> vecrTaps(2 * iMaxTaps), vecrX(iLenX);
+	std::vector<_REAL> vecrYRef(2 * iMaxOut), vecrY(2 * iMaxOut);
+	int i, iNumDiff = 0;
+
+	for (iNumTests = 0; iNumTests < 2000; iNumTests++)
+	{
+		const int iNumTaps = Random.Range(1, iMaxTaps);
+		const int iNumOut = Random.Range(0, iMaxOut);
+		const int iDecFact = Random.Range(1, iMaxDec);
+
+		for (i = 0; i < 2 * iNumTaps; i++)
+			vecrTaps[i] = (_REAL) Random.Range(-1000000, 1000000) / 999983;
+		for (i = 0; i < iLenX; i++)
+			vecrX[i] = (_REAL) Random.Range(-1000000, 1000000) / 65521;
+
+		FirCplxTapsDecC(&vecrTaps[0], iNumTaps, &vecrX[0], iNumTaps - 1,
+			iDecFact, &vecrYRef[0], iNumOut);
+		Kernels.FirCplxTapsDec(&vecrTaps[0], iNumTaps, &vecrX[0],
+			iNumTaps - 1, iDecFact, &vecrY[0], iNumOut);
+
+		Hash.Add(&vecrY[0], 2 * iNumOut * sizeof(_REAL));
+
+		if (memcmp(&vecrY[0], &vecrYRef[0], 2 * iNumOut * sizeof(_REAL)) != 0)
+			iNumDiff++;
+	}
+
+	return iNumDiff;
+}
+
+static int CheckRSSyndromes(const CSimdKernels& Kernels, CCheckRandom& Random,
+							CCheckHash& Hash, int& iNumTests)
+{
+	const int iCodeLen = 255;
+	const int iNumRootsCodes[] = {31, 63, 95, 127};
+	unsigned char ucBlock[iCodeLen], ucRoots[SIMD_RS_MAX_ROOTS];
+	unsigned char ucSynRef[SIMD_RS_MAX_ROOTS], ucSyn[SIMD_RS_MAX_ROOTS];
+	int i, iNumDiff = 0;
+
+	for (iNumTests = 0; iNumTests < 400; iNumTests++)
+	{
+		const int iNumRoots = iNumRootsCodes[iNumTests % 4];
+
+		/* Some blocks without any symbol set, they have no syndromes */
+		const _BOOLEAN bZero = (Random.Range(0, 7) == 0) ? TRUE : FALSE;
+
+		for (i = 0; i < iCodeLen; i++)
+			ucBlock[i] = (unsigned char) ((bZero == TRUE) ? 0 : Random.Range(0, 255));
+		for (i = 0; i < iNumRoots; i++)
+			ucRoots[i] = (unsigned char) Random.Range(1, 255);
+
+		const _BOOLEAN bErrRef =
+			RSSyndromesC(ucBlock, iCodeLen, ucRoots, iNumRoots, ucSynRef);
+		const _BOOLEAN bErr =
+			Kernels.RSSyndromes(ucBlock, iCodeLen, ucRoots, iNumRoots, ucSyn);
+
+		Hash.Add(&bErr, sizeof(bErr));
+		Hash.Add(ucSyn, iNumRoots);
+
+		if ((bErr != bErrRef) || (memcmp(ucSyn, ucSynRef, iNumRoots) != 0))
+			iNumDiff++;
+	}
+
+	return iNumDiff;
+}
+
+static int CheckWindow(const CSimdKernels& Kernels, CCheckRandom& Random,
+					   CCheckHash& Hash, int& iNumTests)
+{
+	const int iMaxLen = 4096;
+	std::vector<float> vecfIn(iMaxLen), vecfWin(iMaxLen);
+	std::vector<double> vecdOutRef(iMaxLen), vecdOut(iMaxLen);
+	int i, iNumDiff = 0;
+
+	for (iNumTests = 0; iNumTests < 200; iNumTests++)
+	{
+		const int iLen = Random.Range(1, iMaxLen);
+
+		/* Input in the range of the sound card samples, window up to 2 */
+		for (i = 0; i < iLen; i++)
+		{
+			vecfIn[i] = (float) Random.Range(-32768, 32767);
+			vecfWin[i] = (float) Random.Range(0, 2000000) / 999983;
+		}
+
+		WindowToDoubleC(&vecfIn[0], &vecfWin[0], &vecdOutRef[0], iLen);
+		Kernels.WindowToDouble(&vecfIn[0], &vecfWin[0], &vecdOut[0], iLen);
+
+		Hash.Add(&vecdOut[0], iLen * sizeof(double));
+
+		if (memcmp(&vecdOut[0], &vecdOutRef[0], iLen * sizeof(double)) != 0)
+			iNumDiff++;
+	}
+
+	return iNumDiff;
+}
+
+static int CheckHalfComplexMag(const CSimdKernels& Kernels, CCheckRandom& Random,
+							   CCheckHash& Hash, int& iNumTests)
+{
+	const int iMaxSize = 4096;
+	std::vector<double> vecdSpec(iMaxSize);
+	std::vector<float> vecfMagRef(iMaxSize / 2), vecfMag(iMaxSize / 2);
+	int i, iNumDiff = 0;
+
+	for (iNumTests = 0; iNumTests < 200; iNumTests++)
+	{
+		/* Sizes of the displays and the signal detection, up to half of the
+		   bins */
+		const int iSize = 64 << Random.Range(0, 6);
+		const int iNumBins = Random.Range(1, iSize / 2);
+		const float fNorm = (float) Random.Range(1, 1000000) / 1e12f;
+
+		for (i = 0; i < iSize; i++)
+			vecdSpec[i] = (double) Random.Range(-1000000, 1000000) * 65.537;
+
+		HalfComplexMagC(&vecdSpec[0], iSize, fNorm, &vecfMagRef[0], iNumBins);
+		Kernels.HalfComplexMag(&vecdSpec[0], iSize, fNorm, &vecfMag[0], iNumBins);
+
+		Hash.Add(&vecfMag[0], iNumBins * sizeof(float));
+
+		if (memcmp(&vecfMag[0], &vecfMagRef[0], iNumBins * sizeof(float)) != 0)
+			iNumDiff++;
+	}
+
+	return iNumDiff;
+}
+
+/* The checks in the order of the report. The hashes of the kernel outputs
+   were taken with the generic code on x86. A different hash on another
+   machine means that the generic code or a kernel rounds differently there */
+class CKernelCheck
+{
+public:
+	const char*		strName;
+	int				(*Check)(const CSimdKernels& Kernels, CCheckRandom& Random,
+						CCheckHash& Hash, int& iNumTests);
+	unsigned int	iRefHash;
+};
+
+static const CKernelCheck KernelChecks[] =
+{
+	{"TrellisUpdate", CheckTrellis, 0x667adabdu},
+	{"QAMMetricQ13", CheckQAMMetric, 0x2c126dacu},
+	{"QAMMetricReal", CheckQAMMetricReal, 0x5c2ebf13u},
+	{"FirCplxTapsDec", CheckFir, 0x8c717708u},
+	{"RSSyndromes", CheckRSSyndromes, 0x872ba8c2u},
+	{"WindowToDouble", CheckWindow, 0xf9471e58u},
+	{"HalfComplexMag", CheckHalfComplexMag, 0xb92be4e5u}
+};
+
+_BOOLEAN SimdSelfCheck(const std::string strReportFile)
+{
+	FILE* pFile = fopen(strReportFile.c_str(), "w");
+
+	if (pFile == NULL)
+		return FALSE;
+
+	fprintf(pFile, "Used: %s\n\n", SimdKernels().strName);
+	fprintf(pFile, "Level\tKernel\tTests\tDifferent\tHash\tReference\n");
+
+	_BOOLEAN bAllEqual = TRUE;
+
+	/* The generic code is only compared with the reference hashes */
+	for (int iLevel = SL_GENERIC; iLevel < SL_NUM_LEVELS; iLevel++)
+	{
+		const CSimdKernels* pKernels = GetSimdKernels((ESimdLevel) iLevel);
+
+		/* Not for this processor */
+		if (pKernels == NULL)
+			continue;
+
+		/* The same random data for each level */
+		CCheckRandom Random;
+
+		for (size_t i = 0; i < sizeof(KernelChecks) / sizeof(KernelChecks[0]); i++)
+		{
+			const CKernelCheck& KernelCheck = KernelChecks[i];
+			CCheckHash Hash;
+			int iNumTests;
+
+			const int iNumDiff = KernelCheck.Check(*pKernels, Random, Hash,
+				iNumTests);
+			const _BOOLEAN bRefOk = (Hash.Get() == KernelCheck.iRefHash) ?
+				TRUE : FALSE;
+
+			fprintf(pFile, "%s\t%s\t%d\t%d\t%08x\t%s\n", pKernels->strName,
+				KernelCheck.strName, iNumTests, iNumDiff, Hash.Get(),
+				(bRefOk == TRUE) ? "ok" : "DIFFERENT");
+
+			if ((iNumDiff != 0) || (bRefOk == FALSE))
+				bAllEqual = FALSE;
+		}
+	}
+
+	fprintf(pFile, "\n%s\n", (bAllEqual == TRUE) ? "All equal" : "DIFFERENT");
+	fclose(pFile);
+
+	return bAllEqual;
+}
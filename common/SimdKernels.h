@@ -0,0 +1,135 @@
+/******************************************************************************\
+ * Copyright (c) 2024
+ *
+ * Author(s):
+ *	EasyDRF developers
+ *
+ * Description:
+ *	See SimdKernels.cpp
+ *
+ ******************************************************************************
+ *
+ * This program is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation; either version 2 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ *
+\******************************************************************************/
+
+#if !defined(SIMDKERNELS_H__3B0UBVE98732KJVEW363SIMDKERN__INCLUDED_)
+#define SIMDKERNELS_H__3B0UBVE98732KJVEW363SIMDKERN__INCLUDED_
+
+#include <string>
+#include "GlobalDefinitions.h"
+
+
+/* Definitions ****************************************************************/
+/* Instruction sets the compiler can generate for the target */
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+# define SIMD_HAVE_SSE2				TRUE
+#else
+# define SIMD_HAVE_SSE2				FALSE
+#endif
+
+#if defined(_M_ARM64) || defined(_M_ARM) || defined(__aarch64__) || defined(__ARM_NEON)
+# define SIMD_HAVE_NEON				TRUE
+#else
+# define SIMD_HAVE_NEON				FALSE
+#endif
+
+/* States of the Viterbi trellis (MC_NUM_STATES) */
+#define SIMD_TRELLIS_STATES			64
+
+/* Low byte of the field polynomial of the RS codes (x^8 + x^7 + x^2 + x + 1,
+   "primitive_polynomial06" of Schifra) */
+#define SIMD_RS_FIELD_POLY			0x87
+
+/* Most roots of one RS code (fec_length of RS4) */
+#define SIMD_RS_MAX_ROOTS			128
+
+
+/* Classes ********************************************************************/
+enum ESimdLevel {SL_GENERIC, SL_SSE2, SL_NEON, SL_NUM_LEVELS};
+
+/* One implementation of each kernel. The results of all tables are bit-exact
+   to the generic one, so the receiver does not depend on the machine */
+class CSimdKernels
+{
+public:
+	ESimdLevel	eLevel;
+	const char*	strName;
+
+	/* One step of the 64 state Viterbi trellis with 8 bit metrics. For each
+	   butterfly p (0..31) the old metrics of the states p and p + 32 get
+	   "pMet1[p]" and "pMet2[p]" added (saturated), the survivors and
+	   decisions (0 or 0xFF) go to 2p and 2p + 1. The metrics are normalized
+	   if the one of state 0 gets above 150 */
+	void (*TrellisUpdate)(unsigned char* pDec, unsigned char* pNewMetric,
+		const unsigned char* pOldMetric, const unsigned char* pMet1,
+		const unsigned char* pMet2);
+
+	/* Fixed-point QAM metric of one bit:
+	   piMetric[i] = (min_j |psSig[i] - psPoints[j]| * psWeight[i]) >> 15,
+	   signal and points in Q13, non-negative weight in Q15 */
+	void (*QAMMetricQ13)(const short* psSig, const short* psWeight,
+		const short* psPoints, const int iNumPoints, int* piMetric,
+		const int iLen);
+
+	/* The same on the floating-point cells, the weight is sqrt of the
+	   channel power: prMetric[i] = min_j |prSig[i] - prPoints[j]| *
+	   prWeight[i] */
+	void (*QAMMetricReal)(const _REAL* prSig, const _REAL* prWeight,
+		const _REAL* prPoints, const int iNumPoints, _REAL* prMetric,
+		const int iLen);
+
+	/* Complex taps on a real signal with decimation:
+	   y[m] = sum_n b[n] x[iFirstPos + m iDecFact - n], taps and output are
+	   interleaved real and imaginary parts. The sums run in the order of n
+	   like the Matlib code (must be built without FMA contraction) */
+	void (*FirCplxTapsDec)(const _REAL* prTaps, const int iNumTaps,
+		const _REAL* prX, const int iFirstPos, const int iDecFact,
+		_REAL* prY, const int iNumOut);
+
+	/* Syndromes of one RS code word in GF(2^8): S_j = r(pRoots[j]) with
+	   r(x) = sum_i pBlock[i] x^(iCodeLen - 1 - i). Returns FALSE if all
+	   syndromes are zero (no error in the code word) */
+	_BOOLEAN (*RSSyndromes)(const unsigned char* pBlock, const int iCodeLen,
+		const unsigned char* pRoots, const int iNumRoots,
+		unsigned char* pSyndromes);
+
+	/* Window of the spectrogram: pdOut[i] = pfIn[i] * pfWin[i], multiplied
+	   in single precision and stored as double for the FFT */
+	void (*WindowToDouble)(const float* pfIn, const float* pfWin,
+		double* pdOut, const int iLen);
+
+	/* Magnitudes of a half complex FFT output (real part of bin k at k,
+	   imaginary part at iSize - k, bin 0 is real):
+	   pfMag[k] = sqrt((re^2 + im^2) * fNorm) in single precision */
+	void (*HalfComplexMag)(const double* pdSpec, const int iSize,
+		const float fNorm, float* pfMag, const int iNumBins);
+};
+
+/* Best implementation for this processor, detected on the first call */
+const CSimdKernels& SimdKernels();
+
+/* NULL if the processor (or the build) does not have the instruction set */
+const CSimdKernels* GetSimdKernels(const ESimdLevel eLevel);
+
+/* Compares all implementations of this processor with the generic one on
+   random data ("-bs"). The outputs of all of them, the generic one
+   included, must also hash to the values of the reference machine, so the
+   results do not depend on the architecture. Writes a report and returns
+   TRUE if all are equal */
+_BOOLEAN SimdSelfCheck(const std::string strReportFile);
+
+
+#endif // !defined(SIMDKERNELS_H__3B0UBVE98732KJVEW363SIMDKERN__INCLUDED_)
@@ -0,0 +1,306 @@
+/******************************************************************************\
+ * Copyright (c) 2024
+ *
+ * Author(s):
+ *	EasyDRF developers
+ *
+ * Description:
+ *	Continuous short time Fourier transform of the receiver input
+ *
+ *	The receive thread feeds every input block in. Each time a hop of new
+ *	samples is complete, the last "size" samples are windowed, transformed
+ *	and the magnitude is stored as one line in a ring of the most recent
+ *	lines. The spectrum and waterfall displays and the clients of the DLL
+ *	only copy lines out of the ring, nothing is computed on their request.
+ *	Window and magnitude are done in float with SSE
+ *
+ ******************************************************************************
+ *
+ * This program is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation; either version 2 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ *
+\******************************************************************************/
+
+#include "Stft.h"
+#include "tables/TableDRMGlobal.h"
+#include <string.h>
+
+
+/* Implementation *************************************************************/
+CStft::CStft() : iDecimation(STFT_DECIMATION), iBinsDiv(4), iLinesStarted(0),
+	iLinesDone(0), iNewSize(0), iNewHop(0)
+{
+	Init(STFT_DEFAULT_SIZE, STFT_DEFAULT_HOP);
+}
+
+void CStft::Setup(const int iNewDecimation, const int iNewBinsDiv,
+				  const int iNewSize, const int iNewHop)
+{
+	iDecimation = iNewDecimation;
+	iBinsDiv = iNewBinsDiv;
+
+	Init(iNewSize, iNewHop);
+}
+
+void CStft::SetParams(const int iSize, const int iHop)
+{
+	/* Power of 2 in the allowed range */
+	int iCheckedSize = STFT_MIN_SIZE;
+	while ((iCheckedSize < iSize) && (iCheckedSize < STFT_MAX_SIZE))
+		iCheckedSize <<= 1;
+
+	int iCheckedHop = iHop;
+	if (iCheckedHop < 1)
+		iCheckedHop = 1;
+
+	/* The size is the flag, so the hop has to be written first */
+	iNewHop.store(iCheckedHop, std::memory_order_relaxed);
+	iNewSize.store(iCheckedSize, std::memory_order_release);
+}
+
+void CStft::Init(const int iNewSize, const int iNewHop)
+{
+	int i;
+
+	std::lock_guard<std::mutex> Guard(BufMutex);
+
+	iSize = iNewSize;
+	iHop = iNewHop;
+	iNumBins = iSize / iBinsDiv;
+
+	FftPlan.Init(iSize);
+
+	/* Same window and scaling as the former input spectrum */
+	CRealVector vecrHann(Hann(iSize));
+	vecfWindow.Init(iSize);
+	for (i = 0; i < iSize; i++)
+		vecfWindow[i] = (float) (vecrHann[i] * 2.0);
+
+	const _REAL rLen = (_REAL) iDecimation * iSize;
+	fNorm = (float) (1.0 / (0.2 * rLen * rLen * _MAXSHORT));
+
+	vecfHistory.Init(2 * iSize, 0.0f);
+	vecfLines.Init(STFT_NUM_LINES * iNumBins, 0.0f);
+
+	iHistPos = 0;
+	iHopCnt = 0;
+	iDecimCnt = 0;
+
+	/* The line numbers start again, the old lines do not fit anymore */
+	iLinesStarted.store(0, std::memory_order_relaxed);
+	iLinesDone.store(0, std::memory_order_release);
+}
+
+void CStft::AddBlock(const CVector<_REAL>& vecrIn, const int iLen)
+{
+	if (iNewSize.load(std::memory_order_acquire) != 0)
+	{
+		const int iS = iNewSize.exchange(0, std::memory_order_acquire);
+		Init(iS, iNewHop.load(std::memory_order_relaxed));
+	}
+
+	for (int i = 0; i < iLen; i++)
+	{
+		if (++iDecimCnt < iDecimation)
+			continue;
+		iDecimCnt = 0;
+
+		/* Every sample is written twice, so the last "size" samples are
+		   always in one piece starting at the write position */
+		const float fSample = (float) vecrIn[i];
+		vecfHistory[iHistPos] = fSample;
+		vecfHistory[iHistPos + iSize] = fSample;
+
+		iHistPos++;
+		if (iHistPos == iSize)
+			iHistPos = 0;
+
+		if (++iHopCnt == iHop)
+		{
+			iHopCnt = 0;
+			CalcLine();
+		}
+	}
+}
+
+void CStft::CalcLine()
+{
+	const CSimdKernels& Kernels = SimdKernels();
+
+	/* Window, fftw_real is double */
+	Kernels.WindowToDouble(&vecfHistory[iHistPos], &vecfWindow[0],
+		FftPlan.pFftwRealIn, iSize);
+
+	rfftw_one(FftPlan.RFFTPlForw, FftPlan.pFftwRealIn, FftPlan.pFftwRealOut);
+
+	/* Magnitude into the next slot ------------------------------------------ */
+	const int iLine = iLinesStarted.load(std::memory_order_relaxed);
+	iLinesStarted.store(iLine + 1, std::memory_order_relaxed);
+	std::atomic_thread_fence(std::memory_order_release);
+
+	Kernels.HalfComplexMag(FftPlan.pFftwRealOut, iSize, fNorm,
+		&vecfLines[(iLine % STFT_NUM_LINES) * iNumBins], iNumBins);
+
+	iLinesDone.store(iLine + 1, std::memory_order_release);
+}
+
+int CStft::GetLines(int& iLine, const int iMaxLines, CVector<float>& vecfData)
+{
+	std::lock_guard<std::mutex> Guard(BufMutex);
+
+	return CopyLines(iLine, iMaxLines, vecfData);
+}
+
+_BOOLEAN CStft::GetCombined(int& iLine, CVector<_REAL>& vecrData, const int iNumOut,
+							const _BOOLEAN bPeak)
+{
+	int				i, j;
+	CVector<float>	vecfData;
+
+	std::lock_guard<std::mutex> Guard(BufMutex);
+
+	const int iNum = CopyLines(iLine, STFT_NUM_LINES, vecfData);
+	if (iNum == 0)
+		return FALSE;
+
+	/* Combined in the first line */
+	for (j = 1; j < iNum; j++)
+	{
+		const float* pfLine = &vecfData[j * iNumBins];
+
+		if (bPeak == TRUE)
+		{
+			for (i = 0; i < iNumBins; i++)
+			{
+				if (pfLine[i] > vecfData[i])
+					vecfData[i] = pfLine[i];
+			}
+		}
+		else
+		{
+			for (i = 0; i < iNumBins; i++)
+				vecfData[i] += pfLine[i];
+		}
+	}
+
+	if ((bPeak == FALSE) && (iNum > 1))
+	{
+		const float fScale = 1.0f / iNum;
+		for (i = 0; i < iNumBins; i++)
+			vecfData[i] *= fScale;
+	}
+
+	Resample(&vecfData[0], vecrData, iNumOut);
+
+	return TRUE;
+}
+
+int CStft::CopyLines(int& iLine, const int iMaxLines, CVector<float>& vecfData)
+{
+	const int iDone = iLinesDone.load(std::memory_order_acquire);
+
+	/* Clip the wanted range to the history. A line which does not exist yet
+	   means that the numbers have started again */
+	int iFirst = iLine;
+	if (iFirst > iDone)
+		iFirst = 0;
+	if (iFirst < iDone - STFT_NUM_LINES)
+		iFirst = iDone - STFT_NUM_LINES;
+	if (iFirst < 0)
+		iFirst = 0;
+
+	int iNum = iDone - iFirst;
+	if (iNum > iMaxLines)
+		iNum = iMaxLines;
+	if (iNum < 0)
+		iNum = 0;
+
+	vecfData.Init(iNum * iNumBins);
+
+	for (int j = 0; j < iNum; j++)
+	{
+		memcpy(&vecfData[j * iNumBins],
+			&vecfLines[((iFirst + j) % STFT_NUM_LINES) * iNumBins],
+			iNumBins * sizeof(float));
+	}
+
+	/* Lines whose slots the writer has started to overwrite in the meantime
+	   are dropped */
+	std::atomic_thread_fence(std::memory_order_acquire);
+	const int iValidFirst =
+		iLinesStarted.load(std::memory_order_relaxed) - STFT_NUM_LINES;
+
+	if (iFirst < iValidFirst)
+	{
+		int iDrop = iValidFirst - iFirst;
+		if (iDrop > iNum)
+			iDrop = iNum;
+
+		if (iDrop < iNum)
+		{
+			memmove(&vecfData[0], &vecfData[iDrop * iNumBins],
+				(iNum - iDrop) * iNumBins * sizeof(float));
+		}
+
+		/* Shrinks the vector, the content stays */
+		vecfData.Enlarge(-iDrop * iNumBins);
+
+		iNum -= iDrop;
+		iFirst += iDrop;
+	}
+
+	iLine = iFirst + iNum;
+
+	return iNum;
+}
+
+_BOOLEAN CStft::GetLatest(CVector<_REAL>& vecrData, const int iNumOut)
+{
+	std::lock_guard<std::mutex> Guard(BufMutex);
+
+	const int iDone = iLinesDone.load(std::memory_order_acquire);
+	if (iDone == 0)
+		return FALSE;
+
+	/* The writer works on the next slot, this one stays untouched */
+	Resample(&vecfLines[((iDone - 1) % STFT_NUM_LINES) * iNumBins], vecrData, iNumOut);
+
+	return TRUE;
+}
+
+void CStft::Resample(const float* pfLine, CVector<_REAL>& vecrData, const int iNumOut)
+{
+	/* Maximum of the bins which fall on one output bin */
+	vecrData.Init(iNumOut);
+	for (int i = 0; i < iNumOut; i++)
+	{
+		const int iStart = i * iNumBins / iNumOut;
+		int iEnd = (i + 1) * iNumBins / iNumOut;
+		if (iEnd <= iStart)
+			iEnd = iStart + 1;
+
+		float fMax = pfLine[iStart];
+		for (int k = iStart + 1; k < iEnd; k++)
+		{
+			if (pfLine[k] > fMax)
+				fMax = pfLine[k];
+		}
+		vecrData[i] = fMax;
+	}
+}
+
+_REAL CStft::GetLineRate()
+{
+	return (_REAL) SOUNDCRD_SAMPLE_RATE / (iDecimation * iHop);
+}
@@ -0,0 +1,135 @@
+/******************************************************************************\
+ * Copyright (c) 2024
+ *
+ * Author(s):
+ *	EasyDRF developers
+ *
+ * Description:
+ *	See Stft.cpp
+ *
+ ******************************************************************************
+ *
+ * This program is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation; either version 2 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ *
+\******************************************************************************/
+
+#if !defined(STFT_H__3B0UBVE98732KJVEW363STFTHIST__INCLUDED_)
+#define STFT_H__3B0UBVE98732KJVEW363STFTHIST__INCLUDED_
+
+#include <atomic>
+#include <mutex>
+#include "GlobalDefinitions.h"
+#include "Vector.h"
+#include "matlib/Matlib.h"
+#include "SimdKernels.h"
+
+
+/* Definitions ****************************************************************/
+/* For the displays the input is decimated by 2 without filter (like the
+   old input spectrum), the lines show the lowest quarter of the FFT, 0 to
+   6 kHz */
+#define STFT_DECIMATION				2
+#define STFT_DEFAULT_SIZE			2048
+#define STFT_DEFAULT_HOP			1024	/* about 23 lines per second */
+#define STFT_MIN_SIZE				256
+#define STFT_MAX_SIZE				8192
+
+/* History of spectral lines, about 11 s with the default hop */
+#define STFT_NUM_LINES				256
+
+/* Number of bins of the input spectrum of the displays */
+#define STFT_DISPLAY_BINS			512
+
+
+/* Classes ********************************************************************/
+/* Written by the receive thread only. The readers never block it: a line
+   is copied first and dropped afterwards if the writer has reached its slot
+   in the meantime */
+class CStft
+{
+public:
+	CStft();
+	virtual ~CStft() {}
+
+	/* Callable from every thread, used with the next block. The size must be
+	   a power of 2, the hop is in decimated samples */
+	void		SetParams(const int iNewSize, const int iNewHop);
+
+	/* Other uses than the displays (the signal detection of the wideband
+	   receiver): every iNewDecimation-th sample, lines with
+	   iNewSize / iNewBinsDiv bins. Must be called before the first block by
+	   the thread which adds the blocks, the size can be any FFT size */
+	void		Setup(const int iNewDecimation, const int iNewBinsDiv,
+					const int iNewSize, const int iNewHop);
+
+	/* Receive thread */
+	void		AddBlock(const CVector<_REAL>& vecrIn, const int iLen);
+
+	/* Callable from every thread. iLine is the number of the first line
+	   which is wanted, it is moved to the oldest line in the history if that
+	   one is gone. On return it is the number of the next line to ask for.
+	   The lines are stored one after another in vecfData. Returns the number
+	   of lines */
+	int			GetLines(int& iLine, const int iMaxLines, CVector<float>& vecfData);
+
+	/* All lines from iLine on in one line of iNumOut bins, the mean or the
+	   peak of each bin. For displays which are slower than the line rate.
+	   FALSE if there is no new line */
+	_BOOLEAN	GetCombined(int& iLine, CVector<_REAL>& vecrData, const int iNumOut,
+					const _BOOLEAN bPeak);
+
+	/* Newest line with iNumBins bins over the same frequency range. FALSE
+	   if there is no line yet */
+	_BOOLEAN	GetLatest(CVector<_REAL>& vecrData, const int iNumBins);
+
+	int			GetNumBins() {return iNumBins;}
+	int			GetLineCount() {return iLinesDone.load(std::memory_order_acquire);}
+	_REAL		GetLineRate(); /* lines per second */
+
+protected:
+	void		Init(const int iNewSize, const int iNewHop);
+	void		CalcLine();
+	int			CopyLines(int& iLine, const int iMaxLines, CVector<float>& vecfData);
+	void		Resample(const float* pfLine, CVector<_REAL>& vecrData, const int iNumOut);
+
+	CFftPlans				FftPlan;
+	CVector<float>			vecfWindow;
+	CVector<float>			vecfHistory; /* twice the size, see AddBlock() */
+	CVector<float>			vecfLines;
+	float					fNorm;
+
+	int						iDecimation;
+	int						iBinsDiv;
+	int						iSize;
+	int						iHop;
+	int						iNumBins;
+	int						iHistPos;
+	int						iHopCnt;
+	int						iDecimCnt;
+
+	/* A line is started before its slot is written, done afterwards */
+	std::atomic<int>		iLinesStarted;
+	std::atomic<int>		iLinesDone;
+
+	/* Pending parameters, 0 if there are none */
+	std::atomic<int>		iNewSize;
+	std::atomic<int>		iNewHop;
+
+	/* Only taken to change the size of the buffers */
+	std::mutex				BufMutex;
+};
+
+
+#endif // !defined(STFT_H__3B0UBVE98732KJVEW363STFTHIST__INCLUDED_)
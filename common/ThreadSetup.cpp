@@ -0,0 +1,276 @@
+/******************************************************************************\
+ * Copyright (c) 2024
+ *
+ * Author(s):
+ *	EasyDRF developers
+ *
+ * Description:
+ *	Setup of the signal processing threads
+ *
+ *	The receive, transmit and capture threads get a name (shown by the
+ *	debugger and the profilers), can be pinned to a core and run as MMCSS
+ *	"Pro Audio" task, which keeps them ahead of compression, other decoders
+ *	and the window when the machine is busy. Without MMCSS the priority of
+ *	the thread is raised instead. The stack is committed when the thread
+ *	starts. With "ThreadLockMB" the minimum working set of the process is
+ *	raised by that amount, so the buffers of the receivers (allocated and
+ *	cleared in Init()) stay in memory, and the stack is locked.
+ *
+ *	The functions which are not available on all versions of Windows are
+ *	looked up at run time. Lost sound blocks are counted in the module
+ *	statistics, see DRMSignalIO.cpp
+ *
+ ******************************************************************************
+ *
+ * This program is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation; either version 2 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ *
+\******************************************************************************/
+
+#include "ThreadSetup.h"
+#include <mutex>
+#include <new>
+
+
+/* Settings */
+int ThreadCoreRx = -1;
+int ThreadCoreTx = -1;
+int ThreadRealtime = TRUE;
+int ThreadLockMB = 0;
+
+/* avrt.h and SetThreadDescription() need newer SDKs than the project */
+#define AVRT_PRIO_HIGH				1
+#define AVRT_PRIO_CRITICAL			2
+
+typedef HANDLE (WINAPI *_AV_SET_TASK)(LPCWSTR, LPDWORD);
+typedef BOOL (WINAPI *_AV_SET_PRIO)(HANDLE, int);
+typedef BOOL (WINAPI *_AV_REVERT)(HANDLE);
+typedef HRESULT (WINAPI *_SET_THREAD_DESC)(HANDLE, PCWSTR);
+typedef VOID (WINAPI *_GET_STACK_LIMITS)(PULONG_PTR, PULONG_PTR);
+
+class CThreadFuncs
+{
+public:
+	CThreadFuncs() : pAvSetTask(NULL), pAvSetPrio(NULL), pAvRevert(NULL),
+		pSetDesc(NULL), pGetStackLimits(NULL)
+	{
+		/* Stays loaded until the program ends */
+		HMODULE hAvrt = LoadLibraryA("avrt.dll");
+		if (hAvrt != NULL)
+		{
+			pAvSetTask = (_AV_SET_TASK) GetProcAddress(hAvrt, "AvSetMmThreadCharacteristicsW");
+			pAvSetPrio = (_AV_SET_PRIO) GetProcAddress(hAvrt, "AvSetMmThreadPriority");
+			pAvRevert = (_AV_REVERT) GetProcAddress(hAvrt, "AvRevertMmThreadCharacteristics");
+
+			if ((pAvSetPrio == NULL) || (pAvRevert == NULL))
+				pAvSetTask = NULL;
+		}
+
+		HMODULE hKernel = GetModuleHandleA("kernel32.dll");
+		if (hKernel != NULL)
+		{
+			pSetDesc = (_SET_THREAD_DESC) GetProcAddress(hKernel, "SetThreadDescription");
+			pGetStackLimits = (_GET_STACK_LIMITS) GetProcAddress(hKernel,
+				"GetCurrentThreadStackLimits");
+		}
+	}
+
+	_AV_SET_TASK		pAvSetTask;
+	_AV_SET_PRIO		pAvSetPrio;
+	_AV_REVERT			pAvRevert;
+	_SET_THREAD_DESC	pSetDesc;
+	_GET_STACK_LIMITS	pGetStackLimits; /* Windows 8 */
+};
+
+static CThreadFuncs& GetThreadFuncs()
+{
+	static CThreadFuncs ThreadFuncs;
+	return ThreadFuncs;
+}
+
+static _BOOLEAN ReserveWorkingSet()
+{
+	/* Once for the process, VirtualLock() needs it for the stacks and the
+	   buffers */
+	static std::once_flag Once;
+	static _BOOLEAN bReserved = FALSE;
+
+	std::call_once(Once, []()
+	{
+		SIZE_T Min, Max;
+		HANDLE hProcess = GetCurrentProcess();
+
+		if (GetProcessWorkingSetSize(hProcess, &Min, &Max) != 0)
+		{
+			const SIZE_T Extra = (SIZE_T) ThreadLockMB * 1024 * 1024;
+			bReserved = SetProcessWorkingSetSize(hProcess, Min + Extra, Max + Extra) != 0;
+		}
+	});
+
+	return bReserved;
+}
+
+
+/* Implementation *************************************************************/
+CDSPThread::CDSPThread(const int iNewType, const wchar_t* pwchName) :
+	iType(iNewType), hTask(NULL), bLocked(FALSE), pvStackLock(NULL),
+	StackLockSize(0)
+{
+	SetName(pwchName);
+	Pin();
+	SetPriority();
+	PrefaultStack();
+
+	if ((ThreadLockMB > 0) && (ReserveWorkingSet() == TRUE))
+		LockStack();
+}
+
+CDSPThread::~CDSPThread()
+{
+	if (bLocked == TRUE)
+		VirtualUnlock(pvStackLock, StackLockSize);
+
+	if (hTask != NULL)
+		GetThreadFuncs().pAvRevert(hTask);
+}
+
+void CDSPThread::SetName(const wchar_t* pwchName)
+{
+	if (GetThreadFuncs().pSetDesc != NULL)
+		GetThreadFuncs().pSetDesc(GetCurrentThread(), pwchName);
+}
+
+void CDSPThread::Pin()
+{
+	int iCore = -1;
+
+	switch (iType)
+	{
+	case DSP_THREAD_RX:
+		iCore = ThreadCoreRx;
+		break;
+
+	case DSP_THREAD_RX2:
+		/* Next to the first receiver */
+		if (ThreadCoreRx >= 0)
+			iCore = ThreadCoreRx + 1;
+		break;
+
+	case DSP_THREAD_TX:
+		iCore = ThreadCoreTx;
+		break;
+	}
+
+	if ((iCore < 0) || (iCore >= (int) (8 * sizeof(DWORD_PTR))))
+		return;
+
+	/* Only cores the process may use */
+	DWORD_PTR ProcessMask, SystemMask;
+	const DWORD_PTR CoreMask = (DWORD_PTR) 1 << iCore;
+
+	if ((GetProcessAffinityMask(GetCurrentProcess(), &ProcessMask, &SystemMask) != 0) &&
+		((ProcessMask & CoreMask) != 0))
+	{
+		SetThreadAffinityMask(GetCurrentThread(), CoreMask);
+	}
+}
+
+void CDSPThread::SetPriority()
+{
+	CThreadFuncs& Funcs = GetThreadFuncs();
+
+	if ((ThreadRealtime == TRUE) && (Funcs.pAvSetTask != NULL))
+	{
+		DWORD dwTaskIndex = 0;
+		hTask = Funcs.pAvSetTask(L"Pro Audio", &dwTaskIndex);
+
+		if (hTask != NULL)
+		{
+			Funcs.pAvSetPrio(hTask,
+				(iType == DSP_THREAD_CAPTURE) ? AVRT_PRIO_CRITICAL : AVRT_PRIO_HIGH);
+			return;
+		}
+	}
+
+	/* The capture thread must never be delayed by the signal processing */
+	int iPriority = THREAD_PRIORITY_ABOVE_NORMAL;
+	if (iType == DSP_THREAD_CAPTURE)
+		iPriority = THREAD_PRIORITY_TIME_CRITICAL;
+	else if (ThreadRealtime == TRUE)
+		iPriority = THREAD_PRIORITY_HIGHEST;
+
+	SetThreadPriority(GetCurrentThread(), iPriority);
+}
+
+void CDSPThread::PrefaultStack()
+{
+	/* The pages are committed one after the other from the top, that is
+	   what the guard page expects */
+	volatile char chStack[DSP_STACK_PREFAULT];
+
+	for (int i = DSP_STACK_PREFAULT - 1; i >= 0; i -= 4096)
+		chStack[i] = 0;
+	chStack[0] = 0;
+}
+
+void CDSPThread::LockStack()
+{
+	ULONG_PTR Low = 0, High = 0;
+
+	if (GetThreadFuncs().pGetStackLimits != NULL)
+		GetThreadFuncs().pGetStackLimits(&Low, &High);
+	else
+	{
+		/* The committed top of the stack is one region which ends at the
+		   top of the reservation */
+		MEMORY_BASIC_INFORMATION Info;
+		if (VirtualQuery(&Info, &Info, sizeof(Info)) == 0)
+			return;
+
+		Low = (ULONG_PTR) Info.AllocationBase;
+		High = (ULONG_PTR) Info.BaseAddress + Info.RegionSize;
+	}
+
+	/* The thread function has used only a few bytes of the stack so far,
+	   the pages down to "DSP_STACK_PREFAULT" below the top were committed
+	   by "PrefaultStack()" */
+	if (High - Low < DSP_STACK_PREFAULT)
+		return;
+
+	pvStackLock = (void*) (High - DSP_STACK_PREFAULT);
+	StackLockSize = DSP_STACK_PREFAULT;
+	bLocked = VirtualLock(pvStackLock, StackLockSize) != 0;
+}
+
+
+/* Memory of the receive path *************************************************/
+void* AllocDSPMemory(const size_t Size)
+{
+	void* pvMem = VirtualAlloc(NULL, Size, MEM_COMMIT | MEM_RESERVE, PAGE_READWRITE);
+
+	if (pvMem == NULL)
+		throw std::bad_alloc();
+
+	/* Freeing the memory unlocks it as well */
+	if ((ThreadLockMB > 0) && (ReserveWorkingSet() == TRUE))
+		VirtualLock(pvMem, Size);
+
+	return pvMem;
+}
+
+void FreeDSPMemory(void* pvMem)
+{
+	if (pvMem != NULL)
+		VirtualFree(pvMem, 0, MEM_RELEASE);
+}
@@ -0,0 +1,92 @@
+/******************************************************************************\
+ * Copyright (c) 2024
+ *
+ * Author(s):
+ *	EasyDRF developers
+ *
+ * Description:
+ *	See ThreadSetup.cpp
+ *
+ ******************************************************************************
+ *
+ * This program is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation; either version 2 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ *
+\******************************************************************************/
+
+#if !defined(THREADSETUP_H__3B0UBVE98732KJVEW363THRSETUP__INCLUDED_)
+#define THREADSETUP_H__3B0UBVE98732KJVEW363THRSETUP__INCLUDED_
+
+#include <windows.h>
+#include "GlobalDefinitions.h"
+
+
+/* Definitions ****************************************************************/
+/* Kinds of signal processing threads */
+#define DSP_THREAD_RX				0
+#define DSP_THREAD_RX2				1	/* second receiver of the DLL */
+#define DSP_THREAD_TX				2
+#define DSP_THREAD_CAPTURE			3	/* sound card capture, see Sound.cpp */
+
+/* Stack which is committed when a thread starts, the processing routines
+   then never run into a guard page. With Lock_Memory_MB set, this top part
+   of the stack is also locked */
+#define DSP_STACK_PREFAULT			(128 * 1024)
+
+/* Settings, see settings.cpp. Core -1: the thread is not pinned. Realtime 0:
+   priority like before (above normal) */
+extern int ThreadCoreRx;
+extern int ThreadCoreTx;
+extern int ThreadRealtime;
+extern int ThreadLockMB;
+
+
+/* Classes ********************************************************************/
+/* Sets up the calling thread as long as the object lives, so it is made at
+   the top of the thread function:
+
+	CDSPThread DSPThread(DSP_THREAD_RX, L"EasyDRF RX");
+
+   Everything is optional, what the system does not support is skipped */
+class CDSPThread
+{
+public:
+	CDSPThread(const int iNewType, const wchar_t* pwchName);
+	virtual ~CDSPThread();
+
+	_BOOLEAN	IsRealtime() {return hTask != NULL;}
+	_BOOLEAN	IsLocked() {return bLocked;}
+
+protected:
+	void		SetName(const wchar_t* pwchName);
+	void		Pin();
+	void		SetPriority();
+	void		PrefaultStack();
+	void		LockStack();
+
+	int			iType;
+	HANDLE		hTask; /* MMCSS task */
+	_BOOLEAN	bLocked;
+	void*		pvStackLock;
+	SIZE_T		StackLockSize;
+};
+
+/* Memory of the receive path (sound card buffers, input ring). Whole pages
+   which are locked in RAM while Lock_Memory_MB is set, so no other memory
+   shares them. Throws std::bad_alloc like "new" */
+void* AllocDSPMemory(const size_t Size);
+void FreeDSPMemory(void* pvMem);
+
+
+#endif // !defined(THREADSETUP_H__3B0UBVE98732KJVEW363THRSETUP__INCLUDED_)
@@ -0,0 +1,341 @@
+/******************************************************************************\
+ * Copyright (c) 2024
+ *
+ * Author(s):
+ *	EasyDRF developers
+ *
+ * Description:
+ *	Transmit shaping chain: PAPR clipping and filtering
+ *
+ *	Same processing as the matlib version in CTransmitData before: 48 kHz
+ *	decimation filter, OFDM sidelobe filter, Hilbert clipper, post clipper
+ *	filter, overshoot clipper and filter at 12 kHz, mixing to the audio
+ *	frequency and interpolation 12 -> 24 -> 48 kHz. The interpolators only
+ *	compute the non-zero products of the zero-stuffed input (polyphase), I
+ *	and Q are filtered in one pass and no vector is allocated per block
+ *
+ ******************************************************************************
+ *
+ * This program is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation; either version 2 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ *
+\******************************************************************************/
+
+#include "TransmitShaper.h"
+#include "matlib/Matlib.h"
+#include "TransmitterFilter.h"
+
+
+/* Implementation *************************************************************/
+/******************************************************************************\
+* FIR filter                                                                   *
+\******************************************************************************/
+void CTxFir::Init(const double* pdTaps, const int iNewNumTaps, const CTxReal rGain,
+				  const int iNewNumPhases, const int iNewNumChan, const int iMaxBlock)
+{
+	iNumPhases = iNewNumPhases;
+	iNumChan = iNewNumChan;
+
+	/* Each phase gets every "iNumPhases"-th tap, the last phase is padded
+	   with zeros */
+	iNumTaps = (iNewNumTaps + iNumPhases - 1) / iNumPhases;
+	iHistLen = iNumTaps - 1;
+
+	vecrTaps.Init(iNumPhases * iNumTaps, (CTxReal) 0.0);
+	for (int p = 0; p < iNumPhases; p++)
+	{
+		for (int j = 0; j < iNumTaps; j++)
+		{
+			const int iTap = j * iNumPhases + p;
+			if (iTap < iNewNumTaps)
+				vecrTaps[p * iNumTaps + iNumTaps - 1 - j] = (CTxReal) (pdTaps[iTap] * rGain);
+		}
+	}
+
+	vecrBufI.Init(iHistLen + iMaxBlock, (CTxReal) 0.0);
+	vecrBufQ.Init((iNumChan == 2) ? iHistLen + iMaxBlock : 0, (CTxReal) 0.0);
+}
+
+void CTxFir::Shift(const int iLenIn)
+{
+	/* The last input samples are the state for the next block */
+	memmove(&vecrBufI[0], &vecrBufI[iLenIn], iHistLen * sizeof(CTxReal));
+
+	if (iNumChan == 2)
+		memmove(&vecrBufQ[0], &vecrBufQ[iLenIn], iHistLen * sizeof(CTxReal));
+}
+
+void CTxFir::Filter(CTxReal* prOutI, CTxReal* prOutQ, const int iLenIn)
+{
+	FilterDec(prOutI, prOutQ, iLenIn, 1);
+}
+
+void CTxFir::FilterDec(CTxReal* prOutI, CTxReal* prOutQ, const int iLenIn, const int iFact)
+{
+	const CTxReal* prTaps = &vecrTaps[0];
+	const CTxReal* prBufI = &vecrBufI[0];
+	const int iLenOut = iLenIn / iFact;
+
+	if (iNumChan == 2)
+	{
+		const CTxReal* prBufQ = &vecrBufQ[0];
+
+		for (int m = 0; m < iLenOut; m++)
+		{
+			const CTxReal* prXI = prBufI + m * iFact;
+			const CTxReal* prXQ = prBufQ + m * iFact;
+			CTxReal rSumI = (CTxReal) 0.0;
+			CTxReal rSumQ = (CTxReal) 0.0;
+
+			for (int j = 0; j < iNumTaps; j++)
+			{
+				rSumI += prTaps[j] * prXI[j];
+				rSumQ += prTaps[j] * prXQ[j];
+			}
+
+			prOutI[m] = rSumI;
+			prOutQ[m] = rSumQ;
+		}
+	}
+	else
+	{
+		for (int m = 0; m < iLenOut; m++)
+		{
+			const CTxReal* prX = prBufI + m * iFact;
+			CTxReal rSum = (CTxReal) 0.0;
+
+			for (int j = 0; j < iNumTaps; j++)
+				rSum += prTaps[j] * prX[j];
+
+			prOutI[m] = rSum;
+		}
+	}
+
+	Shift(iLenIn);
+}
+
+void CTxFir::FilterInterp(CTxReal* prOut, const int iLenIn)
+{
+	/* Output sample "i * iNumPhases + p" of the zero-stuffed input only sees
+	   the taps of phase "p" */
+	const CTxReal* prBuf = &vecrBufI[0];
+
+	for (int i = 0; i < iLenIn; i++)
+	{
+		const CTxReal* prX = prBuf + i;
+
+		for (int p = 0; p < iNumPhases; p++)
+		{
+			const CTxReal* prTaps = &vecrTaps[p * iNumTaps];
+			CTxReal rSum = (CTxReal) 0.0;
+
+			for (int j = 0; j < iNumTaps; j++)
+				rSum += prTaps[j] * prX[j];
+
+			prOut[i * iNumPhases + p] = rSum;
+		}
+	}
+
+	Shift(iLenIn);
+}
+
+
+/******************************************************************************\
+* Clipper                                                                      *
+\******************************************************************************/
+void CTxClipper::Init(const int iMaxBlock)
+{
+	veciI.Init(TXSHAPER_PEAK_HIST + iMaxBlock, 0);
+	veciQ.Init(TXSHAPER_PEAK_HIST + iMaxBlock, 0);
+	veciAmp.Init(TXSHAPER_PEAK_HIST + iMaxBlock, 0);
+}
+
+void CTxClipper::Process(CTxReal* prI, CTxReal* prQ, const int iLen, const int iThreshold)
+{
+	int i;
+	int* piI = &veciI[TXSHAPER_PEAK_HIST];
+	int* piQ = &veciQ[TXSHAPER_PEAK_HIST];
+	int* piAmp = &veciAmp[TXSHAPER_PEAK_HIST];
+
+	/* Amplitudes of the integer levels. No dependency between the samples,
+	   this loop is vectorised */
+	if (iThreshold > 0)
+	{
+		for (i = 0; i < iLen; i++)
+		{
+			piI[i] = (int) prI[i];
+			piQ[i] = (int) prQ[i];
+
+			const CTxReal rAmp = sqrt((CTxReal) piI[i] * piI[i] + (CTxReal) piQ[i] * piQ[i]);
+			piAmp[i] = (int) max(rAmp, (CTxReal) iThreshold);
+		}
+	}
+	else
+	{
+		/* Overshoot compensation: the part above the output level counts
+		   twice */
+		for (i = 0; i < iLen; i++)
+		{
+			piI[i] = (int) prI[i];
+			piQ[i] = (int) prQ[i];
+
+			const CTxReal rAmp = sqrt((CTxReal) piI[i] * piI[i] + (CTxReal) piQ[i] * piQ[i]);
+			piAmp[i] = (int) (max(rAmp - TXSHAPER_OUT_LEVEL, (CTxReal) 0.0) * 2 + TXSHAPER_OUT_LEVEL);
+		}
+	}
+
+	/* Peak stretcher and gain, the signal is delayed by two samples */
+	for (i = 0; i < iLen; i++)
+	{
+		const int iPeak = max(max(max(piAmp[i], piAmp[i - 1]), max(piAmp[i - 2], piAmp[i - 3])),
+			piAmp[i - 4]);
+		const float fGain = (float) TXSHAPER_OUT_LEVEL / iPeak;
+
+		prI[i] = (CTxReal) ((float) piI[i - 2] * fGain);
+		prQ[i] = (CTxReal) ((float) piQ[i - 2] * fGain);
+	}
+
+	/* History for the next block */
+	for (i = 0; i < TXSHAPER_PEAK_HIST; i++)
+	{
+		veciI[i] = piI[iLen - TXSHAPER_PEAK_HIST + i];
+		veciQ[i] = piQ[iLen - TXSHAPER_PEAK_HIST + i];
+		veciAmp[i] = piAmp[iLen - TXSHAPER_PEAK_HIST + i];
+	}
+}
+
+
+/******************************************************************************\
+* Shaping chain                                                                *
+\******************************************************************************/
+void CTransmitShaper::Init(const int iNewBlockSize, const _COMPLEX cMixStep)
+{
+	iBlockSize = iNewBlockSize;
+	const int iDecSize = iBlockSize / TXSHAPER_DEC_FACT;
+
+	/* 48 kHz decimation, filters at 12 kHz, interpolation filters (gain 2
+	   for the zero-stuffing) */
+	FirDec.Init(filter_taps1, FILTER_TAP_NUM1, (CTxReal) 1.0, 1, 2, iBlockSize);
+	FirPre.Init(filter_taps3, FILTER_TAP_NUM3, (CTxReal) 1.0, 1, 2, iDecSize);
+	FirPost.Init(filter_taps3, FILTER_TAP_NUM3, (CTxReal) 1.0, 1, 2, iDecSize);
+	FirComp.Init(filter_taps4, FILTER_TAP_NUM4, (CTxReal) 1.0, 1, 2, iDecSize);
+	FirInt24.Init(filter_taps5, FILTER_TAP_NUM5, (CTxReal) 2.0, 2, 1, iDecSize);
+	FirInt48.Init(filter_taps6, FILTER_TAP_NUM6, (CTxReal) 2.0, 2, 1, 2 * iDecSize);
+
+	Clipper.Init(iDecSize);
+	ClipperComp.Init(iDecSize);
+
+	cStep = cMixStep;
+	cRotate = (_REAL) 1.0;
+
+	vecrDecI.Init(iDecSize, (CTxReal) 0.0);
+	vecrDecQ.Init(iDecSize, (CTxReal) 0.0);
+	vecrMixI.Init(iDecSize);
+	vecrMixQ.Init(iDecSize);
+	vecrOut.Init(iBlockSize);
+
+#if TXSHAPER_TIMING
+	CPUTime = std::chrono::steady_clock::duration::zero();
+	iNumSamples = 0;
+#endif
+}
+
+void CTransmitShaper::Decimate(CVectorEx<_COMPLEX>& vecIn, const _REAL rScale)
+{
+	CTxReal* prI = FirDec.GetInputI();
+	CTxReal* prQ = FirDec.GetInputQ();
+
+	for (int i = 0; i < iBlockSize; i++)
+	{
+		prI[i] = (CTxReal) (vecIn[i].real() * rScale);
+		prQ[i] = (CTxReal) (vecIn[i].imag() * rScale);
+	}
+
+	FirDec.FilterDec(&vecrDecI[0], &vecrDecQ[0], iBlockSize, TXSHAPER_DEC_FACT);
+}
+
+void CTransmitShaper::Process(const int iClipLevel)
+{
+	int i;
+	const int iDecSize = iBlockSize / TXSHAPER_DEC_FACT;
+
+#if TXSHAPER_TIMING
+	const std::chrono::steady_clock::time_point Start = std::chrono::steady_clock::now();
+#endif
+
+	/* The 12 kHz block is kept, it is used again if there is no new input */
+	memcpy(FirPre.GetInputI(), &vecrDecI[0], iDecSize * sizeof(CTxReal));
+	memcpy(FirPre.GetInputQ(), &vecrDecQ[0], iDecSize * sizeof(CTxReal));
+
+	/* Each stage writes directly to the input of the next one */
+	CTxReal* prI = FirPost.GetInputI();
+	CTxReal* prQ = FirPost.GetInputQ();
+
+	/* OFDM sidelobe filter, PAPR clipper */
+	FirPre.Filter(prI, prQ, iDecSize);
+	if (iClipLevel > 0)
+		Clipper.Process(prI, prQ, iDecSize, iClipLevel);
+
+	/* Post clipper filter, overshoot clipper */
+	prI = FirComp.GetInputI();
+	prQ = FirComp.GetInputQ();
+
+	FirPost.Filter(prI, prQ, iDecSize);
+	if (iClipLevel > 0)
+		ClipperComp.Process(prI, prQ, iDecSize, 0);
+
+	/* Overshoot compensation filter */
+	FirComp.Filter(&vecrMixI[0], &vecrMixQ[0], iDecSize);
+
+	/* Move the 0 Hz signal to the audio frequency, only the real part is
+	   used */
+	CTxReal* prReal = FirInt24.GetInputI();
+	for (i = 0; i < iDecSize; i++)
+	{
+		const float fCarI = (float) cRotate.real();
+		const float fCarQ = (float) cRotate.imag();
+		const int iI = (int) vecrMixI[i];
+		const int iQ = (int) vecrMixQ[i];
+
+		prReal[i] = (CTxReal) ((iI * fCarQ) - (iQ * fCarI));
+
+		/* Rotate phase, keep the amplitude at one */
+		cRotate *= cStep;
+		cRotate *= (_REAL) 1.0 / Max((_REAL) 0.5, sqrt(SqMag(cRotate)));
+	}
+
+	/* 12 -> 24 -> 48 kHz */
+	FirInt24.FilterInterp(FirInt48.GetInputI(), iDecSize);
+	FirInt48.FilterInterp(&vecrOut[0], 2 * iDecSize);
+
+#if TXSHAPER_TIMING
+	CPUTime += std::chrono::steady_clock::now() - Start;
+	iNumSamples += iBlockSize;
+
+	if (iNumSamples >= TXSHAPER_TIMING_SEC * SOUNDCRD_SAMPLE_RATE)
+	{
+		FILE* pFiLog = fopen("txshaper.txt", "a+t");
+		if (pFiLog != NULL)
+		{
+			const _REAL rMs = (_REAL) std::chrono::duration_cast<std::chrono::microseconds>(CPUTime).count() / 1000;
+			fprintf(pFiLog, "%s: %.3f ms CPU per second of output\n",
+				TXSHAPER_FLOAT ? "float" : "double", rMs * SOUNDCRD_SAMPLE_RATE / iNumSamples);
+			fclose(pFiLog);
+		}
+
+		CPUTime = std::chrono::steady_clock::duration::zero();
+		iNumSamples = 0;
+	}
+#endif
+}
@@ -0,0 +1,179 @@
+/******************************************************************************\
+ * Copyright (c) 2024
+ *
+ * Author(s):
+ *	EasyDRF developers
+ *
+ * Description:
+ *	See TransmitShaper.cpp
+ *
+ ******************************************************************************
+ *
+ * This program is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation; either version 2 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ *
+\******************************************************************************/
+
+#if !defined(TRANSMITSHAPER_H__3B0UBVE98732KJVEW363TXSHAPER__INCLUDED_)
+#define TRANSMITSHAPER_H__3B0UBVE98732KJVEW363TXSHAPER__INCLUDED_
+
+#include <chrono>
+#include "GlobalDefinitions.h"
+#include "Vector.h"
+
+
+/* Definitions ****************************************************************/
+/* Precision of the shaping chain. Double keeps the on-air samples as they
+   were; float (TRUE) differs by up to a few 16 bit LSB after the clippers
+   and did not run faster on x86, so it is only an option */
+#define TXSHAPER_FLOAT				FALSE
+
+#if TXSHAPER_FLOAT
+typedef float						CTxReal;
+#else
+typedef _REAL						CTxReal;
+#endif
+
+/* The chain works at a quarter of the sound card rate */
+#define TXSHAPER_DEC_FACT			4
+
+/* Clip levels (0 dBFS = 32767). The PAPR clipper threshold is set per call,
+   the output and overshoot clipper limit at -3 dBFS */
+#define TXSHAPER_OUT_LEVEL			23166
+
+/* Length of the peak stretcher of the clippers (current and 4 old samples) */
+#define TXSHAPER_PEAK_HIST			4
+
+/* Set to TRUE to log the CPU time per second of output to "txshaper.txt",
+   one line per TXSHAPER_TIMING_SEC seconds of output */
+#define TXSHAPER_TIMING				FALSE
+#define TXSHAPER_TIMING_SEC			10
+
+
+/* Classes ********************************************************************/
+/* FIR filter on a block of samples, for one or two (I and Q) channels. The
+   input is written behind the state of the last block, so that the filter
+   reads contiguous memory with reversed coefficients. Nothing is allocated
+   after "Init()" */
+class CTxFir
+{
+public:
+	CTxFir() : iNumTaps(0), iNumPhases(1), iNumChan(1) {}
+	virtual ~CTxFir() {}
+
+	/* "iNewNumPhases" > 1: polyphase interpolation of a zero-stuffed input */
+	void		Init(const double* pdTaps, const int iNewNumTaps, const CTxReal rGain,
+					 const int iNewNumPhases, const int iNewNumChan, const int iMaxBlock);
+
+	CTxReal*	GetInputI() {return &vecrBufI[iHistLen];}
+	CTxReal*	GetInputQ() {return &vecrBufQ[iHistLen];}
+
+	/* All functions read "iLenIn" samples which were written to the input
+	   and keep the state for the next block */
+	void		Filter(CTxReal* prOutI, CTxReal* prOutQ, const int iLenIn);
+	void		FilterDec(CTxReal* prOutI, CTxReal* prOutQ, const int iLenIn, const int iFact);
+	void		FilterInterp(CTxReal* prOut, const int iLenIn);
+
+protected:
+	void		Shift(const int iLenIn);
+
+	CVector<CTxReal>	vecrTaps; /* reversed, phase after phase */
+	CVector<CTxReal>	vecrBufI;
+	CVector<CTxReal>	vecrBufQ;
+	int					iNumTaps; /* per phase */
+	int					iNumPhases;
+	int					iNumChan;
+	int					iHistLen;
+};
+
+/* Hilbert clipper with peak stretcher. The signal is delayed by two samples,
+   so that the gain is already lowered when a peak arrives */
+class CTxClipper
+{
+public:
+	CTxClipper() {}
+	virtual ~CTxClipper() {}
+
+	void		Init(const int iMaxBlock);
+
+	/* "iThreshold" > 0: the gain is computed from the amplitude, at least
+	   the threshold. "iThreshold" == 0: overshoot compensation, amplitudes
+	   above the output level are doubled before the gain is computed */
+	void		Process(CTxReal* prI, CTxReal* prQ, const int iLen, const int iThreshold);
+
+protected:
+	/* The first entries hold the end of the last block */
+	CVector<int>		veciI;
+	CVector<int>		veciQ;
+	CVector<int>		veciAmp;
+};
+
+/* Transmit shaping at 12 kHz: decimation of the OFDM signal, PAPR clipping
+   with filters, mixing to the audio frequency and polyphase interpolation
+   back to 48 kHz */
+class CTransmitShaper
+{
+public:
+	CTransmitShaper() : iBlockSize(0) {}
+	virtual ~CTransmitShaper() {}
+
+	/* "iNewBlockSize" is the number of 48 kHz samples per call, "cMixStep"
+	   the phase step of the mixer at 12 kHz */
+	void		Init(const int iNewBlockSize, const _COMPLEX cMixStep);
+
+	/* 48 kHz complex input */
+	void		Decimate(CVectorEx<_COMPLEX>& vecIn, const _REAL rScale);
+
+	/* Direct 12 kHz input (waterfall text), instead of "Decimate()". If
+	   neither is called, the last block is used again */
+	void		SetSample(const int iIdx, const CTxReal rI, const CTxReal rQ)
+					{vecrDecI[iIdx] = rI; vecrDecQ[iIdx] = rQ;}
+
+	/* "iClipLevel" 0 disables the clippers */
+	void		Process(const int iClipLevel);
+
+	/* Real 48 kHz output, "iNewBlockSize" samples */
+	const CTxReal*	GetOutput() {return &vecrOut[0];}
+
+protected:
+	int					iBlockSize;
+
+	CTxFir				FirDec;
+	CTxFir				FirPre;
+	CTxFir				FirPost;
+	CTxFir				FirComp;
+	CTxFir				FirInt24;
+	CTxFir				FirInt48;
+
+	CTxClipper			Clipper;
+	CTxClipper			ClipperComp;
+
+	/* Oscillator of the mixer */
+	_COMPLEX			cRotate;
+	_COMPLEX			cStep;
+
+	CVector<CTxReal>	vecrDecI;
+	CVector<CTxReal>	vecrDecQ;
+	CVector<CTxReal>	vecrMixI;
+	CVector<CTxReal>	vecrMixQ;
+	CVector<CTxReal>	vecrOut;
+
+#if TXSHAPER_TIMING
+	std::chrono::steady_clock::duration	CPUTime;
+	int					iNumSamples;
+#endif
+};
+
+
+#endif // !defined(TRANSMITSHAPER_H__3B0UBVE98732KJVEW363TXSHAPER__INCLUDED_)
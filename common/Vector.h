@@ -31,6 +31,7 @@
 
 #include "GlobalDefinitions.h"
 #include <vector>
+#include <utility>
 
 
 /******************************************************************************\
@@ -52,6 +53,13 @@ public:
 		vector<TData>(static_cast<const vector<TData>&>(vecI)), 
 		iVectorSize(vecI.Size()), pData(begin()), iBitArrayCounter(0) {}
 
+	/* Move constructor: takes over the memory of the other vector, which is
+	   left empty. Also used by vector<> when a vector of vectors grows */
+	CVector(CVector<TData>&& vecI) noexcept :
+		vector<TData>(std::move(static_cast<vector<TData>&>(vecI))),
+		iVectorSize(vecI.iVectorSize), pData(begin()), iBitArrayCounter(0)
+		{vecI.iVectorSize = 0; vecI.pData = vecI.begin();}
+
 	void Init(const int iNewSize);
 
 	/* Use this init to give all elements a defined value */
@@ -85,18 +93,11 @@ public:
 #endif
 		return pData[iPos];}
 
+	/* The base class takes the size of the other vector, so the copy does
+	   the same */
 	CVector<TData>&	operator=(const CVector<TData>& vecI) {
-#ifdef _DEBUG_
-		/* Vectors which shall be copied MUST have same size! (If this is 
-		   satisfied, the parameter "iVectorSize" must not be adjusted as
-		   a side effect) */
-		if (vecI.Size() != iVectorSize)
-		{
-			DebugError("Vector operator=() different size", "Vector size",
-				iVectorSize, "New parameter", vecI.Size());
-		}
-#endif
 		vector<TData>::operator=(vecI);
+		iVectorSize = vecI.iVectorSize;
 
 		/* Reset my data pointer in case, the operator=() of the base class
 		   did change the actual memory */
@@ -105,6 +106,20 @@ public:
 		return *this;
 	}
 
+	/* Like the copy, the move takes the size of the other vector, which is
+	   left empty */
+	CVector<TData>&	operator=(CVector<TData>&& vecI) noexcept {
+		vector<TData>::operator=(std::move(static_cast<vector<TData>&>(vecI)));
+		iVectorSize = vecI.iVectorSize;
+		pData = begin();
+		iBitArrayCounter = 0;
+
+		vecI.iVectorSize = 0;
+		vecI.pData = vecI.begin();
+
+		return *this;
+	}
+
 
 	/* Bit operation functions */
 	void		Enqueue(_UINT32BIT iInformation, const int iNumOfBits);
@@ -267,7 +282,8 @@ class CExtendedVecData
 {
 public:
 	/* Symbol ID of the current block. This number only identyfies the
-	   position in a frame, NOT in a super-frame */
+	   position in a frame, NOT in a super-frame (in the transmitter, after
+	   the OFDM cell mapping, it is the position in the super-frame) */
 	int iSymbolID;
 
 	/* This flag indicates that the symbol ID has changed */
@@ -0,0 +1,303 @@
+/******************************************************************************\
+ * Copyright (c) 2024
+ *
+ * Author(s):
+ *	EasyDRF developers
+ *
+ * Description:
+ *	Wideband receiver: decodes several HamDRM signals in one passband
+ *
+ *	The receiver chain locks onto one 2.5 kHz signal. On a busy frequency
+ *	several stations transmit at different audio offsets, so the input is
+ *	split into one stream per signal (see Channelizer.cpp) and each stream
+ *	is decoded by its own receiver instance
+ *
+ ******************************************************************************
+ *
+ * This program is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation; either version 2 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ *
+\******************************************************************************/
+
+#include "WidebandReceiver.h"
+
+
+/* Implementation *************************************************************/
+CWidebandReceiver::CWidebandReceiver() : pSource(NULL),
+	rLowFreq(WB_DEF_LOW_FREQ), rHighFreq(WB_DEF_HIGH_FREQ), bRunning(FALSE)
+{
+	bRun = FALSE;
+}
+
+CWidebandReceiver::~CWidebandReceiver()
+{
+	Stop();
+
+	for (int i = 0; i < WB_MAX_SIGNALS; i++)
+	{
+		if (Instance[i].pReceiver != NULL)
+			delete Instance[i].pReceiver;
+	}
+}
+
+void CWidebandReceiver::SetSearchRange(const _REAL rNewLowFreq, const _REAL rNewHighFreq)
+{
+	rLowFreq = rNewLowFreq;
+	rHighFreq = rNewHighFreq;
+}
+
+_REAL CWidebandReceiver::GetSignalFreq(const int iSlot)
+{
+	if (Instance[iSlot].bActive == FALSE)
+		return (_REAL) 0.0;
+
+	return Instance[iSlot].rDCFreq;
+}
+
+void CWidebandReceiver::Start(CSoundInterface* pNewSource)
+{
+	if (bRunning == TRUE)
+		return;
+
+	pSource = pNewSource;
+
+	vecrInput.Init(WB_BLOCK_SIZE);
+	vecsChannel.Init(WB_BLOCK_SIZE);
+	Candidates.clear();
+
+	bRun = TRUE;
+	WorkThread = std::thread(&CWidebandReceiver::Run, this);
+	bRunning = TRUE;
+}
+
+void CWidebandReceiver::Stop()
+{
+	if (bRunning == FALSE)
+		return;
+
+	bRun = FALSE;
+
+	/* Make sure the channeliser leaves a blocking read */
+	pSource->Close();
+
+	if (WorkThread.joinable())
+		WorkThread.join();
+
+	bRunning = FALSE;
+}
+
+void CWidebandReceiver::Run()
+{
+	int i;
+
+	/* The instances depend on this thread, it must not be starved by them */
+	SetThreadPriority(GetCurrentThread(), THREAD_PRIORITY_ABOVE_NORMAL);
+
+	const int iNumChan = pSource->GetNumChannels();
+	const int iChanOffset = (iNumChan == 1) ? 0 : RECORDING_CHANNEL;
+
+	try
+	{
+		pSource->InitRecording(WB_BLOCK_SIZE * iNumChan);
+		Detector.Init(rLowFreq, rHighFreq, WB_BLOCK_SIZE);
+
+		while (bRun == TRUE)
+		{
+			const _SAMPLE* psData;
+			pSource->ReadBlock(psData);
+
+			for (i = 0; i < WB_BLOCK_SIZE; i++)
+				vecrInput[i] = (_REAL) psData[iNumChan * i + iChanOffset];
+
+			pSource->ReleaseBlock();
+
+			if (bRun == FALSE)
+				break;
+
+			/* Look for signals and start or stop instances */
+			Detector.AddBlock(vecrInput, WB_BLOCK_SIZE);
+			Track(Detector.Detect(vecrDCFreq));
+
+			/* Feed the instances */
+			for (i = 0; i < WB_MAX_SIGNALS; i++)
+			{
+				if (Instance[i].bActive == TRUE)
+				{
+					Instance[i].Channelizer.Process(vecrInput, WB_BLOCK_SIZE, &vecsChannel[0]);
+					Instance[i].Stream.Put(&vecsChannel[0], WB_BLOCK_SIZE);
+				}
+			}
+		}
+	}
+	catch (CGenErr)
+	{
+		/* Sound card could not be opened, nothing to decode */
+	}
+
+	for (i = 0; i < WB_MAX_SIGNALS; i++)
+		StopInstance(i);
+}
+
+void CWidebandReceiver::Track(const int iNumSignals)
+{
+	int i, j;
+
+	for (i = 0; i < WB_MAX_SIGNALS; i++)
+		Instance[i].iMissCnt++;
+
+	for (std::list<CCandidate>::iterator it = Candidates.begin(); it != Candidates.end(); it++)
+		it->iMissCnt++;
+
+	for (j = 0; j < iNumSignals; j++)
+	{
+		const _REAL rFreq = vecrDCFreq[j];
+		_BOOLEAN bKnown = FALSE;
+
+		/* Signal of a running instance? */
+		for (i = 0; i < WB_MAX_SIGNALS; i++)
+		{
+			if ((Instance[i].bActive == TRUE) &&
+				(fabs(Instance[i].rDCFreq - rFreq) < WB_FREQ_TOLERANCE))
+			{
+				Instance[i].iMissCnt = 0;
+				bKnown = TRUE;
+				break;
+			}
+		}
+
+		if (bKnown == TRUE)
+			continue;
+
+		/* A new signal must be seen for some time, so that a short peak in the
+		   PSD does not start an instance */
+		for (std::list<CCandidate>::iterator it = Candidates.begin(); it != Candidates.end(); it++)
+		{
+			if (fabs(it->rDCFreq - rFreq) < WB_FREQ_TOLERANCE)
+			{
+				it->rDCFreq = rFreq;
+				it->iCount++;
+				it->iMissCnt = 0;
+				bKnown = TRUE;
+				break;
+			}
+		}
+
+		if (bKnown == FALSE)
+			Candidates.push_back(CCandidate(rFreq));
+	}
+
+	/* Stop instances whose signal is gone */
+	for (i = 0; i < WB_MAX_SIGNALS; i++)
+	{
+		if ((Instance[i].bActive == TRUE) &&
+			(Instance[i].iMissCnt > WB_SIGNAL_TIMEOUT_BLOCKS))
+		{
+			StopInstance(i);
+		}
+	}
+
+	/* Start instances for confirmed signals, forget candidates which did not
+	   show up again */
+	std::list<CCandidate>::iterator it = Candidates.begin();
+	while (it != Candidates.end())
+	{
+		if (it->iCount >= WB_CONFIRM_BLOCKS)
+		{
+			for (i = 0; i < WB_MAX_SIGNALS; i++)
+			{
+				if (Instance[i].bActive == FALSE)
+				{
+					StartInstance(i, it->rDCFreq);
+					break;
+				}
+			}
+
+			/* If all slots are used, the signal is tried again later */
+			it = Candidates.erase(it);
+		}
+		else if (it->iMissCnt > WB_CONFIRM_BLOCKS)
+			it = Candidates.erase(it);
+		else
+			it++;
+	}
+}
+
+void CWidebandReceiver::StartInstance(const int iSlot, const _REAL rDCFreq)
+{
+	CInstance& Inst = Instance[iSlot];
+
+	if (Inst.pReceiver == NULL)
+	{
+		Inst.pReceiver = new CDRMReceiver;
+		Inst.Stream.Setup(NULL);
+		Inst.pReceiver->SetSoundBackend(&Inst.Stream);
+
+		/* The decoded audio of several instances can not go to one sound
+		   card */
+		Inst.pReceiver->GetParameters()->bOnlyPicture = TRUE;
+	}
+
+	/* Move the signal to the default search window of the receiver */
+	Inst.Channelizer.Init(rDCFreq + CHAN_DC_TO_CENTRE,
+		WB_NOMINAL_DC_FREQ + CHAN_DC_TO_CENTRE, WB_BLOCK_SIZE);
+
+	Inst.rDCFreq = rDCFreq;
+	Inst.iMissCnt = 0;
+	Inst.bDone = FALSE;
+	Inst.bActive = TRUE;
+
+	Inst.Thread = std::thread(&CWidebandReceiver::RunInstance, this, iSlot);
+}
+
+void CWidebandReceiver::StopInstance(const int iSlot)
+{
+	CInstance& Inst = Instance[iSlot];
+
+	if (Inst.Thread.joinable() == FALSE)
+		return;
+
+	Inst.bActive = FALSE;
+
+	/* "Init()" of the receiver sets the run flag again, so stop until the
+	   thread has really left */
+	while (Inst.bDone == FALSE)
+	{
+		Inst.pReceiver->Stop();
+		Sleep(10);
+	}
+
+	Inst.Thread.join();
+}
+
+void CWidebandReceiver::RunInstance(const int iSlot)
+{
+	CInstance& Inst = Instance[iSlot];
+
+	/* Messages of this thread belong to this instance */
+	iRxChannel = RX_CHANNEL_WIDEBAND + iSlot;
+
+	try
+	{
+		Inst.pReceiver->Init();
+
+		if (Inst.bActive == TRUE)
+			Inst.pReceiver->Start();
+	}
+	catch (CGenErr)
+	{
+		/* The slot is freed when the signal is gone */
+	}
+
+	Inst.bDone = TRUE;
+}
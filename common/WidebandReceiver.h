@@ -0,0 +1,144 @@
+/******************************************************************************\
+ * Copyright (c) 2024
+ *
+ * Author(s):
+ *	EasyDRF developers
+ *
+ * Description:
+ *	See WidebandReceiver.cpp
+ *
+ ******************************************************************************
+ *
+ * This program is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation; either version 2 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ *
+\******************************************************************************/
+
+#if !defined(WIDEBANDRECEIVER_H__3B0UBVE98732KJVEW363W1DEBAND__INCLUDED_)
+#define WIDEBANDRECEIVER_H__3B0UBVE98732KJVEW363W1DEBAND__INCLUDED_
+
+#include <list>
+#include <thread>
+#include <atomic>
+#include "GlobalDefinitions.h"
+#include "Vector.h"
+#include "Channelizer.h"
+#include "DrmReceiver.h"
+#include "../sound/Sound.h"
+
+
+/* Definitions ****************************************************************/
+/* Maximum number of receiver instances (signals decoded at the same time) */
+#define WB_MAX_SIGNALS				6
+
+/* Input block of the channeliser, 64 ms */
+#define WB_BLOCK_SIZE				(CHAN_DEC_FACT * 256)
+
+/* Each signal is moved to the default search window of the receiver */
+#define WB_NOMINAL_DC_FREQ			((_REAL) 350.0)
+
+/* Default search range of the DC carrier in Hz */
+#define WB_DEF_LOW_FREQ				((_REAL) 200.0)
+#define WB_DEF_HIGH_FREQ			((_REAL) 21000.0)
+
+/* A detection within this distance belongs to a known signal */
+#define WB_FREQ_TOLERANCE			((_REAL) 50.0)
+
+/* Number of blocks a new signal must be detected before an instance is
+   started (0.5 s) and a known signal must be missing before its instance is
+   stopped (10 s) */
+#define WB_CONFIRM_BLOCKS			8
+#define WB_SIGNAL_TIMEOUT_BLOCKS	160
+
+/* "iRxChannel" of the first instance, 0 and 1 are the normal receivers */
+#define RX_CHANNEL_WIDEBAND			2
+
+
+/* Classes ********************************************************************/
+/* Wideband receiver. A channeliser thread reads the sound card, finds the
+   HamDRM signals in the input and feeds each of them through its own channel
+   filter into the input ring of a receiver instance. Instances are started
+   when a signal appears and stopped when it is gone. Each instance runs in
+   its own thread and decodes pictures only (no audio output) */
+class CWidebandReceiver
+{
+public:
+	CWidebandReceiver();
+	virtual ~CWidebandReceiver();
+
+	/* Search range of the DC carriers, takes effect with the next "Start()" */
+	void			SetSearchRange(const _REAL rNewLowFreq, const _REAL rNewHighFreq);
+
+	void			Start(CSoundInterface* pNewSource);
+	void			Stop();
+	_BOOLEAN		IsRunning() {return bRunning;}
+
+	/* The receiver of a slot is kept when its signal disappears and reused
+	   for the next one, pointers stay valid until this object is destroyed */
+	_BOOLEAN		IsActive(const int iSlot) {return Instance[iSlot].bActive;}
+	_REAL			GetSignalFreq(const int iSlot);
+	CDRMReceiver*	GetReceiver(const int iSlot) {return Instance[iSlot].pReceiver;}
+
+protected:
+	class CInstance
+	{
+	public:
+		CInstance() : pReceiver(NULL), rDCFreq((_REAL) 0.0), iMissCnt(0)
+			{bActive = FALSE; bDone = TRUE;}
+
+		CDRMReceiver*			pReceiver;
+		CSoundChannel			Stream;
+		CChannelizer			Channelizer;
+		std::thread				Thread;
+		std::atomic<_BOOLEAN>	bActive;
+		std::atomic<_BOOLEAN>	bDone;
+		std::atomic<_REAL>		rDCFreq;
+		int						iMissCnt;
+	};
+
+	class CCandidate
+	{
+	public:
+		CCandidate(const _REAL rNewDCFreq) : rDCFreq(rNewDCFreq), iCount(1), iMissCnt(0) {}
+
+		_REAL	rDCFreq;
+		int		iCount;
+		int		iMissCnt;
+	};
+
+	void					Run();
+	void					Track(const int iNumSignals);
+	void					StartInstance(const int iSlot, const _REAL rDCFreq);
+	void					StopInstance(const int iSlot);
+	void					RunInstance(const int iSlot);
+
+	CSoundInterface*		pSource;
+	CSignalDetector			Detector;
+	_REAL					rLowFreq;
+	_REAL					rHighFreq;
+
+	CInstance				Instance[WB_MAX_SIGNALS];
+	std::list<CCandidate>	Candidates;
+
+	CVector<_REAL>			vecrInput;
+	CVector<_REAL>			vecrDCFreq;
+	CVector<_SAMPLE>		vecsChannel;
+
+	std::thread				WorkThread;
+	std::atomic<_BOOLEAN>	bRun;
+	_BOOLEAN				bRunning;
+};
+
+
+#endif // !defined(WIDEBANDRECEIVER_H__3B0UBVE98732KJVEW363W1DEBAND__INCLUDED_)
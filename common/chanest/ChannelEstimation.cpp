@@ -199,6 +199,13 @@ void CChannelEstimation::ProcessDataInternal(CParameter& ReceiverParam)
 		/* FIR filter of the pilots with filter taps. We need to filter the
 		   pilot positions as well to improve the SNR estimation (which 
 		   follows this procedure) */
+#if USE_FIXED_POINT
+		if (bFixedPoint == TRUE)
+		{
+			FreqFilterFixed();
+			break;
+		}
+#endif
 		for (j = 0; j < iNumCarrier; j++)
 		{
 			/* Convolution */
@@ -215,6 +222,20 @@ void CChannelEstimation::ProcessDataInternal(CParameter& ReceiverParam)
 	/* Equalize the output vector ------------------------------------------- */
 	/* Write to output vector. Take oldest symbol of history for output. Also,
 	   ship the channel state at a certain cell */
+#if USE_FIXED_POINT
+	if (bFixedPoint == TRUE)
+	{
+		/* The Wiener filter leaves its result in Q15 */
+		if (TypeIntFreq != FWIENER)
+		{
+			iChanEstExp =
+				ComplexToQ15(veccChanEst, iNumCarrier, &veccChanEstFix[0]);
+		}
+
+		EqualizeFixed();
+	}
+	else
+#endif
 	for (i = 0; i < iNumCarrier; i++)
 	{
 		(*pvecOutputData)[i].cSig = matcHistory[0][i] / veccChanEst[i];
@@ -490,6 +511,15 @@ void CChannelEstimation::InitInternal(CParameter& ReceiverParam)
 	/* Allocate memory */
 	matcFiltFreq.Init(iNumCarrier, iLengthWiener);
 
+#if USE_FIXED_POINT
+	bFixedPoint = FixedPointRx;
+	matcFiltFreqFix.Init(iNumCarrier, iLengthWiener);
+	veccPilotsFix.Init(iNumIntpFreqPil);
+	veccChanEstFix.Init(iNumCarrier);
+	veccSigFix.Init(iNumCarrier);
+	iChanEstExp = 0;
+#endif
+
 	/* Pilot offset table */
 	veciPilOffTab.Init(iNumCarrier);
 
@@ -520,9 +550,8 @@ CComplexVector CChannelEstimation::FreqOptimalFilter(int iFreqInt, int iDiff, CR
 {
 	int				i = 0;  //init DM
 	int				iCurPos = 0; //init DM
-	CComplexVector	veccReturn(iLength);
-	CComplexVector	veccRpp(iLength);
-	CComplexVector	veccRhp(iLength);
+	CComplexVector	veccRpp(iLength, VTY_TEMP);
+	CComplexVector	veccRhp(iLength, VTY_TEMP);
 
 	/* Calculation of R_hp, this is the SHIFTED correlation function */
 	for (i = 0; i < iLength; i++)
@@ -544,9 +573,7 @@ CComplexVector CChannelEstimation::FreqOptimalFilter(int iFreqInt, int iDiff, CR
 	veccRpp[0] += (CReal) 1.0 / rSNR;
 
 	/* Call levinson algorithm to solve matrix system for optimal solution */
-	veccReturn = Levinson(veccRpp, veccRhp);
-
-	return veccReturn;
+	return Levinson(veccRpp, veccRhp);
 }
 
 CComplex CChannelEstimation::FreqCorrFct(int iCurPos, CReal rRatPDSLen,
@@ -640,8 +667,88 @@ fflush(pFile);
 		/* Copy correct filter in matrix */
 		for (i = 0; i < iLengthWiener; i++)
 			matcFiltFreq[j][i] = matcWienerFilter[iDiff][i];
+
+#if USE_FIXED_POINT
+		for (i = 0; i < iLengthWiener; i++)
+		{
+			matcFiltFreqFix[j][i] =
+				ComplexToFix(matcFiltFreq[j][i], FIXP_WIENER_FRAC_BITS);
+		}
+#endif
+	}
+}
+
+#if USE_FIXED_POINT
+void CChannelEstimation::FreqFilterFixed()
+{
+	int i, j;
+
+	/* One exponent for the pilots of the symbol, the estimate gets the same */
+	iChanEstExp = ComplexToQ15(veccPilots, iNumIntpFreqPil, &veccPilotsFix[0]);
+
+	const _REAL rScale = ldexp((_REAL) 1.0, iChanEstExp - 15);
+
+	for (j = 0; j < iNumCarrier; j++)
+	{
+		const CComplexQ15* pTaps = &matcFiltFreqFix[j][0];
+		const CComplexQ15* pPil = &veccPilotsFix[veciPilOffTab[j]];
+
+		/* Q13 taps times Q15 pilots (below 0.5) */
+		int iRe = 0, iIm = 0;
+		for (i = 0; i < iLengthWiener; i++)
+		{
+			iRe += (int) pTaps[i].re * pPil[i].re - (int) pTaps[i].im * pPil[i].im;
+			iIm += (int) pTaps[i].re * pPil[i].im + (int) pTaps[i].im * pPil[i].re;
+		}
+
+		veccChanEstFix[j].re = SatQ15(RoundShift(iRe, FIXP_WIENER_FRAC_BITS));
+		veccChanEstFix[j].im = SatQ15(RoundShift(iIm, FIXP_WIENER_FRAC_BITS));
+
+		/* The SNR estimation and the displays use the estimate as well */
+		veccChanEst[j] = CComplex(veccChanEstFix[j].re * rScale,
+			veccChanEstFix[j].im * rScale);
+	}
+}
+
+void CChannelEstimation::EqualizeFixed()
+{
+	const int iSigExp =
+		ComplexToQ15(matcHistory[0], iNumCarrier, &veccSigFix[0]);
+
+	/* Quotient in Q13, then the exponents of both blocks */
+	const _REAL rSigScale =
+		ldexp((_REAL) 1.0, iSigExp - iChanEstExp - FIXP_SIG_FRAC_BITS);
+	const _REAL rChanScale = ldexp((_REAL) 1.0, 2 * iChanEstExp - 30);
+
+	for (int i = 0; i < iNumCarrier; i++)
+	{
+		const CComplexQ15 y = veccSigFix[i];
+		const CComplexQ15 h = veccChanEstFix[i];
+
+		/* y / h = y * conj(h) / |h|^2, Q30. Both are below 0.5 */
+		const int iNumRe = (int) y.re * h.re + (int) y.im * h.im;
+		const int iNumIm = (int) y.im * h.re - (int) y.re * h.im;
+		const int iDen = (int) h.re * h.re + (int) h.im * h.im;
+
+		if (iDen == 0)
+		{
+			/* No channel, the metrics of this cell get zero weight */
+			(*pvecOutputData)[i].cSig = _COMPLEX((_REAL) 0.0, (_REAL) 0.0);
+			(*pvecOutputData)[i].rChan = (_REAL) 0.0;
+			continue;
+		}
+
+		const long long llRe =
+			((long long) iNumRe << FIXP_SIG_FRAC_BITS) / iDen;
+		const long long llIm =
+			((long long) iNumIm << FIXP_SIG_FRAC_BITS) / iDen;
+
+		(*pvecOutputData)[i].cSig =
+			_COMPLEX((_REAL) llRe * rSigScale, (_REAL) llIm * rSigScale);
+		(*pvecOutputData)[i].rChan = (_REAL) iDen * rChanScale;
 	}
 }
+#endif
 
 CReal CChannelEstimation::TentativeFACDec(const CComplex cCurRec) const
 {
@@ -34,6 +34,7 @@
 #include "../ofdmcellmapping/OFDMCellMapping.h"
 #include "../tables/TableQAMMapping.h"
 #include "../matlib/Matlib.h"
+#include "../FixedPoint.h"
 #include "TimeLinear.h"
 #include "TimeWiener.h"
 
@@ -74,6 +75,10 @@
    periodicity of the angle() function */
 #define WRAP_AROUND_BOUND_GRP_DLY		((_REAL) 4.0) //was 4.0
 
+/* Fixed-point Wiener filter taps: Q13, the taps of the interpolation can be
+   larger than one */
+#define FIXP_WIENER_FRAC_BITS			13
+
 /* Classes ********************************************************************/
 class CChannelEstimation : public CReceiverModul<_COMPLEX, CEquSig>
 {
@@ -193,6 +198,19 @@ protected:
 	int					iNoWienerFilt;
 	CComplexMatrix		matcWienerFilter;
 
+#if USE_FIXED_POINT
+	/* Frequency interpolation and equalization with Q15 values */
+	void FreqFilterFixed();
+	void EqualizeFixed();
+
+	_BOOLEAN				bFixedPoint;
+	CMatrix<CComplexQ15>	matcFiltFreqFix;
+	CVector<CComplexQ15>	veccPilotsFix;
+	CVector<CComplexQ15>	veccChanEstFix;
+	int						iChanEstExp;
+	CVector<CComplexQ15>	veccSigFix;
+#endif
+
 	int					iInitCnt;
 	int					iSNREstInitCnt;
 	int					iNumCellsSNRInit;
@@ -362,9 +362,8 @@ CReal CTimeWiener::TimeOptimalFilter(CRealVector& vecrTaps, const int iTimeInt,
 	CReal		rMMSE = 0;
 	int			iCurPos = 0;
 
-	CRealVector	vecrReturn(iLength);
-	CRealVector vecrRpp(iLength);
-	CRealVector vecrRhp(iLength);
+	CRealVector vecrRpp(iLength, VTY_TEMP);
+	CRealVector vecrRhp(iLength, VTY_TEMP);
 
 	/* Factor for the argument of the exponetial function to generate the
 	   correlation function */
@@ -410,10 +409,10 @@ CReal CTimeWiener::ModLinRegr(CComplexVector& veccCorrEst)
 
 	/* Init vectors and variables */
 	CReal		rSigmaRet = 0;
-	CRealVector Tau(iVecLen);
-	CRealVector Z(iVecLen);
-	CRealVector W(iVecLen);
-	CRealVector Wmrem(iVecLen);
+	CRealVector Tau(iVecLen, VTY_TEMP);
+	CRealVector Z(iVecLen, VTY_TEMP);
+	CRealVector W(iVecLen, VTY_TEMP);
+	CRealVector Wmrem(iVecLen, VTY_TEMP);
 	CReal		Wm = 0, Zm = 0;
 	CReal		A1 = 0;
 
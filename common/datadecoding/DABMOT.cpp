@@ -36,6 +36,7 @@
 \******************************************************************************/
 #define WIN32_LEAN_AND_MEAN        
 #include <windows.h>
+#include <mutex>
 #include "DABMOT.h"
 #include "picpool.h"
 #include "../bsr.h"
@@ -49,6 +50,33 @@ string strName2 = { 0 }; //this is where the received filename is saved for the
 
 int bsr_transID = 0;
 
+/* CRC-32 (polynomial 0x04C11DB7, reflected) of the body for the
+   UniqueBodyVersion parameter. zlib is not linked anymore */
+static _UINT32BIT BodyCRC32(const _BYTE* pbyData, const int iLen)
+{
+	static _UINT32BIT	iTable[256];
+	static _BOOLEAN		bTableReady = FALSE;
+	int					i, j;
+
+	if (bTableReady == FALSE)
+	{
+		for (i = 0; i < 256; i++)
+		{
+			_UINT32BIT iReg = (_UINT32BIT) i;
+			for (j = 0; j < SIZEOF__BYTE; j++)
+				iReg = (iReg >> 1) ^ (0xEDB88320 & (0 - (iReg & 1)));
+			iTable[i] = iReg;
+		}
+		bTableReady = TRUE;
+	}
+
+	_UINT32BIT iCRC = ~_UINT32BIT(0);
+	for (i = 0; i < iLen; i++)
+		iCRC = (iCRC >> 8) ^ iTable[(iCRC ^ pbyData[i]) & 0xFF];
+
+	return ~iCRC;
+}
+
 void CMOTDABEnc::SetMOTObject(CMOTObject& NewMOTObject, CVector<short> vecsDataIn)
 {
 	int				i = 0; //inits DM
@@ -56,9 +84,8 @@ void CMOTDABEnc::SetMOTObject(CMOTObject& NewMOTObject, CVector<short> vecsDataI
 	//unsigned char flen;
 	CMOTObjectRaw	MOTObjectRaw;
 
-	/* Get some necessary parameters of object */
-	const int iPicSizeBits = NewMOTObject.vecbRawData.Size();
-	const int iPicSizeBytes = iPicSizeBits / SIZEOF__BYTE;
+	/* Get some necessary parameters of object (raw data is packed bytes) */
+	const int iPicSizeBytes = NewMOTObject.vecbRawData.Size();
 	const string strFileName = NewMOTObject.strName;
 	EncFileSize = iPicSizeBytes; //Also set it here to send in the segment header DM (try to do this through the classes for neatness TODO DM)
 
@@ -110,9 +137,9 @@ void CMOTDABEnc::SetMOTObject(CMOTObject& NewMOTObject, CVector<short> vecsDataI
 	}
 #endif
 
-	/* Copy actual raw data of object */
-	MOTObjectRaw.Body.vecbiData.Init(iPicSizeBits);
-	MOTObjectRaw.Body.vecbiData = NewMOTObject.vecbRawData;
+	/* Copy actual raw data of object, it stays packed */
+	MOTObjSegments.vecbyBody.Init(iPicSizeBytes);
+	MOTObjSegments.vecbyBody = NewMOTObject.vecbRawData;
 
 	/* Get content type and content sub type of object. We use the format string
 	   to get these informations about the object */
@@ -127,12 +154,17 @@ void CMOTDABEnc::SetMOTObject(CMOTObject& NewMOTObject, CVector<short> vecsDataI
 
 
 	/* Header --------------------------------------------------------------- */ //This is the file header that contains the filename and file size DM
-	/* Header size (including header extension) */
-	const int iHeaderSize = 7 /* Header core  */ +
+	/* Header size (including header extension). UniqueBodyVersion is only
+	   added if the header still fits one segment */
+	int iHeaderSize = 7 /* Header core  */ +
 		5 /* TriggerTime */ +
 		3 + iFileNameSize /* ContentName (header + actual name) */ +
 		2 /* VersionNumber */;
 
+	const _BOOLEAN bUniqueBodyVersion = (iHeaderSize + 5 <= MOT_HEADER_PARTI_SIZE);
+	if (bUniqueBodyVersion == TRUE)
+		iHeaderSize += 5 /* UniqueBodyVersion */;
+
 	/* Allocate memory and reset bit access */
 	MOTObjectRaw.Header.vecbiData.Init(iHeaderSize * SIZEOF__BYTE);
 	MOTObjectRaw.Header.vecbiData.ResetBitAccess();
@@ -196,6 +228,28 @@ void CMOTDABEnc::SetMOTObject(CMOTObject& NewMOTObject, CVector<short> vecsDataI
 	MOTObjectRaw.Header.vecbiData.Enqueue((uint32_t) 0, 8);
 
 
+	/* UniqueBodyVersion: 32 bits which change with the content of the body,
+	   here the CRC-32 of the body. Receivers use it (as part of the header) to
+	   tell a changed file apart which is sent again under the same name, the
+	   transport ID only depends on the name. Old receivers skip it */
+	if (bUniqueBodyVersion == TRUE)
+	{
+		_UINT32BIT iBodyCRC = 0;
+		if (iPicSizeBytes > 0)
+			iBodyCRC = BodyCRC32(&MOTObjSegments.vecbyBody[0], iPicSizeBytes);
+
+		/* PLI
+		   1 0 total parameter length = 5 bytes; length of DataField is 4 bytes */
+		MOTObjectRaw.Header.vecbiData.Enqueue((uint32_t) 2, 2);
+
+		/* ParamId (Parameter Identifier): 0 0 1 1 0 1 (dec: 13) ->
+		   UniqueBodyVersion */
+		MOTObjectRaw.Header.vecbiData.Enqueue((uint32_t) 13, 6);
+
+		MOTObjectRaw.Header.vecbiData.Enqueue(iBodyCRC, 32);
+	}
+
+
 
 	/* ContentName: The DataField of this parameter starts with a one byte
 	   field, comprising a 4-bit character set indicator (see table 3) and a
@@ -233,15 +287,21 @@ void CMOTDABEnc::SetMOTObject(CMOTObject& NewMOTObject, CVector<short> vecsDataI
 		MOTObjectRaw.Header.vecbiData.Enqueue((uint32_t) strFileName[i], 8); //This is where the filename is sent in the file header DM
 
 
+	/* Pack header */
+	MOTObjSegments.vecbyHeader.Init(iHeaderSize);
+	MOTObjectRaw.Header.vecbiData.ResetBitAccess();
+	for (i = 0; i < iHeaderSize; i++)
+		MOTObjSegments.vecbyHeader[i] = (_BYTE) MOTObjectRaw.Header.vecbiData.Separate(SIZEOF__BYTE);
+
+
 	/* Generate segments ---------------------------------------------------- */ //This is the segment header, sent with each file segment DM
 	/* Header (header should not be partitioned! TODO) */
-	const int iPartiSizeHeader = 98; /* Bytes */ // mode B, 2.3 khz packlen - 11
-
-	PartitionUnits(MOTObjectRaw.Header.vecbiData, MOTObjSegments.vvbiHeader, iPartiSizeHeader, 1);
+	MOTObjSegments.iPartiSizeHeader = MOT_HEADER_PARTI_SIZE; /* Bytes */ // mode B, 2.3 khz packlen - 11
+	MOTObjSegments.iNumSegHeader = PartitionUnits(iHeaderSize, MOTObjSegments.iPartiSizeHeader);
 
 	/* Body */
-	const int iPartiSizeBody = iSegmentSize; /* Bytes */ // TEST 116
-	const int noofseg =	(int) ceil((_REAL) MOTObjectRaw.Body.vecbiData.Size() / (SIZEOF__BYTE * iPartiSizeBody)); 
+	MOTObjSegments.iPartiSizeBody = iSegmentSize; /* Bytes */ // TEST 116
+	const int noofseg = PartitionUnits(iPicSizeBytes, MOTObjSegments.iPartiSizeBody);
 	const int iNumSegments = vecsDataIn.Size();
 
 	MOTObjSegments.vecbiToSend.Init(noofseg);
@@ -266,87 +326,19 @@ void CMOTDABEnc::SetMOTObject(CMOTObject& NewMOTObject, CVector<short> vecsDataI
 		}
 	}
 
-	PartitionUnits(MOTObjectRaw.Body.vecbiData, MOTObjSegments.vvbiBody, iPartiSizeBody, 0);
+	MOTObjSegments.iNumSegBody = noofseg;
+	iTotSegm = noofseg; // for percent display
 }
 
-void CMOTDABEnc::PartitionUnits(CVector<_BINARY>& vecbiSource,
-								CVector<CVector<_BINARY> >& vecbiDest,
-								const int iPartiSize,
-								int ishead)
+int CMOTDABEnc::PartitionUnits(const int iSourceSize, const int iPartiSize)
 {
-	int	i = 0, j = 0; //inits DM
-	int	iActSegSize = 0;
-	_BOOLEAN skipseg = FALSE;
-	_BOOLEAN lastseg = FALSE;
-
-	/* Divide the generated units in partitions */
-	const int iSourceSize = vecbiSource.Size() / SIZEOF__BYTE;
-	const int iNumSeg =	(int) ceil((_REAL) iSourceSize / iPartiSize); /* Bytes */
-	int iSizeLastSeg = iSourceSize - (int) floor((_REAL) iSourceSize / iPartiSize) * iPartiSize;
-
-	if (iSizeLastSeg == 0) iSizeLastSeg = iPartiSize;
-
-	iTotSegm = iNumSeg; // for percent display
-
-	/* Init memory for destination vector, reset bit access of source */
-	vecbiDest.Init(iNumSeg);
-	vecbiSource.ResetBitAccess();
-
-	for (i = 0; i < iNumSeg; i++)
-	{
-		/* All segments except the last one must have the size
-		   "iPartSizeHeader" */
-		if (i < iNumSeg - 1)
-			iActSegSize = iPartiSize;
-		else
-			iActSegSize = iSizeLastSeg;
-
-
-		if (ishead == 0)
-		{
-			skipseg = (MOTObjSegments.vecbiToSend[i] == 0);
-			lastseg = (i == iNumSeg - 1);
-			if (lastseg) skipseg = FALSE;
-		}
-		else skipseg = FALSE;
-
-		if (! skipseg)
-		{
-
-			/* Add segment data ------------------------------------------------- */
-			/* Header */
-
-			/* Allocate memory for body data and segment header bits (16) */
-			vecbiDest[i].Init(iActSegSize * SIZEOF__BYTE + 16);
-			vecbiDest[i].ResetBitAccess();
-	
-			/* Segment header */
-			/* RepetitionCount: This 3-bit field indicates, as an unsigned
-			   binary number, the remaining transmission repetitions for the
-			   current object.
-			   In our current implementation, no repetitions used. TODO */
-			vecbiDest[i].Enqueue((uint32_t) 0, 3);
-	
-			/* SegmentSize: This 13-bit field, coded as an unsigned binary
-			   number, indicates the size of the segment data field in bytes */
-			vecbiDest[i].Enqueue((uint32_t) iActSegSize, 13);
-
-			/* Body */	
-			for (j = 0; j < iActSegSize * SIZEOF__BYTE; j++)
-				vecbiDest[i].Enqueue(vecbiSource.Separate(1), 1);
-		}
-		else
-		{
-			unsigned char dummychar = 0; //init DM
-			vecbiDest[i].Init(0);
-			vecbiDest[i].ResetBitAccess();
-			for (j = 0; j < iActSegSize * SIZEOF__BYTE; j++)
-				dummychar = vecbiSource.Separate(1);
-		}
-	}
+	/* Divide the generated units in partitions. All segments except the last
+	   one have the size "iPartiSize", the data itself is not copied. The
+	   segments are sliced from the packed buffer in "GetDataGroup()" */
+	return (iSourceSize + iPartiSize - 1) / iPartiSize; /* Bytes */
 }
 
-void CMOTDABEnc::GenMOTObj(CVector<_BINARY>& vecbiData, CVector<_BINARY>& vecbiSeg, const _BOOLEAN bHeader, const int iSegNum, const int iTranspID, const _BOOLEAN bLastSeg)
+void CMOTDABEnc::GenMOTObj(CVector<_BINARY>& vecbiData, const _BYTE* pbySeg, const int iSegSize, const _BOOLEAN bHeader, const int iSegNum, const int iTranspID, const _BOOLEAN bLastSeg)
 {
 	int		i = 0;
 	CCRC	CRCObject;
@@ -369,7 +361,7 @@ if (bUsAccFieldUsed == TRUE)
 		iTotLenMOTObj += 16;
 }
 
-iTotLenMOTObj += vecbiSeg.Size();
+iTotLenMOTObj += 16 /* segmentation header */ + iSegSize * SIZEOF__BYTE;
 if (bCRCUsed == TRUE)
 iTotLenMOTObj += 16;
 
@@ -532,10 +524,20 @@ iTotLenMOTObj += 16;
 	}
 
 	/* MSC data group data field -------------------------------------------- */
-	vecbiSeg.ResetBitAccess();
+	/* Segmentation header */
+	/* RepetitionCount: This 3-bit field indicates, as an unsigned
+	   binary number, the remaining transmission repetitions for the
+	   current object.
+	   In our current implementation, no repetitions used. TODO */
+	vecbiData.Enqueue((uint32_t) 0, 3);
+
+	/* SegmentSize: This 13-bit field, coded as an unsigned binary
+	   number, indicates the size of the segment data field in bytes */
+	vecbiData.Enqueue((uint32_t) iSegSize, 13);
 
-	for (i = 0; i < vecbiSeg.Size(); i++)
-		vecbiData.Enqueue(vecbiSeg.Separate(1), 1);
+	/* Segment data, read directly from the packed object */
+	for (i = 0; i < iSegSize; i++)
+		vecbiData.Enqueue((uint32_t) pbySeg[i], SIZEOF__BYTE);
 
 
 	/* MSC data group CRC --------------------------------------------------- */
@@ -573,17 +575,19 @@ _BOOLEAN CMOTDABEnc::GetDataGroup(CVector<_BINARY>& vecbiNewData)
 	if (bCurSegHeader == TRUE)
 	{
 		/* Check if this is last segment */
-		if (iSegmCnt == MOTObjSegments.vvbiHeader.Size() - 1)
+		if (iSegmCnt == MOTObjSegments.iNumSegHeader - 1)
 			bLastSegment = TRUE;
 		else
 			bLastSegment = FALSE;
 
 		/* Generate MOT object for header */
-		GenMOTObj(vecbiNewData, MOTObjSegments.vvbiHeader[iSegmCnt], TRUE,
-			iSegmCnt, iTransportID, bLastSegment);
+		const int iOffset = iSegmCnt * MOTObjSegments.iPartiSizeHeader;
+		GenMOTObj(vecbiNewData, &MOTObjSegments.vecbyHeader[iOffset],
+			min(MOTObjSegments.iPartiSizeHeader, MOTObjSegments.vecbyHeader.Size() - iOffset),
+			TRUE, iSegmCnt, iTransportID, bLastSegment);
 
 		iSegmCnt++;
-		if (iSegmCnt == MOTObjSegments.vvbiHeader.Size())
+		if (iSegmCnt == MOTObjSegments.iNumSegHeader)
 		{
 			/* Reset counter */
 			iSegmCnt = 0;
@@ -595,36 +599,40 @@ _BOOLEAN CMOTDABEnc::GetDataGroup(CVector<_BINARY>& vecbiNewData)
 	else
 	{
 		/* Check that body size is not zero */
-		if (iSegmCnt < MOTObjSegments.vvbiBody.Size())
+		if (iSegmCnt < MOTObjSegments.iNumSegBody)
 		{
 
 			_BOOLEAN skipseg = FALSE; //init DM
 			_BOOLEAN lastseg = FALSE; //init DM
 
-			skipseg = (MOTObjSegments.vvbiBody[iSegmCnt].Size() == 0);
-			lastseg = (iSegmCnt == MOTObjSegments.vvbiBody.Size() - 1);
+			skipseg = (MOTObjSegments.vecbiToSend[iSegmCnt] == 0);
+			lastseg = (iSegmCnt == MOTObjSegments.iNumSegBody - 1);
 			if (lastseg) skipseg = FALSE;
 			while (skipseg)
 			{
 				iSegmCnt++;
 				skipseg = (MOTObjSegments.vecbiToSend[iSegmCnt] == 0);
-				lastseg = (iSegmCnt == MOTObjSegments.vvbiBody.Size() - 1);
+				lastseg = (iSegmCnt == MOTObjSegments.iNumSegBody - 1);
 				if (lastseg) skipseg = FALSE;
 			}
 
 			/* Check if this is last segment */
-			if (iSegmCnt == MOTObjSegments.vvbiBody.Size() - 1)
+			if (iSegmCnt == MOTObjSegments.iNumSegBody - 1)
 				bLastSegment = TRUE;
 			else
 				bLastSegment = FALSE;
 
-			/* Generate MOT object for Body */
-			GenMOTObj(vecbiNewData, MOTObjSegments.vvbiBody[iSegmCnt], FALSE, iSegmCnt, iTransportID, bLastSegment);
+			/* Generate MOT object for Body, the segment is sliced from the
+			   packed body */
+			const int iOffset = iSegmCnt * MOTObjSegments.iPartiSizeBody;
+			GenMOTObj(vecbiNewData, &MOTObjSegments.vecbyBody[iOffset],
+				min(MOTObjSegments.iPartiSizeBody, MOTObjSegments.vecbyBody.Size() - iOffset),
+				FALSE, iSegmCnt, iTransportID, bLastSegment);
 
 			iSegmCnt++;
 		}
 
-		if (iSegmCnt == MOTObjSegments.vvbiBody.Size())
+		if (iSegmCnt == MOTObjSegments.iNumSegBody)
 		{
 			/* Reset counter */
 			iSegmCnt = 0;
@@ -675,12 +683,16 @@ int CMOTDABEnc::GetPicCount(void)
 \******************************************************************************/
 
 
-int iLastGoodTransportID = -1;
-
 CPicPool PicPool;
 
+/* The pool and the global file name are shared by all receivers (dual channel
+   mode), only one data group is decoded at a time */
+std::mutex MOTDecMutex;
+
 _BOOLEAN CMOTDABDec::AddDataGroup(CVector<_BINARY>& vecbiNewData)
 {
+	std::lock_guard<std::mutex> DecLock(MOTDecMutex);
+
 	int			i = 0; //init DM
 	int			j = 0; //j for junk reads... DM
 	int			iSegmentNum = 0; //init DM
@@ -824,6 +836,11 @@ _BOOLEAN CMOTDABDec::AddDataGroup(CVector<_BINARY>& vecbiNewData)
 				//Reset the segtotal registers when the Transport ID changes DM =======================================================================
 				if ((iTransportID > 0) && (DecTransportID != iTransportID)) {
 					RSsw ^= 1; //switch RS buffers here
+					if (RSbusy == 0) {
+						//release the data of the file before last, the buffer is sized again for the new file
+						MOTObjectRaw.BodyRx.RSbytes[RSsw].Init(0);
+						MOTObjectRaw.BodyRx.RSbytes[RSsw].shrink_to_fit();
+					}
 #if RS_SIZE_METHOD == 1
 					DecCheckReg = 0x00FFFF; //reset 16 bits for new version
 #endif
@@ -836,6 +853,7 @@ _BOOLEAN CMOTDABDec::AddDataGroup(CVector<_BINARY>& vecbiNewData)
 					if ((filestate2 == FS_SAVED) && (RxRSlevel > 0)) {
 						PicPool.poolremove(DecTransportID);
 						PicPool.getfrompool(DecTransportID, MOTObjectRaw); //is this needed - yes - it clears the output buffer if the cache is empty
+						SegStore.Remove(DecTransportID); //saved, partial data on disk is not needed anymore
 					}
 					DecTransportID = iTransportID; //Save globally DM
 
@@ -1014,6 +1032,9 @@ _BOOLEAN CMOTDABDec::AddDataGroup(CVector<_BINARY>& vecbiNewData)
 				}
 				else
 				{
+					/* The pool does not keep a copy of the active object, so
+					   store what was received before it is dropped */
+					PicPool.storeinpool(MOTObjectRaw);
 					MOTObjectRaw.Header.Reset();
 					MOTObjectRaw.BodyRx.Reset();
 					MOTObjectRaw.iTransportID = iTransportID;
@@ -1051,12 +1072,30 @@ _BOOLEAN CMOTDABDec::AddDataGroup(CVector<_BINARY>& vecbiNewData)
 							PicPool.getfrompool(iTransportID, MOTObjectRaw);
 						}
 
+						/* Resume from segments stored on disk by an earlier
+						   reception of this object. The last segment is smaller,
+						   only open the store with the real segment size. The
+						   header identifies the content, so wait for it */
+						if ((biLastFlag == FALSE) && (MOTObjectRaw.Header.bReady == TRUE) &&
+							(SegStore.IsOpen(iTransportID) == FALSE))
+						{
+							OpenStore(iSegmentSize);
+						}
+
 						/* Init flag for body ok */
 						MOTObjectRaw.BodyRx.bOK = TRUE;
 
 						MOTObjectRaw.BodyRx.Add(vecbiNewData, iSegmentSize, iSegmentNum); //This is where the incoming segment bits get added - also the segment counts and erasure data is computed DM
 						MOTObjectRaw.iActSegment = iSegmentNum;
 
+						StoreSegment(iSegmentNum, biLastFlag);
+
+						/* Segments which other receivers of the same
+						   transmission have stored meanwhile. The RS decode
+						   below is started as soon as the union is enough */
+						if (SegStore.Refresh() == TRUE)
+							MergeFromStore(SegStore.GetSegmentSize());
+
 #define NEWCODE TRUE
 #if NEWCODE
 						//NEW CODE DM =================================
@@ -1074,11 +1113,16 @@ _BOOLEAN CMOTDABDec::AddDataGroup(CVector<_BINARY>& vecbiNewData)
 							unsigned int k = MOTObjectRaw.BodyRx.vvbiSegment[iSegmentNum].size() / 8; //find total bytes for this segment
 							unsigned int a = 0;
 
+							//RS buffer is allocated lazily, sized to the advertised (RS encoded) file size once it is known
+							//the RS decoder thread works on its own copy of it, so it may still grow or be reused while a decode is running
 							int oldsize = MOTObjectRaw.BodyRx.RSbytes[RSsw].size(); //get current size of new buffer
-							int newsize = max((j + k) * 2, 1050000); //set this large to ensure there is never a read error in the distribute function
+							int newsize = max(j + k, RSfilesize); //distribute() reads up to RSfilesize bytes
 							//if RSbytes buffer is too small, resize it
 							if (oldsize < newsize) {
-								MOTObjectRaw.BodyRx.RSbytes[RSsw].resize(newsize); //make it larger if needed
+								if (RSfilesize == 0) {
+									newsize = max(newsize, oldsize * 2); //size not known yet, grow geometrically
+								}
+								MOTObjectRaw.BodyRx.RSbytes[RSsw].Enlarge(newsize - oldsize); //make it larger if needed
 							}
 							if (k > 0) {
 								for (unsigned int i = 0; i < k; i++)
@@ -1157,10 +1201,13 @@ _BOOLEAN CMOTDABDec::AddDataGroup(CVector<_BINARY>& vecbiNewData)
 						if ((RSlastTransportID != DecTransportID) && (RSbusy == 0)) {
 							RSbusy = 1; //only run one instance of this
 							RSpsegs = actsize; //update
-							unsigned char* RSbuffer = nullptr;
-							RSbuffer = MOTObjectRaw.BodyRx.RSbytes[RSsw].data(); //grab the RSbytes buffer address and save it where we can access it easily
+							if (MOTObjectRaw.BodyRx.RSbytes[RSsw].Size() < (int)RSfilesize) {
+								//missing tail segments - make sure distribute() never reads past the buffer
+								MOTObjectRaw.BodyRx.RSbytes[RSsw].Enlarge(RSfilesize - MOTObjectRaw.BodyRx.RSbytes[RSsw].Size());
+							}
 
-							std::thread RSdecoder(RSdecode, RSbuffer, DecTransportID, RSsw); //launch the RS decoder in a new thread
+							//the thread gets a copy of the RSbytes buffer, the receiver keeps filling (and may enlarge) the original
+							std::thread RSdecoder(RSdecode, MOTObjectRaw.BodyRx.RSbytes[RSsw], DecTransportID, RSsw); //launch the RS decoder in a new thread
 							RSdecoder.detach(); //detach and terminate after running
 						}
 					}
@@ -1176,23 +1223,38 @@ _BOOLEAN CMOTDABDec::AddDataGroup(CVector<_BINARY>& vecbiNewData)
 			if ((MOTObjectRaw.Header.bReady == TRUE) && (MOTObjectRaw.BodyRx.bReady == TRUE))
 			{
 				int mysegsiz = 0; //init DM
+				int iBodyBits = 0;
 				BOOL allfull = TRUE;
-				// Copy BodyRx to Body
-				MOTObjectRaw.Body.Reset();
 				for (int i = 0; i < MOTObjectRaw.BodyRx.iTotSegments; i++)
 				{
 					mysegsiz = MOTObjectRaw.BodyRx.vvbiSegment[i].Size();
 					if (mysegsiz <= 0) allfull = FALSE;
-					MOTObjectRaw.BodyRx.vvbiSegment[i].ResetBitAccess();
-					MOTObjectRaw.Body.Add(MOTObjectRaw.BodyRx.vvbiSegment[i], mysegsiz / SIZEOF__BYTE, i);
+					iBodyBits += mysegsiz;
 				}
 
 				if (allfull)
 				{
+					// Copy BodyRx to Body. The body is allocated once with its
+					// final size and each segment is freed when it is copied, so
+					// the bits are not held twice
+					MOTObjectRaw.Body.Reset();
+					MOTObjectRaw.Body.vecbiData.reserve(iBodyBits);
+					for (int i = 0; i < MOTObjectRaw.BodyRx.iTotSegments; i++)
+					{
+						mysegsiz = MOTObjectRaw.BodyRx.vvbiSegment[i].Size();
+						MOTObjectRaw.BodyRx.vvbiSegment[i].ResetBitAccess();
+						MOTObjectRaw.Body.Add(MOTObjectRaw.BodyRx.vvbiSegment[i], mysegsiz / SIZEOF__BYTE, i);
+						MOTObjectRaw.BodyRx.vvbiSegment[i] = CVector<_BINARY>();
+					}
+
 					// remove from pool
 					PicPool.poolremove(MOTObjectRaw.iTransportID);
+					SegStore.Remove(MOTObjectRaw.iTransportID);
 					DecodeObject(MOTObjectRaw);
 
+					/* The bytes are in the object now */
+					MOTObjectRaw.Body.vecbiData = CVector<_BINARY>();
+
 					/* Set flag that new object was successfully decoded */
 					bMOTObjectReady = TRUE;
 
@@ -1218,9 +1280,9 @@ _BOOLEAN CMOTDABDec::AddDataGroup(CVector<_BINARY>& vecbiNewData)
 		//DecodeObject(MOTObjectRaw);
 		DMnewfile = FALSE; //reset Segment 0 detection
 	}
-	else {
-		LogData(DMfilename, 0); //Update stats file here, to avoid corruption at the end...
-	}
+
+	/* One line per data group in the reception log */
+	ReceptionLog.AddSegment(MOTObjectRaw.iTransportID, iSegmentNum, bCRCOk, DMfilename, SegStore.GetCallsign());
 
 	/* Return status of MOT object decoding */
 	return bMOTObjectReady;
@@ -1229,6 +1291,90 @@ _BOOLEAN CMOTDABDec::AddDataGroup(CVector<_BINARY>& vecbiNewData)
 
 }
 
+void CMOTDABDec::StoreSegment(const int iSegmentNum, const _BOOLEAN bLast)
+{
+	if (SegStore.IsOpen(MOTObjectRaw.iTransportID) == FALSE)
+		return;
+
+	/* Pack the bits of the new segment */
+	CVector<_BINARY>& vecbiSeg = MOTObjectRaw.BodyRx.vvbiSegment[iSegmentNum];
+	const int iLen = vecbiSeg.Size() / SIZEOF__BYTE;
+	if (iLen <= 0)
+		return;
+
+	CVector<_BYTE> vecbyData(iLen);
+
+	vecbiSeg.ResetBitAccess();
+	for (int i = 0; i < iLen; i++)
+		vecbyData[i] = (_BYTE) vecbiSeg.Separate(SIZEOF__BYTE);
+
+	SegStore.PutSegment(iSegmentNum, &vecbyData[0], iLen, bLast);
+}
+
+void CMOTDABDec::OpenStore(const int iSegmentSize)
+{
+	_BYTE byData[SEGSTORE_MAX_HEADER];
+	int i;
+
+	const int iLen = MOTObjectRaw.Header.vecbiData.Size() / SIZEOF__BYTE;
+	if ((iLen <= 0) || (iLen > SEGSTORE_MAX_HEADER))
+		return;
+
+	MOTObjectRaw.Header.vecbiData.ResetBitAccess();
+	for (i = 0; i < iLen; i++)
+		byData[i] = (_BYTE) MOTObjectRaw.Header.vecbiData.Separate(SIZEOF__BYTE);
+
+	if (SegStore.Open(MOTObjectRaw.iTransportID, iSegmentSize, RxRSlevel, byData, iLen) == TRUE)
+		MergeFromStore(iSegmentSize);
+
+	/* Segments which were received before the header */
+	for (i = 0; i < MOTObjectRaw.BodyRx.vvbiSegment.Size(); i++)
+		StoreSegment(i, i == MOTObjectRaw.BodyRx.iTotSegments - 1);
+}
+
+void CMOTDABDec::MergeFromStore(const int iSegmentSize)
+{
+	_BYTE				byData[8192]; /* Segment size is a 13 bit field */
+	CVector<_BINARY>	vecbiSeg;
+	int					i, iLen;
+
+	/* Body segments which were not received in this session yet. BodyRx.Add()
+	   also updates the erasure data and the segment count */
+	const int iNumSlots = SegStore.GetNumSlots();
+	for (int iSeg = 0; iSeg < iNumSlots; iSeg++)
+	{
+		if ((iSeg < MOTObjectRaw.BodyRx.vvbiSegment.Size()) &&
+			(MOTObjectRaw.BodyRx.vvbiSegment[iSeg].Size() > 0))
+		{
+			continue;
+		}
+
+		iLen = SegStore.GetSegment(iSeg, byData);
+		if (iLen <= 0)
+			continue;
+
+		vecbiSeg.Init(iLen * SIZEOF__BYTE);
+		vecbiSeg.ResetBitAccess();
+		for (i = 0; i < iLen; i++)
+			vecbiSeg.Enqueue((_UINT32BIT) byData[i], SIZEOF__BYTE);
+
+		vecbiSeg.ResetBitAccess();
+		MOTObjectRaw.BodyRx.Add(vecbiSeg, iLen, iSeg);
+
+		/* Same byte copy to the RS buffer as for a received segment */
+		CVector<_BYTE>& vecbyRS = MOTObjectRaw.BodyRx.RSbytes[RSsw];
+		const int iBase = iSeg * iSegmentSize;
+		if (vecbyRS.Size() < iBase + iLen)
+			vecbyRS.Enlarge(iBase + iLen - vecbyRS.Size());
+		for (i = 0; i < iLen; i++)
+			vecbyRS[iBase + i] = byData[i];
+	}
+
+	MOTObjectRaw.BodyRx.bOK = TRUE;
+	if (SegStore.GetTotSegments() > 0)
+		MOTObjectRaw.BodyRx.iTotSegments = SegStore.GetTotSegments();
+}
+
 void GetName(CMOTObjectRaw& MOTObjectRaw)
 {
 	int				i = 0; //inits DM
@@ -1305,6 +1451,8 @@ void GetName(CMOTObjectRaw& MOTObjectRaw)
 	
 _BOOLEAN	CMOTDABDec::GetActBSR(int * iNumSeg, string * bsr_name, char * path, int * iHash)
 {
+	std::lock_guard<std::mutex> DecLock(MOTDecMutex);
+
 	FILE * bsr = nullptr; //init DM
 	char filenam[300]{}; //init DM
 
@@ -1642,7 +1790,7 @@ void CMOTObjectRaw::CDataUnitRx::Reset()
 	iTotSegments = -1;
 }
 
-void RSdecode(unsigned char* RSbuffer, unsigned int DecTransportIDc, bool RSswc) {
+void RSdecode(CVector<_BYTE> vecbyRS, unsigned int DecTransportIDc, bool RSswc) {
 	//******************************************************************************
 	//This code runs in a new thread, then terminates... DM  Sep 29th, 2021
 	//******************************************************************************
@@ -1670,18 +1818,18 @@ void RSdecode(unsigned char* RSbuffer, unsigned int DecTransportIDc, bool RSswc)
 		i = 0; //start at zero
 		//this is normally buffer1
 		while (i < DecFileSize) { //edit DM
-			putc(RSbuffer[i], set);
+			putc(vecbyRS[i], set);
 			i++;
 		}
 		fclose(set); //file is closed here - but only if it was opened
 	}
 	//====================================================================================
 #endif
-	//RSbuffer address is grabbed during decoding, just before this routine is launched
+	//vecbyRS is a copy of the RSbytes buffer, taken during decoding just before this routine is launched
 
 	//Data deinterleaver
 	constexpr bool rev = 1; //Reverse mode to deinterleave
-	distribute(RSbuffer, buffer1, RSfilesize, rev); //output is put into buffer1 - read directly from the global RS buffer now
+	distribute(&vecbyRS[0], buffer1, RSfilesize, rev); //output is put into buffer1 - read from this thread's copy of the RS buffer
 
 	//Erasure processing added here...
 	//Unpack the packed erasure bit array and deinterleave it so it matches the deinterleaved data locations
@@ -1810,7 +1958,7 @@ void RSdecode(unsigned char* RSbuffer, unsigned int DecTransportIDc, bool RSswc)
 						//cut extension off filename
 						filenametest[strlen(filenametest) - 3] = 0; //terminate the string early to cut off the extra .gz extension DM
 
-						LogData(filenametest); //log the SNR stats DM
+						ReceptionLog.AddFile(DecTransportIDc, TRUE, filenametest); //log the SNR stats DM
 
 						char RSfilenameS[260] = "";
 						wsprintf(RSfilenameS, "Rx Files\\%s", filenametest);
@@ -1852,7 +2000,7 @@ void RSdecode(unsigned char* RSbuffer, unsigned int DecTransportIDc, bool RSswc)
 							//cut .lz extension off filename
 							filenametest[strlen(filenametest) - 3] = 0; //terminate the string early to cut off the extra .lz extension DM
 
-							LogData(filenametest, 1); //log the SNR stats DM
+							ReceptionLog.AddFile(DecTransportIDc, TRUE, filenametest); //log the SNR stats DM
 
 							char RSfilenameS[260] = "";
 							wsprintf(RSfilenameS, "Rx Files\\%s", filenametest);
@@ -1876,7 +2024,7 @@ void RSdecode(unsigned char* RSbuffer, unsigned int DecTransportIDc, bool RSswc)
 						}
 						else {
 							//If data is noncompressed, save buffer2 to disk
-							LogData(filenametest, 1); //log the SNR stats DM
+							ReceptionLog.AddFile(DecTransportIDc, TRUE, filenametest); //log the SNR stats DM
 
 							char RSfilenameS[260] = "";
 							wsprintf(RSfilenameS, "Rx Files\\%s", filenametest);
@@ -1917,6 +2065,7 @@ void RSdecode(unsigned char* RSbuffer, unsigned int DecTransportIDc, bool RSswc)
 				RSpsegs = 0; //reset on success
 			}
 			else {
+				ReceptionLog.AddFile(DecTransportIDc, FALSE, DMfilename);
 				filestate = FS_TRY; //File decode status
 				RScount += 1; //count the RS decode failures
 				if (RSlastTransportID == DecTransportIDc) {
@@ -35,6 +35,13 @@
 #include "../Vector.h"
 #include "../CRC.h"
 #include "../../RS-defs.h"
+#include "SegmentStore.h"
+
+
+/* Definitions ****************************************************************/
+/* The MOT header is sent in one segment of this size (bytes) */
+#define MOT_HEADER_PARTI_SIZE		98
+
 
 /* Classes ********************************************************************/
 class CMOTObjectRaw
@@ -63,7 +70,7 @@ public:
 		_BOOLEAN			bOK, bReady;
 		int					iDataSegNum;
 		int					iTotSegments;
-		CVector<_BYTE> RSbytes[2]{1050000, 0 }; //added DM - working 1st Oct, 2021 - changed from BYTE to _BYTE Nov 18, 2021
+		CVector<_BYTE> RSbytes[2]; //added DM - working 1st Oct, 2021 - changed from BYTE to _BYTE Nov 18, 2021 - now allocated on demand, sized to the advertised file size
 	};
 
 	int			iTransportID;
@@ -78,7 +85,17 @@ class CMOTObject
 {
 public:
 	CMOTObject() {Reset();}
-	CMOTObject(const CMOTObject& NewObj) : vecbRawData(NewObj.vecbRawData),	strName(NewObj.strName) {}
+	CMOTObject(const CMOTObject& NewObj) : vecbRawData(NewObj.vecbRawData),
+		strName(NewObj.strName), strNameandDir(NewObj.strNameandDir),
+		bIsLeader(NewObj.bIsLeader), iTransportID(NewObj.iTransportID) {}
+
+	/* A completed object is handed over from the decoder to the application
+	   without copying the data, the source is left empty */
+	CMOTObject(CMOTObject&& NewObj) noexcept :
+		vecbRawData(std::move(NewObj.vecbRawData)),
+		strName(std::move(NewObj.strName)),
+		strNameandDir(std::move(NewObj.strNameandDir)),
+		bIsLeader(NewObj.bIsLeader), iTransportID(NewObj.iTransportID) {}
 
 	inline CMOTObject& operator=(const CMOTObject& NewObj)
 	{
@@ -86,6 +103,18 @@ public:
 		strNameandDir = NewObj.strNameandDir;
 		vecbRawData.Init(NewObj.vecbRawData.Size());
 		vecbRawData = NewObj.vecbRawData;
+		bIsLeader = NewObj.bIsLeader;
+		iTransportID = NewObj.iTransportID;
+		return *this;
+	}
+
+	inline CMOTObject& operator=(CMOTObject&& NewObj) noexcept
+	{
+		strName = std::move(NewObj.strName);
+		strNameandDir = std::move(NewObj.strNameandDir);
+		vecbRawData = std::move(NewObj.vecbRawData);
+		bIsLeader = NewObj.bIsLeader;
+		iTransportID = NewObj.iTransportID;
 		return *this;
 	}
 
@@ -95,6 +124,7 @@ public:
 		strName = "";
 		strNameandDir = "";
 		bIsLeader = FALSE;
+		iTransportID = 0;
 	}
 
 	CVector<_BYTE>	vecbRawData;
@@ -119,17 +149,23 @@ public:
 	int GetPicSegmAct(void) { return iSegmCnt; };
 	int GetPicSegmTot(void) { return iTotSegm; };
 protected:
+	/* Header and body are kept packed (one byte per byte), the segments are
+	   sliced directly from these buffers when the data group is generated */
 	class CMOTObjSegm
 	{
 	public:
-		CVector<CVector<_BINARY> > vvbiHeader;
-		CVector<CVector<_BINARY> > vvbiBody;
-		CVector<_BINARY>		   vecbiToSend;
+		CVector<_BYTE>		vecbyHeader;
+		CVector<_BYTE>		vecbyBody;
+		int					iPartiSizeHeader;
+		int					iPartiSizeBody;
+		int					iNumSegHeader;
+		int					iNumSegBody;
+		CVector<_BINARY>	vecbiToSend;
 	};
 
-	void PartitionUnits(CVector<_BINARY>& vecbiSource, CVector<CVector<_BINARY> >& vecbiDest, const int iPartiSize, int ishead);
+	int PartitionUnits(const int iSourceSize, const int iPartiSize);
 
-	void GenMOTObj(CVector<_BINARY>& vecbiData, CVector<_BINARY>& vecbiSeg, const _BOOLEAN bHeader, const int iSegNum, const int iTranspID, const _BOOLEAN bLastSeg);
+	void GenMOTObj(CVector<_BINARY>& vecbiData, const _BYTE* pbySeg, const int iSegSize, const _BOOLEAN bHeader, const int iSegNum, const int iTranspID, const _BOOLEAN bLastSeg);
 
 	CMOTObject		MOTObject;
 	CMOTObjSegm		MOTObjSegments;
@@ -151,14 +187,16 @@ protected:
 class CMOTDABDec
 {
 public:
-	CMOTDABDec() {}
+	CMOTDABDec() : iLastGoodTransportID(-1) {}
 	virtual ~CMOTDABDec() {}
 
 	_BOOLEAN	AddDataGroup(CVector<_BINARY>& vecbiNewData);
 	_BOOLEAN	GetActMOTSegs(CVector<_BINARY>& vSegs);
 	_BOOLEAN	GetActMOTObject(CMOTObject& NewMOTObject);
+	_BOOLEAN	HasActMOTObject() {return (iLastGoodTransportID != MOTObjectRaw.iTransportID) &&
+					(MOTObjectRaw.Header.bReady == TRUE);}
 	_BOOLEAN	GetActBSR(int * iNumSeg, string * bsr_name, char * path, int * iHash);
-	void		GetMOTObject(CMOTObject& NewMOTObject) {NewMOTObject = MOTObject; /* Simply copy object */}
+	void		GetMOTObject(CMOTObject& NewMOTObject) {NewMOTObject = std::move(MOTObject); /* Hand over, no copy */}
 	unsigned int GetObjectTotSize() {
 		//this isn't computing the total segments after the first file, even when all the info has been received... DM
 		unsigned int a = MOTObjectRaw.BodyRx.vvbiSegment.Size(); //try the original method first DM
@@ -184,19 +222,28 @@ public:
 	}
 	int GetObjectActPos()  { return MOTObjectRaw.iActSegment; }
 
+	void SetCallsign(const string& strNewCall) {SegStore.SetCallsign(strNewCall);}
+
 protected:
 	void DecodeObject(CMOTObjectRaw& MOTObjectRaw);
+	void MergeFromStore(const int iSegmentSize);
+	void StoreSegment(const int iSegmentNum, const _BOOLEAN bLast);
+	void OpenStore(const int iSegmentSize);
 
 	CMutex			Mutex;
 
 	CMOTObject		MOTObject;
 	CMOTObjectRaw	MOTObjectRaw;
 
+	/* Partially received objects on disk, for resuming reception */
+	CSegmentStore	SegStore;
+
+	int				iLastGoodTransportID;
 };
 
 void GetName(CMOTObjectRaw& MOTObjectRaw);
 
-void RSdecode(unsigned char* RSbuffer, unsigned int  DecTransportIDc, bool RSswc); //added DM
+void RSdecode(CVector<_BYTE> vecbyRS, unsigned int  DecTransportIDc, bool RSswc); //added DM
 
 void EraseNew();
 #endif // !defined(DABMOT_H__3B0UBVE98732KJVEW363E7A0D31912__INCLUDED_)
@@ -344,6 +344,9 @@ void CDataDecoder::ProcessDataInternal(CParameter& ReceiverParam)
 				switch (eAppType)
 				{
 				case AT_MOTSLISHOW: /* MOTSlideshow */
+					/* Partial objects are stored per received callsign */
+					MOTSlideShow[iPacketID].SetCallsign(ReceiverParam.Service[0].strLabel);
+
 					/* Packet unit decoding */
 					MOTSlideShow[iPacketID].AddDataUnit(DataUnit[iPacketID].vecbiData);
 					break;
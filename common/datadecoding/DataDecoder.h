@@ -78,6 +78,7 @@ public:
 
 	_BOOLEAN GetSlideShowPicture(CMOTObject& NewPic);
 	_BOOLEAN GetSlideShowPartPicture(CMOTObject& NewPic);
+	_BOOLEAN HasSlideShowPartPicture() {return MOTSlideShow[0].HasPartPicture();}
 	_BOOLEAN GetSlideShowPartActSegs(CVector<_BINARY>& vbSegs);
 	_BOOLEAN GetSlideShowBSR(int * iNumSeg, string * bsrname, char * path);
 	EAppType GetAppType() {return eAppType;}
@@ -39,6 +39,10 @@
 #include "../RS/RS-coder.h"
 #include "../../7zTypes.h"
 #include "../../LzmaLib.h"
+#include "TxPrepCache.h"
+#include "../EventQueue.h"
+#include "../ModulStats.h"
+#include <chrono>
 
 
 /* Implementation *************************************************************/
@@ -49,9 +53,25 @@ void CMOTSlideShowEncoder::GetDataUnit(CVector<_BINARY>& vecbiNewData)
 {
 	/* Get new data group from MOT encoder. If the last MOT object was
 	   completely transmitted, this functions returns true. In this case, put
-	   a new picture to the MOT encoder object */
+	   a new picture to the MOT encoder object. The object is set up once per
+	   file, the benchmark does not count it */
 	if (MOTDAB.GetDataGroup(vecbiNewData) == TRUE)
+	{
+		iHeapCountPause++;
 		AddNextPicture();
+		iHeapCountPause--;
+	}
+
+	/* Progress for the application, only when it changes */
+	const int iPicCnt = GetPicCnt();
+	const int iPicPerc = GetPicPerc();
+
+	if ((iPicCnt != iLastPicCnt) || (iPicPerc != iLastPicPerc))
+	{
+		iLastPicCnt = iPicCnt;
+		iLastPicPerc = iPicPerc;
+		EventQueue.Post(EV_TX_PROGRESS, iPicCnt, iPicPerc);
+	}
 }
 
 void CMOTSlideShowEncoder::Init(int iSegSize)
@@ -64,6 +84,9 @@ void CMOTSlideShowEncoder::Init(int iSegSize)
 
 	iSegmentSize = iSegSize;
 
+	iLastPicCnt = -1;
+	iLastPicPerc = -1;
+
 	AddNextPicture();
 }
 
@@ -84,273 +107,304 @@ void CMOTSlideShowEncoder::AddNextPicture()
 	}
 }
 
-void CMOTSlideShowEncoder::AddFileName(const string& strFileName, const string& strFileNamenoDir, CVector<short>  vecsToSend)
-{
-	/* Only ContentSubType "JFIF" (JPEG) and ContentSubType "PNG" are allowed
-	   for SlideShow application (not tested here!) */
-	/* For HamDRM this doesn't matter - any file works! DM */
-	/* Try to open file binary */
+int LzmaFastMode = FALSE;
 
-	int iOldNumObj = 0; //init DM
-	FILE * pFiBody = fopen(strFileName.c_str(), "rb");
+void LzmaParams(const unsigned long insize, const int iFastMode, int& level, unsigned int& dictSize, int& fb, int& numThreads)
+{
+	//the dictionary never needs to be larger than the input, a 32MB dictionary for a small text file only costs allocation time
+	//(and the receiver allocates the same size again for decoding)
+	dictSize = LZMA_MIN_DICT;
+	while ((dictSize < insize) && (dictSize < LZMA_MAX_DICT))
+		dictSize <<= 1;
+
+	//multi-threaded match finding (2 threads) only pays off for larger inputs
+	if (insize > LZMA_MT_SIZE)
+		numThreads = 2;
+	else
+		numThreads = 1;
+
+	if (iFastMode) {
+		//fast mode - hash chain match finder, short matches. About 10x faster, 10-20% larger on text
+		level = 1;
+		fb = 32;
+	}
+	else {
+		//maximum compression
+		level = 9;
+		fb = 255;
+	}
+}
 
-	if (pFiBody != nullptr) //edit DM
+_BOOLEAN PrepareTxObject(const string& strFileName, const string& strFileNamenoDir, const int iECCmode,
+						 CVector<_BYTE>& vecbyObject, string& strFileNamenoDirX)
+{
+	/* Reads, compresses, RS encodes and interleaves one file into its final
+	   packed form. Only depends on the file and the ECC mode, so it can also
+	   run in the background preparation thread */
+	uLongf			filesize = 0;
+	HANDLE			hMap = NULL;
+	const _BYTE*	pbyFile = NULL; //mapped file data
+	_BYTE*			pbyPayload = NULL; //header + (compressed) file data, only needed if it differs from the file
+	const _BYTE*	pbySrc = NULL; //data to be sent, before RS coding
+
+#if TXPREP_TIMING
+	LARGE_INTEGER	liFreq, liStart, liStop;
+	size_t			iPeakBytes = 0;
+	QueryPerformanceFrequency(&liFreq);
+	QueryPerformanceCounter(&liStart);
+#endif
+
+	/* Try to open file binary. The file is mapped into memory and read directly
+	   from the mapping, it is not copied into a read buffer first */
+	HANDLE hFile = CreateFile(strFileName.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL,
+		OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+
+	if (hFile == INVALID_HANDLE_VALUE)
+		return FALSE;
+
+	filesize = GetFileSize(hFile, NULL);
+	if (filesize == INVALID_FILE_SIZE) filesize = 0;
+	if (filesize > TXPREP_MAX_FILE_SIZE) filesize = TXPREP_MAX_FILE_SIZE; //limit to 512k, the RS coded data must fit the receive buffer
+#if TXPREP_TIMING
+	const uLongf insize = filesize;
+#endif
+
+	/* A view of an empty file can't be mapped, nothing needs to be read then */
+	if (filesize > 0)
 	{
-		//		_BYTE byIn; //this is the original file buffer - only 1 byte long DM
-		//=============================================================================================================================
-		const uLongf BUFSIZE = 524288; //512k should be enough for anything practical - HEAP STORAGE
-		_BYTE* buffer1T = new _BYTE[BUFSIZE*2]; //File read buffer - now 1M to fit RS encoding
-		_BYTE* buffer2T = new _BYTE[BUFSIZE*2]; //zlib & interleaver buffer - now 1M to fit RS encoding
-		uLongf filesize;
-		unsigned int dd = 0;
-		int result = 0;
-		filesize = 0;
-
-		// obtain file size : (there might be a more elegant way to do this...)
-		fseek(pFiBody, 0, SEEK_END);
-		filesize = ftell(pFiBody);
-		if (filesize > BUFSIZE) filesize = BUFSIZE; //prevent buffer overrun - limit to 512k
-		rewind(pFiBody);
-
-		//Daz Man: Before we make the header, we need to figure out what the filename extension is going to be
-		LPSTR dx1 = const_cast<char*>(strFileNamenoDir.c_str()); //the filename that is being sent
-		const string& dx2 = ".lz"; //the 2nd filename extension that denotes LZMA compression is used
-		string strFileNamenoDirX; //the variable that holds the modified filename
-		_BOOLEAN compressit = !checkext(dx1); //check list of file types
-//		compressit = FALSE; //TEST ===================================================================================================================
+		hMap = CreateFileMapping(hFile, NULL, PAGE_READONLY, 0, 0, NULL);
+		if (hMap != NULL)
+			pbyFile = (const _BYTE*) MapViewOfFile(hMap, FILE_MAP_READ, 0, 0, filesize);
 
-		if (compressit) {
-			strFileNamenoDirX = strFileNamenoDir.c_str() + dx2; //attach extra file extension to denote compression is used
-		}
-		else {
-			strFileNamenoDirX = strFileNamenoDir.c_str(); //copy normal filename
-		}
-		
-		//Only add the new header if using the new RS mode - Disable RS if BSR.bin is being sent ************* TODO
-		int HeaderSize = 0;
-		if (ECCmode > 3) {
-			//Daz Man:
-			//Write a header for all files, containing the filename, the filesize and the header size to guarantee this data is available if the file decodes ok.
-			//write header into buffer2T before file copy or gzip write, then read it out directly or RS code it into buffer1T
-			string EZHeaderID = "EasyDRFHeader/|000000" + strFileNamenoDirX; //reserve space for numerics using zeroes
-			HeaderSize = size(EZHeaderID); //length of header - add to the filesize used in the header
-			int i = 15; //first byte after version number
-			EZHeaderID[i++] = (2); //version number
-			EZHeaderID[i++] = (HeaderSize & 0xFF); //byte 1 of header size
-			EZHeaderID[i++] = (HeaderSize & 0xFF00) >> 8; //byte 2 of header size
-			EZHeaderID[i++] = ((filesize) & 0xFF); //byte 1 of file size
-			EZHeaderID[i++] = ((filesize) & 0xFF00) >> 8; //byte 2 of file size
-			EZHeaderID[i++] = ((filesize) & 0xFF0000) >> 16; //byte 3 of file size
-
-			//Now write new header into buffer2T
-			i = 0;
-			while (i < HeaderSize) {
-				buffer2T[i] = EZHeaderID[i]; //this is normally buffer2T
-				i++;
-			}
+		if (pbyFile == NULL)
+		{
+			if (hMap != NULL) CloseHandle(hMap);
+			CloseHandle(hFile);
+			return FALSE;
 		}
+	}
+
+	//Daz Man: Before we make the header, we need to figure out what the filename extension is going to be
+	LPSTR dx1 = const_cast<char*>(strFileNamenoDir.c_str()); //the filename that is being sent
+	const string& dx2 = ".lz"; //the 2nd filename extension that denotes LZMA compression is used
+	_BOOLEAN compressit = !checkext(dx1); //check list of file types
 
+	if (compressit) {
+		strFileNamenoDirX = strFileNamenoDir.c_str() + dx2; //attach extra file extension to denote compression is used
+	}
+	else {
+		strFileNamenoDirX = strFileNamenoDir.c_str(); //copy normal filename
+	}
+
+	//Only add the new header if using the new RS mode
+	int HeaderSize = 0;
+	string EZHeaderID;
+	if (iECCmode > 3) {
 		//Daz Man:
-		//if the input data is compressible (selected file types) then send data to buffer1T
-		//else send data to buffer2T
-		//add the text file zlib compressor in here - read the data from buffer1T and put compressed data into buffer2T
-		//keep the filename data intact - just append the extra .gz extension to strFileNamenoDir
-		//change the existing routines below to read from the buffer output
-		//
-		//test the filename extension
+		//Write a header for all files, containing the filename, the filesize and the header size to guarantee this data is available if the file decodes ok.
+		EZHeaderID = "EasyDRFHeader/|000000" + strFileNamenoDirX; //reserve space for numerics using zeroes
+		HeaderSize = size(EZHeaderID); //length of header - add to the filesize used in the header
+		int i = 15; //first byte after version number
+		EZHeaderID[i++] = (2); //version number
+		EZHeaderID[i++] = (HeaderSize & 0xFF); //byte 1 of header size
+		EZHeaderID[i++] = (HeaderSize & 0xFF00) >> 8; //byte 2 of header size
+		EZHeaderID[i++] = ((filesize) & 0xFF); //byte 1 of file size
+		EZHeaderID[i++] = ((filesize) & 0xFF00) >> 8; //byte 2 of file size
+		EZHeaderID[i++] = ((filesize) & 0xFF0000) >> 16; //byte 3 of file size
+	}
+
+	if ((compressit) || (iECCmode > 3)) {
+		//Payload buffer: header, then the compressed (or plain) file data
+		//sized for the actual file, plus room for incompressible data and the RS encoder read-ahead (it reads whole RS data blocks)
+		const uLongf paysize = HeaderSize + LZMA_PROPS_SIZE + 3 + filesize + filesize / 2 + TXPREP_PAD;
+		pbyPayload = new _BYTE[paysize];
+		memset(pbyPayload, 0, paysize);
+#if TXPREP_TIMING
+		iPeakBytes += paysize;
+#endif
+
+		//write header first (if no header is used, Headersize is zero)
+		memcpy(pbyPayload, EZHeaderID.c_str(), HeaderSize);
+
 		if (compressit) {
-			//read into buffer1T if it's compressible
-			result = fread(buffer1T, 1, filesize, pFiBody); //read the file to send into buffer1T if it is text
-			//uLongf ds = BUFSIZE; //tell zlib the buffer size we are using
-			//start at buffer2T + Headersize to avoid overwriting the header (if no header is used, Headersize is zero)
-			//compress2(buffer2T + HeaderSize, &ds, buffer1T, filesize, 9); //zlib compress text data and compressible files (use the headerless filesize)
-			//BYTE* buffer2Th = buffer2T + HeaderSize;
-			unsigned int ds = BUFSIZE*2;
-
-//#define LZMA_PROPS_SIZE 5;
-				unsigned propsSize = LZMA_PROPS_SIZE;
-				//set these accordingly:
-				int level = 9; //Maximum compression
-				unsigned int dictSize = 1 << 25; //24
-				int lc = 3;
-				int lp = 0;
-				int pb = 2;
-				int fb = 255; // 32; //block size
-				int numThreads = 1;
-				//save original filesize after props, as LZMA isn't accurate on data size
-				int i = 0;
-				(buffer2T + HeaderSize + propsSize)[i] = filesize & 0xFF; //byte 1
-				i++; //next
-				(buffer2T + HeaderSize + propsSize)[i] = (filesize & 0x00FF00) >> 8; //byte 2
-				i++; //next
-				(buffer2T + HeaderSize + propsSize)[i] = (filesize & 0x00FF0000) >> 16; //byte 3
-
-				//                     dest to write to      dlen  src read  src size outprops, size, 
-				int res = LzmaCompress(buffer2T+HeaderSize+propsSize+3, &ds, buffer1T, filesize, buffer2T+HeaderSize, &propsSize, level, dictSize, lc, lp, pb, fb, numThreads);
-				//if RS is not used, there is no new header, and HeaderSize is 0
-				
-				//compressed file data size is in ds, and add props data size also
-				filesize = ds + propsSize+3; //update filesize with the new compressed file data size AND the LZMA props AND the new 3-byte filesize data
+			//LZMA compress directly from the mapped file
+			size_t ds = paysize - HeaderSize - LZMA_PROPS_SIZE - 3 - TXPREP_PAD;
+			size_t propsSize = LZMA_PROPS_SIZE;
+			//parameters are chosen from the input size, see LzmaParams()
+			int level = 9;
+			unsigned int dictSize = 1 << 25;
+			int lc = 3;
+			int lp = 0;
+			int pb = 2;
+			int fb = 255;
+			int numThreads = 1;
+			LzmaParams(filesize, LzmaFastMode, level, dictSize, fb, numThreads);
+			//save original filesize after props, as LZMA isn't accurate on data size
+			_BYTE* pbyLzSize = pbyPayload + HeaderSize + propsSize;
+			pbyLzSize[0] = filesize & 0xFF; //byte 1
+			pbyLzSize[1] = (filesize & 0x00FF00) >> 8; //byte 2
+			pbyLzSize[2] = (filesize & 0x00FF0000) >> 16; //byte 3
+
+			//                     dest to write to      dlen  src read  src size outprops, size, 
+			int res = LzmaCompress(pbyLzSize + 3, &ds, pbyFile, filesize, pbyPayload + HeaderSize, &propsSize, level, dictSize, lc, lp, pb, fb, numThreads);
+
+			//compressed file data size is in ds, and add props data size also
+			filesize = ds + propsSize + 3; //update filesize with the new compressed file data size AND the LZMA props AND the new 3-byte filesize data
 		}
 		else {
-			//read into buffer2T directly for all else
-			//start at buffer2T + Headersize to avoid overwriting the header (if no header is used, Headersize is zero)
-			result = fread(buffer2T+HeaderSize, 1, filesize, pFiBody); //this is normally buffer2T
+			//plain file data after the header, this is the only copy of the file
+			if (filesize > 0) memcpy(pbyPayload + HeaderSize, pbyFile, filesize);
 		}
 
-		//if (result != filesize) { fputs("Reading error", stderr); exit(3); } //does it need error checking? NO - this could leak memory by not deleting the buffer arrays
+		pbySrc = pbyPayload;
+	}
+	else {
+		//No header and no compression, send straight from the mapped file
+		pbySrc = pbyFile;
+	}
 
-		fclose(pFiBody); //close file
-		filesize = filesize + HeaderSize; //add header if it's non-zero
+	filesize = filesize + HeaderSize; //add header if it's non-zero
 //=============================================================================================================================
-		//RS encoding can go here, with header added first  DM
-		//Only execute this if ECCmode is > 3
-
-		if (ECCmode > 3) {
-
-			//Put RS coding routine here - Daz Man 2021
-			//Compressed or uncompressed data (+header) is in buffer2T
-			//RS encode the data from buffer2T and put it in buffer1T
-			//Then read out buffer1T to the sending routine next
-			//or read out buffer2T if RS is not used
-
-			//RS encode here
-			//filesize = filesize + HeaderSize; //add size of new header in - already done now...
-			int lasterror = 0;
-			if (ECCmode == 4) {
-				//RS1
-				lasterror = rs1encode(buffer2T, buffer1T, filesize); //
-				filesize = ceil((float)filesize / 224) * 255; //allow for bigger data size
-			}
-			else if (ECCmode == 5) {
-				//RS2
-				lasterror = rs2encode(buffer2T, buffer1T, filesize); //
-				filesize = ceil((float)filesize / 192) * 255; //allow for bigger data size
-			}
-			else if (ECCmode == 6) {
-				//RS3
-				lasterror = rs3encode(buffer2T, buffer1T, filesize); //
-				filesize = ceil((float)filesize / 160) * 255; //allow for bigger data size
-			}
-			else if (ECCmode == 7) {
-				//RS4
-				lasterror = rs4encode(buffer2T, buffer1T, filesize); //
-				filesize = ceil((float)filesize / 128) * 255; //allow for bigger data size
-			}
-
-			//compute the data exactly for the transmission, but don't let the RS decoder decode junk
-			//make sure the number of RS blocks to be decoded is the same as what was encoded
-			//RS Data Interleaver
-			//it is critical that the same filesize be used for interleaving and deinterleaving
-			constexpr bool rev = 0;
-			distribute(buffer1T, buffer2T, filesize, rev); //output is put back into buffer2T
+	//RS encoding can go here, with header added first  DM
+	//Only execute this if ECCmode is > 3
+
+	if (iECCmode > 3) {
+		//RS encode the payload into a temporary buffer, then interleave it straight into the final packed object buffer
+		int datalen = 224; //RS1
+		if (iECCmode == 5) datalen = 192; //RS2
+		else if (iECCmode == 6) datalen = 160; //RS3
+		else if (iECCmode == 7) datalen = 128; //RS4
+		const uLongf rssize = ((filesize + datalen - 1) / datalen) * 255; //allow for bigger data size
+		_BYTE* pbyRS = new _BYTE[rssize];
+#if TXPREP_TIMING
+		iPeakBytes += rssize;
+#endif
+
+		int lasterror = 0;
+		if (iECCmode == 4) {
+			lasterror = rs1encode(pbyPayload, pbyRS, filesize); //RS1
 		}
+		else if (iECCmode == 5) {
+			lasterror = rs2encode(pbyPayload, pbyRS, filesize); //RS2
+		}
+		else if (iECCmode == 6) {
+			lasterror = rs3encode(pbyPayload, pbyRS, filesize); //RS3
+		}
+		else if (iECCmode == 7) {
+			lasterror = rs4encode(pbyPayload, pbyRS, filesize); //RS4
+		}
+		filesize = rssize;
 
-		//data should be in buffer 2 now
+		//compute the data exactly for the transmission, but don't let the RS decoder decode junk
+		//make sure the number of RS blocks to be decoded is the same as what was encoded
+		//RS Data Interleaver
+		//it is critical that the same filesize be used for interleaving and deinterleaving
+		constexpr bool rev = 0;
+		vecbyObject.Init(filesize);
+		distribute(pbyRS, &vecbyObject[0], filesize, rev); //output is the final object buffer
 
-//=============================================================================================================================
-//		FILE* pFiBody = fopen(strFileName.c_str(), "rb"); //Open file - Now we read from buffer only - OLD CODE DM
+		delete[] pbyRS;
+	}
+	else {
+		vecbyObject.Init(filesize);
+		if (filesize > 0) memcpy(&vecbyObject[0], pbySrc, filesize);
+	}
 
-		//Add code to truncate filename if it's longer than 79 characters - this is already done later - but it needs to be more elegant, so it doesn't cut the extensions off... TODO DM
+	//release the payload buffer and the file mapping DM
+	if (pbyPayload != NULL) delete[] pbyPayload;
+	if (pbyFile != NULL) UnmapViewOfFile(pbyFile);
+	if (hMap != NULL) CloseHandle(hMap);
+	CloseHandle(hFile);
 
-		if (vecMOTPicture.Size() == 0)
-		{
-			int i = 0, k = 0; //init DM
-			int actsize = 0;
-			for (i=0;i<the_startdelay;i++)
-			{
-				/* Enlarge vector storing the picture objects */
-				iOldNumObj = vecMOTPicture.Size();
-				vecMOTPicture.Enlarge(1);
-				vecMOTSegments.Enlarge(1);
-	
-				/* Store file name and format string */
-//				vecMOTPicture[iOldNumObj].strName = strFileNamenoDir; //edited DM
-				vecMOTPicture[iOldNumObj].strName = strFileNamenoDirX; //use updated filename instead, in case it needs a .gz extension
-				vecMOTPicture[iOldNumObj].strNameandDir = strFileName;
-	
-				/* Fill body data with content of selected file */
-				vecMOTPicture[iOldNumObj].vecbRawData.Init(0);
-				vecMOTSegments[iOldNumObj].Init(the_startdelay);
-				vecMOTPicture[iOldNumObj].bIsLeader = (i == 0); //mark as leader if i == 0 DM
-				for (k=0;k<the_startdelay;k++)
-					vecMOTSegments[iOldNumObj][k] = k;
-	
-				dd = 0;
-				//During Lead-In only
-				//If no RS coding is used, read from buffer2T
-				//If RS coding is used, read from buffer1T but write the new header first
-				if (ECCmode > 3) {
-					while (dd < filesize)  //Read from buffer up to data size This is a read for the leadin - not all of it is used
-					{
-						/* Add one byte = SIZEOF__BYTE bits */
-						vecMOTPicture[iOldNumObj].vecbRawData.Enlarge(SIZEOF__BYTE);
-						vecMOTPicture[iOldNumObj].vecbRawData.Enqueue((uint32_t)buffer2T[dd], SIZEOF__BYTE); //from new buffer2T
-//						vecMOTPicture[iOldNumObj].vecbRawData.Enqueue((uint32_t)buffer1T[dd], SIZEOF__BYTE); //from new buffer1T
-						dd++; //next
-					}
-				}
-				else {
-					while (dd < filesize)  //Read from buffer up to data size - This is a read for the leadin - not all of it is used
-					{
-					/* Add one byte = SIZEOF__BYTE bits */
-						vecMOTPicture[iOldNumObj].vecbRawData.Enlarge(SIZEOF__BYTE);
-						vecMOTPicture[iOldNumObj].vecbRawData.Enqueue((uint32_t)buffer2T[dd], SIZEOF__BYTE); //from new buffer2T
-						dd++; //next
-					}
-				}
-
-				actsize += iSegmentSize;
-				actsize += vecMOTPicture[iOldNumObj].vecbRawData.Size() / SIZEOF__BYTE;
-				if (actsize >= iSegmentSize*the_startdelay) i = the_startdelay;
-			}
-		}
+	//data is in vecbyObject now, one byte per byte (packed)
 
-		/* Enlarge vector storing the picture objects */
-		iOldNumObj = vecMOTPicture.Size();
-		vecMOTPicture.Enlarge(1);
-		vecMOTSegments.Enlarge(1);
-
-		/* Store file name and format string */
-//		vecMOTPicture[iOldNumObj].strName = strFileNamenoDir;
-		vecMOTPicture[iOldNumObj].strName = strFileNamenoDirX; //use updated filename DM
-		vecMOTPicture[iOldNumObj].strNameandDir = strFileName;
-
-		/* Fill body data with content of selected file */
-		const int vecsegsize = vecsToSend.Size();
-		vecMOTPicture[iOldNumObj].vecbRawData.Init(0);
-		vecMOTSegments[iOldNumObj].Init(vecsegsize);
-		for (int k=0;k<vecsegsize;k++)
-			vecMOTSegments[iOldNumObj][k] = vecsToSend[k];
-		vecMOTPicture[iOldNumObj].bIsLeader = FALSE;
-
-		dd = 0;
-		if (ECCmode > 3) {
-			//FOR RS CODING
-			while (dd < filesize)  //Read from buffer up to data size
-			{
-				/* Add one byte = SIZEOF__BYTE bits */
-				vecMOTPicture[iOldNumObj].vecbRawData.Enlarge(SIZEOF__BYTE);
-				vecMOTPicture[iOldNumObj].vecbRawData.Enqueue((uint32_t)buffer2T[dd], SIZEOF__BYTE); //from new buffer2T
-//				vecMOTPicture[iOldNumObj].vecbRawData.Enqueue((uint32_t)buffer1T[dd], SIZEOF__BYTE); //from new buffer1T
-				dd++; //next
-			}
-		}
-		else {
-			//NO RS CODING
-			while (dd < filesize)  //Read from buffer up to data size
-			{
-				/* Add one byte = SIZEOF__BYTE bits */
-				vecMOTPicture[iOldNumObj].vecbRawData.Enlarge(SIZEOF__BYTE);
-				vecMOTPicture[iOldNumObj].vecbRawData.Enqueue((uint32_t)buffer2T[dd], SIZEOF__BYTE); //from new buffer2T
-				dd++; //next
-			}
-		}
+#if TXPREP_TIMING
+	/* Log preparation time and the largest amount of buffer memory used */
+	QueryPerformanceCounter(&liStop);
+	iPeakBytes += vecbyObject.Size(); /* final buffer */
+	FILE* pFiLog = fopen("txprep.txt", "a+t");
+	if (pFiLog != NULL)
+	{
+		fprintf(pFiLog, "%s: %lu -> %lu bytes, %.2f ms, %lu kB peak\n", strFileNamenoDirX.c_str(),
+			(unsigned long) insize, (unsigned long) vecbyObject.Size(),
+			(_REAL) (liStop.QuadPart - liStart.QuadPart) * 1000 / liFreq.QuadPart,
+			(unsigned long) (iPeakBytes / 1024));
+		fclose(pFiLog);
+	}
+#endif
+
+	return TRUE;
+}
+
+void CMOTSlideShowEncoder::AddFileName(const string& strFileName, const string& strFileNamenoDir, CVector<short>  vecsToSend)
+{
+	/* Only ContentSubType "JFIF" (JPEG) and ContentSubType "PNG" are allowed
+	   for SlideShow application (not tested here!) */
+	/* For HamDRM this doesn't matter - any file works! DM */
+
+	int				iOldNumObj = 0; //init DM
+	CVector<_BYTE>	vecbyObject; //final packed object data
+	string			strFileNamenoDirX; //the filename that is sent, with the .lz extension if compressed
 
-		//remove the buffer arrays from the heap DM
-		delete[] buffer1T;
-		delete[] buffer2T;
+	/* Use the prepared object if the background thread already made it,
+	   otherwise prepare it now and keep it for the next send */
+	if (TxPrepCache.Get(strFileName, strFileNamenoDir, ECCmode, vecbyObject, strFileNamenoDirX) == FALSE)
+	{
+		if (PrepareTxObject(strFileName, strFileNamenoDir, ECCmode, vecbyObject, strFileNamenoDirX) == FALSE)
+			return;
+
+		TxPrepCache.Put(strFileName, strFileNamenoDir, ECCmode, vecbyObject, strFileNamenoDirX);
+	}
+
+//=============================================================================================================================
+	//Add code to truncate filename if it's longer than 79 characters - this is already done later - but it needs to be more elegant, so it doesn't cut the extensions off... TODO DM
+
+	if (vecMOTPicture.Size() == 0)
+	{
+		int i = 0, k = 0; //init DM
+		int actsize = 0;
+		for (i=0;i<the_startdelay;i++)
+		{
+			/* Enlarge vector storing the picture objects */
+			iOldNumObj = vecMOTPicture.Size();
+			vecMOTPicture.Enlarge(1);
+			vecMOTSegments.Enlarge(1);
+
+			/* Store file name and format string */
+			vecMOTPicture[iOldNumObj].strName = strFileNamenoDirX; //use updated filename instead, in case it needs a .gz extension
+			vecMOTPicture[iOldNumObj].strNameandDir = strFileName;
+
+			/* Fill body data with content of selected file (Lead-In) */
+			vecMOTPicture[iOldNumObj].vecbRawData.Init(vecbyObject.Size());
+			vecMOTPicture[iOldNumObj].vecbRawData = vecbyObject;
+			vecMOTSegments[iOldNumObj].Init(the_startdelay);
+			vecMOTPicture[iOldNumObj].bIsLeader = (i == 0); //mark as leader if i == 0 DM
+			for (k=0;k<the_startdelay;k++)
+				vecMOTSegments[iOldNumObj][k] = k;
+
+			actsize += iSegmentSize;
+			actsize += vecMOTPicture[iOldNumObj].vecbRawData.Size();
+			if (actsize >= iSegmentSize*the_startdelay) i = the_startdelay;
+		}
 	}
+
+	/* Enlarge vector storing the picture objects */
+	iOldNumObj = vecMOTPicture.Size();
+	vecMOTPicture.Enlarge(1);
+	vecMOTSegments.Enlarge(1);
+
+	/* Store file name and format string */
+	vecMOTPicture[iOldNumObj].strName = strFileNamenoDirX; //use updated filename DM
+	vecMOTPicture[iOldNumObj].strNameandDir = strFileName;
+
+	/* Fill body data with content of selected file */
+	const int vecsegsize = vecsToSend.Size();
+	vecMOTPicture[iOldNumObj].vecbRawData.Init(vecbyObject.Size());
+	vecMOTPicture[iOldNumObj].vecbRawData = vecbyObject;
+	vecMOTSegments[iOldNumObj].Init(vecsegsize);
+	for (int k=0;k<vecsegsize;k++)
+		vecMOTSegments[iOldNumObj][k] = vecsToSend[k];
+	vecMOTPicture[iOldNumObj].bIsLeader = FALSE;
 }
 
 void CMOTSlideShowEncoder::SetMyStartDelay(int delay)
@@ -379,29 +433,43 @@ void CMOTSlideShowDecoder::AddDataUnit(CVector<_BINARY>& vecbiNewData)
 	   this new data group */
 	if (MOTDAB.AddDataGroup(vecbiNewData) == TRUE)
 	{
+#if USE_MODUL_STATS
+		/* Cost of the handover per completed object, the size in bytes */
+		static CModulStat* pHandoverStat = ModulStats.Register("CMOTObject");
+		const std::chrono::steady_clock::time_point Start = std::chrono::steady_clock::now();
+#endif
+
 		/* Get new received SlideShow picture */
 		MOTDAB.GetMOTObject(MOTPicture);
 		bNewPicture = TRUE; /* Set flag for new picture */
+
+#if USE_MODUL_STATS
+		pHandoverStat->Add(std::chrono::duration_cast<std::chrono::nanoseconds>(
+			std::chrono::steady_clock::now() - Start).count(),
+			MOTPicture.vecbRawData.Size(), 0, -1);
+#endif
+
+		/* A request for missing segments is also saved by GetFileRX() */
+		if (MOTPicture.strName == "bsr.bin")
+			EventQueue.Post(EV_BSR_RX, MOTPicture.iTransportID);
+		else
+			EventQueue.Post(EV_FILE_RX, MOTPicture.iTransportID);
 	}
 }
 
 _BOOLEAN CMOTSlideShowDecoder::GetPicture(CMOTObject& NewPic)
 {
-	const int iRawDataSize = MOTPicture.vecbRawData.Size();
-
 	/* Init output object */
 	NewPic.Reset();
 
-	/* Only copy picture content if picture is available */
-	if (iRawDataSize != 0)
-	{
-		NewPic = MOTPicture;
-	}
-
-	/* Check if this is an old or a new picture and return result */
+	/* Check if this is an old or a new picture and return result. A new
+	   picture is moved to the caller, it is only read once */
 	_BOOLEAN bWasNewPicture = FALSE;
 	if (bNewPicture == TRUE)
 	{
+		NewPic = std::move(MOTPicture);
+		MOTPicture.Reset();
+
 		bNewPicture = FALSE;
 		bWasNewPicture = TRUE;
 	}
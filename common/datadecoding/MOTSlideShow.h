@@ -36,6 +36,27 @@
 #include "DABMOT.h"
 
 
+/* Definitions ****************************************************************/
+/* Largest file which is sent. After RS coding it must still fit the receive
+   buffer */
+#define TXPREP_MAX_FILE_SIZE		524288
+
+/* Zeroed space after the payload, the RS encoders read whole data blocks */
+#define TXPREP_PAD					256
+
+/* Set to TRUE to log the preparation time and buffer memory of each file to
+   "txprep.txt" */
+#define TXPREP_TIMING				FALSE
+
+/* LZMA dictionary size limits and the input size from which two match finder
+   threads are used */
+#define LZMA_MIN_DICT				(1 << 12)
+#define LZMA_MAX_DICT				(1 << 25)
+#define LZMA_MT_SIZE				65536
+
+/* Trade compression ratio for preparation time (settings "LZMA_Fast") */
+extern int LzmaFastMode;
+
 
 /* Classes ********************************************************************/
 /* Encoder ------------------------------------------------------------------ */
@@ -72,6 +93,10 @@ protected:
 	int					iPictureCnt;
 	int					the_startdelay;
 	int					iSegmentSize;
+
+	/* Last progress which was posted as event */
+	int					iLastPicCnt;
+	int					iLastPicPerc;
 };
 
 
@@ -85,6 +110,7 @@ public:
 	void AddDataUnit(CVector<_BINARY>& vecbiNewData);
 	_BOOLEAN GetPicture(CMOTObject& NewPic);
 	_BOOLEAN GetPartPicture(CMOTObject& NewPic);
+	_BOOLEAN HasPartPicture() {return MOTDAB.HasActMOTObject();}
 	_BOOLEAN GetActSegments(CVector<_BINARY>& NewSeg);
 	_BOOLEAN GetPartBSR(int * iNumSeg, string * bsrname, char * path);
 
@@ -92,6 +118,8 @@ public:
 	unsigned int GetActSize(void) { return MOTDAB.GetObjectActSize(); };
 	unsigned int GetActPos(void)  { return MOTDAB.GetObjectActPos(); };
 
+	void SetCallsign(const string& strNewCall) { MOTDAB.SetCallsign(strNewCall); };
+
 
 protected:
 	_BOOLEAN	bNewPicture;
@@ -99,5 +127,8 @@ protected:
 	CMOTDABDec	MOTDAB;
 };
 
+void LzmaParams(const unsigned long insize, const int iFastMode, int& level, unsigned int& dictSize, int& fb, int& numThreads);
+_BOOLEAN PrepareTxObject(const string& strFileName, const string& strFileNamenoDir, const int iECCmode,
+						 CVector<_BYTE>& vecbyObject, string& strFileNamenoDirX);
 
 #endif // !defined(MOTSLIDESHOW_H__3B0UBVE98732KJVEW363LIHGEW982__INCLUDED_)
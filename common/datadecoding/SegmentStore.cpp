@@ -0,0 +1,405 @@
+/******************************************************************************\
+ * Copyright (c) 2024
+ *
+ * Author(s):
+ *	EasyDRF developers
+ *
+ * Description:
+ *	Persistent, memory-mapped store for partially received MOT objects
+ *
+ *	File layout: SStoreHdr (with the presence bitmap) followed by the
+ *	segment data area. Segment n is written at offset
+ *	sizeof(SStoreHdr) + n * iSegmentSize, the file grows on demand
+ *
+ ******************************************************************************
+ *
+ * This program is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation; either version 2 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ *
+\******************************************************************************/
+
+#include "SegmentStore.h"
+#include "../CRC.h"
+
+
+/* Implementation *************************************************************/
+CSegmentStore::CSegmentStore() : strCall("unknown"), iCurTransportID(-1),
+	iCurSegSize(0), hFile(INVALID_HANDLE_VALUE), hMap(NULL), hMutex(NULL),
+	pbyView(NULL), pHdr(NULL), dwMapSize(0), bPruned(FALSE), iKnownSegments(0)
+{
+}
+
+void CSegmentStore::SetCallsign(const string& strNewCall)
+{
+	/* Only use characters which are safe in a file name. The FAC label is
+	   zero terminated inside the string, stop there */
+	string strSafe = "";
+	for (size_t i = 0; (i < strNewCall.length()) && (strSafe.length() < 15); i++)
+	{
+		const char c = strNewCall[i];
+		if (c == 0)
+			break;
+		if (((c >= '0') && (c <= '9')) || ((c >= 'A') && (c <= 'Z')) ||
+			((c >= 'a') && (c <= 'z')) || (c == '-'))
+		{
+			strSafe += c;
+		}
+	}
+
+	if (strSafe.length() > 0)
+		strCall = strSafe;
+}
+
+_BOOLEAN CSegmentStore::Open(const int iTransportID, const int iSegmentSize, const int iRSLevel,
+							 const _BYTE* pbyHeader, const int iHeaderLen)
+{
+	char	chFileName[MAX_PATH];
+	CCRC	CRCObject;
+	int		i;
+
+	if ((iSegmentSize <= 0) || (iTransportID <= 2 /* bsr.bin */) ||
+		(iHeaderLen < 4) || (iHeaderLen > SEGSTORE_MAX_HEADER))
+	{
+		return FALSE;
+	}
+
+	/* Already open? */
+	if ((pHdr != NULL) && (iCurTransportID == iTransportID) && (iCurSegSize == iSegmentSize))
+		return FALSE;
+
+	Close();
+
+	if (bPruned == FALSE)
+	{
+		/* Only once per program run, this scans the directory, the object files
+		   themselves are not read */
+		Prune();
+		bPruned = TRUE;
+	}
+
+	CreateDirectory(SEGSTORE_DIR, NULL);
+
+	/* "File hash": segment size and RS level, together with the transport ID
+	   (which already contains the name hash and the mode hash) this
+	   identifies the transmission */
+	const unsigned int iHash = ((unsigned int) iSegmentSize << 3) | ((unsigned int) iRSLevel & 7);
+
+	/* Content: the BodySize field (first 28 bits of the MOT header) and a
+	   CRC of the whole header, which also contains the name */
+	const unsigned int iBodySize = ((unsigned int) pbyHeader[0] << 20) |
+		((unsigned int) pbyHeader[1] << 12) | ((unsigned int) pbyHeader[2] << 4) |
+		((unsigned int) pbyHeader[3] >> 4);
+
+	CRCObject.Reset(16);
+	for (i = 0; i < iHeaderLen; i++)
+		CRCObject.AddByte(pbyHeader[i]);
+	const unsigned int iHeaderCRC = CRCObject.GetCRC() & 0xFFFF;
+
+	wsprintf(chFileName, "%s\\%s_%05d_%04x_%07x_%04x.seg", SEGSTORE_DIR, strCall.c_str(),
+		iTransportID, iHash, iBodySize, iHeaderCRC);
+	strFileName = chFileName;
+
+	/* Other decoders may have the file open at the same time. Deleting is
+	   shared as well, a decoder which has saved the object removes the file
+	   while the others still use it */
+	hFile = CreateFile(chFileName, GENERIC_READ | GENERIC_WRITE,
+		FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+		NULL, OPEN_ALWAYS, FILE_ATTRIBUTE_NORMAL, NULL);
+	if (hFile == INVALID_HANDLE_VALUE)
+		return FALSE;
+
+	/* Named after the object, a backslash is not allowed in the name */
+	wsprintf(chFileName, "Local\\EasyDRF_seg_%s_%05d_%04x_%07x_%04x", strCall.c_str(),
+		iTransportID, iHash, iBodySize, iHeaderCRC);
+	hMutex = CreateMutex(NULL, FALSE, chFileName);
+
+	Lock();
+
+	DWORD dwFileSize = GetFileSize(hFile, NULL);
+	if (dwFileSize < sizeof(SStoreHdr))
+		dwFileSize = sizeof(SStoreHdr) + SEGSTORE_GROW_SEGS * iSegmentSize;
+
+	if (Map(dwFileSize) == FALSE)
+	{
+		Unlock();
+		Close();
+		return FALSE;
+	}
+
+	iCurTransportID = iTransportID;
+	iCurSegSize = iSegmentSize;
+
+	/* New (or unusable) file, init header. This is only decided from the
+	   header under the mutex: whether the file existed when it was opened
+	   says nothing, another decoder may have created and filled it since */
+	_BOOLEAN bMerge = FALSE;
+	if ((memcmp(pHdr->chMagic, SEGSTORE_MAGIC, 8) != 0) ||
+		(pHdr->iSegmentSize != iSegmentSize) || (pHdr->iTransportID != iTransportID) ||
+		(pHdr->iHeaderLen != iHeaderLen) || (memcmp(pHdr->byHeader, pbyHeader, iHeaderLen) != 0))
+	{
+		memset(pHdr, 0, sizeof(SStoreHdr));
+		memcpy(pHdr->chMagic, SEGSTORE_MAGIC, 8);
+		pHdr->iTransportID = iTransportID;
+		pHdr->iSegmentSize = iSegmentSize;
+		pHdr->iRSLevel = iRSLevel;
+		pHdr->iTotSegments = -1;
+		strncpy(pHdr->chCall, strCall.c_str(), sizeof(pHdr->chCall) - 1);
+		memcpy(pHdr->byHeader, pbyHeader, iHeaderLen);
+		pHdr->iHeaderLen = iHeaderLen;
+	}
+	else
+		bMerge = (pHdr->iNumSegments > 0);
+
+	/* The caller merges everything which is in the file now */
+	iKnownSegments = pHdr->iNumSegments;
+
+	Unlock();
+
+	return bMerge;
+}
+
+void CSegmentStore::Close()
+{
+	Unmap();
+
+	if (hFile != INVALID_HANDLE_VALUE)
+	{
+		CloseHandle(hFile);
+		hFile = INVALID_HANDLE_VALUE;
+	}
+
+	if (hMutex != NULL)
+	{
+		CloseHandle(hMutex);
+		hMutex = NULL;
+	}
+
+	iCurTransportID = -1;
+	iCurSegSize = 0;
+	iKnownSegments = 0;
+}
+
+void CSegmentStore::Remove(const int iTransportID)
+{
+	/* Object was completely received (or saved after RS decoding), the
+	   partial data is not needed anymore */
+	if ((pHdr == NULL) || (iCurTransportID != iTransportID))
+		return;
+
+	Close();
+	DeleteFile(strFileName.c_str());
+}
+
+_BOOLEAN CSegmentStore::Map(const DWORD dwNewSize)
+{
+	Unmap();
+
+	/* Mapping a size larger than the file enlarges the file */
+	hMap = CreateFileMapping(hFile, NULL, PAGE_READWRITE, 0, dwNewSize, NULL);
+	if (hMap == NULL)
+		return FALSE;
+
+	pbyView = (_BYTE*) MapViewOfFile(hMap, FILE_MAP_ALL_ACCESS, 0, 0, dwNewSize);
+	if (pbyView == NULL)
+	{
+		CloseHandle(hMap);
+		hMap = NULL;
+		return FALSE;
+	}
+
+	pHdr = (SStoreHdr*) pbyView;
+	dwMapSize = dwNewSize;
+
+	return TRUE;
+}
+
+_BOOLEAN CSegmentStore::Remap(const DWORD dwNeeded)
+{
+	/* Must be called with the mutex held. Another decoder may have enlarged
+	   the file already */
+	if (dwNeeded <= dwMapSize)
+		return TRUE;
+
+	const DWORD dwFileSize = GetFileSize(hFile, NULL);
+	DWORD dwNewSize = max(dwNeeded, dwFileSize);
+	if (dwNewSize > dwFileSize)
+		dwNewSize = max(dwNewSize, dwMapSize + SEGSTORE_GROW_SEGS * iCurSegSize);
+
+	return Map(dwNewSize);
+}
+
+_BOOLEAN CSegmentStore::Refresh()
+{
+	if (pHdr == NULL)
+		return FALSE;
+
+	Lock();
+
+	const int iNumSegments = pHdr->iNumSegments;
+	const _BOOLEAN bNew = (iNumSegments != iKnownSegments);
+
+	/* Segments of other decoders may lie beyond the mapped area */
+	if ((bNew == TRUE) && (Remap(GetFileSize(hFile, NULL)) == FALSE))
+	{
+		Unlock();
+		Close();
+		return FALSE;
+	}
+
+	iKnownSegments = iNumSegments;
+
+	Unlock();
+
+	return bNew;
+}
+
+void CSegmentStore::Unmap()
+{
+	if (pbyView != NULL)
+	{
+		UnmapViewOfFile(pbyView);
+		pbyView = NULL;
+	}
+	if (hMap != NULL)
+	{
+		CloseHandle(hMap);
+		hMap = NULL;
+	}
+
+	pHdr = NULL;
+	dwMapSize = 0;
+}
+
+_BYTE* CSegmentStore::SegPtr(const int iSegNum)
+{
+	return pbyView + sizeof(SStoreHdr) + (size_t) iSegNum * iCurSegSize;
+}
+
+void CSegmentStore::PutSegment(const int iSegNum, const _BYTE* pbyData, const int iLen, const _BOOLEAN bLast)
+{
+	if ((pHdr == NULL) || (iSegNum < 0) || (iSegNum >= SEGSTORE_MAX_SEGS) ||
+		(iLen <= 0) || (iLen > iCurSegSize))
+	{
+		return;
+	}
+
+	Lock();
+
+	/* Append-only: a segment which is already present (maybe written by
+	   another decoder) is never rewritten */
+	if (HasSegment(iSegNum) == TRUE)
+	{
+		Unlock();
+		return;
+	}
+
+	/* Enlarge file if the segment is beyond the mapped area */
+	if (Remap((DWORD) (sizeof(SStoreHdr) + (size_t) (iSegNum + 1) * iCurSegSize)) == FALSE)
+	{
+		Unlock();
+		Close();
+		return;
+	}
+
+	/* Data first, then the presence bit */
+	memcpy(SegPtr(iSegNum), pbyData, iLen);
+
+	if (bLast == TRUE)
+	{
+		pHdr->iTotSegments = iSegNum + 1;
+		pHdr->iLastSegSize = iLen;
+	}
+
+	pHdr->byPresent[iSegNum >> 3] |= 1 << (iSegNum & 7);
+
+	/* Only segments of other decoders are reported by "Refresh()" */
+	if (pHdr->iNumSegments == iKnownSegments)
+		iKnownSegments++;
+	pHdr->iNumSegments++;
+
+	Unlock();
+}
+
+_BOOLEAN CSegmentStore::HasSegment(const int iSegNum)
+{
+	if ((pHdr == NULL) || (iSegNum < 0) || (iSegNum >= SEGSTORE_MAX_SEGS))
+		return FALSE;
+
+	return ((pHdr->byPresent[iSegNum >> 3] >> (iSegNum & 7)) & 1) == 1;
+}
+
+int CSegmentStore::GetSegment(const int iSegNum, _BYTE* pbyData)
+{
+	if (HasSegment(iSegNum) == FALSE)
+		return 0;
+
+	int iLen = iCurSegSize;
+	if ((pHdr->iTotSegments > 0) && (iSegNum == pHdr->iTotSegments - 1))
+		iLen = pHdr->iLastSegSize;
+
+	memcpy(pbyData, SegPtr(iSegNum), iLen);
+
+	return iLen;
+}
+
+int CSegmentStore::GetNumSlots()
+{
+	if (pHdr == NULL)
+		return 0;
+
+	/* Number of segments which fit in the currently mapped file */
+	return min((int) ((dwMapSize - sizeof(SStoreHdr)) / iCurSegSize), SEGSTORE_MAX_SEGS);
+}
+
+int CSegmentStore::GetTotSegments()
+{
+	if (pHdr == NULL)
+		return -1;
+
+	return pHdr->iTotSegments;
+}
+
+void CSegmentStore::Prune()
+{
+	WIN32_FIND_DATA	FindData;
+	char			chPath[MAX_PATH];
+	FILETIME		ftNow;
+	ULARGE_INTEGER	ulNow, ulFile;
+
+	GetSystemTimeAsFileTime(&ftNow);
+	ulNow.LowPart = ftNow.dwLowDateTime;
+	ulNow.HighPart = ftNow.dwHighDateTime;
+
+	/* FILETIME is in 100 ns units */
+	const ULONGLONG ullMaxAge = (ULONGLONG) SEGSTORE_MAX_AGE_DAYS * 24 * 3600 * 10000000;
+
+	HANDLE hFind = FindFirstFile(SEGSTORE_DIR "\\*.seg", &FindData);
+	if (hFind == INVALID_HANDLE_VALUE)
+		return;
+
+	do
+	{
+		ulFile.LowPart = FindData.ftLastWriteTime.dwLowDateTime;
+		ulFile.HighPart = FindData.ftLastWriteTime.dwHighDateTime;
+
+		if (ulNow.QuadPart - ulFile.QuadPart > ullMaxAge)
+		{
+			wsprintf(chPath, "%s\\%s", SEGSTORE_DIR, FindData.cFileName);
+			DeleteFile(chPath);
+		}
+	}
+	while (FindNextFile(hFind, &FindData));
+
+	FindClose(hFind);
+}
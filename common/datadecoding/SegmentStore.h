@@ -0,0 +1,139 @@
+/******************************************************************************\
+ * Copyright (c) 2024
+ *
+ * Author(s):
+ *	EasyDRF developers
+ *
+ * Description:
+ *	See SegmentStore.cpp
+ *
+ ******************************************************************************
+ *
+ * This program is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation; either version 2 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ *
+\******************************************************************************/
+
+#if !defined(SEGMENTSTORE_H__3B0UBVE98732KJVEW363E7A0D31912__INCLUDED_)
+#define SEGMENTSTORE_H__3B0UBVE98732KJVEW363E7A0D31912__INCLUDED_
+
+#include <windows.h>
+#include "../GlobalDefinitions.h"
+
+
+/* Definitions ****************************************************************/
+#define SEGSTORE_DIR				"Rx Cache"
+#define SEGSTORE_MAGIC				"EZSEGST2"
+
+/* Segment number is a 15 bit field in the MOT session header */
+#define SEGSTORE_MAX_SEGS			32768
+#define SEGSTORE_MAX_HEADER			256
+
+/* Number of segments the mapped file grows by when it has to be enlarged */
+#define SEGSTORE_GROW_SEGS			64
+
+/* Object files which were not touched for this many days are deleted */
+#define SEGSTORE_MAX_AGE_DAYS		7
+
+
+/* Classes ********************************************************************/
+/* On-disk store of partially received MOT objects. Each object lives in its
+   own memory-mapped file, keyed by callsign, transport ID, a hash of the
+   segment size and RS level and the content of the object: its body size and
+   a CRC of its MOT header. The transport ID only depends on the file name, a
+   changed file which is sent again under the same name gets a new file here
+   and is never merged with the old one. Good segments are written once at their offset
+   and marked in a presence bitmap, so reception can be resumed after pool
+   eviction, further transmissions, BSR rounds or a program restart. Files are
+   only opened when their transport ID is heard, nothing is read at startup.
+
+   Several decoders (receivers of this program or other instances of it which
+   hear the same transmission) open the same file, all writes are done under
+   a named mutex. Each decoder publishes its good segments there and picks up
+   the ones it missed itself with "Refresh()", so the object is complete as
+   soon as the union of all receptions is */
+class CSegmentStore
+{
+public:
+	CSegmentStore();
+	virtual ~CSegmentStore() {Close();}
+
+	void SetCallsign(const string& strNewCall);
+	const string& GetCallsign() {return strCall;}
+
+	/* Returns TRUE if an existing object file with stored segments was
+	   opened, i.e. the caller should merge the stored segments. The MOT
+	   header of the object must be known, it identifies the content */
+	_BOOLEAN Open(const int iTransportID, const int iSegmentSize, const int iRSLevel,
+				  const _BYTE* pbyHeader, const int iHeaderLen);
+	void Close();
+	void Remove(const int iTransportID);
+
+	_BOOLEAN IsOpen(const int iTransportID) {return (pHdr != NULL) && (iCurTransportID == iTransportID);}
+
+	/* Returns TRUE if other decoders have added segments since the last
+	   call, i.e. the caller should merge the stored segments */
+	_BOOLEAN Refresh();
+
+	void PutSegment(const int iSegNum, const _BYTE* pbyData, const int iLen, const _BOOLEAN bLast);
+
+	_BOOLEAN HasSegment(const int iSegNum);
+	int GetSegment(const int iSegNum, _BYTE* pbyData);
+	int GetSegmentSize() {return iCurSegSize;}
+	int GetNumSlots();
+	int GetTotSegments();
+
+protected:
+	struct SStoreHdr
+	{
+		char	chMagic[8];
+		int		iTransportID;
+		int		iSegmentSize;
+		int		iRSLevel;
+		int		iTotSegments; /* -1 if last segment was not received yet */
+		int		iLastSegSize;
+		int		iNumSegments; /* Number of segments present */
+		int		iHeaderLen;
+		char	chCall[16];
+		_BYTE	byHeader[SEGSTORE_MAX_HEADER];
+		_BYTE	byPresent[SEGSTORE_MAX_SEGS / SIZEOF__BYTE];
+	};
+
+	_BOOLEAN	Map(const DWORD dwNewSize);
+	_BOOLEAN	Remap(const DWORD dwNeeded);
+	void		Unmap();
+	void		Lock() {if (hMutex != NULL) WaitForSingleObject(hMutex, INFINITE);}
+	void		Unlock() {if (hMutex != NULL) ReleaseMutex(hMutex);}
+	_BYTE*		SegPtr(const int iSegNum);
+	void		Prune();
+
+	string		strCall;
+	string		strFileName;
+	int			iCurTransportID;
+	int			iCurSegSize;
+
+	HANDLE		hFile;
+	HANDLE		hMap;
+	HANDLE		hMutex;
+	_BYTE*		pbyView;
+	SStoreHdr*	pHdr;
+	DWORD		dwMapSize;
+	_BOOLEAN	bPruned;
+
+	/* Segments which the decoder already knows about */
+	int			iKnownSegments;
+};
+
+
+#endif // !defined(SEGMENTSTORE_H__3B0UBVE98732KJVEW363E7A0D31912__INCLUDED_)
@@ -0,0 +1,239 @@
+/******************************************************************************\
+ * Copyright (c) 2024
+ *
+ * Author(s):
+ *	EasyDRF developers
+ *
+ * Description:
+ *	Background preparation and cache of transmit objects
+ *
+ *	The files in the transmit list are compressed, RS encoded and
+ *	interleaved by a worker thread while the current file is sent. Since the
+ *	segments are sliced from the packed object when the data groups are
+ *	generated, the packed object is all that needs to be kept
+ *
+ ******************************************************************************
+ *
+ * This program is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation; either version 2 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ *
+\******************************************************************************/
+
+#include "TxPrepCache.h"
+#include "MOTSlideShow.h"
+
+
+CTxPrepCache TxPrepCache;
+
+
+/* Implementation *************************************************************/
+_BOOLEAN CTxPrepCache::CKey::Set(const string& strNewFileName, const string& strNewFileNamenoDir, const int iNewECCmode)
+{
+	WIN32_FILE_ATTRIBUTE_DATA FileData;
+
+	if (GetFileAttributesEx(strNewFileName.c_str(), GetFileExInfoStandard, &FileData) == 0)
+		return FALSE;
+
+	strFileName = strNewFileName;
+	strFileNamenoDir = strNewFileNamenoDir;
+	ftWrite = FileData.ftLastWriteTime;
+	iFileSize = FileData.nFileSizeLow;
+
+	/* Modes 1 to 3 only repeat the object, it is prepared the same way */
+	if (iNewECCmode > 3)
+		iECCmode = iNewECCmode;
+	else
+		iECCmode = 1;
+
+	return TRUE;
+}
+
+_BOOLEAN CTxPrepCache::CKey::operator==(const CKey& Key) const
+{
+	return (iECCmode == Key.iECCmode) && (iFileSize == Key.iFileSize) &&
+		(CompareFileTime(&ftWrite, &Key.ftWrite) == 0) &&
+		(strFileName == Key.strFileName) && (strFileNamenoDir == Key.strFileNamenoDir);
+}
+
+void CTxPrepCache::Request(const string& strFileName, const string& strFileNamenoDir, const int iECCmode)
+{
+	CKey Key;
+
+	if (Key.Set(strFileName, strFileNamenoDir, iECCmode) == FALSE)
+		return;
+
+	std::lock_guard<std::mutex> Lock(Mutex);
+
+	/* Already prepared or queued? */
+	if (Find(Key) != NULL)
+		return;
+	if ((bActJob == TRUE) && (ActJob == Key))
+		return;
+	for (std::list<CKey>::iterator it = Jobs.begin(); it != Jobs.end(); it++)
+	{
+		if (*it == Key)
+			return;
+	}
+
+	Jobs.push_back(Key);
+
+	/* The worker is only started when it is needed the first time */
+	if (bRunning == FALSE)
+	{
+		bStop = FALSE;
+		WorkerThread = std::thread(&CTxPrepCache::Worker, this);
+		bRunning = TRUE;
+	}
+
+	CondJob.notify_one();
+}
+
+_BOOLEAN CTxPrepCache::Get(const string& strFileName, const string& strFileNamenoDir, const int iECCmode,
+						   CVector<_BYTE>& vecbyObject, string& strFileNamenoDirX)
+{
+	CKey Key;
+
+	if (Key.Set(strFileName, strFileNamenoDir, iECCmode) == FALSE)
+		return FALSE;
+
+	std::unique_lock<std::mutex> Lock(Mutex);
+
+	/* Preparing it again here would only take longer */
+	while ((bActJob == TRUE) && (ActJob == Key))
+		CondDone.wait(Lock);
+
+	CEntry* pEntry = Find(Key);
+	if (pEntry == NULL)
+		return FALSE;
+
+	/* The assignment does not set the size of the vector */
+	vecbyObject.Init(pEntry->vecbyObject.Size());
+	vecbyObject = pEntry->vecbyObject;
+	strFileNamenoDirX = pEntry->strFileNamenoDirX;
+
+	return TRUE;
+}
+
+void CTxPrepCache::Put(const string& strFileName, const string& strFileNamenoDir, const int iECCmode,
+					   const CVector<_BYTE>& vecbyObject, const string& strFileNamenoDirX)
+{
+	CKey Key;
+
+	if (Key.Set(strFileName, strFileNamenoDir, iECCmode) == FALSE)
+		return;
+
+	std::lock_guard<std::mutex> Lock(Mutex);
+	Insert(Key, vecbyObject, strFileNamenoDirX);
+}
+
+void CTxPrepCache::Stop()
+{
+	{
+		std::lock_guard<std::mutex> Lock(Mutex);
+		bStop = TRUE;
+		Jobs.clear();
+		CondJob.notify_one();
+	}
+
+	if (WorkerThread.joinable())
+		WorkerThread.join();
+
+	bRunning = FALSE;
+}
+
+void CTxPrepCache::Worker()
+{
+	std::unique_lock<std::mutex> Lock(Mutex);
+
+	while (bStop == FALSE)
+	{
+		if (Jobs.empty())
+		{
+			CondJob.wait(Lock);
+			continue;
+		}
+
+		ActJob = Jobs.front();
+		Jobs.pop_front();
+
+		if (Find(ActJob) != NULL)
+			continue;
+
+		bActJob = TRUE;
+
+		/* Prepare without holding the lock, "ActJob" is not changed by
+		   anybody else while "bActJob" is set */
+		Lock.unlock();
+
+		CVector<_BYTE>	vecbyObject;
+		string			strFileNamenoDirX;
+		const _BOOLEAN bOK = PrepareTxObject(ActJob.strFileName, ActJob.strFileNamenoDir,
+			ActJob.iECCmode, vecbyObject, strFileNamenoDirX);
+
+		Lock.lock();
+
+		if (bOK == TRUE)
+			Insert(ActJob, vecbyObject, strFileNamenoDirX);
+
+		bActJob = FALSE;
+		CondDone.notify_all();
+	}
+}
+
+CTxPrepCache::CEntry* CTxPrepCache::Find(const CKey& Key)
+{
+	for (std::list<CEntry>::iterator it = Entries.begin(); it != Entries.end(); it++)
+	{
+		if (it->Key == Key)
+		{
+			/* Mark as most recently used */
+			Entries.splice(Entries.begin(), Entries, it);
+			return &Entries.front();
+		}
+	}
+
+	return NULL;
+}
+
+void CTxPrepCache::Insert(const CKey& Key, const CVector<_BYTE>& vecbyObject, const string& strFileNamenoDirX)
+{
+	/* Remove older versions of this file in this mode */
+	std::list<CEntry>::iterator it = Entries.begin();
+	while (it != Entries.end())
+	{
+		if ((it->Key.strFileName == Key.strFileName) &&
+			(it->Key.strFileNamenoDir == Key.strFileNamenoDir) &&
+			(it->Key.iECCmode == Key.iECCmode))
+		{
+			iCacheBytes -= it->vecbyObject.Size();
+			it = Entries.erase(it);
+		}
+		else
+			it++;
+	}
+
+	Entries.push_front(CEntry());
+	Entries.front().Key = Key;
+	Entries.front().vecbyObject.Init(vecbyObject.Size());
+	Entries.front().vecbyObject = vecbyObject;
+	Entries.front().strFileNamenoDirX = strFileNamenoDirX;
+	iCacheBytes += vecbyObject.Size();
+
+	/* Drop least recently used objects, but always keep the new one */
+	while ((iCacheBytes > TXPREP_CACHE_BUDGET) && (Entries.size() > 1))
+	{
+		iCacheBytes -= Entries.back().vecbyObject.Size();
+		Entries.pop_back();
+	}
+}
@@ -0,0 +1,116 @@
+/******************************************************************************\
+ * Copyright (c) 2024
+ *
+ * Author(s):
+ *	EasyDRF developers
+ *
+ * Description:
+ *	See TxPrepCache.cpp
+ *
+ ******************************************************************************
+ *
+ * This program is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation; either version 2 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ *
+\******************************************************************************/
+
+#if !defined(TXPREPCACHE_H__3B0UBVE98732KJVEW363LIHGEW982__INCLUDED_)
+#define TXPREPCACHE_H__3B0UBVE98732KJVEW363LIHGEW982__INCLUDED_
+
+#include <windows.h>
+#include <list>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include "../GlobalDefinitions.h"
+#include "../Vector.h"
+
+
+/* Definitions ****************************************************************/
+/* Memory used by prepared objects. Least recently used ones are dropped */
+#define TXPREP_CACHE_BUDGET			(32 * 1024 * 1024)
+
+
+/* Classes ********************************************************************/
+/* Prepared (compressed, RS encoded and interleaved) transmit objects, keyed by
+   file path, sent name, last write time, size and ECC mode. A worker thread
+   prepares queued files in the background while the current file is sent,
+   "AddFileName()" then only has to copy the finished object */
+class CTxPrepCache
+{
+public:
+	CTxPrepCache() : iCacheBytes(0), bActJob(FALSE), bRunning(FALSE), bStop(FALSE) {}
+	virtual ~CTxPrepCache() {Stop();}
+
+	/* Queue a file for background preparation, does nothing if it is already
+	   prepared for this ECC mode */
+	void Request(const string& strFileName, const string& strFileNamenoDir, const int iECCmode);
+
+	/* Returns FALSE if the object is not prepared (or the file has changed
+	   since). Waits if the worker is just preparing this file */
+	_BOOLEAN Get(const string& strFileName, const string& strFileNamenoDir, const int iECCmode,
+				 CVector<_BYTE>& vecbyObject, string& strFileNamenoDirX);
+	void Put(const string& strFileName, const string& strFileNamenoDir, const int iECCmode,
+			 const CVector<_BYTE>& vecbyObject, const string& strFileNamenoDirX);
+
+	void Stop();
+
+protected:
+	class CKey
+	{
+	public:
+		CKey() : iECCmode(0), iFileSize(0) {ftWrite.dwLowDateTime = ftWrite.dwHighDateTime = 0;}
+
+		_BOOLEAN Set(const string& strNewFileName, const string& strNewFileNamenoDir, const int iNewECCmode);
+		_BOOLEAN operator==(const CKey& Key) const;
+
+		string		strFileName;
+		string		strFileNamenoDir;
+		int			iECCmode;
+		FILETIME	ftWrite;
+		DWORD		iFileSize;
+	};
+
+	class CEntry
+	{
+	public:
+		CKey			Key;
+		CVector<_BYTE>	vecbyObject;
+		string			strFileNamenoDirX;
+	};
+
+	void			Worker();
+	CEntry*			Find(const CKey& Key);
+	void			Insert(const CKey& Key, const CVector<_BYTE>& vecbyObject, const string& strFileNamenoDirX);
+
+	/* Front is most recently used */
+	std::list<CEntry>		Entries;
+	size_t					iCacheBytes;
+
+	std::list<CKey>			Jobs;
+	CKey					ActJob;
+	_BOOLEAN				bActJob;
+
+	std::mutex				Mutex;
+	std::condition_variable	CondJob;
+	std::condition_variable	CondDone;
+	std::thread				WorkerThread;
+	_BOOLEAN				bRunning;
+	_BOOLEAN				bStop;
+};
+
+extern CTxPrepCache TxPrepCache;
+
+
+#endif // !defined(TXPREPCACHE_H__3B0UBVE98732KJVEW363LIHGEW982__INCLUDED_)
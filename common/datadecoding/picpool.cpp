@@ -28,38 +28,27 @@
 #include <windows.h>
 #include "picpool.h"
 
-void CopyNew(CMOTObjectRaw::CDataUnitRx& input, CMOTObjectRaw::CDataUnitRx& output)
+/* The segments are moved, not copied: the input is always the active object
+   of the decoder which is overwritten right after it has been stored, and an
+   entry which is taken from the pool is removed from it. The RS buffers stay
+   where they are, the RS decoder thread may still read them */
+void MoveNew(CMOTObjectRaw::CDataUnitRx& input, CMOTObjectRaw::CDataUnitRx& output)
 {
-	int segsize = 0; //init DM
-	int segno = 0; //unused?? DM
 	output.bOK = input.bOK;
 	output.bReady = input.bReady;
 	output.iDataSegNum = input.iDataSegNum;
 	output.iTotSegments = input.iTotSegments;
-	segsize = input.vvbiSegment.Size();
-	output.vvbiSegment.Init(segsize);
-	for (int i=0;i<segsize;i++)
-	{
-		output.vvbiSegment[i].Init(input.vvbiSegment[i].Size());
-		output.vvbiSegment[i] = input.vvbiSegment[i];
-	}
-	output.iDataSegNum = input.iDataSegNum;
+	output.vvbiSegment = std::move(input.vvbiSegment);
 }
-void CopyNewH(CMOTObjectRaw::CDataUnit& input, CMOTObjectRaw::CDataUnit& output)
+void MoveNewH(CMOTObjectRaw::CDataUnit& input, CMOTObjectRaw::CDataUnit& output)
 {
-	int segsize = 0; //init DM
 	output.bOK = input.bOK;
 	output.bReady = input.bReady;
 	output.iDataSegNum = input.iDataSegNum;
-	segsize = input.vecbiData.Size();
-	output.vecbiData.Init(segsize);
-	for (int i=0;i<segsize;i++)
-	{
-		output.vecbiData[i] = input.vecbiData[i];
-	}
+	output.vecbiData = std::move(input.vecbiData);
 }
 
-void CopyOld(CMOTObjectRaw::CDataUnitRx& input, CMOTObjectRaw::CDataUnitRx& output)
+void MoveOld(CMOTObjectRaw::CDataUnitRx& input, CMOTObjectRaw::CDataUnitRx& output)
 {
 	int segsizein = 0,segsizeout = 0; //init DM
 	int segno = 0;
@@ -72,15 +61,12 @@ void CopyOld(CMOTObjectRaw::CDataUnitRx& input, CMOTObjectRaw::CDataUnitRx& outp
 	for (int i=0;i<segsizein;i++)
 	{
 		if (input.vvbiSegment[i].Size() > 0)
-		{
-			output.vvbiSegment[i].Init(input.vvbiSegment[i].Size());
-			output.vvbiSegment[i] = input.vvbiSegment[i];
-		}
+			output.vvbiSegment[i] = std::move(input.vvbiSegment[i]);
 		if (output.vvbiSegment[i].Size() > 0) segno++;
 	}
 	output.iDataSegNum = segno;
 }
-void CopyOldH(CMOTObjectRaw::CDataUnit& input, CMOTObjectRaw::CDataUnit& output)
+void MoveOldH(CMOTObjectRaw::CDataUnit& input, CMOTObjectRaw::CDataUnit& output)
 {
 	int segsizein = 0,segsizeout = 0; //init DM
 	if (input.bOK) output.bOK = TRUE;
@@ -88,41 +74,84 @@ void CopyOldH(CMOTObjectRaw::CDataUnit& input, CMOTObjectRaw::CDataUnit& output)
 	if (input.iDataSegNum >= output.iDataSegNum) input.iDataSegNum = output.iDataSegNum;
 	segsizein = input.vecbiData.Size();
 	segsizeout = output.vecbiData.Size();
-	if (segsizein > segsizeout)	output.vecbiData.Enlarge(segsizein-segsizeout);
-	for (int i=0;i<segsizein;i++)
+	if (segsizein >= segsizeout)
+		output.vecbiData = std::move(input.vecbiData);
+	else
 	{
-		output.vecbiData[i] = input.vecbiData[i];
+		for (int i=0;i<segsizein;i++)
+			output.vecbiData[i] = input.vecbiData[i];
 	}
 }
 
-void CPicPool::storeinpool(CMOTObjectRaw& input)
+/* Memory budget of the pool, can be changed in settings.txt */
+int PicPoolBudgetMB = PICPOOL_DEF_BUDGET_MB;
+
+size_t CPicPool::EntryBytes(CMOTObjectRaw& entry)
+{
+	/* Approximate heap usage: one byte per stored bit plus the vector
+	   overhead of every (also empty) segment */
+	size_t bytes = sizeof(CMOTObjectRaw);
+	bytes += entry.Header.vecbiData.capacity();
+	bytes += entry.Body.vecbiData.capacity();
+	bytes += entry.BodyRx.vvbiSegment.capacity() * sizeof(CVector<_BINARY>);
+	for (int i=0;i<entry.BodyRx.vvbiSegment.Size();i++)
+		bytes += entry.BodyRx.vvbiSegment[i].capacity();
+	bytes += entry.BodyRx.RSbytes[0].capacity() + entry.BodyRx.RSbytes[1].capacity();
+	return bytes;
+}
+
+void CPicPool::EvictToBudget()
 {
-	int position = 0; //init DM
+	const size_t budget = (size_t) max(PicPoolBudgetMB, 1) * 1024 * 1024;
+
+	/* Never evict the most recently used entry (the one just stored) */
+	while ((iPoolBytes > budget) && (poolID.numinpool() > 1))
+		poolremove(poolID.getoldest());
+}
 
+void CPicPool::storeinpool(CMOTObjectRaw& input)
+{
 	if (!poolID.ispoolid(input.iTransportID)) return;
 
-	if (poolID.storeinpool(input.iTransportID,&position))	// found in pool
+	/* Nothing received for this object yet */
+	if ((input.Header.bOK == FALSE) && (input.BodyRx.iDataSegNum <= 0)) return;
+
+	if (poolID.storeinpool(input.iTransportID))	// found in pool
 	{		
-		CopyOld(input.BodyRx,picpool[position].BodyRx);
-		CopyOldH(input.Header,picpool[position].Header);
+		CMOTObjectRaw& entry = picpool[input.iTransportID];
+		iPoolBytes -= EntryBytes(entry);
+		MoveOld(input.BodyRx,entry.BodyRx);
+		MoveOldH(input.Header,entry.Header);
+		iPoolBytes += EntryBytes(entry);
 	}
 	else
 	{
-		CopyNewH(input.Header,picpool[position].Header);
-		CopyNew(input.BodyRx,picpool[position].BodyRx);
-		picpool[position].iSegmentSize = input.iSegmentSize;
+		CMOTObjectRaw& entry = picpool[input.iTransportID];
+		MoveNewH(input.Header,entry.Header);
+		MoveNew(input.BodyRx,entry.BodyRx);
+		entry.iSegmentSize = input.iSegmentSize;
+		entry.iTransportID = input.iTransportID;
+		iPoolBytes += EntryBytes(entry);
 	}
+
+	EvictToBudget();
 }
 
 void CPicPool::getfrompool(int transid, CMOTObjectRaw& output)
 {
-	int position = 0;
-	if (poolID.getfrompool(transid,&position))	// found in pool
+	auto it = picpool.find(transid);
+
+	/* The object becomes the active one of the decoder, it is stored again
+	   when the transport ID changes */
+	if (poolID.poolremove(transid) && (it != picpool.end()))	// found in pool
 	{
-		CopyNew(picpool[position].BodyRx,output.BodyRx);
-		CopyNewH(picpool[position].Header,output.Header);
-		output.iSegmentSize = picpool[position].iSegmentSize;
+		CMOTObjectRaw& entry = it->second;
+		iPoolBytes -= EntryBytes(entry);
+		MoveNew(entry.BodyRx,output.BodyRx);
+		MoveNewH(entry.Header,output.Header);
+		output.iSegmentSize = entry.iSegmentSize;
 		output.iTransportID = transid;
+		picpool.erase(it);
 	}
 	else
 	{
@@ -135,26 +164,20 @@ void CPicPool::getfrompool(int transid, CMOTObjectRaw& output)
 
 void CPicPool::poolremove(int transid)
 {
-	int position = 0;
-	if (poolID.poolremove(transid,&position))	// found in pool
+	if (poolID.poolremove(transid))	// found in pool
 	{
-		picpool[position].Body.Reset();
-		picpool[position].BodyRx.Reset();
-		picpool[position].Header.Reset();
-		picpool[position].iTransportID = -1;
-		picpool[position].iSegmentSize = -1;
+		auto it = picpool.find(transid);
+		if (it != picpool.end())
+		{
+			iPoolBytes -= EntryBytes(it->second);
+			picpool.erase(it);
+		}
 	}
 }
 
 void CPicPool::Reset()
 {
 	poolID.Reset();
-	for (int i=0;i<numpoolele;i++)
-	{
-		picpool[i].Body.Reset();
-		picpool[i].BodyRx.Reset();
-		picpool[i].Header.Reset();
-		picpool[i].iTransportID = -1;
-		picpool[i].iSegmentSize = -1;
-	}
-}
\ No newline at end of file
+	picpool.clear();
+	iPoolBytes = 0;
+}
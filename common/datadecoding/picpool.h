@@ -32,11 +32,18 @@
 #include "DABMOT.h"
 #include "../libs/poolid.h"
 
+/* Definitions ****************************************************************/
+/* Default memory budget of the picture pool in MB. Partially received objects
+   are evicted least recently used first when the budget is exceeded */
+#define PICPOOL_DEF_BUDGET_MB	64
+
+extern int PicPoolBudgetMB;
+
 /* Classes ********************************************************************/
 class CPicPool
 {
 public:
-	CPicPool() { Reset();}
+	CPicPool() : iPoolBytes(0) { Reset();}
 
 	void Reset();
 
@@ -44,10 +51,16 @@ public:
 	void getfrompool(int transid, CMOTObjectRaw& output);
 	void poolremove(int transid);
 
+	size_t GetPoolBytes() { return iPoolBytes; }
+	int GetNumInPool() { return poolID.numinpool(); }
+
 protected:
+	size_t EntryBytes(CMOTObjectRaw& entry);
+	void EvictToBudget();
 
-	CMOTObjectRaw picpool[numpoolele];
+	std::unordered_map<int, CMOTObjectRaw> picpool;
 	CPoolID poolID;
+	size_t iPoolBytes;
 };
 
 #endif // 
@@ -25,25 +25,14 @@ double coeff[zffiltlen] =
 	};
 
 
-int no_dft = 0;
-
 FILE * cfile;
 
-void FirInit(int dftsize,ESpecOcc spec)
-{
-	int i;
-	no_dft = dftsize;
-
-	//for (i=0;i<zffiltlen;i++) //This did nothing except waste time! DM
-	//	coeff[i] = coeff[i];
-}
-
-void DoFir (_COMPLEX * samples,_COMPLEX * outsamples)
+void DoFir (_COMPLEX * samples,_COMPLEX * outsamples,int dftsize)
 {
 	int i = 0,k; //init DM
 	_COMPLEX firres;
 
-	for (k=0;k<no_dft;k++)
+	for (k=0;k<dftsize;k++)
 	{
 		firres = 0.0;
 		for (i=0;i<zffiltlen;i++)
@@ -54,11 +43,11 @@ void DoFir (_COMPLEX * samples,_COMPLEX * outsamples)
 	}
 }
 
-void NoFir (_COMPLEX * samples,_COMPLEX * outsamples)
+void NoFir (_COMPLEX * samples,_COMPLEX * outsamples,int dftsize)
 {
 	int k;
 	_COMPLEX firres;
-	for (k=0;k<no_dft;k++)
+	for (k=0;k<dftsize;k++)
 	{
 		firres = *(samples+zffiltleadlen+k);
 		*(outsamples+k) = firres;
@@ -5,9 +5,8 @@
 #define zffilttraillen 41
 #define zffiltlen (zffiltleadlen+zffilttraillen)
 
-void FirInit(int dftsize,ESpecOcc spec);
-
-void DoFir (_COMPLEX * samples,_COMPLEX * outsamples);
-void NoFir (_COMPLEX * samples,_COMPLEX * outsamples);
+/* The DFT size is passed in each call, each receiver has its own */
+void DoFir (_COMPLEX * samples,_COMPLEX * outsamples,int dftsize);
+void NoFir (_COMPLEX * samples,_COMPLEX * outsamples,int dftsize);
 
 #endif
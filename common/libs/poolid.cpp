@@ -11,10 +11,6 @@
 
 #include "poolid.h"
 
-int iIDpool[numpoolele];
-int age[numpoolele];
-int actage;
-
 
 BOOL CPoolID::ispoolid(int iID)
 {
@@ -25,91 +21,53 @@ BOOL CPoolID::ispoolid(int iID)
 	return TRUE;
 }
 
-BOOL CPoolID::storeinpool(int iID, int * position)
+BOOL CPoolID::storeinpool(int iID)
 {
-	int locposition = -1;
-	int minage = actage + 1;
-
-	for (int i=0;i<numpoolele;i++)
+	auto it = IDIndex.find(iID);
+	if (it != IDIndex.end())	// found in pool -> keep old segments !
 	{
-		if (iID == iIDpool[i])
-		{
-			locposition = i;
-			i = numpoolele;
-		}
-	}
-	if (locposition >= 0)	// found in pool -> keep old segments !
-	{		
-		age[locposition] = actage;
-		actage++;
-		*position = locposition;
+		// move to front (most recently used)
+		IDOrder.splice(IDOrder.begin(), IDOrder, it->second);
 		return TRUE;
 	}
-	else				// not found in pool
+	else						// not found in pool
 	{
-		for (int i=0;i<numpoolele;i++)
-		{
-			if (age[i] <= minage)
-			{
-				minage = age[i];
-				locposition = i;
-			}	
-		}
-		iIDpool[locposition] = iID;
-		age[locposition] = actage;
-		actage++;
-		*position = locposition;
+		IDOrder.push_front(iID);
+		IDIndex[iID] = IDOrder.begin();
 		return FALSE;
 	}
 }
 
-BOOL CPoolID::getfrompool(int iID, int * position)
+BOOL CPoolID::getfrompool(int iID)
 {
-	int locposition = -1;
-	// search for old pool entry
-	for (int i=0;i<numpoolele;i++)
-	{
-		if (iID == iIDpool[i])
-		{
-			locposition = i;
-			i = numpoolele;
-		}
-	}
-	*position = locposition;
-	if (locposition >= 0)	//found in pool
-		return TRUE;
-	else					//not found in pool
+	auto it = IDIndex.find(iID);
+	if (it == IDIndex.end())	// not found in pool
 		return FALSE;
+
+	// found in pool, mark as recently used
+	IDOrder.splice(IDOrder.begin(), IDOrder, it->second);
+	return TRUE;
 }
 
-BOOL CPoolID::poolremove(int iID, int * position)
+BOOL CPoolID::poolremove(int iID)
 {
-	int locposition = -1;
-	// search for old pool entry
-	for (int i=0;i<numpoolele;i++)
-	{
-		if (iID == iIDpool[i])
-		{
-			locposition = i;
-			i = numpoolele;
-		}
-	}
-	*position = locposition;
-	if (locposition >= 0)	// found in pool
-	{
-		iIDpool[locposition] = -1;
-		return TRUE;
-	}
-	else
+	auto it = IDIndex.find(iID);
+	if (it == IDIndex.end())	// not in pool
 		return FALSE;
+
+	IDOrder.erase(it->second);
+	IDIndex.erase(it);
+	return TRUE;
+}
+
+int CPoolID::getoldest()
+{
+	if (IDOrder.empty()) return -1;
+	return IDOrder.back();
 }
 
 void CPoolID::Reset()
 {
-	actage = 1;
-	for (int i=0;i<numpoolele;i++)
-	{
-		age[i] = 0;
-		iIDpool[i] = -1;
-	}
-}
\ No newline at end of file
+	IDOrder.clear();
+	IDIndex.clear();
+}
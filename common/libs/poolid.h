@@ -13,11 +13,14 @@
 #define POOLID_H__3P0UBVE93452KJVEW363E7A0D31912__INCLUDED_
 
 #include <windows.h>
+#include <list>
+#include <unordered_map>
 
 /* Classes ********************************************************************/
 
-#define numpoolele 5
-
+/* Transport ID index of the MOT object pool. IDs are kept in LRU order, the
+   most recently used ID is at the front of the list. Lookups are done via the
+   hash map, so the pool size is no longer limited to a handful of slots */
 class CPoolID
 {
 public:
@@ -26,9 +29,15 @@ public:
 	void Reset();
 
 	BOOL ispoolid(int iID);
-	BOOL storeinpool(int iID, int * position);
-	BOOL getfrompool(int iID, int * position);
-	BOOL poolremove(int iID, int * position);
+	BOOL storeinpool(int iID);	// TRUE if ID was already in pool, marks it as recently used
+	BOOL getfrompool(int iID);	// TRUE if ID is in pool, marks it as recently used
+	BOOL poolremove(int iID);	// TRUE if ID was in pool
+	int	 getoldest();			// least recently used ID, -1 if pool is empty
+	int	 numinpool() { return (int) IDIndex.size(); }
+
+protected:
+	std::list<int>									IDOrder;
+	std::unordered_map<int, std::list<int>::iterator>	IDIndex;
 };
 
 #endif // 
@@ -30,12 +30,15 @@
 
 #include <math.h>
 #include <complex>
+#include <type_traits>
 using namespace std;
 #include "../GlobalDefinitions.h"
+#include "../FrameArena.h"
 
 
 /* Definitions ****************************************************************/
-/* Two different types: constant and temporary buffer */
+/* Two different types: constant and temporary buffer. Temporary buffers are
+   taken from the frame arena of the thread if it has one, see FrameArena.h */
 enum EVecTy {VTY_CONST, VTY_TEMP};
 
 
@@ -121,18 +124,18 @@ class CMatlibVector
 {
 public:
 	/* Construction, Destruction -------------------------------------------- */
-	CMatlibVector() : iVectorLength(0), pData(NULL), eVType(VTY_CONST) {}
+	CMatlibVector() : iVectorLength(0), pData(NULL), pArena(NULL), iAllocLength(0), eVType(VTY_CONST) {}
 	CMatlibVector(const int iNLen, const EVecTy eNTy = VTY_CONST) : 
-		iVectorLength(0), pData(NULL), eVType(eNTy) {Init(iNLen);}
+		iVectorLength(0), pData(NULL), pArena(NULL), iAllocLength(0), eVType(eNTy) {Init(iNLen);}
 	CMatlibVector(CMatlibVector<T>& vecI);
 	CMatlibVector(const CMatlibVector<T>& vecI);
-	virtual ~CMatlibVector() {if (pData != NULL) delete[] pData;}
+	virtual ~CMatlibVector() {Free();}
 
 	CMatlibVector(const CMatlibVector<CReal>& fvReal, const CMatlibVector<CReal>& fvImag) : 
-		iVectorLength(fvReal.GetSize()), pData(NULL), eVType(VTY_CONST/*VTY_TEMP*/)
+		iVectorLength(fvReal.GetSize()), pData(NULL), pArena(NULL), iAllocLength(0), eVType(VTY_CONST/*VTY_TEMP*/)
 	{
 		/* Allocate data block for vector */
-		pData = new CComplex[iVectorLength];
+		Alloc(iVectorLength);
 
 		/* Copy data from real-vectors in complex vector */
 		for (int i = 0; i < iVectorLength; i++)
@@ -155,6 +158,11 @@ public:
 	CMatlibVector<T> operator()(const int iFrom, const int iStep, const int iTo) const;
 
 	inline int GetSize() const {return iVectorLength;}
+
+	/* The elements as plain array, e.g. for the SIMD kernels */
+	inline const T* GetData() const {return pData;}
+	inline T* GetData() {return pData;}
+
 	void Init(const int iIniLen);
 	void Init(const int iIniLen, const T tIniVal);
 	CMatlibVector<T>& PutIn(const int iFrom, const int iTo, CMatlibVector<T>& fvA);
@@ -212,9 +220,50 @@ public:
 
 
 protected:
-	EVecTy	eVType;
-	int		iVectorLength;
-	T*		pData;
+	/* The memory of the arena is not constructed, only plain types */
+	static_assert(is_trivially_destructible<T>::value, "Matlib vectors hold plain types");
+
+	inline void Alloc(const int iLen)
+	{
+#if USE_FRAME_ARENA
+		if ((eVType == VTY_TEMP) && (pFrameArena != NULL))
+		{
+			pData = (T*) pFrameArena->Alloc(iLen * sizeof(T));
+
+			if (pData != NULL)
+			{
+				pArena = pFrameArena;
+				iAllocLength = iLen;
+				return;
+			}
+		}
+#endif
+		pData = new T[iLen];
+		pArena = NULL;
+		iAllocLength = iLen;
+	}
+
+	inline void Free()
+	{
+		if (pData == NULL)
+			return;
+
+		/* Memory of the arena goes back to the arena it came from */
+		if (pArena != NULL)
+			pArena->Free(pData);
+		else
+			delete[] pData;
+
+		pData = NULL;
+		pArena = NULL;
+		iAllocLength = 0;
+	}
+
+	EVecTy			eVType;
+	int				iVectorLength;
+	T*				pData;
+	CFrameArena*	pArena; /* NULL: pData is from the heap */
+	int				iAllocLength;
 };
 
 
@@ -330,7 +379,7 @@ CMatlibVector<T> // r, T
    (the implementation of template classes must be in the header file!) */
 template<class T>
 CMatlibVector<T>::CMatlibVector(CMatlibVector<T>& vecI) :
-	iVectorLength(vecI.GetSize()), pData(NULL), eVType(VTY_CONST/*VTY_TEMP*/)
+	iVectorLength(vecI.GetSize()), pData(NULL), pArena(NULL), iAllocLength(0), eVType(VTY_CONST/*VTY_TEMP*/)
 {
 	/* The copy constructor for the constant vector is a real copying
 	   task. But in the case of a temporary buffer only the pointer
@@ -344,7 +393,7 @@ CMatlibVector<T>::CMatlibVector(CMatlibVector<T>& vecI) :
 		if (vecI.eVType == VTY_CONST)
 		{
 			/* Allocate data block for vector */
-			pData = new T[iVectorLength];
+			Alloc(iVectorLength);
 
 			/* Copy vector */
 			for (int i = 0; i < iVectorLength; i++)
@@ -357,9 +406,13 @@ CMatlibVector<T>::CMatlibVector(CMatlibVector<T>& vecI) :
 			   saves us from always copy the entire vector */
 			/* Take data pointer from input vector (steal it) */
 			pData = vecI.pData;
+			pArena = vecI.pArena;
+			iAllocLength = vecI.iAllocLength;
 
 			/* Destroy other vector (temporary vectors only) */
 			vecI.pData = NULL;
+			vecI.pArena = NULL;
+			vecI.iAllocLength = 0;
 		}
 	}
 }
@@ -367,12 +420,12 @@ CMatlibVector<T>::CMatlibVector(CMatlibVector<T>& vecI) :
 /* Copy constructor for constant Matlib vectors */
 template<class T>
 CMatlibVector<T>::CMatlibVector(const CMatlibVector<T>& vecI) : 
-	iVectorLength(vecI.GetSize()), pData(NULL), eVType(VTY_CONST)
+	iVectorLength(vecI.GetSize()), pData(NULL), pArena(NULL), iAllocLength(0), eVType(VTY_CONST)
 {
 	if (iVectorLength > 0)
 	{
 		/* Allocate data block for vector */
-		pData = new T[iVectorLength];
+		Alloc(iVectorLength);
 
 		/* Copy vector */
 		for (int i = 0; i < iVectorLength; i++)
@@ -385,13 +438,15 @@ void CMatlibVector<T>::Init(const int iIniLen)
 {
 	iVectorLength = iIniLen;
 
-	/* Allocate data block for vector */
+	/* Allocate data block for vector. State vectors are initialized in each
+	   call, they keep their block as long as the new size fits in it */
 	if (iVectorLength > 0)
 	{
-		if (pData != NULL)
-			delete[] pData;
-
-		pData = new T[iVectorLength];
+		if ((pData == NULL) || (iVectorLength > iAllocLength))
+		{
+			Free();
+			Alloc(iVectorLength);
+		}
 
 		/* Init with zeros */
 		for (int i = 0; i < iVectorLength; i++)
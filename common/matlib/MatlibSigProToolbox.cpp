@@ -27,6 +27,7 @@
 \******************************************************************************/
 
 #include "MatlibSigProToolbox.h"
+#include "../SimdKernels.h"
 
 
 /* Implementation *************************************************************/
@@ -206,7 +207,7 @@ CMatlibVector<CReal> Filter(const CMatlibVector<CReal>& fvB,
 	{
 		/* FIR filter ------------------------------------------------------- */
 		const int				iSizeXNew = iSizeX + iSizeZ;
-		CMatlibVector<CReal>	rvXNew(iSizeXNew);
+		CMatlibVector<CReal>	rvXNew(iSizeXNew, VTY_TEMP);
 
 		/* Add old values to input vector */
 		rvXNew.Merge(fvZ, fvX);
@@ -270,7 +271,6 @@ CMatlibVector<CComplex> FirFiltDec(const CMatlibVector<CComplex>& cvB,
 								   CMatlibVector<CReal>& rvZ,
 								   const int iDecFact)
 {
-	int			m, n, iCurPos;
 	const int	iSizeX = rvX.GetSize();
 	const int	iSizeZ = rvZ.GetSize();
 	const int	iSizeB = cvB.GetSize();
@@ -302,20 +302,18 @@ CMatlibVector<CComplex> FirFiltDec(const CMatlibVector<CComplex>& cvB,
 	}
 
 	CMatlibVector<CComplex>	cvY(iDecSizeY, VTY_TEMP);
-	CMatlibVector<CReal>	rvXNew(iSizeXNew);
+	CMatlibVector<CReal>	rvXNew(iSizeXNew, VTY_TEMP);
 
 	/* Add old values to input vector */
 	rvXNew.Merge(rvZ, rvX);
 
-	/* FIR filter */
-	for (m = 0; m < iDecSizeY; m++)
+	/* FIR filter, SIMD kernel for this processor. Complex values are stored
+	   as real and imaginary part, the kernel works on these arrays */
+	if (iDecSizeY > 0)
 	{
-		iCurPos = m * iDecFact + iSizeFiltHist;
-
-		cvY[m] = (CReal) 0.0;
-
-		for (n = 0; n < iSizeB; n++)
-			cvY[m] += cvB[n] * rvXNew[iCurPos - n];
+		SimdKernels().FirCplxTapsDec((const CReal*) cvB.GetData(), iSizeB,
+			rvXNew.GetData(), iSizeFiltHist, iDecFact,
+			(CReal*) cvY.GetData(), iDecSizeY);
 	}
 
 	/* Save last samples in state vector */
@@ -348,8 +346,8 @@ CMatlibVector<CReal> Levinson(const CMatlibVector<CReal>& vecrRx,
 	CReal		rE;
 	CReal		rQ;
 	int			i, j;
-	CRealVector vecraP(iLength);
-	CRealVector vecrA(iLength);
+	CRealVector vecraP(iLength, VTY_TEMP);
+	CRealVector vecrA(iLength, VTY_TEMP);
 
 	/* Initialize the recursion --------------------------------------------- */
 	// (a) First coefficient is always unity
@@ -430,8 +428,8 @@ CMatlibVector<CComplex> Levinson(const CMatlibVector<CComplex>& veccRx,
 	CReal			rE;
 	CComplex		cQ;
 	int				i, j;
-	CComplexVector	veccaP(iLength);
-	CComplexVector	veccA(iLength);
+	CComplexVector	veccaP(iLength, VTY_TEMP);
+	CComplexVector	veccA(iLength, VTY_TEMP);
 
 	/* Initialize the recursion --------------------------------------------- */
 	// (a) First coefficient is always unity
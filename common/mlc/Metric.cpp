@@ -41,6 +41,41 @@ void CMLCMetric::CalculateMetric(CVector<CEquSig>* pcInSymb,
 								 CVector<_BINARY>& vecbiSubsetDef5,
 								 CVector<_BINARY>& vecbiSubsetDef6,
 								 int iLevel, _BOOLEAN bIteration)
+{
+#if USE_FIXED_POINT
+	if (bFixedPoint == TRUE)
+	{
+		QuantizeCells(pcInSymb);
+
+		if (MetricKernel(vecMetric, iLevel, bIteration) == TRUE)
+			return;
+
+		CalcMetric(&vecFixSymb, sTableQAM4, sTableQAM16, sTableQAM64SM,
+			vecMetric, vecbiSubsetDef1, vecbiSubsetDef2, vecbiSubsetDef3,
+			iLevel, bIteration);
+
+		return;
+	}
+#endif
+
+	if (MetricKernelReal(pcInSymb, vecMetric, iLevel, bIteration) == TRUE)
+		return;
+
+	CalcMetric(pcInSymb, rTableQAM4, rTableQAM16, rTableQAM64SM,
+		vecMetric, vecbiSubsetDef1, vecbiSubsetDef2, vecbiSubsetDef3,
+		iLevel, bIteration);
+}
+
+template<class TCell, class TTab>
+void CMLCMetric::CalcMetric(CVector<TCell>* pcInSymb,
+							const TTab rTableQAM4[][2],
+							const TTab rTableQAM16[][2],
+							const TTab rTableQAM64SM[][2],
+							CVector<CDistance>& vecMetric, 
+							CVector<_BINARY>& vecbiSubsetDef1, 
+							CVector<_BINARY>& vecbiSubsetDef2,
+							CVector<_BINARY>& vecbiSubsetDef3, 
+							int iLevel, _BOOLEAN bIteration)
 {
 	int i, k;
 	int iTabInd0;
@@ -386,8 +421,216 @@ void CMLCMetric::CalculateMetric(CVector<CEquSig>* pcInSymb,
 	}
 }
 
+template<class TTab>
+_BOOLEAN CMLCMetric::KernelTable(const TTab rTableQAM4[][2],
+								 const TTab rTableQAM16[][2],
+								 const TTab rTableQAM64SM[][2],
+								 int iLevel, _BOOLEAN bIteration,
+								 const TTab (*&pTable)[2], int& iNumPoints) const
+{
+	/* The points of "0" come first in the tables, then the ones of "1" */
+	switch (eMapType)
+	{
+	case CParameter::CS_1_SM:
+		pTable = rTableQAM4;
+		iNumPoints = 1;
+		return TRUE;
+
+	case CParameter::CS_2_SM:
+		if ((iLevel != 0) || (bIteration == TRUE))
+			return FALSE;
+
+		pTable = rTableQAM16;
+		iNumPoints = 2;
+		return TRUE;
+
+	case CParameter::CS_3_SM:
+		if ((iLevel != 0) || (bIteration == TRUE))
+			return FALSE;
+
+		pTable = rTableQAM64SM;
+		iNumPoints = 4;
+		return TRUE;
+
+	default:
+		return FALSE;
+	}
+}
+
+_BOOLEAN CMLCMetric::MetricKernelReal(CVector<CEquSig>* pcInSymb,
+									  CVector<CDistance>& vecMetric,
+									  int iLevel, _BOOLEAN bIteration)
+{
+	int i, j, c, b;
+	const _REAL (*prTable)[2];
+	int iNumPoints;
+
+	if (KernelTable(rTableQAM4, rTableQAM16, rTableQAM64SM, iLevel,
+		bIteration, prTable, iNumPoints) == FALSE)
+	{
+		return FALSE;
+	}
+
+	/* The square root is taken once per cell, "Metric()" does the same */
+	for (i = 0; i < iInputBlockSize; i++)
+	{
+		vecrSigRe[i] = (*pcInSymb)[i].cSig.real();
+		vecrSigIm[i] = (*pcInSymb)[i].cSig.imag();
+		vecrWeight[i] = sqrt((*pcInSymb)[i].rChan);
+	}
+
+	const CSimdKernels& Kernels = SimdKernels();
+	_REAL rPoints[4];
+
+	/* Real part (c = 0) and imaginary part (c = 1), distances to "0" (b = 0)
+	   and to "1" (b = 1) */
+	for (c = 0; c < 2; c++)
+	{
+		const _REAL* prSig = (c == 0) ? &vecrSigRe[0] : &vecrSigIm[0];
+
+		for (b = 0; b < 2; b++)
+		{
+			for (j = 0; j < iNumPoints; j++)
+				rPoints[j] = prTable[b * iNumPoints + j][c];
+
+			Kernels.QAMMetricReal(prSig, &vecrWeight[0], rPoints, iNumPoints,
+				&vecrMetric[0], iInputBlockSize);
+
+			if (b == 0)
+			{
+				for (i = 0; i < iInputBlockSize; i++)
+					vecMetric[2 * i + c].rTow0 = vecrMetric[i];
+			}
+			else
+			{
+				for (i = 0; i < iInputBlockSize; i++)
+					vecMetric[2 * i + c].rTow1 = vecrMetric[i];
+			}
+		}
+	}
+
+	return TRUE;
+}
+
+#if USE_FIXED_POINT
+void CMLCMetric::QuantizeCells(CVector<CEquSig>* pcInSymb)
+{
+	int i;
+
+	/* The weights are relative to the strongest cell of the block. The
+	   Viterbi decoder only compares sums of metrics, so the scale of the
+	   block does not matter */
+	_REAL rMaxChan = (_REAL) 0.0;
+	for (i = 0; i < iInputBlockSize; i++)
+	{
+		if ((*pcInSymb)[i].rChan > rMaxChan)
+			rMaxChan = (*pcInSymb)[i].rChan;
+	}
+
+	_REAL rWeightScale = (_REAL) 0.0;
+	if (rMaxChan > (_REAL) 0.0)
+		rWeightScale = (_REAL) 1.0 / rMaxChan;
+
+	const _REAL rSigScale = (_REAL) (1 << FIXP_SIG_FRAC_BITS);
+
+	for (i = 0; i < iInputBlockSize; i++)
+	{
+		const CEquSig& Cell = (*pcInSymb)[i];
+
+		vecFixSymb[i].cSig.iRe = SatQ15(RoundReal(Cell.cSig.real() * rSigScale));
+		vecFixSymb[i].cSig.iIm = SatQ15(RoundReal(Cell.cSig.imag() * rSigScale));
+		vecFixSymb[i].rChan = SatQ15(RoundReal(
+			sqrt(Cell.rChan * rWeightScale) * FIXP_Q15_ONE));
+
+		vecsSigRe[i] = (_FIXP16) vecFixSymb[i].cSig.iRe;
+		vecsSigIm[i] = (_FIXP16) vecFixSymb[i].cSig.iIm;
+		vecsWeight[i] = (_FIXP16) vecFixSymb[i].rChan;
+	}
+}
+
+_BOOLEAN CMLCMetric::MetricKernel(CVector<CDistance>& vecMetric, int iLevel,
+								  _BOOLEAN bIteration)
+{
+	int i, j, c, b;
+	const _FIXP16 (*psTable)[2];
+	int iNumPoints;
+
+	if (KernelTable(sTableQAM4, sTableQAM16, sTableQAM64SM, iLevel,
+		bIteration, psTable, iNumPoints) == FALSE)
+	{
+		return FALSE;
+	}
+
+	const CSimdKernels& Kernels = SimdKernels();
+	_FIXP16 sPoints[4];
+
+	/* Real part (c = 0) and imaginary part (c = 1), distances to "0" (b = 0)
+	   and to "1" (b = 1) */
+	for (c = 0; c < 2; c++)
+	{
+		const _FIXP16* psSig = (c == 0) ? &vecsSigRe[0] : &vecsSigIm[0];
+
+		for (b = 0; b < 2; b++)
+		{
+			for (j = 0; j < iNumPoints; j++)
+				sPoints[j] = psTable[b * iNumPoints + j][c];
+
+			Kernels.QAMMetricQ13(psSig, &vecsWeight[0], sPoints, iNumPoints,
+				&veciMetricFix[0], iInputBlockSize);
+
+			if (b == 0)
+			{
+				for (i = 0; i < iInputBlockSize; i++)
+					vecMetric[2 * i + c].rTow0 = (_REAL) veciMetricFix[i];
+			}
+			else
+			{
+				for (i = 0; i < iInputBlockSize; i++)
+					vecMetric[2 * i + c].rTow1 = (_REAL) veciMetricFix[i];
+			}
+		}
+	}
+
+	return TRUE;
+}
+#endif
+
 void CMLCMetric::Init(int iNewInputBlockSize, CParameter::ECodScheme eNewCodingScheme)
 {
 	iInputBlockSize = iNewInputBlockSize;
 	eMapType = eNewCodingScheme;
+
+	vecrSigRe.Init(iInputBlockSize);
+	vecrSigIm.Init(iInputBlockSize);
+	vecrWeight.Init(iInputBlockSize);
+	vecrMetric.Init(iInputBlockSize);
+
+#if USE_FIXED_POINT
+	int i;
+
+	bFixedPoint = FixedPointRx;
+	vecFixSymb.Init(iInputBlockSize);
+	vecsSigRe.Init(iInputBlockSize);
+	vecsSigIm.Init(iInputBlockSize);
+	vecsWeight.Init(iInputBlockSize);
+	veciMetricFix.Init(iInputBlockSize);
+
+	for (i = 0; i < 2; i++)
+	{
+		sTableQAM4[i][0] = SatQ15(RoundReal(ldexp(rTableQAM4[i][0], FIXP_SIG_FRAC_BITS)));
+		sTableQAM4[i][1] = SatQ15(RoundReal(ldexp(rTableQAM4[i][1], FIXP_SIG_FRAC_BITS)));
+	}
+
+	for (i = 0; i < 4; i++)
+	{
+		sTableQAM16[i][0] = SatQ15(RoundReal(ldexp(rTableQAM16[i][0], FIXP_SIG_FRAC_BITS)));
+		sTableQAM16[i][1] = SatQ15(RoundReal(ldexp(rTableQAM16[i][1], FIXP_SIG_FRAC_BITS)));
+	}
+
+	for (i = 0; i < 8; i++)
+	{
+		sTableQAM64SM[i][0] = SatQ15(RoundReal(ldexp(rTableQAM64SM[i][0], FIXP_SIG_FRAC_BITS)));
+		sTableQAM64SM[i][1] = SatQ15(RoundReal(ldexp(rTableQAM64SM[i][1], FIXP_SIG_FRAC_BITS)));
+	}
+#endif
 }
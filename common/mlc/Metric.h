@@ -33,6 +33,8 @@
 #include "../tables/TableQAMMapping.h"
 #include "../Vector.h"
 #include "../Parameter.h"
+#include "../FixedPoint.h"
+#include "../SimdKernels.h"
 
 
 /* Classes ********************************************************************/
@@ -41,6 +43,33 @@ inline _REAL Metric(const _REAL rDist, const _REAL rChan)
 	return rDist * sqrt(rChan);
 }
 
+#if USE_FIXED_POINT
+/* Equalized cell for the fixed-point metrics. The names are the ones of
+   CEquSig, the metric code is the same for both */
+class CEquSigFix
+{
+public:
+	class CSigFix
+	{
+	public:
+		int real() const {return iRe;}
+		int imag() const {return iIm;}
+
+		int iRe; /* Q13 */
+		int iIm;
+	};
+
+	CSigFix	cSig;
+	int		rChan; /* weight: sqrt of the channel power, Q15 */
+};
+
+/* Q13 distance times Q15 weight, the result is Q13 */
+inline int Metric(const int iDist, const int iWeight)
+{
+	return (iDist * iWeight) >> 15;
+}
+#endif
+
 class CMLCMetric
 {
 public:
@@ -61,6 +90,19 @@ public:
 
 
 protected:
+	/* The tables are arguments, so the same code works on _REAL and on
+	   fixed-point cells */
+	template<class TCell, class TTab>
+	void	CalcMetric(CVector<TCell>* pcInSymb,
+					   const TTab rTableQAM4[][2],
+					   const TTab rTableQAM16[][2],
+					   const TTab rTableQAM64SM[][2],
+					   CVector<CDistance>& vecMetric, 
+					   CVector<_BINARY>& vecbiSubsetDef1, 
+					   CVector<_BINARY>& vecbiSubsetDef2,
+					   CVector<_BINARY>& vecbiSubsetDef3, 
+					   int iLevel, _BOOLEAN bIteration);
+
 	inline _REAL Minimum1(const _REAL rA, const _REAL rB,
 						  const _REAL rChan) const
 	{
@@ -103,6 +145,83 @@ protected:
 		return Metric(rReturn, rChan);
 	}
 
+	/* The bits whose points do not depend on the other levels are done by
+	   the SIMD kernels: all of 4-QAM and level 0 without iteration. Returns
+	   the table and the number of points per bit value, FALSE for the other
+	   bits */
+	template<class TTab>
+	_BOOLEAN	KernelTable(const TTab rTableQAM4[][2],
+							const TTab rTableQAM16[][2],
+							const TTab rTableQAM64SM[][2],
+							int iLevel, _BOOLEAN bIteration,
+							const TTab (*&pTable)[2], int& iNumPoints) const;
+
+	_BOOLEAN	MetricKernelReal(CVector<CEquSig>* pcInSymb,
+								 CVector<CDistance>& vecMetric, int iLevel,
+								 _BOOLEAN bIteration);
+
+	/* Cells of the kernel as separate arrays, weight = sqrt(channel) */
+	CVector<_REAL>			vecrSigRe;
+	CVector<_REAL>			vecrSigIm;
+	CVector<_REAL>			vecrWeight;
+	CVector<_REAL>			vecrMetric;
+
+#if USE_FIXED_POINT
+	/* Same as above with Q13 values and Q15 weight */
+	inline int Minimum1(const int iA, const int iB, const int iWeight) const
+	{
+		return Metric(abs(iA - iB), iWeight);
+	}
+
+	inline int Minimum2(const int iA, const int iB1, const int iB2,
+						const int iWeight) const
+	{
+		const int iResult1 = abs(iA - iB1);
+		const int iResult2 = abs(iA - iB2);
+
+		return Metric((iResult1 < iResult2) ? iResult1 : iResult2, iWeight);
+	}
+
+	inline int Minimum4(const int iA, const int iB1, const int iB2,
+						const int iB3, const int iB4, const int iWeight) const
+	{
+		int iReturn = abs(iA - iB1);
+
+		const int iResult2 = abs(iA - iB2);
+		const int iResult3 = abs(iA - iB3);
+		const int iResult4 = abs(iA - iB4);
+
+		if (iResult2 < iReturn)
+			iReturn = iResult2;
+		if (iResult3 < iReturn)
+			iReturn = iResult3;
+		if (iResult4 < iReturn)
+			iReturn = iResult4;
+
+		return Metric(iReturn, iWeight);
+	}
+
+	void	QuantizeCells(CVector<CEquSig>* pcInSymb);
+
+	/* Same as "MetricKernelReal()" on the Q13 cells */
+	_BOOLEAN	MetricKernel(CVector<CDistance>& vecMetric, int iLevel,
+							 _BOOLEAN bIteration);
+
+	_BOOLEAN				bFixedPoint;
+	CVector<CEquSigFix>		vecFixSymb;
+
+	/* The same cells as separate arrays for the kernel */
+	CVector<_FIXP16>		vecsSigRe;
+	CVector<_FIXP16>		vecsSigIm;
+	CVector<_FIXP16>		vecsWeight;
+	CVector<int>			veciMetricFix;
+
+	/* QAM tables in Q13 */
+	_FIXP16					sTableQAM4[2][2];
+	_FIXP16					sTableQAM16[4][2];
+	_FIXP16					sTableQAM64SM[8][2];
+#endif
+
 
 	int						iInputBlockSize;
 	CParameter::ECodScheme	eMapType;
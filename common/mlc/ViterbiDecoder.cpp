@@ -58,6 +58,11 @@ _REAL CViterbiDecoder::Decode(CVector<CDistance>& vecNewDistance,
 		vecNewDistance[i].rTow0 /= rAmp;
 		vecNewDistance[i].rTow1 /= rAmp;
 	}
+
+#ifndef USE_MMX
+	/* Trellis kernel for this processor */
+	const CSimdKernels& Kernels = SimdKernels();
+#endif
 #endif
 
 	/* Init pointers for old and new trellis state */
@@ -297,15 +302,15 @@ _REAL CViterbiDecoder::Decode(CVector<CDistance>& vecNewDistance,
 #undef BUTTERFLY
 
 #ifdef USE_SIMD
-		/* Do actual trellis update in separate file (assembler implementation) */
+		/* Do actual trellis update in separate file (assembler implementation
+		   or SIMD kernel) */
 #ifdef USE_MMX
-		TrellisUpdateMMX(
-#endif
-#ifdef USE_SSE2
-		TrellisUpdateSSE2(
+		TrellisUpdateMMX(&matdecDecisions[i][0], pCurTrelMetric,
+			pOldTrelMetric, chMet1, chMet2);
+#else
+		Kernels.TrellisUpdate(&matdecDecisions[i][0], pCurTrelMetric,
+			pOldTrelMetric, chMet1, chMet2);
 #endif
-			&matdecDecisions[i][0], pCurTrelMetric, pOldTrelMetric,
-			chMet1, chMet2);
 #endif
 
 #ifdef USE_MAX_LOG_MAP
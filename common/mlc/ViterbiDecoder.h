@@ -33,6 +33,7 @@
 #include "../tables/TableMLC.h"
 #include "ConvEncoder.h"
 #include "ChannelCode.h"
+#include "../SimdKernels.h"
 
 
 /* Definitions ****************************************************************/
@@ -44,7 +45,8 @@
 #define USE_SIMD
 #undef USE_SIMD
 
-/* Use MMX or SSE2 */
+/* Use the MMX assembler code (32 bit Windows only) instead of the SSE2 or
+   NEON kernel, see SimdKernels.cpp */
 #define USE_MMX
 #undef USE_MMX
 
@@ -52,9 +54,6 @@
 #ifdef USE_SIMD
 /* No MAP implementation for SIMD */
 # undef USE_MAX_LOG_MAP
-# ifndef USE_MMX
-#  define USE_SSE2
-# endif
 #endif
 
 /* Data type for Viterbi metric */
@@ -124,20 +123,16 @@ protected:
 	CMatrix<_DECISIONTYPE>	matdecDecisions;
 
 #ifdef USE_SIMD
-	/* Fields for storing the reodered metrics for MMX trellis */
+	/* Fields for storing the reodered metrics for SIMD trellis */
 	_VITMETRTYPE			chMet1[MC_NUM_STATES / 2];
 	_VITMETRTYPE			chMet2[MC_NUM_STATES / 2];
 
 #ifdef USE_MMX
-	void TrellisUpdateMMX(
-#endif
-#ifdef USE_SSE2
-	void TrellisUpdateSSE2(
-#endif
-		const _DECISIONTYPE* pCurDec,
+	void TrellisUpdateMMX(const _DECISIONTYPE* pCurDec,
 		const _VITMETRTYPE* pCurTrelMetric, const _VITMETRTYPE* pOldTrelMetric,
 		const _VITMETRTYPE* pchMet1, const _VITMETRTYPE* pchMet2);
 #endif
+#endif
 };
 
 
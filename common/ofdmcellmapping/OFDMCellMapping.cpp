@@ -82,12 +82,15 @@ void COFDMCellMapping::ProcessDataInternal(CParameter& TransmParam)
 		if (_IsDC(TransmParam.matiMapTab[iSymbolCounterAbs][iCar]))
 			(*pvecOutputData)[iCar] = _COMPLEX((_REAL) 0.0, (_REAL) 0.0);
 
-		/* Pilots */
+		/* Pilots. They are the same in each super frame, the OFDM modulation
+		   adds their precomputed time signal (see OFDM.cpp) */
 		if (_IsPilot(TransmParam.matiMapTab[iSymbolCounterAbs][iCar]))
-			(*pvecOutputData)[iCar] = 
-				TransmParam.matcPilotCells[iSymbolCounterAbs][iCar];
+			(*pvecOutputData)[iCar] = _COMPLEX((_REAL) 0.0, (_REAL) 0.0);
 	}
 
+	/* The OFDM modulation needs the position in the super frame */
+	(*pvecOutputData).GetExData().iSymbolID = iSymbolCounterAbs;
+
 	/* Increase symbol-counter and wrap if needed */
 	iSymbolCounter++;
 	if (iSymbolCounter == iNumSymPerFrame)
@@ -158,6 +161,15 @@ void COFDMCellDemapping::ProcessDataInternal(CParameter& ReceiverParam)
 	iOutputBlockSize = ReceiverParam.veciNumMSCSym[iSymbolCounterAbs];
 	iOutputBlockSize2 = ReceiverParam.veciNumFACSym[iSymbolCounterAbs];
 
+	/* Diversity reception, all cells of this symbol are combined */
+	if (pDiversity != NULL)
+	{
+		if (iDiversityRole == DIV_MAIN)
+			pDiversity->Combine(iSymbolCounterAbs, *pvecInputData, iNumCarrier);
+		else
+			pDiversity->Publish(iSymbolCounterAbs, *pvecInputData, iNumCarrier);
+	}
+
 	/* Demap data from the cells */
 	iMSCCounter = 0;
 	iFACCounter = 0;
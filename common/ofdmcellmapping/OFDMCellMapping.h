@@ -34,6 +34,7 @@
 #include "../Modul.h"
 #include "../tables/TableCarMap.h"
 #include "../tables/TableFAC.h"
+#include "../DiversityCombiner.h"
 
 
 /* Classes ********************************************************************/
@@ -56,10 +57,18 @@ protected:
 class COFDMCellDemapping : public CReceiverModul<CEquSig, CEquSig>
 {
 public:
-	COFDMCellDemapping() {}
+	COFDMCellDemapping() : pDiversity(NULL), iDiversityRole(DIV_MAIN) {}
 	virtual ~COFDMCellDemapping() {}
 
+	/* The cells are handed to (DIV_AUX) or combined with (DIV_MAIN) the
+	   cells of a second receiver before demapping. NULL switches it off */
+	void	SetDiversity(CDiversityCombiner* pNewDiv, const int iNewRole)
+				{pDiversity = pNewDiv; iDiversityRole = iNewRole;}
+
 protected:
+	CDiversityCombiner*	pDiversity;
+	int		iDiversityRole;
+
 	int		iNumSymPerFrame;
 	int		iNumCarrier;
 	int		iNumUsefMSCCellsPerFrame;
@@ -39,6 +39,11 @@
 /* Implementation *************************************************************/
 int CResample::Resample(CVector<_REAL>* prInput, CVector<_REAL>* prOutput, _REAL rRation)
 {
+#if USE_FIXED_POINT
+	if (bFixedPoint == TRUE)
+		return ResampleFixed(prInput, prOutput, rRation);
+#endif
+
 	/* Move old data from the end to the history part of the buffer and 
 	   add new data (shift register) */
 	vecrIntBuff.AddEnd((*prInput), iInputBlockSize);
@@ -96,6 +101,61 @@ int CResample::Resample(CVector<_REAL>* prInput, CVector<_REAL>* prOutput, _REAL
 	return im;
 }
 
+#if USE_FIXED_POINT
+int CResample::ResampleFixed(CVector<_REAL>* prInput, CVector<_REAL>* prOutput,
+							 _REAL rRation)
+{
+	int i;
+
+	/* The input are sound card samples, they fit in 16 bits */
+	for (i = 0; i < iInputBlockSize; i++)
+		vecsInput[i] = SatQ15(RoundReal((*prInput)[i]));
+
+	vecsIntBuff.AddEnd(vecsInput, iInputBlockSize);
+
+	rTStep = (_REAL) INTERP_DECIM_I_D / rRation;
+
+	int im = 0;
+
+	do
+	{
+		const int ik = (int) rtOut;
+
+		const int ip1 = ik % INTERP_DECIM_I_D;
+		const int ip2 = (ik + 1) % INTERP_DECIM_I_D;
+
+		const int in1 = (int) (ik / INTERP_DECIM_I_D);
+		const int in2 = (int) ((ik + 1) / INTERP_DECIM_I_D);
+
+		/* The magnitudes of the taps of one phase sum up to less than 2, so
+		   the products of Q15 taps and 16 bit samples fit in 32 bits */
+		int iy1 = 0;
+		int iy2 = 0;
+		for (i = 0; i < NUM_TAPS_PER_PHASE; i++)
+		{
+			iy1 += (int) sResTaps[ip1][i] * vecsIntBuff[in1 - i];
+			iy2 += (int) sResTaps[ip2][i] * vecsIntBuff[in2 - i];
+		}
+
+		iy1 = SatQ15(RoundShift(iy1, 15));
+		iy2 = SatQ15(RoundShift(iy2, 15));
+
+		/* Linear interpolation, fraction in Q15 */
+		const int iFrac = (int) ((rtOut - (int) rtOut) * FIXP_Q15_ONE);
+		(*prOutput)[im] = (_REAL) (iy1 + RoundShift((iy2 - iy1) * iFrac, 15));
+
+		im++;
+
+		rtOut = rtOut + rTStep;
+	} 
+	while (rtOut < rBlockDuration);
+
+	rtOut -= iInputBlockSize * INTERP_DECIM_I_D;
+
+	return im;
+}
+#endif
+
 void CResample::Init(int iNewInputBlockSize)
 {
 	iInputBlockSize = iNewInputBlockSize;
@@ -112,6 +172,19 @@ void CResample::Init(int iNewInputBlockSize)
 
 	/* Init absolute time for output stream (at the end of the history part */
 	rtOut = (_REAL) (iHistorySize - 1) * INTERP_DECIM_I_D;
+
+#if USE_FIXED_POINT
+	bFixedPoint = FixedPointRx;
+
+	vecsIntBuff.Init(iInputBlockSize + iHistorySize, 0);
+	vecsInput.Init(iInputBlockSize);
+
+	for (int ip = 0; ip < INTERP_DECIM_I_D; ip++)
+	{
+		for (int i = 0; i < NUM_TAPS_PER_PHASE; i++)
+			sResTaps[ip][i] = SatQ15(RoundReal(fResTaps1To1[ip][i] * FIXP_Q15_ONE));
+	}
+#endif
 }
 
 void CAudioResample::Resample(CVector<_REAL>& rInput, CVector<_REAL>& rOutput)
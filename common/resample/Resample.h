@@ -32,6 +32,7 @@
 #include "ResampleFilter.h"
 #include "../GlobalDefinitions.h"
 #include "../Vector.h"
+#include "../FixedPoint.h"
 
 
 /* Classes ********************************************************************/
@@ -54,6 +55,17 @@ protected:
 	int						iHistorySize;
 
 	int						iInputBlockSize;
+
+#if USE_FIXED_POINT
+	/* Same filter with Q15 taps and 16 bit samples */
+	int ResampleFixed(CVector<_REAL>* prInput, CVector<_REAL>* prOutput,
+					  _REAL rRation);
+
+	_BOOLEAN				bFixedPoint;
+	CShiftRegister<_FIXP16>	vecsIntBuff;
+	CVector<_FIXP16>		vecsInput;
+	_FIXP16					sResTaps[INTERP_DECIM_I_D][NUM_TAPS_PER_PHASE];
+#endif
 };
 
 class CAudioResample
@@ -35,6 +35,7 @@
 //#include "libs/callsign.h"
 #include "callsign2.h" //edit by DM
 #include "settings.h"
+#include "datadecoding/picpool.h"
 
 HANDLE hComm = nullptr;;
 
@@ -214,6 +215,14 @@ void savevar(void)
 		fprintf(set, "%d TxLevel\n", TxLevel); //added DM
 		fprintf(set, "%d Allow_Text_Message\n", AllowRXTextMessage);
 		fprintf(set, "%d DV_Compressor\n", DVcomp);
+		fprintf(set, "%d PicPool_MB\n", PicPoolBudgetMB);
+		fprintf(set, "%d LZMA_Fast\n", LzmaFastMode);
+		fprintf(set, "%d Sound_Backend\n", SoundBackend);
+		fprintf(set, "%d Sound_Latency_ms\n", SoundLatencyMs);
+		fprintf(set, "%d Thread_Core_RX\n", ThreadCoreRx);
+		fprintf(set, "%d Thread_Core_TX\n", ThreadCoreTx);
+		fprintf(set, "%d Thread_Realtime\n", ThreadRealtime);
+		fprintf(set, "%d Lock_Memory_MB\n", ThreadLockMB);
 		fclose(set);
 	}
 }
@@ -247,11 +256,27 @@ void getvar(void)
 		fscanf(set, "%d %s", &TxLevel, &rubbish); //added DM
 		fscanf(set, "%d %s", &AllowRXText, &rubbish);
 		fscanf(set, "%d %s", &DVcomp, &rubbish);
+		fscanf(set, "%d %s", &PicPoolBudgetMB, &rubbish);
+		fscanf(set, "%d %s", &LzmaFastMode, &rubbish);
+		fscanf(set, "%d %s", &SoundBackend, &rubbish);
+		fscanf(set, "%d %s", &SoundLatencyMs, &rubbish);
+		fscanf(set, "%d %s", &ThreadCoreRx, &rubbish);
+		fscanf(set, "%d %s", &ThreadCoreTx, &rubbish);
+		fscanf(set, "%d %s", &ThreadRealtime, &rubbish);
+		fscanf(set, "%d %s", &ThreadLockMB, &rubbish);
 		fclose(set);
 
 		disptype = Display;
 		if (disptype == 9) disptype = OSCDISP; //scope display type
 		if (!TxLevel) TxLevel = FALSE; //if setting not found, set it to FALSE
+		if (PicPoolBudgetMB <= 0) PicPoolBudgetMB = PICPOOL_DEF_BUDGET_MB; //invalid setting, use default pool budget
+		if (LzmaFastMode != 1) LzmaFastMode = FALSE; //if setting not found, use maximum compression
+		if (SoundBackend != 1) SoundBackend = 0; //if setting not found, use the sound card
+		if ((SoundLatencyMs < 50) || (SoundLatencyMs > 5000)) SoundLatencyMs = 500; //invalid setting, use default latency
+		if (ThreadCoreRx < -1) ThreadCoreRx = -1; //-1: the threads are not pinned
+		if (ThreadCoreTx < -1) ThreadCoreTx = -1;
+		if (ThreadRealtime != 0) ThreadRealtime = TRUE; //if setting not found, use MMCSS
+		if ((ThreadLockMB < 0) || (ThreadLockMB > 1024)) ThreadLockMB = 0; //invalid setting, lock nothing
 		if (!AllowRXText) AllowRXTextMessage = TRUE; //if setting not found, make it TRUE
 		if (AllowRXText == 0) AllowRXTextMessage = FALSE;
 		if (AllowRXText == 1) AllowRXTextMessage = TRUE;
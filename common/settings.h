@@ -31,6 +31,14 @@ extern BOOL rtsonfac;
 extern BOOL dtronfac;
 extern BOOL fastreset;
 extern int ECCmode;
+extern int PicPoolBudgetMB;
+extern int LzmaFastMode;
+extern int SoundBackend;
+extern int SoundLatencyMs;
+extern int ThreadCoreRx;
+extern int ThreadCoreTx;
+extern int ThreadRealtime;
+extern int ThreadLockMB;
 
 void comtx(char port);
 void dotx(void);
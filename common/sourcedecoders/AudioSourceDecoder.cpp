@@ -38,7 +38,6 @@
 
 //LPC_10
 struct lpc10_e_state *es;
-struct lpc10_d_state *ds;
 
 //short wavdata[LPC10_SAMPLES_PER_FRAME]; //Array for Codec input
 short wavdata[maxLPC10_SAMPLES_PER_FRAME*2]; //Array for Codec input - does this need to be x2 as well? (for bytes value)
@@ -51,19 +50,13 @@ int lpcsumT = 27; //LPC-10 CRC is always 27 bits now - this always divides evenl
 int lpciterT = 0;
 int upsampleT = 0;
 
-int lpcblocksR = 0;
 int lpcsumR = lpcsumT;
-int lpciterR = 0;
-int upsampleR = 0;
-int size1 = 0;
 
 int LPC10_SAMPLES_PER_FRAME = 180; //default on Mode B, QAM16, normal protection, 2.5kHz
 
 //SPEEX
 SpeexBits encbits;
-SpeexBits decbits;
 void *enc_state;
-void *dec_state;
 int speex_frame_size;
 float spinp[160];
 char spoutp[20];
@@ -519,19 +512,18 @@ void CAudioSourceEncoder::ProcessDataInternal(CParameter& TransmParam)
 	{
 		// TODO: make a separate modul for data encoding
 				/* Write data packets in stream */
-		CVector<_BINARY> vecbiData;
 		const int iNumPack = iOutputBlockSize / iTotPacketSize;
 		int iPos = 0;
 
 		for (int j = 0; j < iNumPack; j++)
 		{
 			/* Get new packet */
-			DataEncoder.GeneratePacket(vecbiData);
+			DataEncoder.GeneratePacket(vecbiDataPacket);
 
 			/* Put it on stream */
 			for (i = 0; i < iTotPacketSize; i++)
 			{
-				(*pvecOutputData)[iPos] = vecbiData[i];
+				(*pvecOutputData)[iPos] = vecbiDataPacket[i];
 				iPos++;
 			}
 		}
@@ -665,15 +657,17 @@ void CAudioSourceDecoder::ProcessDataInternal(CParameter& ReceiverParam)
 		//LPC-10 in all modes ====================================================================================
 		//First, make sure all the variables are current
 		//compute LPC data sizes
-		if (iInputBlockSize > 0) {
-			LPC10_SAMPLES_PER_FRAME = max(min((180 / max(lpcblocksR, 6)) * LPCscale, maxLPC10_SAMPLES_PER_FRAME), 180); //adapt to available bandwidth DM
+		if (lpcblocksR > 0) {
+			//the codec reads the global frame length, the buffers of this receiver use its own copy
+			const int iLPCFrameLen = max(min((180 / max(lpcblocksR, 6)) * LPCscale, maxLPC10_SAMPLES_PER_FRAME), 180); //adapt to available bandwidth DM
+			LPC10_SAMPLES_PER_FRAME = iLPCFrameLen;
 			lpciterR = (lpcblocksR * LPC10_BITS_IN_COMPRESSED_FRAME) / lpcsumR;
-			upsampleR = 35000 / (LPC10_SAMPLES_PER_FRAME * lpcblocksR);
+			upsampleR = 35000 / (iLPCFrameLen * lpcblocksR);
 
 			//if the sizes change, reinit the buffers
-			int LPFDecSize = lpcblocksR * LPC10_SAMPLES_PER_FRAME;
+			int LPFDecSize = lpcblocksR * iLPCFrameLen;
 			if (speechLPFDec.GetSize() != LPFDecSize) speechLPFDec.Init(LPFDecSize);
-			size1 = upsampleR * LPC10_SAMPLES_PER_FRAME * lpcblocksR;
+			size1 = upsampleR * iLPCFrameLen * lpcblocksR;
 			if (speechLPFDec2.GetSize() != size1) speechLPFDec2.Init(size1);
 
 
@@ -705,7 +699,7 @@ void CAudioSourceDecoder::ProcessDataInternal(CParameter& ReceiverParam)
 
 					//Gather all samples into the new buffer DM
 					//for each pass, add another block of samples
-					for (j = 0; j < LPC10_SAMPLES_PER_FRAME; j++) //edited DM
+					for (j = 0; j < iLPCFrameLen; j++) //edited DM
 					{
 						speechLPFDec[w++] = wavdata[j] * 0.7; //fill the buffer and scale level DM
 					}
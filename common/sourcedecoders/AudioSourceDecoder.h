@@ -37,6 +37,7 @@
 #include "../TextMessage.h"
 #include "../datadecoding/DataDecoder.h"
 #include "lpc10.h"
+#include "../speex/speex_bits.h"
 
 /* Definitions ****************************************************************/
 /* Forgetting factor for audio blocks in case CRC was wrong */
@@ -101,6 +102,7 @@ protected:
 	CDataEncoder		DataEncoder{};
 	int					iTotPacketSize{};
 	_BOOLEAN			bIsDataService{};
+	CVector<_BINARY>	vecbiDataPacket{}; /* keeps its memory over the frames */
 
 	CRealVector			speechIN; //speech buffer DM
 	CRealVector			speechLPFDec; //~8kHz LPC-10 decimation buffer DM
@@ -163,6 +165,16 @@ protected:
 
 	int					iTotalFrameSize{};
 
+	/* Codec states and LPC-10 block sizes, each receiver (also the second
+	   one of the dual-channel mode) has its own */
+	lpc10_decoder_state*	ds{};
+	SpeexBits			decbits{};
+	void*				dec_state{};
+	int					lpcblocksR{};
+	int					lpciterR{};
+	int					upsampleR{};
+	int					size1{};
+
 	_BOOLEAN			bAudioIsOK{};
 	_BOOLEAN			bAudioWasOK{};
 
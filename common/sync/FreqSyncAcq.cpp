@@ -43,7 +43,7 @@ void CFreqSyncAcq::ProcessDataInternal(CParameter& ReceiverParam)
 	fftw_real	rMaxValue = 0; //init DM
 	int			iNumDetPeaks = 0; //init DM
 	_BOOLEAN	bNoPeaksLeft = FALSE; //init DM
-	CRealVector vecrPSDPilPoin(3);
+	CRealVector vecrPSDPilPoin(3, VTY_TEMP);
 
 	if (bAquisition == TRUE)
 	{
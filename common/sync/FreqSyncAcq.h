@@ -74,7 +74,7 @@ public:
 		rWinSize((_REAL) 200),
 		veciTableFreqPilots(3), /* 3 freqency pilots */
 		rCenterFreq((_REAL) 350),
-		rPeakBoundFiltToSig(PEAK_BOUND_FILT2SIGNAL_2) {}
+		rPeakBoundFiltToSig(PEAK_BOUND_FILT2SIGNAL_2), iHalfBuffer(0) {}
 	virtual ~CFreqSyncAcq() {}
 
 	void SetSearchWindow(_REAL rNewCenterFreq, _REAL rNewWinSize);
@@ -51,10 +51,9 @@ void CTimeSync::ProcessDataInternal(CParameter& ReceiverParam)
 	CReal			rMaxValue = 0;
 	CReal			rMaxValRMCorr = 0;
 	CReal			rSecHighPeak = 0;
-	CRealVector		rvecInpTmp;
-	CRealVector		rResMode(NUM_ROBUSTNESS_MODES);
+	CReal			rResMode[NUM_ROBUSTNESS_MODES];
 	/* Max number of detected peaks ("5" for safety reasons. Could be "2") */
-	CVector<int>	iNewStartIndexField(5);
+	int				iNewStartIndexField[5];
 
 	/* Write new block of data at the end of shift register */
 	HistoryBuf.AddEnd((*pvecInputData), iInputBlockSize);
@@ -72,8 +71,9 @@ void CTimeSync::ProcessDataInternal(CParameter& ReceiverParam)
 		   from DC to 2.5 kHz. */
 
 		/* The FIR filter intermediate buffer must be adjusted to the new
-		   input block size since the size can be vary */
-		rvecInpTmp.Init(iInputBlockSize);
+		   input block size since the size can be vary. It is a temporary of
+		   the frame arena */
+		CRealVector rvecInpTmp(iInputBlockSize, VTY_TEMP);
 
 		/* Copy CVector data in CMatlibVector */
 		for (i = 0; i < iInputBlockSize; i++)
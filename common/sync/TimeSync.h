@@ -87,7 +87,7 @@ public:
 		rGuardPow(NUM_ROBUSTNESS_MODES),
 		cGuardCorrBlock(NUM_ROBUSTNESS_MODES),
 		rGuardPowBlock(NUM_ROBUSTNESS_MODES),
-		rLambdaCoAv((CReal) 1.0) {}
+		rLambdaCoAv((CReal) 1.0), iRMCorrBufSize(0) {}
 	virtual ~CTimeSync() {}
 
 	void StartAcquisition();
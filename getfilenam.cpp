@@ -38,6 +38,7 @@
 #include "getfilenam.h"
 #include "common/DrmTransmitter.h"
 #include "common/settings.h"
+#include "common/datadecoding/TxPrepCache.h"
 #include "common/callsign2.h" //Added DM
 
 /*--------------------------------------------------------------------
@@ -201,6 +202,15 @@ void putfiles(HWND hwnd)
 	SetDlgItemText( hwnd, IDC_PICFILE_TX, acttxt);
 }
 
+void prepfiles(void)
+{
+	//queue all files in the TX list for background preparation in the current ECC mode
+	//files which are already prepared are skipped, so this can be called after every change
+	int k = 0; //init DM
+	for (k = 0; k < TXpicpospt; k++)
+		TxPrepCache.Request(pictfile[k], filetitle[k], ECCmode);
+}
+
 /*
 //Tick or untick the appropriate sound device in the menu - ALL MOVED TO Dialog.cpp
 void unchecksoundrx(HWND hDlg, int num)
@@ -56,6 +56,8 @@ void SetTXmode(BOOL ispic);
 
 void putfiles(HWND hwnd);
 
+void prepfiles(void);
+
 void unchecksoundrx(HWND hDlg, int num);
 void unchecksoundtx(HWND hDlg, int num);
 void unchecksoundvoI(HWND hDlg, int num);
@@ -27,7 +27,13 @@
 #include "common/GlobalDefinitions.h"
 #include "common/DrmReceiver.h"
 #include "common/DrmTransmitter.h"
+#include "common/WidebandReceiver.h"
+#include "common/ModulStats.h"
+#include "common/EventQueue.h"
+#include "common/ThreadSetup.h"
+#include "Logging.h"
 #include "hamdrm.h"
+#include "sound/SoundLoopback.h"
 #include "common/libs/callsign.h"
 #include "common/bsr.h"
 #include "common/ptt.h"
@@ -41,10 +47,21 @@ char sFileName[200];
 CDRMReceiver	DRMReceiver;
 CDRMTransmitter	DRMTransmitter;
 
+// Second receiver for the right input channel (dual channel mode), only
+// created when it is used
+CDRMReceiver*	pDRMReceiver2 = NULL;
+
+// Wideband mode, one receiver per detected signal (channels 2 and up)
+CWidebandReceiver	WidebandReceiver;
+
+// Diversity mode, the right channel is combined into the left one
+CDiversityCombiner	DiversityCombiner;
+
 // Implementation *************************************************************
 
 HWND messhwnd;
 BOOL RX_Running = FALSE;
+BOOL RX2_Running = FALSE;
 BOOL TX_Running = FALSE;
 BOOL TX_Sending = FALSE;
 
@@ -57,11 +74,55 @@ BOOL TX_Sending = FALSE;
 //MS_MOT_OBJ_STAT	7
 
 int messtate[10] = {-1,-1,-1,-1,-1,-1,-1,-1,-1,-1};
+int messtate2[10] = {-1,-1,-1,-1,-1,-1,-1,-1,-1,-1};
+int messtateWB[WB_MAX_SIGNALS][10];
+
+// Each receiver runs in its own thread, the thread knows its channel
+thread_local int iRxChannel = 0;
+thread_local CMessageSink* pMessageSink = NULL;
+thread_local int iHeapCountPause = 0;
+
+int * GetMessState(int ch)
+{
+	if (ch == 1) return messtate2;
+	if ((ch >= RX_CHANNEL_WIDEBAND) && (ch < RX_CHANNEL_WIDEBAND + WB_MAX_SIGNALS))
+		return messtateWB[ch - RX_CHANNEL_WIDEBAND];
+	return messtate;
+}
 
 void PostWinMessage(unsigned int MessID, int iMessageParam)
 {
-	messtate[MessID] = iMessageParam;
-	if (MessID == MS_RESET_ALL) for (int i=0;i<10;i++) messtate[i] = -1;
+	if (pMessageSink != NULL)
+	{
+		pMessageSink->OnMessage(MessID, iMessageParam);
+		return;
+	}
+
+	int * state = GetMessState(iRxChannel);
+	if ((MessID == MS_FAC_CRC) && (state[MessID] != iMessageParam))
+		EventQueue.Post(EV_FAC_CRC, iMessageParam);
+	if ((MessID == MS_MSC_CRC) && (state[MessID] != iMessageParam))
+		EventQueue.Post(EV_MSC_CRC, iMessageParam);
+	state[MessID] = iMessageParam;
+	if (MessID == MS_RESET_ALL) for (int i=0;i<10;i++) state[i] = -1;
+}
+
+CDRMReceiver * GetReceiverCh(int ch)
+{
+	if (ch == 0) return &DRMReceiver;
+	if ((ch == 1) && (pDRMReceiver2 != NULL)) return pDRMReceiver2;
+	if ((ch >= RX_CHANNEL_WIDEBAND) && (ch < RX_CHANNEL_WIDEBAND + WB_MAX_SIGNALS))
+		return WidebandReceiver.GetReceiver(ch - RX_CHANNEL_WIDEBAND);
+	return NULL;
+}
+
+BOOL IsRunningCh(int ch)
+{
+	if (ch == 0) return RX_Running;
+	if (ch == 1) return RX2_Running;
+	if ((ch >= RX_CHANNEL_WIDEBAND) && (ch < RX_CHANNEL_WIDEBAND + WB_MAX_SIGNALS))
+		return WidebandReceiver.IsActive(ch - RX_CHANNEL_WIDEBAND);
+	return FALSE;
 }
 
 __declspec(dllexport) int __cdecl getFatalErr(void)
@@ -76,7 +137,8 @@ __declspec(dllexport) int __cdecl getFatalErr(void)
 
 void RxFunction(  void *dummy  )
 {
-	SetThreadPriority(GetCurrentThread(), THREAD_PRIORITY_ABOVE_NORMAL);
+	CDSPThread DSPThread(DSP_THREAD_RX, L"EasyDRF RX");
+	if (RX2_Running && (ThreadCoreRx < 0)) SetThreadIdealProcessor(GetCurrentThread(), 0);
 	try
 	{
 		DRMReceiver.Start();	
@@ -87,9 +149,24 @@ void RxFunction(  void *dummy  )
 	}
 }
 
+void RxFunction2(  void *dummy  )
+{
+	iRxChannel = 1;
+	CDSPThread DSPThread(DSP_THREAD_RX2, L"EasyDRF RX2");
+	if (ThreadCoreRx < 0) SetThreadIdealProcessor(GetCurrentThread(), 1);
+	try
+	{
+		pDRMReceiver2->Start();	
+	}
+	catch (CGenErr GenErr)
+	{
+		messtate2[9] = 1;
+	}
+}
+
 void TxFunction(  void *dummy  )
 {
-	SetThreadPriority(GetCurrentThread(), THREAD_PRIORITY_ABOVE_NORMAL);
+	CDSPThread DSPThread(DSP_THREAD_TX, L"EasyDRF TX");
 	try
 	{
 		DRMTransmitter.Start();
@@ -103,6 +180,7 @@ void TxFunction(  void *dummy  )
 
 // Initialize File Path
 char rxfilepath[200] = { 0 };
+char rxfilepath2[200] = { 0 };
 char rxcorruptpath[200] = { 0 };
 char bsrpath[200] = { 0 };
 
@@ -110,6 +188,13 @@ __declspec(dllexport) void __cdecl SetRXFileSavePath(char * PathToSaveRXFile)
 {
 	strcpy(rxfilepath,PathToSaveRXFile);
 }
+__declspec(dllexport) void __cdecl SetRXFileSavePathCh(int ch, char * PathToSaveRXFile)
+{
+	if (ch == 1)
+		strcpy(rxfilepath2,PathToSaveRXFile);
+	else
+		strcpy(rxfilepath,PathToSaveRXFile);
+}
 __declspec(dllexport) void __cdecl SetRXCorruptSavePath(char * PathToCorruptRXFile)
 {
 	strcpy(rxcorruptpath,PathToCorruptRXFile);
@@ -205,6 +290,25 @@ __declspec(dllexport) int  __cdecl GetState(int * states)
 		*statept++ = messtate[i];
 	return 8;
 }
+
+__declspec(dllexport) int  __cdecl GetStateCh(int ch, int * states)  
+{
+	int * state = GetMessState(ch);
+	for (int i=0;i<8;i++)
+		states[i] = state[i];
+	return 8;
+}
+
+// Events, the callback runs in a thread of its own (see common/EventQueue.cpp)
+__declspec(dllexport) void __cdecl SetEventCallback(EventCallback callback, void * user)
+{
+	EventQueue.Start(callback, user);
+}
+
+__declspec(dllexport) int __cdecl GetEventsLost()
+{
+	return EventQueue.GetNumLost();
+}
 	
 // Set com-port for PTT 
 __declspec(dllexport) void __cdecl SetCommDevice(int dev)
@@ -248,6 +352,37 @@ __declspec(dllexport) void __cdecl SetAudDeviceOut(int ID)
 	DRMTransmitter.GetSoundInterface()->SetOutDev(ID);
 }
 
+// Audio backend (0 = sound card, 1 = loopback TX -> RX), call before the threads are started
+__declspec(dllexport) void __cdecl SetAudBackend(int backend)
+{
+	CSoundInterface* pBackend = NULL;
+	if (backend == SOUND_BACKEND_LOOPBACK)
+		pBackend = GetSoundLoopback();
+	DRMReceiver.SetSoundBackend(pBackend);
+	DRMTransmitter.SetSoundBackend(pBackend);
+}
+__declspec(dllexport) void __cdecl SetAudLatency(int ms)
+{
+	DRMReceiver.GetSoundInterface()->SetLatency(ms);
+}
+__declspec(dllexport) int __cdecl GetAudOverruns()
+{
+	return DRMReceiver.GetReceiver()->GetSoundInterface()->GetNumOverruns();
+}
+__declspec(dllexport) int __cdecl GetAudUnderruns()
+{
+	return DRMReceiver.GetReceiver()->GetSoundInterface()->GetNumUnderruns();
+}
+
+// Setup of the RX/TX threads, call before the threads are started
+__declspec(dllexport) void __cdecl SetThreadParams(int rxcore, int txcore, int realtime, int lockmb)
+{
+	ThreadCoreRx = (rxcore < 0) ? -1 : rxcore;
+	ThreadCoreTx = (txcore < 0) ? -1 : txcore;
+	ThreadRealtime = (realtime != 0) ? TRUE : FALSE;
+	ThreadLockMB = ((lockmb < 0) || (lockmb > 1024)) ? 0 : lockmb;
+}
+
 
 // File transfer
 __declspec(dllexport) boolean __cdecl SetFileTX(char * FileName, char * Dir_and_FileName, int inst)  
@@ -298,10 +433,10 @@ __declspec(dllexport) boolean __cdecl SendBSR(int inst, int fast)
 
 int iTID = 0;
 
-__declspec(dllexport) boolean __cdecl GetFileRX(char * FileName)  
+boolean SaveFileRX(CDRMReceiver & Receiver, char * savepath, char * FileName)
 {
 	CMOTObject NewPic;
-	if (DRMReceiver.GetDataDecoder()->GetSlideShowPicture(NewPic))
+	if (Receiver.GetDataDecoder()->GetSlideShowPicture(NewPic))
 	{
 		char filenam[300];
 		int picsize,i;
@@ -327,7 +462,7 @@ __declspec(dllexport) boolean __cdecl GetFileRX(char * FileName)
 		}
 		else
 		{
-			wsprintf(filenam,"%s%s",rxfilepath,NewPic.strName.c_str());
+			wsprintf(filenam,"%s%s",savepath,NewPic.strName.c_str());
 			set = fopen(filenam,"wb");
 			if (set != NULL)
 			{
@@ -341,6 +476,21 @@ __declspec(dllexport) boolean __cdecl GetFileRX(char * FileName)
 	return FALSE;
 }
 
+__declspec(dllexport) boolean __cdecl GetFileRX(char * FileName)  
+{
+	return SaveFileRX(DRMReceiver, rxfilepath, FileName);
+}
+
+__declspec(dllexport) boolean __cdecl GetFileRXCh(int ch, char * FileName)  
+{
+	CDRMReceiver * Receiver = GetReceiverCh(ch);
+	if (Receiver == NULL) return FALSE;
+	// Without an own path, channel 2 saves to the same directory
+	if ((ch == 1) && (rxfilepath2[0] != 0))
+		return SaveFileRX(*Receiver, rxfilepath2, FileName);
+	return SaveFileRX(*Receiver, rxfilepath, FileName);
+}
+
 __declspec(dllexport) int __cdecl GetLastTID()
 {
 	return iTID;
@@ -413,6 +563,88 @@ __declspec(dllexport) void __cdecl StartThreadRX(int AudDev)
 	}
 }
 
+void StartDual(int AudDev, BOOL bDiversity)
+{
+	try
+	{
+		if (pDRMReceiver2 == NULL)
+			pDRMReceiver2 = new CDRMReceiver;
+
+		CSound* pSound = DRMReceiver.GetSoundInterface();
+		pSound->SetDualChannel(TRUE);
+		pSound->SetInDev(AudDev);
+		DRMReceiver.SetSoundBackend(pSound->GetChannel(0));
+		pDRMReceiver2->SetSoundBackend(pSound->GetChannel(1));
+
+		DiversityCombiner.Reset();
+		if (bDiversity)
+		{
+			DRMReceiver.SetDiversity(&DiversityCombiner, DIV_MAIN);
+			pDRMReceiver2->SetDiversity(&DiversityCombiner, DIV_AUX);
+		}
+		else
+		{
+			DRMReceiver.SetDiversity(NULL, DIV_MAIN);
+			pDRMReceiver2->SetDiversity(NULL, DIV_AUX);
+		}
+
+		DRMReceiver.Init();
+		pDRMReceiver2->Init();
+		RX_Running = TRUE;
+		RX2_Running = TRUE;
+		_beginthread(RxFunction,0,NULL);
+		_beginthread(RxFunction2,0,NULL);
+	}
+	catch(CGenErr)
+	{
+		messtate[9] = 3;
+	}
+}
+
+// Decode the left and the right input channel with two receivers. The
+// capture thread splits the stereo stream once for both
+__declspec(dllexport) void __cdecl StartThreadRXDual(int AudDev)
+{
+	StartDual(AudDev, FALSE);
+}
+
+// Two antennas on the left and right input, the cells of both receivers are
+// combined (maximum-ratio) in the first one. Files come from channel 0, the
+// second receiver still saves what only it has received
+__declspec(dllexport) void __cdecl StartThreadRXDiversity(int AudDev)
+{
+	StartDual(AudDev, TRUE);
+}
+
+__declspec(dllexport) void __cdecl GetDiversityStat(int * symbols, int * combined)
+{
+	DiversityCombiner.GetStatistics(*symbols, *combined);
+}
+
+// Find the signals in the whole input and decode each of them with its own
+// receiver, channels 2 and up
+__declspec(dllexport) void __cdecl StartThreadRXWide(int AudDev)
+{
+	for (int i=0;i<WB_MAX_SIGNALS;i++)
+		for (int j=0;j<10;j++) messtateWB[i][j] = -1;
+
+	CSoundInterface* pSource = DRMReceiver.GetReceiver()->GetSoundInterface();
+	pSource->SetInDev(AudDev);
+	WidebandReceiver.Start(pSource);
+}
+
+__declspec(dllexport) void __cdecl SetWideRange(int LowFreq, int HighFreq)
+{
+	WidebandReceiver.SetSearchRange(LowFreq, HighFreq);
+}
+
+__declspec(dllexport) int __cdecl GetWideSignals(int * freqs)
+{
+	for (int i=0;i<WB_MAX_SIGNALS;i++)
+		freqs[i] = (int)WidebandReceiver.GetSignalFreq(i);
+	return WB_MAX_SIGNALS;
+}
+
 __declspec(dllexport) void __cdecl StartThreadTX(int AudDev)
 {
 	try
@@ -433,8 +665,13 @@ __declspec(dllexport) void __cdecl StartThreadTX(int AudDev)
 __declspec(dllexport) void __cdecl StopThreads()  
 {
 	DRMReceiver.Stop(); 
+	if (pDRMReceiver2 != NULL) pDRMReceiver2->Stop();
+	WidebandReceiver.Stop();
 	DRMTransmitter.Stop();
 	TX_Sending = FALSE;
+	ModulStats.StopDump();
+	EventQueue.Stop();
+	ReceptionLog.Stop();
 }
 
 // Start/Stop DRM routines
@@ -444,9 +681,17 @@ __declspec(dllexport) void __cdecl ControlRX(boolean SetON)
 	{
 		DRMReceiver.SetInStartMode();
 		DRMReceiver.Rec();
+		if (RX2_Running)
+		{
+			pDRMReceiver2->SetInStartMode();
+			pDRMReceiver2->Rec();
+		}
 	}
 	else 
+	{
 		DRMReceiver.NotRec();
+		if (RX2_Running) pDRMReceiver2->NotRec();
+	}
 }
 
 __declspec(dllexport) void __cdecl ControlTX(boolean SetON)
@@ -467,36 +712,125 @@ __declspec(dllexport) void __cdecl ControlTX(boolean SetON)
 	}
 }
 
+__declspec(dllexport) float __cdecl RenderTX(char * WavFileName, float * speed)
+{
+	_REAL rSpeed = 0.0;
+	_REAL rSeconds = 0.0;
+	*speed = 0.0;
+	if (TX_Sending) return 0.0;
+	try
+	{
+		DRMTransmitter.GetParameters()->Service[0].strLabel = getcall();
+		rSeconds = DRMTransmitter.Render(WavFileName, rSpeed);
+	}
+	catch(CGenErr)
+	{
+		messtate[9] = 4;
+		return 0.0;
+	}
+	*speed = (float)rSpeed;
+	return (float)rSeconds;
+}
+
+__declspec(dllexport) int __cdecl GetModuleStats(char * names, float * data, int maxmodules)
+{
+	CVector<CModulStatSnap> vecSnap;
+	const int iNum = min(ModulStats.GetSnapshot(vecSnap), maxmodules);
+	for (int i=0;i<iNum;i++)
+	{
+		strncpy(&names[i * MODSTATS_NAME_LEN], vecSnap[i].strName.c_str(), MODSTATS_NAME_LEN - 1);
+		names[i * MODSTATS_NAME_LEN + MODSTATS_NAME_LEN - 1] = 0;
+		data[i * 7 + 0] = (float)vecSnap[i].llNumCalls;
+		data[i * 7 + 1] = (float)vecSnap[i].rTimeTotalMs;
+		data[i * 7 + 2] = (float)vecSnap[i].rTimeMaxUs;
+		data[i * 7 + 3] = (float)vecSnap[i].llSamplesIn;
+		data[i * 7 + 4] = (float)vecSnap[i].llSamplesOut;
+		data[i * 7 + 5] = (float)vecSnap[i].iInputFill;
+		data[i * 7 + 6] = (float)vecSnap[i].iInputFillMax;
+	}
+	return iNum;
+}
+
+__declspec(dllexport) void __cdecl ResetModuleStats()
+{
+	ModulStats.Reset();
+}
+
+__declspec(dllexport) void __cdecl SetModuleStatsDump(char * FileName, int seconds)
+{
+	if ((FileName == NULL) || (seconds <= 0)) ModulStats.StopDump();
+	else ModulStats.StartDump(FileName, seconds);
+}
+
+__declspec(dllexport) void __cdecl SetReceptionLog(char * FileName)
+{
+	if (FileName == NULL) ReceptionLog.Stop();
+	else ReceptionLog.Start(FileName);
+}
+
+__declspec(dllexport) boolean __cdecl ExportReceptionLog(char * FileName, char * OutPath)
+{
+	return (ReceptionLog.Export(FileName, OutPath) == TRUE);
+}
+
 
 // Get data for display
 
+// The data comes from the latest snapshot of the receive thread, see
+// common/DisplaySnapshot.cpp. Each calling thread has its own copy
+
 int vecrSize;
-CVector<_REAL>		vecrData;
-CVector<_REAL>		vecrScale;
-CVector<_COMPLEX>	veccData;
+thread_local CDisplaySnapshot DisplaySnap;
 
 __declspec(dllexport) int  __cdecl GetSpectrum(float * data) // 500 bins
 {
-	DRMReceiver.GetReceiver()->GetInputSpec(vecrData);
-	vecrSize = vecrData.Size();
+	DRMReceiver.GetDisplay(DisplaySnap);
+	vecrSize = DisplaySnap.vecrInputSpec.Size();
 	if (vecrSize >= 500) 
 	{
 		PFLOAT farr = data;
 		for (int i=0;i<500;i++)
-			*farr++ = (float)vecrData[i];
+			*farr++ = (float)DisplaySnap.vecrInputSpec[i];
 		return 500;
 	}
 	return 0;
 }
 
+// Lines of the input STFT, copied out of its history without computation
+
+thread_local CVector<float> vecfLines;
+
+__declspec(dllexport) int  __cdecl GetSpectrumLines(int * line, float * data, int maxlines, int bins)
+{
+	CStft& Stft = DRMReceiver.GetStft();
+	if (bins != Stft.GetNumBins()) return -1;
+
+	const int iNum = Stft.GetLines(*line, maxlines, vecfLines);
+
+	/* The size may have been changed right now */
+	if (vecfLines.Size() != iNum * bins) return -1;
+	if (iNum > 0) memcpy(data, &vecfLines[0], iNum * bins * sizeof(float));
+	return iNum;
+}
+
+__declspec(dllexport) int  __cdecl GetSpectrumBins()
+{
+	return DRMReceiver.GetStft().GetNumBins();
+}
+
+__declspec(dllexport) void __cdecl SetSpectrumParams(int size, int hop)
+{
+	DRMReceiver.GetStft().SetParams(size, hop);
+}
+
 __declspec(dllexport) int  __cdecl GetSPSD(float * data)
 {
-	DRMReceiver.GetOFDMDemod()->GetPowDenSpec(vecrData);
+	DRMReceiver.GetDisplay(DisplaySnap);
 	PFLOAT farr = data;
-	vecrSize = vecrData.Size();
+	vecrSize = DisplaySnap.vecrPSD.Size();
 	if (vecrSize >= 400) vecrSize = 400; 
 	for (int i=0;i<vecrSize;i++)
-		*farr++ = (float)vecrData[i];
+		*farr++ = (float)DisplaySnap.vecrPSD[i];
 	return vecrSize;
 }
 
@@ -504,36 +838,31 @@ __declspec(dllexport) int  __cdecl GetTF(float * data, float * gddata)
 {
 	PFLOAT farr1 = data;
 	PFLOAT farr2 = gddata;
-	DRMReceiver.GetChanEst()->GetTransferFunction(vecrData, vecrScale);
-	vecrSize = vecrData.Size();
+	DRMReceiver.GetDisplay(DisplaySnap);
+	vecrSize = DisplaySnap.vecrTransFct.Size();
 	if (vecrSize >= 250) vecrSize = 250;
 	for (int i=0;i<vecrSize;i++) 
 	{
-		*farr1++ = (float)vecrData[i];
-		*farr2++ = (float)vecrScale[i];
+		*farr1++ = (float)DisplaySnap.vecrTransFct[i];
+		*farr2++ = (float)DisplaySnap.vecrGroupDelay[i];
 	}
 	return vecrSize;
 }
 
 __declspec(dllexport) int  __cdecl GetIR(float*lb,float*hb,float*sg,float*eg,float*pb,float*pe,float*data)
 {
-	_REAL				rLowerBound, rHigherBound;
-	_REAL				rStartGuard, rEndGuard;
-	_REAL				rPDSBegin, rPDSEnd;
 	PFLOAT farr = data;
-	DRMReceiver.GetChanEst()->
-				GetAvPoDeSp(vecrData, vecrScale, rLowerBound, rHigherBound,
-				rStartGuard, rEndGuard, rPDSBegin, rPDSEnd);
-	*lb = (float)rLowerBound;
-	*hb = (float)rHigherBound;
-	*sg = (float)rStartGuard;
-	*eg = (float)rEndGuard;
-	*pb = (float)rPDSBegin;
-	*pe = (float)rPDSEnd;
-	vecrSize = vecrData.Size();
+	DRMReceiver.GetDisplay(DisplaySnap);
+	*lb = (float)DisplaySnap.rLowerBound;
+	*hb = (float)DisplaySnap.rHigherBound;
+	*sg = (float)DisplaySnap.rStartGuard;
+	*eg = (float)DisplaySnap.rEndGuard;
+	*pb = (float)DisplaySnap.rPDSBegin;
+	*pe = (float)DisplaySnap.rPDSEnd;
+	vecrSize = DisplaySnap.vecrImpResp.Size();
 	if (vecrSize >= 250) vecrSize = 250;
 	for (int i=0;i<vecrSize;i++) 
-		*farr++ = (float)vecrData[i];
+		*farr++ = (float)DisplaySnap.vecrImpResp[i];
 	return vecrSize;
 }
 
@@ -541,7 +870,8 @@ __declspec(dllexport) int  __cdecl GetFAC(float * datax,float * datay)
 {
 	PFLOAT farr1 = datax;
 	PFLOAT farr2 = datay;
-	DRMReceiver.GetFACMLC()->GetVectorSpace(veccData);
+	DRMReceiver.GetDisplay(DisplaySnap);
+	const CVector<_COMPLEX>& veccData = DisplaySnap.veccFACVectorSpace;
 	vecrSize = veccData.Size();
 	if (vecrSize >= 250) vecrSize = 250;
 	for (int i=0;i<vecrSize;i++)
@@ -556,7 +886,8 @@ __declspec(dllexport) int  __cdecl GetMSC(float * datax,float * datay)
 {
 	PFLOAT farr1 = datax;
 	PFLOAT farr2 = datay;
-	DRMReceiver.GetMSCMLC()->GetVectorSpace(veccData);
+	DRMReceiver.GetDisplay(DisplaySnap);
+	const CVector<_COMPLEX>& veccData = DisplaySnap.veccMSCVectorSpace;
 	vecrSize = veccData.Size();
 	if (vecrSize >= 250) vecrSize = 250;
 	for (int i=0;i<vecrSize;i++) 
@@ -567,6 +898,11 @@ __declspec(dllexport) int  __cdecl GetMSC(float * datax,float * datay)
 	return vecrSize;
 }
 
+__declspec(dllexport) void __cdecl SetDisplayRate(int rate)
+{
+	DRMReceiver.SetDisplayRate(rate);
+}
+
 __declspec(dllexport) int  __cdecl GetSNR()
 {
 	if (RX_Running)
@@ -577,7 +913,25 @@ __declspec(dllexport) int  __cdecl GetSNR()
 
 __declspec(dllexport) int  __cdecl GetLevel()
 {
-	return (int)(DRMReceiver.GetReceiver()->GetLevelMeter() * 100.0);
+	DRMReceiver.GetDisplay(DisplaySnap);
+	return (int)(DisplaySnap.rLevel * 100.0);
+}
+
+__declspec(dllexport) int  __cdecl GetSNRCh(int ch)
+{
+	CDRMReceiver * Receiver = GetReceiverCh(ch);
+	if ((Receiver != NULL) && IsRunningCh(ch))
+		return 10.0 * Receiver->GetChanEst()->GetSNREstdB();
+	else
+		return 0;
+}
+
+__declspec(dllexport) int  __cdecl GetLevelCh(int ch)
+{
+	CDRMReceiver * Receiver = GetReceiverCh(ch);
+	if (Receiver == NULL) return 0;
+	Receiver->GetDisplay(DisplaySnap);
+	return (int)(DisplaySnap.rLevel * 100.0);
 }
 
 __declspec(dllexport) int  __cdecl GetDCFreq()
@@ -672,6 +1026,7 @@ __declspec(dllexport) boolean __cdecl GetActSegm(char * data)
 __declspec(dllexport) void __cdecl ResetRX(void)
 {
 	DRMReceiver.SetInStartMode();
+	if (RX2_Running) pDRMReceiver2->SetInStartMode();
 }
 
 
@@ -41,6 +41,18 @@
 #define interleave_short 0
 #define interleave_long 1
 
+// Events for SetEventCallback
+#define event_file_rx 1		// param1 = transport ID, get it with GetFileRXCh
+#define event_bsr_rx 2		// param1 = transport ID, GetFileRXCh writes bsrreq.bin
+#define event_file_corrupt 3	// signal lost during a file, get it with GetCorruptFileRX
+#define event_fac_crc 4		// param1 = 0 ok, 2 wrong (only changes)
+#define event_msc_crc 5		// param1 = 0 ok, 1 was ok, 2 wrong (only changes)
+#define event_acq_state 6	// param1 = 1 signal found, 0 signal lost
+#define event_tx_progress 7	// param1 = file counter, param2 = percent
+#define event_lost 8		// param1 = events dropped so far (callback too slow)
+
+typedef void (__cdecl *EventCallback)(int event, int channel, int param1, int param2, void * user);
+
 
 //********************************************************************
 
@@ -54,6 +66,7 @@
 
 	// Initialize File Path (max 200 char)
 	__declspec(dllexport) void __cdecl SetRXFileSavePath(char * PathToSaveRXFile);
+	__declspec(dllexport) void __cdecl SetRXFileSavePathCh(int ch, char * PathToSaveRXFile);
 	__declspec(dllexport) void __cdecl SetRXCorruptSavePath(char * PathToCorruptRXFile);
 	__declspec(dllexport) void __cdecl SetBSRPath(char * PathToBSR);
   
@@ -77,6 +90,14 @@
 	__declspec(dllexport) int	 __cdecl GetAudNumDevOut();
 	__declspec(dllexport) char * __cdecl GetAudDeviceNameOut(int ID);
 	__declspec(dllexport) void	 __cdecl SetAudDeviceOut(int ID);
+	// Audio backend: 0 = sound card, 1 = loopback TX -> RX (set before StartThreadRX/TX)
+	__declspec(dllexport) void	 __cdecl SetAudBackend(int backend);
+	__declspec(dllexport) void	 __cdecl SetAudLatency(int ms);  // capture latency, default 500
+	__declspec(dllexport) int	 __cdecl GetAudOverruns();		// captured samples lost
+	__declspec(dllexport) int	 __cdecl GetAudUnderruns();
+	// DSP threads: core of RX and TX (-1 = any, the second receiver uses rxcore + 1),
+	// realtime 1 = MMCSS "Pro Audio", lockmb = MB of memory kept resident (set before StartThreadRX/TX)
+	__declspec(dllexport) void	 __cdecl SetThreadParams(int rxcore, int txcore, int realtime, int lockmb);
 
 	// Set Serial Device number for PTT 
 	__declspec(dllexport) void	 __cdecl SetCommDevice(int dev);
@@ -86,6 +107,8 @@
 	__declspec(dllexport) boolean __cdecl SetFileTX(char * FileName, char * Dir_and_FileName, int inst = 1);  
 		// 1 to 4 allowed for instance parameter
 	__declspec(dllexport) boolean __cdecl GetFileRX(char * FileName); 
+	__declspec(dllexport) boolean __cdecl GetFileRXCh(int ch, char * FileName); 
+		// ch 0 = left, 1 = right input channel (dual channel mode), 2 and up = wideband mode
 		// bsr requests go to root directory
 	__declspec(dllexport) boolean __cdecl GetCorruptFileRX(char * FileName);  
 	__declspec(dllexport) boolean __cdecl GetPercentTX(int * piccnt,int * percent); 
@@ -115,26 +138,64 @@
 
 	// Threads. only start once.
 	__declspec(dllexport) void __cdecl StartThreadRX(int AudDev);
+	__declspec(dllexport) void __cdecl StartThreadRXDual(int AudDev);	// decode left and right channel
+	__declspec(dllexport) void __cdecl StartThreadRXDiversity(int AudDev);	// two antennas, left and right
+	__declspec(dllexport) void __cdecl GetDiversityStat(int * symbols, int * combined);
+	__declspec(dllexport) void __cdecl StartThreadRXWide(int AudDev);	// decode all signals in the input
+	__declspec(dllexport) void __cdecl SetWideRange(int LowFreq, int HighFreq);	// DC carriers in Hz
+	__declspec(dllexport) int  __cdecl GetWideSignals(int * freqs);
+		// DC frequency of channel 2, 3, ... (0 = no signal), returns number of channels
 	__declspec(dllexport) void __cdecl StartThreadTX(int AudDev);
 	__declspec(dllexport) void __cdecl StopThreads();  
 
 	// Start/Stop DRM routines
 	__declspec(dllexport) void	  __cdecl ControlTX(boolean SetON);
+	__declspec(dllexport) float	  __cdecl RenderTX(char * WavFileName, float * speed);
+		// files of SetFileTX to a wave file, returns seconds, speed = multiple of real time
+
+	// Profiling of the processing modules (all instances of a module type are summed up)
+	__declspec(dllexport) int  __cdecl GetModuleStats(char * names, float * data, int maxmodules);
+		// names: 32 chars per module, data: 7 floats per module (calls, total ms, max us,
+		// samples in, samples out, input backlog, max input backlog), returns number of modules
+	__declspec(dllexport) void __cdecl ResetModuleStats();
+	__declspec(dllexport) void __cdecl SetModuleStatsDump(char * FileName, int seconds);
+		// appends the table to the file every few seconds, 0 = off
+	__declspec(dllexport) void __cdecl SetReceptionLog(char * FileName);
+		// appends a CSV line per received segment and file, NULL = off
+	__declspec(dllexport) boolean __cdecl ExportReceptionLog(char * FileName, char * OutPath);
+		// makes reception.js and the JS files of the series from the log, OutPath with trailing backslash
 	__declspec(dllexport) void	  __cdecl ControlRX(boolean SetON);
 	__declspec(dllexport) void    __cdecl ResetRX(void);
 
 	// Get data for display (array length 250 elements, call at 400ms intervals max except Spectrum 100ms)
 	__declspec(dllexport) int  __cdecl GetSpectrum(float * data);	// 500 bins
+	__declspec(dllexport) int  __cdecl GetSpectrumLines(int * line, float * data, int maxlines, int bins);
+		// waterfall lines 0-6 kHz since *line (0 = oldest kept), data holds maxlines * bins floats.
+		// Returns the number of lines and sets *line to the next one, -1 if bins is not GetSpectrumBins()
+	__declspec(dllexport) int  __cdecl GetSpectrumBins();
+	__declspec(dllexport) void __cdecl SetSpectrumParams(int size, int hop);
+		// FFT size (power of 2, default 2048) and hop (default 1024) at 24 kHz, bins = size / 4
 	__declspec(dllexport) int  __cdecl GetSPSD(float * data);
 	__declspec(dllexport) int  __cdecl GetTF(float * data, float * gddata);
 	__declspec(dllexport) int  __cdecl GetIR(float*lb,float*hb,float*sg,float*eg,float*pb,float*pe,float*data);
 	__declspec(dllexport) int  __cdecl GetFAC(float * datax,float * datay);
 	__declspec(dllexport) int  __cdecl GetMSC(float * datax,float * datay);
+	__declspec(dllexport) void __cdecl SetDisplayRate(int rate);
+		// snapshots of the display data per second made by the receiver (default 10), 0 = off
 
 	__declspec(dllexport) int  __cdecl GetSNR();
 	__declspec(dllexport) int  __cdecl GetLevel();
 	__declspec(dllexport) int  __cdecl GetDCFreq();
 	__declspec(dllexport) int  __cdecl GetState(int * states);  
+	__declspec(dllexport) int  __cdecl GetSNRCh(int ch);
+	__declspec(dllexport) int  __cdecl GetLevelCh(int ch);
+	__declspec(dllexport) int  __cdecl GetStateCh(int ch, int * states);  
+
+	// Events instead of polling: the callback is called from a thread of the DLL
+	// for each event_xxx, channel as in GetFileRXCh. NULL stops the events.
+	// The callback must return quickly and must not call SetEventCallback
+	__declspec(dllexport) void __cdecl SetEventCallback(EventCallback callback, void * user);
+	__declspec(dllexport) int  __cdecl GetEventsLost();
 	__declspec(dllexport) void __cdecl GetData(int * totsize,int * actsize,int * actpos);  
 
 
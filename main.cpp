@@ -25,10 +25,14 @@
  *
 \******************************************************************************/
 
+#include "Daemon.h" // winsock2.h must come before windows.h
 #include "main.h"
 #include "dialog.h"
 #include "common/libs/graphwin.h"
 #include "resource.h"
+#include "common/DrmSimulation.h"
+#include "common/ModulStats.h"
+#include "common/SimdKernels.h"
 
 HINSTANCE TheInstance = nullptr; //edited DM was 0
 
@@ -51,6 +55,52 @@ int WINAPI WinMain(_In_ HINSTANCE hInst, _In_opt_ HINSTANCE hPrevInst, _In_ LPST
 		if (!strcmp(cmdParam,"-P")) runmode = 'P';
 	}
 
+	// Profile of the processing modules, appended to modstats.txt every 10 seconds
+	if (!strcmp(cmdParam,"-m")) ModulStats.StartDump("modstats.txt", 10);
+
+	// Loopback benchmark without window (-b all points, -bq quick check), the report is written to benchmark.txt together with the render speed of the transmitter.
+	// The SIMD kernels are checked first like with -bs (simdcheck.txt), the numbers of wrong kernels mean nothing.
+	// Exit code 1 if a check fails (SIMD kernels, heap use in the steady state, counted by the Benchmark configuration, or no diversity gain)
+	if (!strcmp(cmdParam,"-b") || !strcmp(cmdParam,"-bq"))
+	{
+		const _BOOLEAN bSimdOk = SimdSelfCheck("simdcheck.txt");
+
+		CDRMSimulation Simulation;
+		std::vector<CSimPoint> vecPlan;
+
+		if (!strcmp(cmdParam,"-bq")) Simulation.MakeQuickPlan(vecPlan);
+		else Simulation.MakeDefaultPlan(vecPlan);
+
+		const _BOOLEAN bSimOk = Simulation.Run(vecPlan, "benchmark.txt");
+
+		return ((bSimdOk == TRUE) && (bSimOk == TRUE)) ? 0 : 1;
+	}
+
+#if USE_FIXED_POINT
+	// Sensitivity of the fixed-point receive path against floating point (-bf), the report is written to fixedpoint.txt
+	if (!strcmp(cmdParam,"-bf"))
+	{
+		CDRMSimulation Simulation;
+
+		return (Simulation.RunFixedPoint("fixedpoint.txt") == TRUE) ? 0 : 1;
+	}
+#endif
+
+	// Compare the SIMD kernels of this processor with the generic C code (-bs), the report is written to simdcheck.txt
+	if (!strcmp(cmdParam,"-bs"))
+	{
+		return (SimdSelfCheck("simdcheck.txt") == TRUE) ? 0 : 1;
+	}
+
+	// Without window, controlled through a local socket (-d or -d socketname), see Daemon.cpp
+	if (!strncmp(cmdParam,"-d",2) && ((cmdParam[2] == 0) || (cmdParam[2] == ' ')))
+	{
+		const char* pchSocketName = cmdParam + 2;
+		while (*pchSocketName == ' ') pchSocketName++;
+
+		return RunDaemon((*pchSocketName != 0) ? pchSocketName : DMN_SOCKET_NAME);
+	}
+
     if (!RegisterGraphClass( hInst )) return( 0 );
 
 	HWND hDialog;
@@ -167,6 +167,7 @@
 #define ID_SETTINGS_LOADLASTRXFILE      40043
 #define ID_SETTINGS_DISPLAY_OSCILLOSCOPE 40045
 #define ID_SETTINGS_VOICECOMPRESSOR     40046
+#define ID_SETTINGS_FILETRANSFER_EXPORTLOG 40047
 #define IDC_STATIC                      -1
 
 // Next default values for new objects
@@ -175,7 +176,7 @@
 #ifndef APSTUDIO_READONLY_SYMBOLS
 #define _APS_NO_MFC                     1
 #define _APS_NEXT_RESOURCE_VALUE        166
-#define _APS_NEXT_COMMAND_VALUE         40047
+#define _APS_NEXT_COMMAND_VALUE         40048
 #define _APS_NEXT_CONTROL_VALUE         1063
 #define _APS_NEXT_SYMED_VALUE           102
 #endif
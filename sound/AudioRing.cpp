@@ -0,0 +1,115 @@
+/******************************************************************************\
+ * Copyright (c) 2024
+ *
+ * Author(s):
+ *	EasyDRF developers
+ *
+ * Description:
+ *	Lock-free ring buffer between the sound card capture thread and the
+ *	receiver thread
+ *
+ *	The size is a power of two so that the free running counters can be
+ *	masked to buffer positions. Memory layout:
+ *	[0 ... iSize - 1][copy of 0 ... iMaxRead - 1]
+ *
+ ******************************************************************************
+ *
+ * This program is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation; either version 2 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ *
+\******************************************************************************/
+
+#include "AudioRing.h"
+#include "../common/ThreadSetup.h"
+#include <string.h>
+
+
+/* Implementation *************************************************************/
+CAudioRing::~CAudioRing()
+{
+	FreeDSPMemory(psBuffer);
+}
+
+void CAudioRing::Init(const int iMinSize, const int iNewMaxRead)
+{
+	int iNewSize = 1;
+	while ((iNewSize < iMinSize) || (iNewSize < iNewMaxRead))
+		iNewSize <<= 1;
+
+	/* Only allocate new memory if the layout has changed */
+	if ((iNewSize != iSize) || (iNewMaxRead != iMaxRead))
+	{
+		/* Locked in RAM with Lock_Memory_MB */
+		FreeDSPMemory(psBuffer);
+		psBuffer = (_SAMPLE*) AllocDSPMemory((iNewSize + iNewMaxRead) * sizeof(_SAMPLE));
+		memset(psBuffer, 0, (iNewSize + iNewMaxRead) * sizeof(_SAMPLE));
+
+		iSize = iNewSize;
+		iMask = iNewSize - 1;
+		iMaxRead = iNewMaxRead;
+	}
+
+	Reset();
+}
+
+void CAudioRing::Copy(const int iPos, const _SAMPLE* psData, const int iLen)
+{
+	/* "iPos + iLen" must not exceed "iSize" */
+	memcpy(&psBuffer[iPos], psData, iLen * sizeof(_SAMPLE));
+
+	/* Keep the mirror behind the end of the buffer up to date */
+	if (iPos < iMaxRead)
+	{
+		const int iMirror = (iLen < iMaxRead - iPos) ? iLen : iMaxRead - iPos;
+		memcpy(&psBuffer[iSize + iPos], psData, iMirror * sizeof(_SAMPLE));
+	}
+}
+
+_BOOLEAN CAudioRing::Put(const _SAMPLE* psData, const int iLen)
+{
+	const unsigned int iCurPut = iPut.load(std::memory_order_relaxed);
+	const unsigned int iCurGet = iGet.load(std::memory_order_acquire);
+
+	if ((psBuffer == nullptr) || ((int) (iCurPut - iCurGet) + iLen > iSize))
+		return FALSE;
+
+	const int iPos = (int) (iCurPut & iMask);
+	const int iFirst = (iLen < iSize - iPos) ? iLen : iSize - iPos;
+
+	Copy(iPos, psData, iFirst);
+	if (iFirst < iLen)
+		Copy(0, &psData[iFirst], iLen - iFirst);
+
+	/* Publish the samples after they are written */
+	iPut.store(iCurPut + iLen, std::memory_order_release);
+
+	return TRUE;
+}
+
+const _SAMPLE* CAudioRing::Peek(const int iLen)
+{
+	const unsigned int iCurGet = iGet.load(std::memory_order_relaxed);
+	const unsigned int iCurPut = iPut.load(std::memory_order_acquire);
+
+	if ((psBuffer == nullptr) || (iLen > iMaxRead) || ((int) (iCurPut - iCurGet) < iLen))
+		return nullptr;
+
+	/* Because of the mirror, the block is contiguous even if it wraps */
+	return &psBuffer[iCurGet & iMask];
+}
+
+void CAudioRing::Release(const int iLen)
+{
+	iGet.store(iGet.load(std::memory_order_relaxed) + iLen, std::memory_order_release);
+}
@@ -0,0 +1,78 @@
+/******************************************************************************\
+ * Copyright (c) 2024
+ *
+ * Author(s):
+ *	EasyDRF developers
+ *
+ * Description:
+ *	See AudioRing.cpp
+ *
+ ******************************************************************************
+ *
+ * This program is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation; either version 2 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ *
+\******************************************************************************/
+
+#if !defined(AUDIORING_H__3B0UBVE98732KJVEW363A0D1R1NG__INCLUDED_)
+#define AUDIORING_H__3B0UBVE98732KJVEW363A0D1R1NG__INCLUDED_
+
+#include <atomic>
+#include "../common/GlobalDefinitions.h"
+
+
+/* Classes ********************************************************************/
+/* Lock-free single producer / single consumer ring of sound samples. The
+   first "iMaxRead" samples are mirrored behind the end of the buffer, so the
+   consumer always gets a contiguous block of up to "iMaxRead" samples and can
+   work directly on the ring memory ("Peek()" ... "Release()") */
+class CAudioRing
+{
+public:
+	CAudioRing() : psBuffer(nullptr), iSize(0), iMask(0), iMaxRead(0), iPut(0), iGet(0) {}
+	virtual ~CAudioRing();
+
+	/* Must not be called while the producer or the consumer is active */
+	void			Init(const int iMinSize, const int iNewMaxRead);
+	void			Reset() {iPut = 0; iGet = 0;}
+
+	/* Producer. Returns FALSE (nothing is written) if there is no room */
+	_BOOLEAN		Put(const _SAMPLE* psData, const int iLen);
+
+	/* Consumer. Returns NULL if less than "iLen" samples are available */
+	const _SAMPLE*	Peek(const int iLen);
+	void			Release(const int iLen);
+
+	/* Consumer. Drops all samples which are in the ring now */
+	void			Flush() {iGet.store(iPut.load(std::memory_order_acquire), std::memory_order_release);}
+
+	int				GetFill() const {return (int) (iPut.load() - iGet.load());}
+	int				GetSize() const {return iSize;}
+
+protected:
+	void			Copy(const int iPos, const _SAMPLE* psData, const int iLen);
+
+	_SAMPLE*		psBuffer;
+	int				iSize;
+	int				iMask;
+	int				iMaxRead;
+
+	/* Free running sample counters, only the producer changes "iPut", only
+	   the consumer changes "iGet" */
+	std::atomic<unsigned int>	iPut;
+	std::atomic<unsigned int>	iGet;
+};
+
+
+#endif // !defined(AUDIORING_H__3B0UBVE98732KJVEW363A0D1R1NG__INCLUDED_)
@@ -28,6 +28,12 @@
 
 #include "Sound.h"
 #include <time.h>
+#include "../common/ThreadSetup.h"
+
+
+/* Modem audio backend and capture latency, from the settings */
+int SoundBackend = SOUND_BACKEND_WINMM;
+int SoundLatencyMs = SOUND_DEF_LATENCY_MS;
 
 
 /* Implementation *************************************************************/
@@ -36,61 +42,167 @@
 \******************************************************************************/
 
 
-_BOOLEAN CSound::Read(CVector<short>& psData)
+_BOOLEAN CSound::ReadBlock(const _SAMPLE*& psData)
 {
-	int			i = 0; //inits DM
-	_BOOLEAN	bError = FALSE;
-
 	/* Check if device must be opened or reinitialized */
 	if (bChangDevIn == TRUE)
 	{
-		OpenInDevice();
-
-		/* Reinit sound interface */
+		/* Reinit sound interface, this opens the new device */
 		InitRecording(iBufferSizeIn, bBlockingRec);
+	}
 
-		/* Reset flag */
-		bChangDevIn = FALSE;
+	/* Wait until the capture thread has put enough samples in the ring */
+	psData = RingIn.Peek(iBufferSizeIn);
+	while (psData == nullptr)
+	{
+		if ((bBlockingRec == FALSE) || (bClosed == TRUE))
+		{
+			/* Non-blocking read or interface was closed, return silence */
+			if (bBlockingRec == TRUE)
+				iNumUnderruns++;
+
+			psData = &vecsZeroIn[0];
+			bReadFromRing = FALSE;
+
+			return bBlockingRec;
+		}
+
+		/* Also wait if the capture is not running (yet), the capture thread
+		   sets the event as soon as samples arrive and "Close()" wakes us */
+		WaitForSingleObject(m_DataInEvent, INFINITE);
+
+		psData = RingIn.Peek(iBufferSizeIn);
 	}
 
-	/* Wait until data is available */
-	if (!(m_WaveInHeader[iWhichBufferIn].dwFlags & WHDR_DONE))
+	bReadFromRing = TRUE;
+
+	/* Samples got lost since the last block -> set error flag */
+	const int iCurOverruns = iNumOverruns;
+	const _BOOLEAN bError = (iCurOverruns != iLastOverruns);
+	iLastOverruns = iCurOverruns;
+
+	return bError;
+}
+
+void CSound::ReleaseBlock()
+{
+	/* Give the samples of the last block back to the capture thread */
+	if (bReadFromRing == TRUE)
 	{
-		if (bBlockingRec == TRUE)
-			WaitForSingleObject(m_WaveInEvent, INFINITE);
-		else
+		RingIn.Release(iBufferSizeIn);
+		bReadFromRing = FALSE;
+	}
+}
+
+void CSound::CaptureLoop()
+{
+	/* Must not be delayed by the signal processing */
+	CDSPThread DSPThread(DSP_THREAD_CAPTURE, L"EasyDRF capture");
+
+	while (bCaptureRun == TRUE)
+	{
+		WaitForSingleObject(m_WaveInEvent, SOUND_CAPTURE_TIMEOUT_MS);
+
+		/* If the number of done buffers equals the total number of buffers,
+		   the driver had no buffer left to fill and samples got lost */
+		int iNumInBufDone = 0;
+		for (int i = 0; i < NUM_SOUND_BUFFERS_IN; i++)
 		{
-			for (i = 0; i < iBufferSizeIn; i++) psData[i] = 0;
-			return FALSE;
+			if (m_WaveInHeader[i].dwFlags & WHDR_DONE)
+				iNumInBufDone++;
+		}
+
+		if (iNumInBufDone == NUM_SOUND_BUFFERS_IN)
+		{
+			iNumOverruns++;
+
+			if (bDualChannel == TRUE)
+			{
+				for (int c = 0; c < NUM_IN_OUT_CHANNELS; c++)
+					Channel[c].CountOverrun();
+			}
+		}
+
+		/* The driver returns the buffers in the order they were added */
+		while ((bCaptureRun == TRUE) &&
+			(m_WaveInHeader[iWhichBufferIn].dwFlags & WHDR_DONE))
+		{
+			const _SAMPLE* psBuffer = psSoundcardBuffer[iWhichBufferIn];
+			const int iLen = m_WaveInHeader[iWhichBufferIn].dwBytesRecorded / BYTES_PER_SAMPLE;
+
+			if (bDualChannel == TRUE)
+			{
+				/* Split the interleaved buffer once for both receivers */
+				const int iFrames = iLen / NUM_IN_OUT_CHANNELS;
+
+				for (int i = 0; i < iFrames; i++)
+				{
+					for (int c = 0; c < NUM_IN_OUT_CHANNELS; c++)
+						vecsDemux[c][i] = psBuffer[NUM_IN_OUT_CHANNELS * i + c];
+				}
+
+				for (int c = 0; c < NUM_IN_OUT_CHANNELS; c++)
+					Channel[c].Put(&vecsDemux[c][0], iFrames);
+			}
+			else if (RingIn.Put(psBuffer, iLen) == FALSE)
+			{
+				/* Ring full: the receiver is too slow, drop this buffer */
+				iNumOverruns++;
+			}
+
+			/* Give the buffer back to the driver right away */
+			AddInBuffer();
+
+			SetEvent(m_DataInEvent);
 		}
 	}
+}
 
-	/* Check if buffers got lost */
-	int iNumInBufDone = 0;
-	for (i = 0; i < NUM_SOUND_BUFFERS_IN; i++)
+void CSound::StartCapture()
+{
+	bCaptureRun = TRUE;
+	CaptureThread = std::thread(&CSound::CaptureLoop, this);
+}
+
+void CSound::StopCapture()
+{
+	if (CaptureThread.joinable())
 	{
-		if (m_WaveInHeader[i].dwFlags & WHDR_DONE)
-			iNumInBufDone++;
+		bCaptureRun = FALSE;
+		SetEvent(m_WaveInEvent);
+		CaptureThread.join();
 	}
 
-	/* If the number of done buffers equals the total number of buffers, it is
-	   very likely that a buffer got lost -> set error flag */
-	if (iNumInBufDone == NUM_SOUND_BUFFERS_IN)
-		bError = TRUE;
-	else
-		bError = FALSE;
+	bCaptureRun = FALSE;
 
-	/* Copy data from sound card in output buffer */
-	for (i = 0; i < iBufferSizeIn; i++)
-		psData[i] = psSoundcardBuffer[iWhichBufferIn][i];
+	/* Ensure that a waiting reader leaves the waiting function */
+	if (m_DataInEvent != nullptr)
+		SetEvent(m_DataInEvent);
 
-	/* Add the buffer so that it can be filled with new samples */
-	AddInBuffer();
+	for (int c = 0; c < NUM_IN_OUT_CHANNELS; c++)
+		Channel[c].Wake();
+}
 
-	/* In case more than one buffer was ready, reset event */
-	ResetEvent(m_WaveInEvent);
+void CSound::SetDualChannel(const _BOOLEAN bNewDual)
+{
+	/* The rings are allocated here, before the capture thread uses them */
+	if (bNewDual == TRUE)
+	{
+		for (int c = 0; c < NUM_IN_OUT_CHANNELS; c++)
+			Channel[c].Setup(this);
+	}
 
-	return bError;
+	bDualChannel = bNewDual;
+}
+
+void CSound::InitDualCapture(const int iChanBufferSize)
+{
+	/* Both receiver threads come here, the sound card is only (re)started by
+	   the first one or if the device was changed */
+	std::lock_guard<std::mutex> Lock(InitMutex);
+
+	if ((bCaptureRun == FALSE) || (bChangDevIn == TRUE))
+		InitRecording(iChanBufferSize * NUM_IN_OUT_CHANNELS, TRUE);
 }
 
 void CSound::AddInBuffer()
@@ -115,7 +227,7 @@ void CSound::PrepareInBuffer(int iBufNum)
 {
 	/* Set struct entries */
 	m_WaveInHeader[iBufNum].lpData = (LPSTR) &psSoundcardBuffer[iBufNum][0];
-	m_WaveInHeader[iBufNum].dwBufferLength = iBufferSizeIn * BYTES_PER_SAMPLE;
+	m_WaveInHeader[iBufNum].dwBufferLength = iPeriodIn * BYTES_PER_SAMPLE;
 	m_WaveInHeader[iBufNum].dwFlags = 0;
 
 	/* Prepare wave-header */
@@ -124,6 +236,9 @@ void CSound::PrepareInBuffer(int iBufNum)
 
 void CSound::InitRecording(int iNewBufferSize, _BOOLEAN bNewBlocking)
 {
+	/* The capture thread must not use the buffers while they are changed */
+	StopCapture();
+
 	/* Check if device must be opened or reinitialized */
 	if (bChangDevIn == TRUE)
 	{
@@ -136,6 +251,27 @@ void CSound::InitRecording(int iNewBufferSize, _BOOLEAN bNewBlocking)
 	/* Set internal parameter */
 	iBufferSizeIn = iNewBufferSize;
 	bBlockingRec = bNewBlocking;
+	bClosed = FALSE;
+
+	/* The sound card buffers together hold the latency, independent of the
+	   block size the receiver reads */
+	const int iLatencySamples =
+		iLatencyMs * (SOUNDCRD_SAMPLE_RATE / 1000) * NUM_IN_OUT_CHANNELS;
+
+	iPeriodIn = iLatencySamples / NUM_SOUND_BUFFERS_IN;
+	iPeriodIn -= iPeriodIn % NUM_IN_OUT_CHANNELS;
+	if (iPeriodIn < MIN_SOUND_PERIOD_IN)
+		iPeriodIn = MIN_SOUND_PERIOD_IN;
+
+	/* The ring has to take everything which is captured while the receiver
+	   works on an MSC block (in robustness mode D these are 24 symbols) */
+	RingIn.Init(max(iLatencySamples, NUM_SOUND_BUFFERS_IN * iBufferSizeIn), iBufferSizeIn);
+	vecsZeroIn.Init(iBufferSizeIn, 0);
+	bReadFromRing = FALSE;
+	iLastOverruns = iNumOverruns;
+
+	for (int c = 0; c < NUM_IN_OUT_CHANNELS; c++)
+		vecsDemux[c].Init(iPeriodIn / NUM_IN_OUT_CHANNELS);
 
 	/* Reset interface so that all buffers are returned from the interface */
 	waveInReset(m_WaveIn);
@@ -154,10 +290,10 @@ void CSound::InitRecording(int iNewBufferSize, _BOOLEAN bNewBlocking)
 		   simply no effect */
 		waveInUnprepareHeader(m_WaveIn, &m_WaveInHeader[i], sizeof(WAVEHDR));
 
-		if (psSoundcardBuffer[i] != nullptr)
-			delete[] psSoundcardBuffer[i];
+		FreeDSPMemory(psSoundcardBuffer[i]);
 
-		psSoundcardBuffer[i] = new short[iBufferSizeIn];
+		/* Locked in RAM with Lock_Memory_MB */
+		psSoundcardBuffer[i] = (short*) AllocDSPMemory(iPeriodIn * sizeof(short));
 
 
 		/* Send all buffers to driver for filling the queue ----------------- */
@@ -167,12 +303,15 @@ void CSound::InitRecording(int iNewBufferSize, _BOOLEAN bNewBlocking)
 		AddInBuffer();
 	}
 
-	/* Notify that sound capturing can start now */
-	waveInStart(m_WaveIn);
-
 	/* This reset event is very important for initialization, otherwise we will
 	   get errors! */
 	ResetEvent(m_WaveInEvent);
+	ResetEvent(m_DataInEvent);
+
+	/* Notify that sound capturing can start now */
+	waveInStart(m_WaveIn);
+
+	StartCapture();
 }
 
 void CSound::OpenInDevice()
@@ -308,7 +447,11 @@ _BOOLEAN CSound::Write(CVector<short>& psData)
 		/* ---------------------------------------------------------------------
 		   Buffer is empty -> send as many cleared blocks to the sound-
 		   interface until half of the buffer size is reached */
-		   /* Send half of the buffer size blocks to the sound-interface */
+		/* The sound card ran out of samples (not at the start) */
+		if (bPlayStarted == TRUE)
+			iNumUnderruns++;
+
+		/* Send half of the buffer size blocks to the sound-interface */
 		for (j = 0; j < NUM_SOUND_BUFFERS_OUT / 2; j++)
 		{
 			/* First, clear these buffers */
@@ -334,6 +477,7 @@ _BOOLEAN CSound::Write(CVector<short>& psData)
 
 	/* Now, send the current block */
 	AddOutBuffer(iIndexDoneBuf);
+	bPlayStarted = TRUE;
 
 	return FALSE;
 }
@@ -414,6 +558,7 @@ void CSound::InitPlayback(int iNewBufferSize, _BOOLEAN bNewBlocking)
 	/* Set internal parameters */
 	iBufferSizeOut = iNewBufferSize;
 	bBlockingPlay = bNewBlocking;
+	bPlayStarted = FALSE;
 
 	/* Reset interface */
 	if (m_WaveOut != nullptr)
@@ -535,6 +680,11 @@ void CSound::Close()
 	int			i = 0; //inits DM
 	MMRESULT	result = 0;
 
+	/* Stop the capture thread before the buffers are returned, this also
+	   ensures that the receiver thread leaves the waiting function */
+	bClosed = TRUE;
+	StopCapture();
+
 	/* Reset audio driver */
 	if (m_WaveOut != nullptr) //edit DM
 	{
@@ -610,10 +760,19 @@ CSound::CSound()
 	/* Should be initialized because an error can occur during init */
 	m_WaveInEvent = nullptr; //edit DM
 	m_WaveOutEvent = nullptr; //edit DM
+	m_DataInEvent = nullptr;
 	m_WaveIn = nullptr; //edit DM
 	m_WaveOut = nullptr; //edit DM
 	wavdir = nullptr; //edit NulAsh
 	m_WaveOutFile = nullptr; // edit NulAsh
+	iBufferSizeIn = 0;
+	iPeriodIn = 0;
+	bCaptureRun = FALSE;
+	bClosed = FALSE;
+	bReadFromRing = FALSE;
+	iLastOverruns = 0;
+	bPlayStarted = FALSE;
+	bDualChannel = FALSE;
 
 	/* Init buffer pointer to zero */
 	for (i = 0; i < NUM_SOUND_BUFFERS_IN; i++)
@@ -664,6 +823,7 @@ CSound::CSound()
 	/* Create events */
 	m_WaveInEvent = CreateEvent(nullptr, FALSE, FALSE, nullptr);
 	m_WaveOutEvent = CreateEvent(nullptr, FALSE, FALSE, nullptr);
+	m_DataInEvent = CreateEvent(nullptr, FALSE, FALSE, nullptr);
 
 	/* Set flag to open devices */
 	bChangDevIn = TRUE;
@@ -684,12 +844,11 @@ CSound::~CSound()
 {
 	int i;
 
+	StopCapture();
+
 	/* Delete allocated memory */
 	for (i = 0; i < NUM_SOUND_BUFFERS_IN; i++)
-	{
-		if (psSoundcardBuffer[i] != nullptr)
-			delete[] psSoundcardBuffer[i];
-	}
+		FreeDSPMemory(psSoundcardBuffer[i]);
 
 	for (i = 0; i < NUM_SOUND_BUFFERS_OUT; i++)
 	{
@@ -703,4 +862,129 @@ CSound::~CSound()
 
 	if (m_WaveOutEvent != nullptr)
 		CloseHandle(m_WaveOutEvent);
+
+	if (m_DataInEvent != nullptr)
+		CloseHandle(m_DataInEvent);
+}
+
+
+/******************************************************************************\
+* One channel in dual channel mode                                             *
+\******************************************************************************/
+CSoundChannel::CSoundChannel() : pSound(nullptr), iBufferSizeIn(0),
+	bBlockingRec(TRUE), bReadFromRing(FALSE), iLastOverruns(0)
+{
+	bClosed = FALSE;
+	hDataEvent = CreateEvent(nullptr, FALSE, FALSE, nullptr);
+}
+
+CSoundChannel::~CSoundChannel()
+{
+	if (hDataEvent != nullptr)
+		CloseHandle(hDataEvent);
+}
+
+void CSoundChannel::Setup(CSound* pNewSound)
+{
+	pSound = pNewSound;
+
+	if (Ring.GetSize() == 0)
+		Ring.Init(SOUND_CHANNEL_RING_SIZE, MAX_SOUND_CHANNEL_BLOCK);
+}
+
+void CSoundChannel::InitRecording(int iNewBufferSize, _BOOLEAN bNewBlocking)
+{
+	if ((Ring.GetSize() == 0) || (iNewBufferSize > MAX_SOUND_CHANNEL_BLOCK))
+		throw CGenErr("Sound Interface, channel not set up.");
+
+	iBufferSizeIn = iNewBufferSize;
+	bBlockingRec = bNewBlocking;
+	bClosed = FALSE;
+
+	vecsZeroIn.Init(iBufferSizeIn, 0);
+	bReadFromRing = FALSE;
+	iLastOverruns = iNumOverruns;
+
+	/* Old samples belong to the previous settings of this receiver */
+	Ring.Flush();
+
+	if (pSound != nullptr)
+		pSound->InitDualCapture(iBufferSizeIn);
+}
+
+_BOOLEAN CSoundChannel::ReadBlock(const _SAMPLE*& psData)
+{
+	/* A new input device was selected */
+	if ((pSound != nullptr) && (pSound->DevInChanged() == TRUE))
+		pSound->InitDualCapture(iBufferSizeIn);
+
+	psData = Ring.Peek(iBufferSizeIn);
+	while (psData == nullptr)
+	{
+		/* If the sound card is not capturing, we wait until it is started
+		   again or this channel is closed */
+		if ((bBlockingRec == FALSE) || (bClosed == TRUE))
+		{
+			if (bBlockingRec == TRUE)
+				iNumUnderruns++;
+
+			psData = &vecsZeroIn[0];
+			bReadFromRing = FALSE;
+
+			return bBlockingRec;
+		}
+
+		WaitForSingleObject(hDataEvent, INFINITE);
+
+		psData = Ring.Peek(iBufferSizeIn);
+	}
+
+	bReadFromRing = TRUE;
+
+	const int iCurOverruns = iNumOverruns;
+	const _BOOLEAN bError = (iCurOverruns != iLastOverruns);
+	iLastOverruns = iCurOverruns;
+
+	return bError;
+}
+
+void CSoundChannel::ReleaseBlock()
+{
+	if (bReadFromRing == TRUE)
+	{
+		Ring.Release(iBufferSizeIn);
+		bReadFromRing = FALSE;
+	}
+}
+
+void CSoundChannel::Put(const _SAMPLE* psData, const int iLen)
+{
+	/* This receiver is too slow, the other one is not affected */
+	if (Ring.Put(psData, iLen) == FALSE)
+		iNumOverruns++;
+
+	SetEvent(hDataEvent);
+}
+
+void CSoundChannel::Close()
+{
+	/* The sound card itself is closed by the receiver which owns it */
+	bClosed = TRUE;
+	SetEvent(hDataEvent);
+}
+
+int CSoundChannel::GetNumDevIn()
+{
+	return (pSound != nullptr) ? pSound->GetNumDevIn() : 0;
+}
+
+string CSoundChannel::GetDeviceNameIn(int iDiD)
+{
+	return (pSound != nullptr) ? pSound->GetDeviceNameIn(iDiD) : "";
+}
+
+void CSoundChannel::SetInDev(int iNewDev)
+{
+	if (pSound != nullptr)
+		pSound->SetInDev(iNewDev);
 }
@@ -32,8 +32,14 @@
 #include <windows.h>
 #include <mmsystem.h>
 
+#include <thread>
+#include <atomic>
+#include <mutex>
+
 #include "../common/GlobalDefinitions.h"
 #include "../common/Vector.h"
+#include "SoundInterface.h"
+#include "AudioRing.h"
 
 
 /* Definitions ****************************************************************/
@@ -46,6 +52,18 @@
 
 #define NUM_SOUND_BUFFERS_OUT	4 		/* Number of sound card buffers */
 
+/* Smallest sound card buffer for capturing (samples, both channels). The
+   buffer size follows from the latency, not from the receiver block size */
+#define MIN_SOUND_PERIOD_IN		512
+
+/* The capture thread checks its stop flag at least this often */
+#define SOUND_CAPTURE_TIMEOUT_MS	100
+
+/* Dual channel mode: size of the ring of each channel and largest block a
+   receiver can read from it (samples of one channel) */
+#define SOUND_CHANNEL_RING_SIZE		(1 << 18)
+#define MAX_SOUND_CHANNEL_BLOCK		(1 << 14)
+
 /* Maximum number of recognized sound cards installed in the system */
 #define MAX_NUMBER_SOUND_CARDS	10
 
@@ -73,7 +91,59 @@ typedef struct WaveHeader {
 } WaveHeader;
 
 /* Classes ********************************************************************/
-class CSound
+class CSound;
+
+/* One channel of the stereo capture in dual channel mode. The capture thread
+   of "CSound" splits each sound card buffer once into the rings of both
+   channels, so that two receivers can work on one sound card */
+class CSoundChannel : public CSoundInterface
+{
+public:
+	CSoundChannel();
+	virtual ~CSoundChannel();
+
+	/* "pNewSound" is NULL if the samples are not taken from the sound card
+	   (wideband channeliser), "Put()" is then called by the producer */
+	void		Setup(CSound* pNewSound);
+
+	void		InitRecording(int iNewBufferSize, _BOOLEAN bNewBlocking = TRUE);
+	void		InitPlayback(int, _BOOLEAN) {}
+	_BOOLEAN	ReadBlock(const _SAMPLE*& psData);
+	void		ReleaseBlock();
+	_BOOLEAN	Write(CVector<short>&) {return TRUE;} /* Capture only */
+	_BOOLEAN	IsEmpty(void) {return TRUE;}
+	void		Close();
+
+	int			GetNumDevIn();
+	string		GetDeviceNameIn(int iDiD);
+	int			GetNumDevOut() {return 0;}
+	string		GetDeviceNameOut(int) {return "";}
+	void		SetInDev(int iNewDev);
+	void		SetOutDev(int) {}
+	unsigned int	GetOutDev() {return 0;}
+	int			GetNumChannels() {return 1;}
+
+	/* Called by the capture thread */
+	void		Put(const _SAMPLE* psData, const int iLen);
+	void		Wake() {SetEvent(hDataEvent);}
+	void		CountOverrun() {iNumOverruns++;}
+
+protected:
+	CSound*				pSound;
+	CAudioRing			Ring;
+	HANDLE				hDataEvent;
+	int					iBufferSizeIn;
+	_BOOLEAN			bBlockingRec;
+	std::atomic<_BOOLEAN>	bClosed;
+	CVector<_SAMPLE>	vecsZeroIn;
+	_BOOLEAN			bReadFromRing;
+	int					iLastOverruns;
+};
+
+/* WinMM backend. A capture thread takes the filled sound card buffers, puts
+   the samples in the lock-free ring "RingIn" and gives the buffers back to
+   the driver right away, the receiver reads its blocks from the ring */
+class CSound : public CSoundInterface
 {
 public:
 	CSound();
@@ -82,7 +152,8 @@ public:
 	void		InitRecording(int iNewBufferSize, _BOOLEAN bNewBlocking = TRUE);
 	void		InitPlayback(int iNewBufferSize, _BOOLEAN bNewBlocking = FALSE);
 	void		CloseOutFile();
-	_BOOLEAN	Read(CVector<short>& psData);
+	_BOOLEAN	ReadBlock(const _SAMPLE*& psData);
+	void		ReleaseBlock();
 	_BOOLEAN	Write(CVector<short>& psData);
 	_BOOLEAN	IsEmpty(void);
 
@@ -98,6 +169,16 @@ public:
 
 	void		Close();
 
+	/* Dual channel mode, must be set before the recording is initialized.
+	   The receivers then read from "GetChannel()" instead of this object */
+	void		SetDualChannel(const _BOOLEAN bNewDual);
+	_BOOLEAN	GetDualChannel() {return bDualChannel;}
+	CSoundChannel*	GetChannel(const int iChan) {return &Channel[iChan];}
+
+	/* Used by "CSoundChannel" */
+	void		InitDualCapture(const int iChanBufferSize);
+	_BOOLEAN	DevInChanged() {return bChangDevIn;}
+
 protected:
 	void		OpenInDevice();
 	void		OpenOutDevice();
@@ -106,6 +187,9 @@ protected:
 	void		AddInBuffer();
 	void		AddOutBuffer(int iBufNum);
 	void		GetDoneBuffer(int& iCntPrepBuf, int& iIndexDoneBuf);
+	void		StartCapture();
+	void		StopCapture();
+	void		CaptureLoop();
 	WaveHeader	MakeWaveHeader(int const sampleRate, short int const numChannels, short int const bitsPerSample);
 
 	WAVEFORMATEX	sWaveFormatEx;
@@ -124,10 +208,27 @@ protected:
 	HANDLE			m_WaveInEvent;
 	WAVEHDR			m_WaveInHeader[NUM_SOUND_BUFFERS_IN];
 	int				iBufferSizeIn;
+	int				iPeriodIn;
 	int				iWhichBufferIn;
 	short*			psSoundcardBuffer[NUM_SOUND_BUFFERS_IN];
 	_BOOLEAN		bBlockingRec;
 
+	/* Capture thread and ring buffer */
+	CAudioRing		RingIn;
+	HANDLE			m_DataInEvent;
+	std::thread		CaptureThread;
+	std::atomic<_BOOLEAN>	bCaptureRun;
+	std::atomic<_BOOLEAN>	bClosed;
+	CVector<_SAMPLE>	vecsZeroIn;
+	_BOOLEAN		bReadFromRing;
+	int				iLastOverruns;
+
+	/* Dual channel mode */
+	_BOOLEAN		bDualChannel;
+	CSoundChannel	Channel[NUM_IN_OUT_CHANNELS];
+	CVector<_SAMPLE>	vecsDemux[NUM_IN_OUT_CHANNELS];
+	std::mutex		InitMutex;
+
 	/* Wave out */
 	WAVEOUTCAPS		m_WaveOutDevCaps;
 	int				iBufferSizeOut;
@@ -136,6 +237,7 @@ protected:
 	WAVEHDR			m_WaveOutHeader[NUM_SOUND_BUFFERS_OUT];
 	HANDLE			m_WaveOutEvent;
 	_BOOLEAN		bBlockingPlay;
+	_BOOLEAN		bPlayStarted;
 	FILE			*m_WaveOutFile;
 	std::string		m_strWaveOutFileName;
 	char			*wavdir;
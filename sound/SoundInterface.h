@@ -0,0 +1,112 @@
+/******************************************************************************\
+ * Copyright (c) 2024
+ *
+ * Author(s):
+ *	EasyDRF developers
+ *
+ * Description:
+ *	Audio backend interface used by the receiver and transmitter modules
+ *
+ ******************************************************************************
+ *
+ * This program is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation; either version 2 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ *
+\******************************************************************************/
+
+#if !defined(SOUNDINTERFACE_H__3B0UBVE98732KJVEW363S0UND1F__INCLUDED_)
+#define SOUNDINTERFACE_H__3B0UBVE98732KJVEW363S0UND1F__INCLUDED_
+
+#include <string.h>
+#include <atomic>
+#include "../common/GlobalDefinitions.h"
+#include "../common/Vector.h"
+
+
+/* Definitions ****************************************************************/
+/* Audio backends which can be selected in the settings */
+#define SOUND_BACKEND_WINMM		0
+#define SOUND_BACKEND_LOOPBACK	1
+
+/* Default capture latency (sound card buffers plus ring buffer) */
+#define SOUND_DEF_LATENCY_MS	500
+
+extern int SoundBackend;
+extern int SoundLatencyMs;
+
+
+/* Classes ********************************************************************/
+/* All sample buffers are interleaved stereo. "ReadBlock()" gives the receiver
+   a pointer to the captured samples without copying them, the block stays
+   valid until "ReleaseBlock()" is called. Both return the error flag
+   (TRUE if samples got lost since the last call) like "Read()" */
+class CSoundInterface
+{
+public:
+	CSoundInterface() : iLatencyMs(SOUND_DEF_LATENCY_MS), iNumOverruns(0), iNumUnderruns(0) {}
+	virtual ~CSoundInterface() {}
+
+	virtual void		InitRecording(int iNewBufferSize, _BOOLEAN bNewBlocking = TRUE) = 0;
+	virtual void		InitPlayback(int iNewBufferSize, _BOOLEAN bNewBlocking = FALSE) = 0;
+	virtual _BOOLEAN	ReadBlock(const _SAMPLE*& psData) = 0;
+	virtual void		ReleaseBlock() = 0;
+	virtual _BOOLEAN	Write(CVector<short>& psData) = 0;
+	virtual _BOOLEAN	IsEmpty(void) = 0;
+	virtual void		Close() = 0;
+
+	/* Copying read for users which keep the samples */
+	_BOOLEAN			Read(CVector<short>& psData)
+	{
+		const _SAMPLE* psBlock;
+		const _BOOLEAN bError = ReadBlock(psBlock);
+		memcpy(&psData[0], psBlock, psData.Size() * sizeof(_SAMPLE));
+		ReleaseBlock();
+		return bError;
+	}
+
+	virtual int			GetNumDevIn() = 0;
+	virtual string		GetDeviceNameIn(int iDiD) = 0;
+	virtual int			GetNumDevOut() = 0;
+	virtual string		GetDeviceNameOut(int iDiD) = 0;
+	virtual void		SetInDev(int iNewDev) = 0;
+	virtual void		SetOutDev(int iNewDev) = 0;
+	virtual unsigned int	GetOutDev() = 0;
+
+	/* Number of interleaved channels in the blocks of "ReadBlock()" */
+	virtual int			GetNumChannels() {return 2;}
+
+	/* Only the WinMM backend can write the output to a wave file */
+	virtual void		SetWaveOutDir(char*) {}
+	virtual void		ForceReopenOut() {}
+	virtual void		CloseOutFile() {}
+
+	/* Takes effect with the next "InitRecording()" */
+	void				SetLatency(const int iNewLatencyMs) {iLatencyMs = iNewLatencyMs;}
+	int					GetLatency() {return iLatencyMs;}
+
+	/* Overrun: captured samples were dropped because the sound card or the
+	   ring buffer was full. Underrun: the receiver found no samples or the
+	   sound card ran out of samples to play */
+	int					GetNumOverruns() {return iNumOverruns;}
+	int					GetNumUnderruns() {return iNumUnderruns;}
+	void				ResetCounters() {iNumOverruns = 0; iNumUnderruns = 0;}
+
+protected:
+	int					iLatencyMs;
+	std::atomic<int>	iNumOverruns;
+	std::atomic<int>	iNumUnderruns;
+};
+
+
+#endif // !defined(SOUNDINTERFACE_H__3B0UBVE98732KJVEW363S0UND1F__INCLUDED_)
@@ -0,0 +1,156 @@
+/******************************************************************************\
+ * Copyright (c) 2024
+ *
+ * Author(s):
+ *	EasyDRF developers
+ *
+ * Description:
+ *	Loopback audio backend for testing without sound card
+ *
+ *	The transmitter is the producer, the receiver the consumer of one
+ *	lock-free ring buffer. Both sides use stereo samples, like the sound
+ *	card interface
+ *
+ ******************************************************************************
+ *
+ * This program is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation; either version 2 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ *
+\******************************************************************************/
+
+#include "SoundLoopback.h"
+
+
+/* Implementation *************************************************************/
+CSoundLoopback* GetSoundLoopback()
+{
+	static CSoundLoopback SoundLoopback;
+
+	return &SoundLoopback;
+}
+
+CSoundLoopback::CSoundLoopback() : iBufferSizeIn(0), iBufferSizeOut(0),
+	bBlockingRec(TRUE), bBlockingPlay(FALSE), bReadFromRing(FALSE), iLastOverruns(0)
+{
+	bClosed = FALSE;
+
+	Ring.Init(LOOPBACK_RING_SIZE, LOOPBACK_MAX_BLOCK);
+
+	hDataEvent = CreateEvent(nullptr, FALSE, FALSE, nullptr);
+	hSpaceEvent = CreateEvent(nullptr, FALSE, FALSE, nullptr);
+}
+
+CSoundLoopback::~CSoundLoopback()
+{
+	CloseHandle(hDataEvent);
+	CloseHandle(hSpaceEvent);
+}
+
+void CSoundLoopback::InitRecording(int iNewBufferSize, _BOOLEAN bNewBlocking)
+{
+	if (iNewBufferSize > LOOPBACK_MAX_BLOCK)
+		throw CGenErr("Loopback sound interface, block size too large.");
+
+	iBufferSizeIn = iNewBufferSize;
+	bBlockingRec = bNewBlocking;
+	bClosed = FALSE;
+
+	vecsZeroIn.Init(iBufferSizeIn, 0);
+	bReadFromRing = FALSE;
+	iLastOverruns = iNumOverruns;
+}
+
+void CSoundLoopback::InitPlayback(int iNewBufferSize, _BOOLEAN bNewBlocking)
+{
+	iBufferSizeOut = iNewBufferSize;
+	bBlockingPlay = bNewBlocking;
+	bClosed = FALSE;
+}
+
+_BOOLEAN CSoundLoopback::ReadBlock(const _SAMPLE*& psData)
+{
+	psData = Ring.Peek(iBufferSizeIn);
+
+	if ((psData == nullptr) && (bBlockingRec == TRUE))
+	{
+		/* Wait at most as long as the block lasts, so that the receiver
+		   runs in real time on silence if nothing is transmitted */
+		const DWORD dwBlockMs = (DWORD) (iBufferSizeIn / LOOPBACK_NUM_CHANNELS * 1000 / SOUNDCRD_SAMPLE_RATE) + 1;
+
+		WaitForSingleObject(hDataEvent, dwBlockMs);
+
+		psData = Ring.Peek(iBufferSizeIn);
+	}
+
+	if (psData == nullptr)
+	{
+		if (bBlockingRec == TRUE)
+			iNumUnderruns++;
+
+		psData = &vecsZeroIn[0];
+		bReadFromRing = FALSE;
+
+		return FALSE;
+	}
+
+	bReadFromRing = TRUE;
+
+	const int iCurOverruns = iNumOverruns;
+	const _BOOLEAN bError = (iCurOverruns != iLastOverruns);
+	iLastOverruns = iCurOverruns;
+
+	return bError;
+}
+
+void CSoundLoopback::ReleaseBlock()
+{
+	if (bReadFromRing == TRUE)
+	{
+		Ring.Release(iBufferSizeIn);
+		bReadFromRing = FALSE;
+
+		SetEvent(hSpaceEvent);
+	}
+}
+
+_BOOLEAN CSoundLoopback::Write(CVector<short>& psData)
+{
+	DWORD dwWaited = 0;
+
+	while (Ring.Put(&psData[0], iBufferSizeOut) == FALSE)
+	{
+		/* Non-blocking, closed or nobody reads: drop the block */
+		if ((bBlockingPlay == FALSE) || (bClosed == TRUE) ||
+			(dwWaited >= LOOPBACK_WRITE_TIMEOUT_MS))
+		{
+			iNumOverruns++;
+			return TRUE;
+		}
+
+		WaitForSingleObject(hSpaceEvent, LOOPBACK_WAIT_MS);
+		dwWaited += LOOPBACK_WAIT_MS;
+	}
+
+	SetEvent(hDataEvent);
+
+	return FALSE;
+}
+
+void CSoundLoopback::Close()
+{
+	/* Ensure that waiting threads leave the waiting functions */
+	bClosed = TRUE;
+	SetEvent(hDataEvent);
+	SetEvent(hSpaceEvent);
+}
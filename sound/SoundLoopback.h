@@ -0,0 +1,101 @@
+/******************************************************************************\
+ * Copyright (c) 2024
+ *
+ * Author(s):
+ *	EasyDRF developers
+ *
+ * Description:
+ *	See SoundLoopback.cpp
+ *
+ ******************************************************************************
+ *
+ * This program is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation; either version 2 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ *
+\******************************************************************************/
+
+#if !defined(SOUNDLOOPBACK_H__3B0UBVE98732KJVEW363L00PBACK__INCLUDED_)
+#define SOUNDLOOPBACK_H__3B0UBVE98732KJVEW363L00PBACK__INCLUDED_
+
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#include <atomic>
+#include "SoundInterface.h"
+#include "AudioRing.h"
+
+
+/* Definitions ****************************************************************/
+/* Size of the ring between transmitter and receiver (samples, both channels).
+   It is allocated once, so that both sides can init independently */
+#define LOOPBACK_RING_SIZE		(1 << 21)
+
+/* Interleaved stereo, like the sound card interface */
+#define LOOPBACK_NUM_CHANNELS	2
+
+/* Largest block the receiver can read */
+#define LOOPBACK_MAX_BLOCK		(1 << 16)
+
+/* A blocking write gives up after this time if nobody reads */
+#define LOOPBACK_WRITE_TIMEOUT_MS	1000
+#define LOOPBACK_WAIT_MS			100
+
+
+/* Classes ********************************************************************/
+/* Audio backend without sound card: what the transmitter writes is read by
+   the receiver, so the whole chain can be tested on one PC. If nothing is
+   transmitted, the receiver gets silence in real time */
+class CSoundLoopback : public CSoundInterface
+{
+public:
+	CSoundLoopback();
+	virtual ~CSoundLoopback();
+
+	void		InitRecording(int iNewBufferSize, _BOOLEAN bNewBlocking = TRUE);
+	void		InitPlayback(int iNewBufferSize, _BOOLEAN bNewBlocking = FALSE);
+	_BOOLEAN	ReadBlock(const _SAMPLE*& psData);
+	void		ReleaseBlock();
+	_BOOLEAN	Write(CVector<short>& psData);
+	_BOOLEAN	IsEmpty(void) {return Ring.GetFill() == 0;}
+	void		Close();
+
+	int			GetNumDevIn() {return 1;}
+	string		GetDeviceNameIn(int) {return "Loopback";}
+	int			GetNumDevOut() {return 1;}
+	string		GetDeviceNameOut(int) {return "Loopback";}
+	void		SetInDev(int) {}
+	void		SetOutDev(int) {}
+	unsigned int	GetOutDev() {return 0;}
+
+protected:
+	CAudioRing			Ring;
+	HANDLE				hDataEvent;
+	HANDLE				hSpaceEvent;
+
+	int					iBufferSizeIn;
+	int					iBufferSizeOut;
+	_BOOLEAN			bBlockingRec;
+	_BOOLEAN			bBlockingPlay;
+	std::atomic<_BOOLEAN>	bClosed;
+
+	CVector<_SAMPLE>	vecsZeroIn;
+	_BOOLEAN			bReadFromRing;
+	int					iLastOverruns;
+};
+
+/* The loopback interface is shared by receiver and transmitter. It is only
+   created when it is used the first time */
+CSoundLoopback* GetSoundLoopback();
+
+
+#endif // !defined(SOUNDLOOPBACK_H__3B0UBVE98732KJVEW363L00PBACK__INCLUDED_)
@@ -0,0 +1,118 @@
+/******************************************************************************\
+ * Copyright (c) 2024
+ *
+ * Author(s):
+ *	EasyDRF developers
+ *
+ * Description:
+ *	Wave file audio backend for rendering the transmit signal offline
+ *
+ *	The modem output is written to a 16 bit stereo wave file at the sound
+ *	card sample rate, so that it can be played later by another program
+ *
+ ******************************************************************************
+ *
+ * This program is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation; either version 2 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ *
+\******************************************************************************/
+
+
+#include "SoundWaveFile.h"
+
+
+/* Implementation *************************************************************/
+_BOOLEAN CSoundWaveFile::Open(const string& strFileName)
+{
+	Close();
+
+	pFile = fopen(strFileName.c_str(), "wb");
+	if (pFile == NULL)
+		return FALSE;
+
+	/* The output is written in many small blocks */
+	setvbuf(pFile, NULL, _IOFBF, WAVEFILE_BUFFER_SIZE);
+
+	/* Sizes are written again when the file is closed */
+	iNumSamples = 0;
+	WriteHeader(0);
+
+	return TRUE;
+}
+
+void CSoundWaveFile::WriteHeader(const int iDataBytes)
+{
+	const int	iSampleRate = SOUNDCRD_SAMPLE_RATE;
+	const short	sNumChannels = WAVEFILE_NUM_CHANNELS;
+	const short	sBitsPerSample = 16;
+	const short	sBlockAlign = sNumChannels * sBitsPerSample / 8;
+	const int	iByteRate = iSampleRate * sBlockAlign;
+	const int	iRiffSize = 36 + iDataBytes;
+	const int	iFmtSize = 16;
+	const short	sFormatPCM = 1;
+
+	fwrite("RIFF", 1, 4, pFile);
+	fwrite(&iRiffSize, 4, 1, pFile);
+	fwrite("WAVE", 1, 4, pFile);
+	fwrite("fmt ", 1, 4, pFile);
+	fwrite(&iFmtSize, 4, 1, pFile);
+	fwrite(&sFormatPCM, 2, 1, pFile);
+	fwrite(&sNumChannels, 2, 1, pFile);
+	fwrite(&iSampleRate, 4, 1, pFile);
+	fwrite(&iByteRate, 4, 1, pFile);
+	fwrite(&sBlockAlign, 2, 1, pFile);
+	fwrite(&sBitsPerSample, 2, 1, pFile);
+	fwrite("data", 1, 4, pFile);
+	fwrite(&iDataBytes, 4, 1, pFile);
+}
+
+void CSoundWaveFile::InitRecording(int iNewBufferSize, _BOOLEAN)
+{
+	vecsZeroIn.Init(iNewBufferSize, 0);
+}
+
+_BOOLEAN CSoundWaveFile::ReadBlock(const _SAMPLE*& psData)
+{
+	psData = &vecsZeroIn[0];
+
+	return FALSE;
+}
+
+_BOOLEAN CSoundWaveFile::Write(CVector<short>& psData)
+{
+	if (pFile == NULL)
+		return TRUE;
+
+	const int iSize = psData.Size();
+
+	if (fwrite(&psData[0], sizeof(short), iSize, pFile) != (size_t) iSize)
+		return TRUE;
+
+	iNumSamples += iSize / WAVEFILE_NUM_CHANNELS;
+
+	return FALSE;
+}
+
+void CSoundWaveFile::Close()
+{
+	if (pFile == NULL)
+		return;
+
+	/* Complete the header */
+	fseek(pFile, 0, SEEK_SET);
+	WriteHeader(iNumSamples * WAVEFILE_NUM_CHANNELS * sizeof(short));
+
+	fclose(pFile);
+	pFile = NULL;
+}
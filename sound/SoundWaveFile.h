@@ -0,0 +1,86 @@
+/******************************************************************************\
+ * Copyright (c) 2024
+ *
+ * Author(s):
+ *	EasyDRF developers
+ *
+ * Description:
+ *	See SoundWaveFile.cpp
+ *
+ ******************************************************************************
+ *
+ * This program is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation; either version 2 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ *
+\******************************************************************************/
+
+
+#if !defined(SOUNDWAVEFILE_H__3B0UBVE98732KJVEW363WAVEF1LE__INCLUDED_)
+#define SOUNDWAVEFILE_H__3B0UBVE98732KJVEW363WAVEF1LE__INCLUDED_
+
+#include <stdio.h>
+#include "SoundInterface.h"
+
+
+/* Definitions ****************************************************************/
+/* Interleaved stereo, 16 bit, like the sound card interface */
+#define WAVEFILE_NUM_CHANNELS	2
+
+/* Size of the stdio buffer of the output file */
+#define WAVEFILE_BUFFER_SIZE	(1 << 20)
+
+
+/* Classes ********************************************************************/
+/* Audio backend which writes the output to a wave file instead of playing it.
+   "Write()" does not block, so the transmitter runs as fast as the CPU allows.
+   There is no input, a receiver would get silence */
+class CSoundWaveFile : public CSoundInterface
+{
+public:
+	CSoundWaveFile() : pFile(NULL), iNumSamples(0) {}
+	virtual ~CSoundWaveFile() {Close();}
+
+	/* Creates the file, the header is completed by "Close()" */
+	_BOOLEAN	Open(const string& strFileName);
+
+	void		InitRecording(int iNewBufferSize, _BOOLEAN bNewBlocking = TRUE);
+	void		InitPlayback(int, _BOOLEAN = FALSE) {}
+	_BOOLEAN	ReadBlock(const _SAMPLE*& psData);
+	void		ReleaseBlock() {}
+	_BOOLEAN	Write(CVector<short>& psData);
+	_BOOLEAN	IsEmpty(void) {return TRUE;}
+	void		Close();
+
+	int			GetNumDevIn() {return 1;}
+	string		GetDeviceNameIn(int) {return "Wave file";}
+	int			GetNumDevOut() {return 1;}
+	string		GetDeviceNameOut(int) {return "Wave file";}
+	void		SetInDev(int) {}
+	void		SetOutDev(int) {}
+	unsigned int	GetOutDev() {return 0;}
+
+	/* Number of samples (per channel) written since "Open()" */
+	int			GetNumSamples() {return iNumSamples;}
+	_REAL		GetDuration() {return (_REAL) iNumSamples / SOUNDCRD_SAMPLE_RATE;}
+
+protected:
+	void		WriteHeader(const int iDataBytes);
+
+	FILE*				pFile;
+	int					iNumSamples;
+	CVector<_SAMPLE>	vecsZeroIn;
+};
+
+
+#endif // !defined(SOUNDWAVEFILE_H__3B0UBVE98732KJVEW363WAVEF1LE__INCLUDED_)